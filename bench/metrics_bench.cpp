@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include "core/Metrics.hpp"
+
+namespace falconsim {
+namespace {
+
+// Cost of one histogram record, the per-event price of hot-path instrumentation
+void BM_HistogramRecord(benchmark::State& state) {
+    Histogram histogram;
+    std::uint64_t value{1};
+    for (auto _ : state) {
+        histogram.record(value);
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL; // Spread over every bucket
+        value >>= 20;
+    }
+    benchmark::DoNotOptimize(histogram.count());
+}
+BENCHMARK(BM_HistogramRecord);
+
+// Clock read plus record, as done around every physics step
+void BM_HistogramTimedEvent(benchmark::State& state) {
+    Histogram histogram;
+    for (auto _ : state) {
+        const auto start{std::chrono::steady_clock::now()};
+        histogram.record(nanosecondsSince(start));
+    }
+    benchmark::DoNotOptimize(histogram.count());
+}
+BENCHMARK(BM_HistogramTimedEvent);
+
+void BM_ShardedCounterAdd(benchmark::State& state) {
+    static ShardedCounter counter;
+    for (auto _ : state) {
+        counter.add();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedCounterAdd)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
+} // namespace falconsim
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "network/TelemetryServer.hpp"
+
+namespace falconsim {
+namespace {
+
+namespace asio = boost::asio;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kReceiveTimeout{std::chrono::milliseconds(100)};
+
+// Spin until a datagram arrives and return its size; 0 on timeout (a lost datagram must not hang the run)
+std::size_t receiveWithin(asio::ip::udp::socket& socket, std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize>& datagram) {
+    const auto deadline = Clock::now() + kReceiveTimeout;
+    while (socket.available() == 0) {
+        if (Clock::now() > deadline) {
+            return 0;
+        }
+    }
+    asio::ip::udp::endpoint sender;
+    return socket.receive_from(asio::buffer(datagram), sender);
+}
+
+// Latency percentiles in microseconds, reported as counters next to the mean
+void reportPercentiles(benchmark::State& state, std::vector<double>& latencies) {
+    if (latencies.empty()) {
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        const auto rank = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+        return latencies[rank] * 1e6;
+    };
+    state.counters["p50_us"] = percentile(0.50);
+    state.counters["p90_us"] = percentile(0.90);
+    state.counters["p99_us"] = percentile(0.99);
+    state.counters["max_us"] = latencies.back() * 1e6;
+}
+
+// Kernel baseline: one pre-encoded frame over a raw loopback socket pair
+void BM_UdpLoopbackRaw(benchmark::State& state) {
+    asio::io_context io;
+    asio::ip::udp::socket sender{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    asio::ip::udp::socket receiver{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    const asio::ip::udp::endpoint target{receiver.local_endpoint()};
+    
+    TelemetryFrameBuffer frame;
+    encodeTelemetryBinary(TelemetryData{}, 0, frame);
+    std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> datagram{};
+    std::vector<double> latencies;
+    
+    for (auto _ : state) {
+        const auto start = Clock::now();
+        sender.send_to(asio::buffer(frame.bytes.data(), frame.size), target);
+        if (receiveWithin(receiver, datagram) == 0) {
+            state.SkipWithError("Datagram lost on loopback");
+            break;
+        }
+        const std::chrono::duration<double> elapsed{Clock::now() - start};
+        state.SetIterationTime(elapsed.count());
+        latencies.push_back(elapsed.count());
+    }
+    reportPercentiles(state, latencies);
+}
+BENCHMARK(BM_UdpLoopbackRaw)->UseManualTime();
+
+// End to end: publishStep() on the physics side until a registered client holds the decoded frame
+void BM_TelemetryServerLoopback(benchmark::State& state) {
+    TelemetryServer server{0};
+    server.setStreamMode(TelemetryStreamMode::PhysicsStep);
+    server.setQueuePolicy(TelemetryQueuePolicy::DrainAll);
+    server.start();
+    
+    asio::io_context io;
+    asio::ip::udp::socket client{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    const asio::ip::udp::endpoint serverEndpoint{asio::ip::address_v4::loopback(), server.getPort()};
+    client.send_to(asio::buffer(std::string{"REGISTER BINARY"}), serverEndpoint);
+    const auto registered = Clock::now() + std::chrono::seconds(1);
+    while (server.getClientCount() == 0 && Clock::now() < registered) {
+        std::this_thread::yield();
+    }
+    if (server.getClientCount() == 0) {
+        state.SkipWithError("Client registration timed out");
+        server.stop();
+        return;
+    }
+    
+    const AircraftState aircraft;
+    const ControlInputs controls;
+    std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> datagram{};
+    std::vector<double> latencies;
+    double simTime{0.0};
+    
+    for (auto _ : state) {
+        const auto start = Clock::now();
+        simTime += 0.001;
+        server.publishStep(aircraft, controls, simTime);
+        TelemetryData decoded;
+        const std::size_t bytes{receiveWithin(client, datagram)};
+        if (bytes == 0 || !decodeTelemetry(datagram.data(), bytes, decoded)) {
+            state.SkipWithError("Telemetry frame lost or malformed");
+            break;
+        }
+        const std::chrono::duration<double> elapsed{Clock::now() - start};
+        state.SetIterationTime(elapsed.count());
+        latencies.push_back(elapsed.count());
+    }
+    reportPercentiles(state, latencies);
+    server.stop();
+}
+BENCHMARK(BM_TelemetryServerLoopback)->UseManualTime();
+
+} // namespace
+} // namespace falconsim
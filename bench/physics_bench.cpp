@@ -0,0 +1,381 @@
+#include <benchmark/benchmark.h>
+#include "core/ProximityMonitor.hpp"
+#include "core/SweepRunner.hpp"
+#include "physics/AeroTable.hpp"
+#include "physics/FlightDynamics.hpp"
+#include "physics/FleetDynamics.hpp"
+#include "physics/FleetKernels.hpp"
+#include "physics/TerrainMap.hpp"
+#include "physics/WindField.hpp"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace falconsim {
+namespace {
+
+// The open-loop model drifts away from trim, so long runs are periodically
+// rewound to keep every step measuring finite, representative values
+constexpr std::int64_t kStepsPerRewind{256};
+constexpr double kTimestep{0.001};
+
+AircraftState cruiseState() {
+    AircraftState state;
+    state.position = Eigen::Vector3d(0.0, 0.0, -100.0);
+    state.velocity = Eigen::Vector3d(20.0, 0.0, 0.0);
+    return state;
+}
+
+ControlInputs cruiseControls(std::size_t vehicle = 0) {
+    ControlInputs controls;
+    controls.throttle = 0.6;
+    controls.aileron = 0.05 * static_cast<double>(vehicle % 3);
+    controls.elevator = -0.02;
+    return controls;
+}
+
+// Per airframe policy: the runtime-parameterized model against the same small UAV fixed at compile time
+template <typename Dynamics>
+void BM_FlightDynamicsUpdate(benchmark::State& state) {
+    Dynamics dynamics;
+    dynamics.setIntegrationMethod(static_cast<IntegrationMethod>(state.range(0)));
+    dynamics.setState(cruiseState());
+    dynamics.setControls(cruiseControls());
+    const DynamicsSnapshot trim{dynamics.snapshot()};
+    
+    std::int64_t steps{0};
+    for (auto _ : state) {
+        dynamics.update(kTimestep);
+        if (++steps == kStepsPerRewind) {
+            dynamics.restore(trim);
+            steps = 0;
+        }
+        benchmark::DoNotOptimize(dynamics.getState().position);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_FlightDynamicsUpdate, FlightDynamics)
+    ->ArgName("method")
+    ->Arg(static_cast<int>(IntegrationMethod::EulerAngles))
+    ->Arg(static_cast<int>(IntegrationMethod::SemiImplicitEuler))
+    ->Arg(static_cast<int>(IntegrationMethod::RK4));
+BENCHMARK_TEMPLATE(BM_FlightDynamicsUpdate, SmallUavDynamics)
+    ->ArgName("method")
+    ->Arg(static_cast<int>(IntegrationMethod::EulerAngles))
+    ->Arg(static_cast<int>(IntegrationMethod::SemiImplicitEuler))
+    ->Arg(static_cast<int>(IntegrationMethod::RK4));
+
+void BM_FlightDynamicsSnapshotRestore(benchmark::State& state) {
+    FlightDynamics dynamics;
+    dynamics.setState(cruiseState());
+    for (auto _ : state) {
+        DynamicsSnapshot snapshot{dynamics.snapshot()};
+        benchmark::DoNotOptimize(snapshot);
+        dynamics.restore(snapshot);
+    }
+}
+BENCHMARK(BM_FlightDynamicsSnapshotRestore);
+
+// Fleet step per SIMD kernel; items are vehicle-steps
+void BM_FleetUpdate(benchmark::State& state) {
+    const auto isa = static_cast<SimdIsa>(state.range(0));
+    if (!isSimdIsaAvailable(isa)) {
+        state.SkipWithError("ISA not available on this CPU");
+        return;
+    }
+    
+    const auto vehicles = static_cast<std::size_t>(state.range(1));
+    FleetDynamics trim;
+    trim.reserve(vehicles);
+    for (std::size_t i = 0; i < vehicles; ++i) {
+        trim.addVehicle(cruiseState());
+        trim.setControls(i, cruiseControls(i));
+    }
+    FleetDynamics fleet{trim};
+    fleet.setSimdIsa(isa);
+    
+    std::int64_t steps{0};
+    for (auto _ : state) {
+        fleet.update(kTimestep);
+        if (++steps == kStepsPerRewind) {
+            state.PauseTiming();
+            fleet = trim;
+            fleet.setSimdIsa(isa);
+            state.ResumeTiming();
+            steps = 0;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(vehicles));
+    state.SetLabel(simdIsaName(isa));
+}
+BENCHMARK(BM_FleetUpdate)
+    ->ArgNames({"isa", "vehicles"})
+    ->ArgsProduct({{static_cast<int>(SimdIsa::Scalar), static_cast<int>(SimdIsa::Neon),
+                    static_cast<int>(SimdIsa::Avx2), static_cast<int>(SimdIsa::Avx512)},
+                   {64, 1024}});
+
+// A table the size of a typical airframe data set: 21 alpha x 9 beta x 5 Mach x 7 deflection
+std::shared_ptr<const AeroTable> benchAeroTable() {
+    AeroTableAxes axes;
+    axes.alpha.clear();
+    for (int i = -10; i <= 10; ++i) {
+        axes.alpha.push_back(0.03 * i);
+    }
+    axes.beta = {-0.2, -0.15, -0.1, -0.05, 0.0, 0.05, 0.1, 0.15, 0.2};
+    axes.mach = {0.0, 0.05, 0.1, 0.2, 0.3};
+    axes.deflection = {-1.0, -0.6, -0.3, 0.0, 0.3, 0.6, 1.0};
+    std::vector<AeroCoefficients> values;
+    for (double alpha : axes.alpha) {
+        for (double beta : axes.beta) {
+            for (double mach : axes.mach) {
+                for (double deflection : axes.deflection) {
+                    values.push_back(AeroCoefficients{0.2 + 5.0 * alpha + 0.3 * deflection, 0.03 + 0.5 * alpha * alpha + beta * beta,
+                                                      -0.5 * alpha + 0.1 * deflection * (1.0 + mach)});
+                }
+            }
+        }
+    }
+    return std::make_shared<const AeroTable>(axes, values);
+}
+
+void BM_AeroTableLookup(benchmark::State& state) {
+    const auto table = benchAeroTable();
+    double alpha{-0.29};
+    for (auto _ : state) {
+        AeroCoefficients coefficients{table->lookup(alpha, 0.03, 0.07, 0.1)};
+        benchmark::DoNotOptimize(coefficients);
+        alpha = alpha > 0.29 ? -0.29 : alpha + 0.0137; // Wander across cells
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AeroTableLookup);
+
+// Fleet step with every vehicle sharing one table; items are vehicle-steps
+void BM_FleetUpdateAeroTable(benchmark::State& state) {
+    const auto vehicles = static_cast<std::size_t>(state.range(0));
+    const auto table = benchAeroTable();
+    FleetDynamics trim;
+    trim.reserve(vehicles);
+    for (std::size_t i = 0; i < vehicles; ++i) {
+        trim.addVehicle(cruiseState());
+        trim.setControls(i, cruiseControls(i));
+        trim.setAeroTable(i, table);
+    }
+    FleetDynamics fleet{trim};
+    
+    std::int64_t steps{0};
+    for (auto _ : state) {
+        fleet.update(kTimestep);
+        if (++steps == kStepsPerRewind) {
+            state.PauseTiming();
+            fleet = trim;
+            state.ResumeTiming();
+            steps = 0;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(vehicles));
+}
+BENCHMARK(BM_FleetUpdateAeroTable)->ArgName("vehicles")->Arg(64)->Arg(1024);
+
+// A regional weather grid: 12.8 x 12.8 km at 100 m, 3.2 km deep, two slices (~30 MB of bricks)
+std::shared_ptr<const WindField> benchWindField() {
+    WindGridSpec spec;
+    spec.nodes[0] = 129;
+    spec.nodes[1] = 129;
+    spec.nodes[2] = 33;
+    spec.slices = 2;
+    spec.origin[2] = -3200.0;
+    std::vector<float> values;
+    values.reserve(spec.nodes[0] * spec.nodes[1] * spec.nodes[2] * spec.slices * 3);
+    for (std::size_t t = 0; t < spec.slices; ++t) {
+        for (std::size_t n = 0; n < spec.nodes[0]; ++n) {
+            for (std::size_t e = 0; e < spec.nodes[1]; ++e) {
+                for (std::size_t d = 0; d < spec.nodes[2]; ++d) {
+                    values.insert(values.end(), {static_cast<float>(5.0 + 0.01 * e + t),
+                                                 static_cast<float>(-2.0 + 0.02 * n),
+                                                 static_cast<float>(0.1 * (d % 3))});
+                }
+            }
+        }
+    }
+    return std::make_shared<const WindField>(spec, values);
+}
+
+// NED positions scattered over the whole grid
+std::vector<double> scatteredPositions(std::size_t count) {
+    std::vector<double> positions;
+    std::uint64_t seed{0x9E3779B97F4A7C15ull};
+    const auto next = [&seed](double scale) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<double>(seed >> 11) * 0x1.0p-53 * scale;
+    };
+    for (std::size_t i = 0; i < count; ++i) {
+        positions.insert(positions.end(), {next(12800.0), next(12800.0), -next(3200.0)});
+    }
+    return positions;
+}
+
+// Random-access samples, optionally prefetching eight samples ahead
+void BM_WindFieldSample(benchmark::State& state) {
+    const auto field = benchWindField();
+    const bool prefetch{state.range(0) != 0};
+    constexpr std::size_t kPoints{1 << 16};
+    constexpr std::size_t kAhead{8};
+    const std::vector<double> positions{scatteredPositions(kPoints)};
+    std::size_t i{0};
+    for (auto _ : state) {
+        if (prefetch) {
+            const double* ahead{&positions[((i + kAhead) % kPoints) * 3]};
+            field->prefetch(ahead[0], ahead[1], ahead[2], 30.0);
+        }
+        const double* p{&positions[i * 3]};
+        double wind[3];
+        field->sample(p[0], p[1], p[2], 30.0, wind);
+        benchmark::DoNotOptimize(wind);
+        i = (i + 1) % kPoints;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WindFieldSample)->ArgName("prefetch")->Arg(0)->Arg(1);
+
+// Fleet step through the weather grid, with or without Dryden turbulence; items are vehicle-steps
+void BM_FleetUpdateWind(benchmark::State& state) {
+    const auto vehicles = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> positions{scatteredPositions(vehicles)};
+    FleetDynamics trim;
+    trim.reserve(vehicles);
+    for (std::size_t i = 0; i < vehicles; ++i) {
+        AircraftState start{cruiseState()};
+        start.position = Eigen::Vector3d(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+        trim.addVehicle(start);
+        trim.setControls(i, cruiseControls(i));
+    }
+    trim.setWindField(benchWindField());
+    if (state.range(1) != 0) {
+        trim.setTurbulence(TurbulenceParameters{10.0, 1});
+    }
+    FleetDynamics fleet{trim};
+    
+    std::int64_t steps{0};
+    for (auto _ : state) {
+        fleet.update(kTimestep);
+        if (++steps == kStepsPerRewind) {
+            state.PauseTiming();
+            fleet = trim;
+            state.ResumeTiming();
+            steps = 0;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(vehicles));
+}
+BENCHMARK(BM_FleetUpdateWind)->ArgNames({"vehicles", "turbulence"})->ArgsProduct({{64, 1024}, {0, 1}});
+
+// Swarm at one vehicle per (40 m)³, drifting 2 m per step so a few percent change cell each update
+struct BenchSwarm {
+    explicit BenchSwarm(std::size_t count) : north(count), east(count), down(count) {
+        const double edge{40.0 * std::cbrt(static_cast<double>(count))};
+        std::uint64_t seed{0x2545F4914F6CDD1Dull};
+        const auto next = [&seed](double scale) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<double>(seed >> 11) * 0x1.0p-53 * scale;
+        };
+        for (std::size_t i = 0; i < count; ++i) {
+            north[i] = next(edge);
+            east[i] = next(edge);
+            down[i] = -200.0 - next(edge);
+        }
+    }
+    
+    void drift(std::int64_t step) {
+        const double offset{(step & 1) != 0 ? 2.0 : -2.0};
+        for (std::size_t i = 0; i < north.size(); i += 2) {
+            north[i] += offset;
+            east[i] -= offset;
+        }
+    }
+    
+    std::vector<double> north, east, down;
+};
+
+std::shared_ptr<const TerrainMap> benchTerrain() {
+    TerrainSpec spec;
+    spec.samples[0] = spec.samples[1] = 1025;
+    std::vector<float> heights(spec.samples[0] * spec.samples[1]);
+    for (std::size_t i = 0; i < heights.size(); ++i) {
+        heights[i] = static_cast<float>(50.0 + 40.0 * std::sin(0.01 * static_cast<double>(i % 1025)) *
+                                                   std::cos(0.013 * static_cast<double>(i / 1025)));
+    }
+    return std::make_shared<const TerrainMap>(spec, heights);
+}
+
+// Separation, collision and terrain checks with the grid broadphase; items are vehicles checked
+void BM_ProximityUpdate(benchmark::State& state) {
+    const auto vehicles = static_cast<std::size_t>(state.range(0));
+    BenchSwarm swarm{vehicles};
+    ProximityMonitor monitor;
+    monitor.setTerrain(benchTerrain());
+    
+    std::int64_t step{0};
+    for (auto _ : state) {
+        swarm.drift(step++);
+        monitor.update(swarm.north.data(), swarm.east.data(), swarm.down.data(), vehicles);
+        benchmark::DoNotOptimize(monitor.getConflicts().data());
+    }
+    state.counters["conflicts"] = static_cast<double>(monitor.getConflicts().size());
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(vehicles));
+}
+BENCHMARK(BM_ProximityUpdate)->ArgName("vehicles")->Arg(1024)->Arg(16384);
+
+// The all-pairs separation check the grid replaces, for comparison; items are vehicles checked
+void BM_ProximityBruteForce(benchmark::State& state) {
+    const auto vehicles = static_cast<std::size_t>(state.range(0));
+    BenchSwarm swarm{vehicles};
+    constexpr double kSeparation{50.0};
+    
+    for (auto _ : state) {
+        std::size_t conflicts{0};
+        for (std::size_t i = 0; i < vehicles; ++i) {
+            for (std::size_t j = i + 1; j < vehicles; ++j) {
+                const double dn{swarm.north[j] - swarm.north[i]};
+                const double de{swarm.east[j] - swarm.east[i]};
+                const double dd{swarm.down[j] - swarm.down[i]};
+                conflicts += dn * dn + de * de + dd * dd < kSeparation * kSeparation ? 1 : 0;
+            }
+        }
+        benchmark::DoNotOptimize(conflicts);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(vehicles));
+}
+BENCHMARK(BM_ProximityBruteForce)->ArgName("vehicles")->Arg(1024)->Arg(16384);
+
+// Monte Carlo sweep throughput over all hardware threads; items are physics steps
+void BM_SweepRun(benchmark::State& state) {
+    SweepRanges ranges;
+    ranges.mass[0] = 0.8;
+    ranges.mass[1] = 1.4;
+    ranges.initial_state.position = Eigen::Vector3d{0, 0, -100};
+    ranges.initial_state.velocity = Eigen::Vector3d{3.0, 0, 0};
+    ranges.velocity_spread = Eigen::Vector3d{1.0, 0.2, 0.2};
+    ControlKeyframe cruise;
+    cruise.controls.throttle = 0.02;
+    ranges.schedule = {cruise};
+    const SweepSpace space{SweepSpace::monteCarlo(ranges, static_cast<std::uint64_t>(state.range(0)))};
+    SweepSettings settings;
+    settings.duration = 5.0;
+    
+    SweepRunner runner;
+    std::uint64_t steps{0};
+    for (auto _ : state) {
+        const SweepAggregate result{runner.run(space, settings)};
+        steps += result.getSteps();
+        benchmark::DoNotOptimize(result.stats(SweepMetric::FinalAltitude).mean());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(steps));
+}
+BENCHMARK(BM_SweepRun)->ArgName("cases")->Arg(256)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
+} // namespace falconsim
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include "core/BoundedQueue.hpp"
+#include "core/SeqLock.hpp"
+#include "physics/FlightDynamics.hpp"
+#include "network/TelemetryCodec.hpp"
+
+namespace falconsim {
+namespace {
+
+// Uncontended push + pop of a telemetry-sized element
+void BM_BoundedQueuePushPop(benchmark::State& state) {
+    BoundedQueue<TelemetrySample> queue{128};
+    TelemetrySample sample;
+    for (auto _ : state) {
+        queue.tryPush(sample);
+        queue.tryPop(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoundedQueuePushPop);
+
+// Every thread both produces and consumes on one shared ring; items are completed pushes
+void BM_BoundedQueueContended(benchmark::State& state) {
+    static BoundedQueue<std::uint64_t> queue{1024};
+    std::uint64_t value{static_cast<std::uint64_t>(state.thread_index())};
+    std::int64_t pushed{0};
+    for (auto _ : state) {
+        if (queue.tryPush(value)) {
+            ++pushed;
+        }
+        queue.tryPop(value);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(pushed);
+}
+BENCHMARK(BM_BoundedQueueContended)->ThreadRange(2, 8)->UseRealTime();
+
+void BM_SeqLockStoreLoad(benchmark::State& state) {
+    SeqLock<AircraftState> lock;
+    AircraftState value;
+    for (auto _ : state) {
+        value.mass += 1.0;
+        lock.store(value);
+        benchmark::DoNotOptimize(lock.load());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SeqLockStoreLoad);
+
+} // namespace
+} // namespace falconsim
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include "network/TelemetryCodec.hpp"
+#include "network/CompactTelemetry.hpp"
+
+namespace falconsim {
+namespace {
+
+TelemetryData sampleTelemetry(double time = 12.5) {
+    TelemetryData data;
+    data.timestamp = time;
+    data.position_north = 152.25;
+    data.position_east = -37.5;
+    data.position_down = -120.0;
+    data.velocity_x = 21.0;
+    data.velocity_y = 0.125;
+    data.velocity_z = -0.75;
+    data.roll = 0.1;
+    data.pitch = -0.05;
+    data.yaw = 1.5;
+    data.throttle = 0.6;
+    data.aileron = 0.02;
+    data.elevator = -0.03;
+    data.rudder = 0.01;
+    return data;
+}
+
+void BM_EncodeTelemetry(benchmark::State& state) {
+    const auto encoding = static_cast<TelemetryEncoding>(state.range(0));
+    const TelemetryData data{sampleTelemetry()};
+    TelemetryFrameBuffer frame;
+    std::uint32_t sequence{0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(encodeTelemetry(encoding, data, ++sequence, frame));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(frame.size));
+}
+BENCHMARK(BM_EncodeTelemetry)
+    ->ArgName("encoding")
+    ->Arg(static_cast<int>(TelemetryEncoding::Binary))
+    ->Arg(static_cast<int>(TelemetryEncoding::Csv));
+
+void BM_DecodeTelemetry(benchmark::State& state) {
+    const auto encoding = static_cast<TelemetryEncoding>(state.range(0));
+    TelemetryFrameBuffer frame;
+    encodeTelemetry(encoding, sampleTelemetry(), 1, frame);
+    TelemetryData decoded;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decodeTelemetry(frame.bytes.data(), frame.size, decoded));
+        benchmark::DoNotOptimize(decoded);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(frame.size));
+}
+BENCHMARK(BM_DecodeTelemetry)
+    ->ArgName("encoding")
+    ->Arg(static_cast<int>(TelemetryEncoding::Binary))
+    ->Arg(static_cast<int>(TelemetryEncoding::Csv));
+
+// A full MTU-sized Batch frame; items are samples
+void BM_TelemetryBatchRoundTrip(benchmark::State& state) {
+    std::array<TelemetrySample, telemetry_wire::kMaxBatchSamples> samples{};
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i].vehicle_id = static_cast<std::uint32_t>(i);
+        samples[i].data = sampleTelemetry();
+    }
+    std::array<TelemetrySample, telemetry_wire::kMaxBatchSamples> decoded{};
+    TelemetryFrameBuffer frame;
+    for (auto _ : state) {
+        encodeTelemetryBatch(samples.data(), samples.size(), 1, frame);
+        benchmark::DoNotOptimize(decodeTelemetrySamples(frame.bytes.data(), frame.size, decoded.data(), decoded.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(samples.size()));
+}
+BENCHMARK(BM_TelemetryBatchRoundTrip);
+
+// Steady state of the compact stream: mostly deltas, a keyframe every 10 frames
+void BM_CompactTelemetryRoundTrip(benchmark::State& state) {
+    CompactTelemetryEncoder encoder;
+    CompactTelemetryDecoder decoder;
+    TelemetrySample sample;
+    sample.data = sampleTelemetry(0.0);
+    TelemetrySample decoded;
+    TelemetryFrameBuffer frame;
+    std::int64_t bytes{0};
+    for (auto _ : state) {
+        sample.data.timestamp += 0.001;
+        sample.data.position_north += 0.02;
+        bytes += static_cast<std::int64_t>(encoder.encode(sample, frame));
+        benchmark::DoNotOptimize(decoder.decode(frame.bytes.data(), frame.size, decoded));
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_CompactTelemetryRoundTrip);
+
+} // namespace
+} // namespace falconsim
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+
+#include "../src/core/Simulation.hpp"
+#include "../src/physics/FlightDynamics.hpp"
+
+using namespace falconsim;
+
+int main() {
+    std::cout << "FalconSim - Batch Simulation Example" << std::endl;
+    std::cout << "====================================" << std::endl;
+    
+    // 100Hz physics, stepped headless on this thread
+    Simulation sim{0.01};
+    
+    // Set initial state: aircraft at 100m altitude
+    AircraftState initialState;
+    initialState.position = Eigen::Vector3d{0, 0, -100}; // -Z is up in NED frame
+    sim.setState(initialState);
+    
+    // Same scripted pattern as the telemetry server example:
+    // 80% throttle, and the control surfaces change every 10 seconds
+    auto flightPlan = [](Simulation& s, double time) {
+        s.setThrust(0.8);
+        switch (static_cast<int>(time) / 10 % 4) {
+            case 0: // Straight flight
+                s.setControlSurfaces(Eigen::Vector3d{0.0, 0.0, 0.0});
+                break;
+            case 1: // Roll right
+                s.setControlSurfaces(Eigen::Vector3d{0.2, 0.0, 0.0});
+                break;
+            case 2: // Level flight with climb
+                s.setControlSurfaces(Eigen::Vector3d{0.0, 0.2, 0.0});
+                break;
+            case 3: // Roll left
+                s.setControlSurfaces(Eigen::Vector3d{-0.2, 0.0, 0.0});
+                break;
+        }
+    };
+    
+    // Fly 10 simulated minutes as fast as possible
+    const double duration{600.0};
+    auto wallStart = std::chrono::steady_clock::now();
+    auto steps = sim.run(duration, 0.01, flightPlan);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Simulated " << sim.getSimulationTime() << " s (" << steps << " steps) in "
+              << wallSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Speed-up over real time: " << duration / wallSeconds << "x" << std::endl;
+    
+    return 0;
+}
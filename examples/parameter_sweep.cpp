@@ -0,0 +1,75 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+
+#include "../src/core/SweepRunner.hpp"
+#include "../src/recording/SweepLogWriter.hpp"
+
+using namespace falconsim;
+
+int main(int argc, char** argv) {
+    const std::uint64_t cases{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000};
+    const std::string path{argc > 2 ? argv[2] : "sweep.fssweep"};
+    
+    std::cout << "FalconSim - Monte Carlo Parameter Sweep" << std::endl;
+    std::cout << "=======================================" << std::endl;
+    
+    // Glide from 100m at 3 m/s with uncertain mass, aerodynamics, wind and launch attitude
+    SweepRanges ranges;
+    ranges.mass[0] = 0.8;
+    ranges.mass[1] = 1.4;
+    ranges.lift_coefficient[0] = 0.9;
+    ranges.lift_coefficient[1] = 1.2;
+    ranges.drag_coefficient[0] = 0.08;
+    ranges.drag_coefficient[1] = 0.14;
+    ranges.wind_min = Eigen::Vector3d{-2.0, -2.0, -0.2};
+    ranges.wind_max = Eigen::Vector3d{2.0, 2.0, 0.2};
+    ranges.initial_state.position = Eigen::Vector3d{0, 0, -100}; // -Z is up in NED frame
+    ranges.initial_state.velocity = Eigen::Vector3d{3.0, 0, 0};
+    ranges.velocity_spread = Eigen::Vector3d{1.0, 0.2, 0.2};
+    ranges.attitude_spread = Eigen::Vector3d{0.05, 0.05, 0.0};
+    ranges.seed = 42;
+    
+    // 2% throttle, cut after 10 seconds
+    ControlKeyframe cruise;
+    cruise.controls.throttle = 0.02;
+    ControlKeyframe glide;
+    glide.time = 10.0;
+    ranges.schedule = {cruise, glide};
+    
+    SweepSettings settings;
+    settings.duration = 20.0;
+    settings.timestep = 0.01;
+    
+    // Every run streams its summary into the statistics and the result file; no trajectory is kept
+    SweepRunner runner;
+    SweepLogWriter writer{path};
+    const auto wallStart = std::chrono::steady_clock::now();
+    const SweepAggregate result{runner.run(SweepSpace::monteCarlo(ranges, cases), settings,
+                                           [&writer](const SweepRunSummary& run) { writer.append(run); })};
+    const double wallSeconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count()};
+    writer.close();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << result.getRuns() << " runs (" << result.getSteps() << " steps) on " << runner.threadCount()
+              << " threads in " << wallSeconds << " s" << std::endl;
+    std::cout << "Ground impacts: " << result.getOutcomeCount(SweepOutcome::GroundImpact)
+              << ", diverged: " << result.getOutcomeCount(SweepOutcome::Diverged) << std::endl;
+    
+    const auto report = [&result](const char* name, SweepMetric metric) {
+        const RunningStats& stats{result.stats(metric)};
+        const QuantileSketch& quantiles{result.quantiles(metric)};
+        std::cout << std::setw(16) << name << "  mean " << std::setw(9) << stats.mean() << "  sd " << std::setw(8)
+                  << stats.stddev() << "  p5 " << std::setw(9) << quantiles.quantile(0.05) << "  p50 " << std::setw(9)
+                  << quantiles.quantile(0.5) << "  p95 " << std::setw(9) << quantiles.quantile(0.95) << std::endl;
+    };
+    report("end time (s)", SweepMetric::EndTime);
+    report("final alt (m)", SweepMetric::FinalAltitude);
+    report("min alt (m)", SweepMetric::MinAltitude);
+    report("max speed (m/s)", SweepMetric::MaxSpeed);
+    std::cout << "Per-run summaries written to " << path << std::endl;
+    
+    return 0;
+}
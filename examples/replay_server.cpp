@@ -0,0 +1,60 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <algorithm>
+
+#include "../src/network/TelemetryServer.hpp"
+#include "../src/recording/FlightLogReader.hpp"
+
+using namespace falconsim;
+
+// Signal handling for clean shutdown
+std::atomic<bool> running{true};
+
+void signalHandler(int signum) {
+    std::cout << "Interrupt signal (" << signum << ") received. Shutting down..." << std::endl;
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <flight log> [start time (s)] [speed]" << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, signalHandler);
+
+    std::cout << "FalconSim - Flight Log Replay Server" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    // The log is memory-mapped; only the pages we replay are read from disk
+    FlightLogReader log{argv[1]};
+    if (log.empty()) {
+        std::cerr << "Flight log is empty" << std::endl;
+        return 1;
+    }
+    const double startTime{argc > 2 ? std::atof(argv[2]) : log.getStartTime()};
+    const double speed{argc > 3 ? std::max(0.01, std::atof(argv[3])) : 1.0};
+    std::cout << "Log covers " << log.getStartTime() << " - " << log.getEndTime() << " s in "
+              << log.size() << " steps" << (log.wasRecovered() ? " (index rebuilt)" : "") << std::endl;
+
+    // Stream every recorded step; clients pick their own rate with "REGISTER BINARY <N>"
+    TelemetryServer telemetry{12345};
+    telemetry.setStreamMode(TelemetryStreamMode::PhysicsStep);
+    telemetry.start();
+
+    // Jump straight to the requested time, then replay at the recorded pace
+    const auto wallStart = std::chrono::steady_clock::now();
+    for (std::size_t index = log.seek(startTime); index < log.size() && running; ++index) {
+        const FlightLogRecord record{log.at(index)};
+        const std::chrono::duration<double> offset{(record.sim_time - startTime) / speed};
+        std::this_thread::sleep_until(wallStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset));
+        telemetry.publishStep(record.state, record.controls, record.sim_time);
+    }
+
+    telemetry.stop();
+    std::cout << "Replay finished." << std::endl;
+    return 0;
+}
@@ -7,6 +7,8 @@
 #include "../src/core/Simulation.hpp"
 #include "../src/physics/FlightDynamics.hpp"
 #include "../src/network/TelemetryServer.hpp"
+#include "../src/network/SharedTelemetry.hpp"
+#include "../src/network/MetricsServer.hpp"
 
 using namespace falconsim;
 using namespace std::chrono_literals;
@@ -26,8 +28,15 @@ int main() {
     std::cout << "FalconSim - Telemetry Server Example" << std::endl;
     std::cout << "====================================" << std::endl;
     
+    // Same-host consumers (the GUI, loggers) read every step from shared memory;
+    // declared first so it outlives the simulation thread that publishes into it
+    SharedTelemetryPublisher sharedTelemetry;
+    
     // Create simulation with 10ms timestep (100Hz)
     Simulation sim{0.01};
+    sim.setStepObserver([&sharedTelemetry](const AircraftState& state, const ControlInputs& controls, double time) {
+        sharedTelemetry.publish(state, controls, time);
+    });
     
     // Set initial state: aircraft at 100m altitude
     AircraftState initialState;
@@ -35,19 +44,25 @@ int main() {
     sim.setState(initialState);
     
     // Create and configure telemetry server
-    TelemetryConfig config;
-    config.port = 12345;          // UDP port to listen on
-    config.update_rate = 20;      // 20 Hz telemetry updates
+    constexpr uint16_t port{12345};   // UDP port to listen on
+    TelemetryServer telemetry{port};
+    telemetry.setUpdateRate(20.0);    // 20 Hz telemetry updates
     
-    TelemetryServer telemetry{sim.getPhysics(), config};
+    // Health counters and latency histograms on their own port
+    MetricsServer metrics{12346};
+    metrics.addSource([&sim](MetricsReport& report) { appendMetrics(report, sim.getMetrics()); });
+    metrics.addSource([&telemetry](MetricsReport& report) { appendMetrics(report, telemetry.getMetrics()); });
     
-    // Start the simulation and telemetry server
+    // Start the simulation, telemetry and metrics servers
     sim.start();
     telemetry.start();
+    metrics.start();
     
     std::cout << "Simulation started." << std::endl;
-    std::cout << "Telemetry server listening on UDP port " << config.port << std::endl;
-    std::cout << "Connect with a telemetry client or send 'REGISTER' via UDP to receive updates." << std::endl;
+    std::cout << "Telemetry server listening on UDP port " << port << std::endl;
+    std::cout << "Local clients can map shared memory " << sharedTelemetry.getName() << std::endl;
+    std::cout << "Query metrics with: echo STATS | nc -u -w1 localhost " << metrics.getPort() << std::endl;
+    std::cout << "Connect with a telemetry client or send 'REGISTER' (or 'REGISTER CSV') via UDP to receive updates." << std::endl;
     std::cout << "Press Ctrl+C to stop." << std::endl;
     
     // Simple flight pattern
@@ -56,6 +71,7 @@ int main() {
     
     // Main loop - keep the program running and apply different control inputs over time
     auto startTime = std::chrono::steady_clock::now();
+    long long lastStatusSec{-1};
     
     while (running) {
         auto currentTime = std::chrono::steady_clock::now();
@@ -80,15 +96,20 @@ int main() {
                 break;
         }
         
+        // Stream the latest state (the server paces transmission itself)
+        telemetry.updateFromState(sim.getState(), sim.getControls());
+        
         // Print connection status occasionally
-        if (elapsedSec % 5 == 0) {
+        if (elapsedSec % 5 == 0 && elapsedSec != lastStatusSec) {
             std::cout << "Connected clients: " << telemetry.getClientCount() << std::endl;
+            lastStatusSec = elapsedSec;
         }
         
-        std::this_thread::sleep_for(200ms);
+        std::this_thread::sleep_for(50ms);
     }
     
     // Cleanup
+    metrics.stop();
     telemetry.stop();
     sim.stop();
     
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace falconsim {
+
+/**
+ * @brief Lock-free bounded multi-producer, multi-consumer ring buffer
+ *
+ * Each cell carries a sequence number that tells producers and consumers
+ * whether it is free for the current lap, so push and pop are a single CAS
+ * on the respective cursor in the uncontended case and never block. The
+ * capacity is rounded up to a power of two.
+ *
+ * pushEvictingOldest() gives drop-oldest semantics: a producer that finds
+ * the ring full pops the oldest element itself and retries, so the newest
+ * sample always gets in and the backlog stays bounded.
+ */
+template <typename T>
+class BoundedQueue {
+    static_assert(std::is_default_constructible<T>::value, "BoundedQueue requires a default-constructible type");
+    static_assert(std::is_copy_assignable<T>::value, "BoundedQueue requires a copy-assignable type");
+
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : m_capacity{roundUpToPowerOfTwo(capacity)}
+        , m_mask{m_capacity - 1}
+        , m_cells{new Cell[m_capacity]} {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Append a value; false if the ring is full
+    bool tryPush(const T& value) noexcept {
+        Cell* cell;
+        std::size_t position{m_enqueuePos.load(std::memory_order_relaxed)};
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            const std::size_t sequence{cell->sequence.load(std::memory_order_acquire)};
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Cell still holds last lap's value
+            } else {
+                position = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Remove the oldest value; false if the ring is empty
+    bool tryPop(T& value) noexcept {
+        Cell* cell;
+        std::size_t position{m_dequeuePos.load(std::memory_order_relaxed)};
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            const std::size_t sequence{cell->sequence.load(std::memory_order_acquire)};
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Producer has not published this cell yet
+            } else {
+                position = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = cell->value;
+        cell->sequence.store(position + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Append a value, discarding the oldest entries if full; returns how many were discarded
+    std::size_t pushEvictingOldest(const T& value) noexcept {
+        std::size_t evicted{0};
+        T discarded{};
+        while (!tryPush(value)) {
+            if (tryPop(discarded)) {
+                ++evicted;
+            }
+        }
+        return evicted;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+    // Number of queued elements (exact only when producers and consumers are quiescent)
+    [[nodiscard]] std::size_t sizeApprox() const noexcept {
+        const std::size_t dequeue{m_dequeuePos.load(std::memory_order_relaxed)};
+        const std::size_t enqueue{m_enqueuePos.load(std::memory_order_relaxed)};
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t capacity{2};
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    // Cursors on separate cache lines so producers and consumers do not false-share
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> m_dequeuePos{0};
+};
+
+} // namespace falconsim
@@ -0,0 +1,110 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace falconsim {
+
+void Histogram::reset() noexcept {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_release);
+}
+
+std::uint64_t Histogram::bucketUpperBound(std::size_t bucket) noexcept {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const std::size_t exponentIndex{bucket / kSubBuckets};
+    const std::uint64_t subBucket{bucket % kSubBuckets};
+    const unsigned shift{static_cast<unsigned>(exponentIndex - 1)};
+    return ((kSubBuckets + subBucket + 1) << shift) - 1;
+}
+
+HistogramSummary Histogram::summary() const {
+    HistogramSummary summary;
+    
+    // Snapshot the buckets first; the total is recounted from them so the
+    // percentiles stay consistent even if records land during the read
+    std::array<std::uint64_t, kBucketCount> counts{};
+    std::uint64_t total{0};
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return summary;
+    }
+    
+    summary.count = total;
+    summary.min = m_min.load(std::memory_order_relaxed);
+    summary.max = m_max.load(std::memory_order_relaxed);
+    summary.mean = static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(total);
+    
+    // Highest value equivalent to the bucket holding each rank, clamped to the observed range
+    const auto percentile = [&](double fraction) {
+        const auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen{0};
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::max(summary.min, std::min(bucketUpperBound(i), summary.max));
+            }
+        }
+        return summary.max;
+    };
+    summary.p50 = percentile(0.50);
+    summary.p90 = percentile(0.90);
+    summary.p99 = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    return summary;
+}
+
+std::uint64_t ShardedCounter::value() const noexcept {
+    std::uint64_t total{0};
+    for (const auto& shard : m_shards) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::size_t ShardedCounter::shardIndex() noexcept {
+    static std::atomic<std::size_t> nextShard{0};
+    thread_local const std::size_t shard{nextShard.fetch_add(1, std::memory_order_relaxed) % kShards};
+    return shard;
+}
+
+void MetricsReport::add(const std::string& name, double value, const std::string& labels) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.17g", value);
+    
+    m_text += name;
+    if (!labels.empty()) {
+        m_text += '{';
+        m_text += labels;
+        m_text += '}';
+    }
+    m_text += ' ';
+    m_text += number;
+    m_text += '\n';
+}
+
+void MetricsReport::add(const std::string& name, const HistogramSummary& summary, const std::string& labels) {
+    add(name + "_count", static_cast<double>(summary.count), labels);
+    add(name + "_min", static_cast<double>(summary.min), labels);
+    add(name + "_max", static_cast<double>(summary.max), labels);
+    add(name + "_mean", summary.mean, labels);
+    add(name + "_p50", static_cast<double>(summary.p50), labels);
+    add(name + "_p90", static_cast<double>(summary.p90), labels);
+    add(name + "_p99", static_cast<double>(summary.p99), labels);
+    add(name + "_p999", static_cast<double>(summary.p999), labels);
+}
+
+const std::string& MetricsReport::str() const {
+    return m_text;
+}
+
+} // namespace falconsim
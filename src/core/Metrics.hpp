@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace falconsim {
+
+// Nanoseconds elapsed on the steady clock since start (for Histogram::record)
+[[nodiscard]] inline std::uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start) noexcept {
+    const auto elapsed{std::chrono::steady_clock::now() - start};
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+/**
+ * @brief Percentile summary of a Histogram (values in the unit that was recorded)
+ */
+struct HistogramSummary {
+    std::uint64_t count{0};
+    std::uint64_t min{0};
+    std::uint64_t max{0};
+    double mean{0.0};
+    std::uint64_t p50{0};
+    std::uint64_t p90{0};
+    std::uint64_t p99{0};
+    std::uint64_t p999{0};
+};
+
+/**
+ * @brief Fixed-size log-linear histogram of non-negative integers (HDR-style)
+ *
+ * Values below 16 get exact buckets. Above that, every power of two is
+ * split into 16 linear sub-buckets, so a reported percentile is within
+ * about 6% of the true value, anywhere from nanoseconds to days. The
+ * buckets are a fixed array: record() never allocates and costs a handful
+ * of relaxed atomic stores.
+ *
+ * record() is single-writer. Give each recording thread its own histogram.
+ * summary() may be called from any thread at any time; a concurrent read
+ * may miss the records in flight but never sees a torn counter.
+ */
+class Histogram {
+public:
+    static constexpr unsigned kSubBucketBits{4};
+    static constexpr std::size_t kSubBuckets{std::size_t{1} << kSubBucketBits};
+    static constexpr unsigned kMaxExponent{47}; // Values from 2^48 up land in the last bucket
+    static constexpr std::size_t kBucketCount{(kMaxExponent - kSubBucketBits + 2) * kSubBuckets};
+    
+    Histogram() = default;
+    
+    // Deleted copy and move operations (atomics; take a summary() instead)
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+    Histogram(Histogram&&) = delete;
+    Histogram& operator=(Histogram&&) = delete;
+    
+    // Add one value (single writer)
+    void record(std::uint64_t value) noexcept {
+        const std::size_t bucket{bucketIndex(value)};
+        m_buckets[bucket].store(m_buckets[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value < m_min.load(std::memory_order_relaxed)) {
+            m_min.store(value, std::memory_order_relaxed);
+        }
+        if (value > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(value, std::memory_order_relaxed);
+        }
+        m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    // Forget everything (not concurrent with record())
+    void reset() noexcept;
+    
+    [[nodiscard]] std::uint64_t count() const noexcept {
+        return m_count.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] HistogramSummary summary() const;
+    
+    // Bucket layout
+    [[nodiscard]] static std::size_t bucketIndex(std::uint64_t value) noexcept {
+        if (value < kSubBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned exponent{highestBit(value)};
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const unsigned shift{exponent - kSubBucketBits};
+        return (exponent - kSubBucketBits + 1) * kSubBuckets + static_cast<std::size_t>((value >> shift) - kSubBuckets);
+    }
+    [[nodiscard]] static std::uint64_t bucketUpperBound(std::size_t bucket) noexcept;
+
+private:
+    [[nodiscard]] static unsigned highestBit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit{0};
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+    
+    std::array<std::atomic<std::uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sum{0};
+    std::atomic<std::uint64_t> m_min{UINT64_MAX};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+/**
+ * @brief Event counter for many writer threads, merged on read
+ *
+ * Each thread increments its own cache-line-sized shard, so producers on
+ * different cores never contend for one line. value() adds up the shards.
+ */
+class ShardedCounter {
+public:
+    static constexpr std::size_t kShards{16};
+    
+    ShardedCounter() = default;
+    
+    // Deleted copy and move operations
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+    ShardedCounter(ShardedCounter&&) = delete;
+    ShardedCounter& operator=(ShardedCounter&&) = delete;
+    
+    void add(std::uint64_t amount = 1) noexcept {
+        m_shards[shardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t value() const noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+    
+    // Stable per thread, assigned round-robin on first use
+    [[nodiscard]] static std::size_t shardIndex() noexcept;
+    
+    std::array<Shard, kShards> m_shards{};
+};
+
+/**
+ * @brief Plain-text metrics report, one "name{labels} value" line per sample
+ *
+ * The layout follows the Prometheus text exposition format, so the stats
+ * endpoint can be scraped as-is or read by a human with netcat.
+ */
+class MetricsReport {
+public:
+    void add(const std::string& name, double value, const std::string& labels = {});
+    
+    // Count, min, max, mean and percentiles as name_count, name_p50, ...
+    void add(const std::string& name, const HistogramSummary& summary, const std::string& labels = {});
+    
+    [[nodiscard]] const std::string& str() const;
+
+private:
+    std::string m_text{};
+};
+
+} // namespace falconsim
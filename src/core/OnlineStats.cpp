@@ -0,0 +1,129 @@
+#include "OnlineStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace falconsim {
+
+void RunningStats::add(double value) noexcept {
+    ++m_count;
+    const double delta{value - m_mean};
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (value - m_mean);
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+}
+
+void RunningStats::merge(const RunningStats& other) noexcept {
+    if (other.m_count == 0) {
+        return;
+    }
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+    const double n{static_cast<double>(m_count)};
+    const double m{static_cast<double>(other.m_count)};
+    const double delta{other.m_mean - m_mean};
+    m_count += other.m_count;
+    m_mean += delta * m / (n + m);
+    m_m2 += other.m_m2 + delta * delta * n * m / (n + m);
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+double RunningStats::variance() const noexcept {
+    return m_count < 2 ? 0.0 : m_m2 / static_cast<double>(m_count - 1);
+}
+
+double RunningStats::stddev() const noexcept {
+    return std::sqrt(variance());
+}
+
+QuantileSketch::QuantileSketch()
+    : m_negative(kBucketCount, 0)
+    , m_positive(kBucketCount, 0) {
+}
+
+std::size_t QuantileSketch::bucketIndex(double magnitude) noexcept {
+    std::uint64_t bits;
+    std::memcpy(&bits, &magnitude, sizeof(bits));
+    const int exponent{static_cast<int>((bits >> 52) & 0x7FF) - 1023};
+    if (exponent >= kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    const auto sub = static_cast<std::size_t>((bits >> (52 - kSubBucketBits)) & ((1u << kSubBucketBits) - 1));
+    return (static_cast<std::size_t>(exponent - kMinExponent) << kSubBucketBits) | sub;
+}
+
+double QuantileSketch::bucketValue(std::size_t bucket) noexcept {
+    // Midpoint of the bucket, so the relative error is at most half a bucket
+    const int exponent{static_cast<int>(bucket >> kSubBucketBits) + kMinExponent};
+    const double sub{static_cast<double>(bucket & ((std::size_t{1} << kSubBucketBits) - 1))};
+    return std::ldexp(1.0 + (sub + 0.5) / static_cast<double>(1u << kSubBucketBits), exponent);
+}
+
+void QuantileSketch::add(double value) noexcept {
+    if (std::isnan(value)) {
+        return;
+    }
+    const double magnitude{std::fabs(value)};
+    if (magnitude < std::ldexp(1.0, kMinExponent)) {
+        ++m_zero;
+    } else if (value < 0.0) {
+        ++m_negative[bucketIndex(magnitude)];
+    } else {
+        ++m_positive[bucketIndex(magnitude)];
+    }
+    ++m_count;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) noexcept {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        m_negative[i] += other.m_negative[i];
+        m_positive[i] += other.m_positive[i];
+    }
+    m_zero += other.m_zero;
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+double QuantileSketch::quantile(double q) const noexcept {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    q = std::min(std::max(q, 0.0), 1.0);
+    if (q == 0.0) {
+        return m_min;
+    }
+    if (q == 1.0) {
+        return m_max;
+    }
+    
+    // Walk the buckets in ascending value order up to the nearest rank
+    const auto rank = static_cast<std::uint64_t>(std::llround(q * static_cast<double>(m_count - 1)));
+    const auto clamp = [this](double value) { return std::min(std::max(value, m_min), m_max); };
+    std::uint64_t seen{0};
+    for (std::size_t i = kBucketCount; i-- > 0;) {
+        seen += m_negative[i];
+        if (seen > rank) {
+            return clamp(-bucketValue(i));
+        }
+    }
+    seen += m_zero;
+    if (seen > rank) {
+        return clamp(0.0);
+    }
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += m_positive[i];
+        if (seen > rank) {
+            return clamp(bucketValue(i));
+        }
+    }
+    return m_max;
+}
+
+} // namespace falconsim
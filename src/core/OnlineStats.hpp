@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace falconsim {
+
+/**
+ * @brief Count, mean, variance and range of a stream of values in O(1) memory
+ *
+ * Welford's update for each value, and Chan's pairwise formula to merge two
+ * partial streams, so per-thread accumulators can be combined at the end.
+ */
+class RunningStats {
+public:
+    void add(double value) noexcept;
+    void merge(const RunningStats& other) noexcept;
+    
+    [[nodiscard]] std::uint64_t count() const noexcept { return m_count; }
+    [[nodiscard]] double mean() const noexcept { return m_mean; }
+    [[nodiscard]] double variance() const noexcept; // Sample variance (n - 1); 0 below two values
+    [[nodiscard]] double stddev() const noexcept;
+    [[nodiscard]] double min() const noexcept { return m_min; } // +inf when empty
+    [[nodiscard]] double max() const noexcept { return m_max; } // -inf when empty
+
+private:
+    std::uint64_t m_count{0};
+    double m_mean{0.0};
+    double m_m2{0.0}; // Sum of squared deviations from the mean
+    double m_min{std::numeric_limits<double>::infinity()};
+    double m_max{-std::numeric_limits<double>::infinity()};
+};
+
+/**
+ * @brief Mergeable quantile sketch with bounded relative error
+ *
+ * Values are counted in logarithmic buckets taken straight from the bits of
+ * the double: the exponent and the top kSubBucketBits of the mantissa, for
+ * each sign. Any quantile is then within about 1.6% of a true sample value
+ * (relative), whatever the distribution, in a fixed 32 KiB. Magnitudes
+ * below 2^kMinExponent count as zero and those from 2^kMaxExponent up land
+ * in the last bucket; the exact minimum and maximum are kept besides.
+ *
+ * Merging adds bucket counts, so unlike a mean it is exact and independent
+ * of the order in which partial sketches are combined.
+ */
+class QuantileSketch {
+public:
+    static constexpr unsigned kSubBucketBits{5};
+    static constexpr int kMinExponent{-24};
+    static constexpr int kMaxExponent{40};
+    static constexpr std::size_t kBucketCount{static_cast<std::size_t>(kMaxExponent - kMinExponent) << kSubBucketBits};
+    
+    QuantileSketch();
+    
+    // NaN values are ignored
+    void add(double value) noexcept;
+    void merge(const QuantileSketch& other) noexcept;
+    
+    [[nodiscard]] std::uint64_t count() const noexcept { return m_count; }
+    
+    // Value at quantile q in [0, 1] (clamped); 0 when empty
+    [[nodiscard]] double quantile(double q) const noexcept;
+
+private:
+    // Bucket of a magnitude of at least 2^kMinExponent, and a value representing that bucket
+    static std::size_t bucketIndex(double magnitude) noexcept;
+    static double bucketValue(std::size_t bucket) noexcept;
+    
+    std::vector<std::uint64_t> m_negative; // Indexed by magnitude bucket
+    std::vector<std::uint64_t> m_positive;
+    std::uint64_t m_zero{0};
+    std::uint64_t m_count{0};
+    double m_min{std::numeric_limits<double>::infinity()};
+    double m_max{-std::numeric_limits<double>::infinity()};
+};
+
+} // namespace falconsim
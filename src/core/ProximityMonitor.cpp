@@ -0,0 +1,131 @@
+#include "ProximityMonitor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include "Trace.hpp"
+
+namespace falconsim {
+
+namespace {
+
+const ProximitySettings& validateSettings(const ProximitySettings& settings) {
+    if (!(settings.separation > 0.0)) {
+        throw std::invalid_argument{"Proximity separation must be positive"};
+    }
+    if (!(settings.collision_radius >= 0.0 && settings.collision_radius <= settings.separation)) {
+        throw std::invalid_argument{"Proximity collision radius must lie between 0 and the separation"};
+    }
+    return settings;
+}
+
+} // namespace
+
+ProximityMonitor::ProximityMonitor(const ProximitySettings& settings)
+    : m_settings{validateSettings(settings)}, m_grid{m_settings.separation} {
+}
+
+void ProximityMonitor::setSettings(const ProximitySettings& settings) {
+    validateSettings(settings);
+    if (settings.separation != m_settings.separation) {
+        m_grid = SpatialGrid{settings.separation};
+    }
+    m_settings = settings;
+}
+
+const ProximitySettings& ProximityMonitor::getSettings() const {
+    return m_settings;
+}
+
+void ProximityMonitor::setTerrain(std::shared_ptr<const TerrainMap> terrain) {
+    m_terrain = std::move(terrain);
+}
+
+const std::shared_ptr<const TerrainMap>& ProximityMonitor::getTerrain() const {
+    return m_terrain;
+}
+
+void ProximityMonitor::update(const FleetDynamics& fleet) {
+    update(fleet.positionNorth(), fleet.positionEast(), fleet.positionDown(), fleet.size());
+}
+
+void ProximityMonitor::update(const double* north, const double* east, const double* down, std::size_t count) {
+    FALCONSIM_TRACE_ZONE("ProximityMonitor::update");
+    const auto start{std::chrono::steady_clock::now()};
+    
+    // Broadphase and exact distances; the cell is one separation, so the stencil is 3 x 3 x 3
+    m_grid.update(north, east, down, count);
+    m_grid.findPairs(m_settings.separation, m_conflicts);
+    m_collisions.clear();
+    double minSeparation{m_settings.separation};
+    for (const ProximityPair& pair : m_conflicts) {
+        minSeparation = std::min(minSeparation, pair.distance);
+        if (pair.distance < m_settings.collision_radius) {
+            m_collisions.push_back(pair);
+        }
+    }
+    
+    // Ground contact against the terrain, or against altitude 0
+    m_heightAboveGround.resize(count);
+    m_groundContacts.clear();
+    const TerrainMap* terrain{m_terrain.get()};
+    for (std::size_t i = 0; i < count; ++i) {
+        const double height{terrain ? terrain->heightAboveGround(north[i], east[i], down[i]) : -down[i]};
+        m_heightAboveGround[i] = height;
+        if (height < m_settings.ground_clearance) {
+            m_groundContacts.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    
+    m_vehicles.store(count, std::memory_order_relaxed);
+    m_conflictCount.store(m_conflicts.size(), std::memory_order_relaxed);
+    m_collisionCount.store(m_collisions.size(), std::memory_order_relaxed);
+    m_groundContactCount.store(m_groundContacts.size(), std::memory_order_relaxed);
+    m_moved.store(m_grid.getMovedCount(), std::memory_order_relaxed);
+    m_minSeparation.store(m_conflicts.empty() ? 0.0 : minSeparation, std::memory_order_relaxed);
+    m_updates.store(m_updates.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    m_updateTime.record(nanosecondsSince(start));
+}
+
+const std::vector<ProximityPair>& ProximityMonitor::getConflicts() const {
+    return m_conflicts;
+}
+
+const std::vector<ProximityPair>& ProximityMonitor::getCollisions() const {
+    return m_collisions;
+}
+
+const std::vector<std::uint32_t>& ProximityMonitor::getGroundContacts() const {
+    return m_groundContacts;
+}
+
+const SpatialGrid& ProximityMonitor::getGrid() const {
+    return m_grid;
+}
+
+ProximityStats ProximityMonitor::getStats() const {
+    ProximityStats stats;
+    stats.updates = m_updates.load(std::memory_order_acquire);
+    stats.vehicles = m_vehicles.load(std::memory_order_relaxed);
+    stats.conflicts = m_conflictCount.load(std::memory_order_relaxed);
+    stats.collisions = m_collisionCount.load(std::memory_order_relaxed);
+    stats.ground_contacts = m_groundContactCount.load(std::memory_order_relaxed);
+    stats.moved = m_moved.load(std::memory_order_relaxed);
+    stats.min_separation = m_minSeparation.load(std::memory_order_relaxed);
+    stats.update_time = m_updateTime.summary();
+    return stats;
+}
+
+void appendMetrics(MetricsReport& report, const ProximityStats& stats) {
+    report.add("falconsim_proximity_updates_total", static_cast<double>(stats.updates));
+    report.add("falconsim_proximity_vehicles", static_cast<double>(stats.vehicles));
+    report.add("falconsim_proximity_conflicts", static_cast<double>(stats.conflicts));
+    report.add("falconsim_proximity_collisions", static_cast<double>(stats.collisions));
+    report.add("falconsim_proximity_ground_contacts", static_cast<double>(stats.ground_contacts));
+    report.add("falconsim_proximity_moved", static_cast<double>(stats.moved));
+    report.add("falconsim_proximity_min_separation_meters", stats.min_separation);
+    report.add("falconsim_proximity_update_time_ns", stats.update_time);
+}
+
+} // namespace falconsim
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../physics/AlignedAllocator.hpp"
+#include "../physics/FleetDynamics.hpp"
+#include "../physics/SpatialGrid.hpp"
+#include "../physics/TerrainMap.hpp"
+#include "Metrics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Distances that make a pair a conflict or a collision, and a vehicle grounded
+ */
+struct ProximitySettings {
+    double separation{50.0};      // Pairs closer than this are in conflict (m); also the grid cell size
+    double collision_radius{3.0}; // Pairs closer than this have collided (m)
+    double ground_clearance{0.0}; // Vehicles lower than this above the terrain are in ground contact (m)
+};
+
+/**
+ * @brief Proximity counters for the metrics endpoint
+ */
+struct ProximityStats {
+    std::uint64_t updates{0};         // Calls to update()
+    std::uint64_t vehicles{0};        // Vehicles checked by the latest update
+    std::uint64_t conflicts{0};       // Pairs within the separation in the latest update
+    std::uint64_t collisions{0};      // Pairs within the collision radius in the latest update
+    std::uint64_t ground_contacts{0}; // Vehicles in ground contact in the latest update
+    std::uint64_t moved{0};           // Vehicles the grid relinked in the latest update
+    double min_separation{0.0};       // Closest conflict pair in the latest update (m; 0 without a conflict)
+    HistogramSummary update_time{};   // Duration of update() (ns)
+};
+
+// Append stats as falconsim_proximity_* lines
+void appendMetrics(MetricsReport& report, const ProximityStats& stats);
+
+/**
+ * @brief Per-tick separation, collision and terrain checks for a swarm
+ *
+ * update() takes the fleet's positions after a step, advances a
+ * SpatialGrid whose cells are one separation wide, and lists every pair
+ * within the separation, and every vehicle below the ground clearance over
+ * the terrain (flat ground at altitude 0 without a TerrainMap). Both are
+ * O(n) for a bounded density: one hashed stencil sweep and one O(1)
+ * height query per vehicle. The result vectors are reused, so a monitor of
+ * steady size does not allocate once warmed up.
+ *
+ * The results belong to the thread calling update(), typically the
+ * lockstep loop's tick callback, where scenario code reacts to them.
+ * getStats() may be called from any thread, e.g. a MetricsServer source.
+ */
+class ProximityMonitor {
+public:
+    explicit ProximityMonitor(const ProximitySettings& settings = {});
+    
+    // Deleted copy and move operations (histogram; take getStats() instead)
+    ProximityMonitor(const ProximityMonitor&) = delete;
+    ProximityMonitor& operator=(const ProximityMonitor&) = delete;
+    ProximityMonitor(ProximityMonitor&&) = delete;
+    ProximityMonitor& operator=(ProximityMonitor&&) = delete;
+    
+    // Throws std::invalid_argument unless 0 <= collision_radius <= separation and the separation is positive
+    void setSettings(const ProximitySettings& settings);
+    [[nodiscard]] const ProximitySettings& getSettings() const;
+    
+    // Terrain for ground checks (nullptr is flat ground at altitude 0)
+    void setTerrain(std::shared_ptr<const TerrainMap> terrain);
+    [[nodiscard]] const std::shared_ptr<const TerrainMap>& getTerrain() const;
+    
+    // Check count NED positions (m), or every vehicle of a fleet
+    void update(const double* north, const double* east, const double* down, std::size_t count);
+    void update(const FleetDynamics& fleet);
+    
+    // Results of the latest update
+    [[nodiscard]] const std::vector<ProximityPair>& getConflicts() const;        // Pairs within the separation
+    [[nodiscard]] const std::vector<ProximityPair>& getCollisions() const;       // Subset within the collision radius
+    [[nodiscard]] const std::vector<std::uint32_t>& getGroundContacts() const;   // Ascending vehicle indices
+    [[nodiscard]] const double* heightAboveGround() const { return m_heightAboveGround.data(); } // Per vehicle (m)
+    [[nodiscard]] const SpatialGrid& getGrid() const;
+    
+    // Update count and latest results in brief (safe from any thread)
+    [[nodiscard]] ProximityStats getStats() const;
+
+private:
+    ProximitySettings m_settings{};
+    std::shared_ptr<const TerrainMap> m_terrain{};
+    SpatialGrid m_grid;
+    
+    // Results, reused from update to update
+    std::vector<ProximityPair> m_conflicts{};
+    std::vector<ProximityPair> m_collisions{};
+    std::vector<std::uint32_t> m_groundContacts{};
+    AlignedVector<double> m_heightAboveGround{};
+    
+    // Published for getStats(), written by the updating thread only
+    std::atomic<std::uint64_t> m_updates{0};
+    std::atomic<std::uint64_t> m_vehicles{0};
+    std::atomic<std::uint64_t> m_conflictCount{0};
+    std::atomic<std::uint64_t> m_collisionCount{0};
+    std::atomic<std::uint64_t> m_groundContactCount{0};
+    std::atomic<std::uint64_t> m_moved{0};
+    std::atomic<double> m_minSeparation{0.0};
+    Histogram m_updateTime{};
+};
+
+} // namespace falconsim
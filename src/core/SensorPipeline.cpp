@@ -0,0 +1,114 @@
+#include "SensorPipeline.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace falconsim {
+
+SensorPipeline::SensorPipeline(const SensorSettings& settings, Sink sink, std::size_t queueCapacity,
+                               std::size_t maxBatch)
+    : m_suite{settings}
+    , m_sink{std::move(sink)}
+    , m_queue{std::max<std::size_t>(2, queueCapacity)}
+    , m_maxBatch{std::max<std::size_t>(1, maxBatch)} {
+    m_batch.reserve(m_maxBatch);
+    m_worker = std::thread{&SensorPipeline::workerLoop, this};
+}
+
+SensorPipeline::~SensorPipeline() {
+    stop();
+}
+
+bool SensorPipeline::publish(const AircraftState& state, double simTime, std::uint32_t vehicleId) {
+    if (m_stopping.load(std::memory_order_relaxed) || !m_queue.tryPush(SensorSnapshot{vehicleId, simTime, state})) {
+        m_dropped.add();
+        return false;
+    }
+    m_published.add();
+    
+    // The worker polls anyway; a full batch wakes it early
+    if (m_queue.sizeApprox() >= m_maxBatch) {
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+void SensorPipeline::publishStep(const AircraftState& state, const ControlInputs&, double simTime,
+                                 std::uint32_t vehicleId) {
+    publish(state, simTime, vehicleId);
+}
+
+void SensorPipeline::stop() {
+    std::call_once(m_stopped, [this] {
+        m_stopping = true;
+        m_wake.notify_one();
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+    });
+}
+
+void SensorPipeline::workerLoop() {
+    FALCONSIM_TRACE_THREAD_NAME("sensors");
+    for (;;) {
+        // Read the flag first: snapshots published before stop() are queued by then
+        const bool stopping{m_stopping.load()};
+        
+        processQueued();
+        if (stopping) {
+            return;
+        }
+        
+        // Timed wait: a notify that races the check above costs at most one period
+        std::unique_lock<std::mutex> lock{m_wakeMutex};
+        m_wake.wait_for(lock, kPollInterval);
+    }
+}
+
+void SensorPipeline::processQueued() {
+    for (;;) {
+        m_batch.clear();
+        SensorSnapshot snapshot;
+        while (m_batch.size() < m_maxBatch && m_queue.tryPop(snapshot)) {
+            m_batch.push_back(snapshot);
+        }
+        if (m_batch.empty()) {
+            return;
+        }
+        
+        FALCONSIM_TRACE_ZONE("SensorPipeline::batch");
+        const auto batchStart{std::chrono::steady_clock::now()};
+        m_samples.clear();
+        m_suite.process(m_batch.data(), m_batch.size(), m_samples);
+        if (!m_samples.empty() && m_sink) {
+            m_sink(m_samples.data(), m_samples.size());
+        }
+        m_batchTime.record(nanosecondsSince(batchStart));
+        
+        m_stale.store(m_suite.getStale(), std::memory_order_relaxed);
+        m_sampleCount.fetch_add(m_samples.size(), std::memory_order_relaxed);
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SensorPipelineStats SensorPipeline::getStats() const {
+    SensorPipelineStats stats;
+    stats.published = m_published.value();
+    stats.dropped = m_dropped.value();
+    stats.stale = m_stale.load(std::memory_order_relaxed);
+    stats.samples = m_sampleCount.load(std::memory_order_relaxed);
+    stats.batches = m_batches.load(std::memory_order_relaxed);
+    stats.batch_time = m_batchTime.summary();
+    return stats;
+}
+
+void appendMetrics(MetricsReport& report, const SensorPipelineStats& stats) {
+    report.add("falconsim_sensor_published_total", static_cast<double>(stats.published));
+    report.add("falconsim_sensor_dropped_total", static_cast<double>(stats.dropped));
+    report.add("falconsim_sensor_stale_total", static_cast<double>(stats.stale));
+    report.add("falconsim_sensor_samples_total", static_cast<double>(stats.samples));
+    report.add("falconsim_sensor_batches_total", static_cast<double>(stats.batches));
+    report.add("falconsim_sensor_batch_time_ns", stats.batch_time);
+}
+
+} // namespace falconsim
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.hpp"
+#include "Metrics.hpp"
+#include "../physics/Sensors.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Sensor pipeline counters for the metrics endpoint
+ */
+struct SensorPipelineStats {
+    std::uint64_t published{0}; // Snapshots accepted by publish()
+    std::uint64_t dropped{0};   // Snapshots refused because the queue was full
+    std::uint64_t stale{0};     // Snapshots older than their vehicle's last, ignored by the sensors
+    std::uint64_t samples{0};   // Sensor samples handed to the sink
+    std::uint64_t batches{0};   // SensorSuite::process() calls
+    HistogramSummary batch_time{}; // Sensors and sink per batch (ns)
+};
+
+// Append stats as falconsim_sensor_* lines
+void appendMetrics(MetricsReport& report, const SensorPipelineStats& stats);
+
+/**
+ * @brief Runs a SensorSuite on its own thread, fed by physics step observers
+ *
+ * publish() copies a vehicle's state into a lock-free bounded queue and
+ * returns at once; it never blocks or allocates, so publishStep() can be
+ * attached as a Simulation step observer of any number of simulations. The
+ * worker thread takes whatever is queued, up to maxBatch snapshots, runs
+ * the sensor models over the whole batch in one call and hands the samples
+ * to the sink, e.g. TelemetryServer::sendSensorSamples(). The samples do not
+ * depend on how the snapshots were batched (see SensorSuite). A full queue
+ * drops snapshots and counts them rather than stalling the physics.
+ *
+ * The sink runs on the worker thread. getStats() may be called from any thread.
+ */
+class SensorPipeline {
+public:
+    using Sink = std::function<void(const SensorSample* samples, std::size_t count)>;
+    
+    // Starts the worker; throws std::invalid_argument for invalid sensor settings
+    SensorPipeline(const SensorSettings& settings, Sink sink,
+                   std::size_t queueCapacity = 4096, std::size_t maxBatch = 1024);
+    ~SensorPipeline();
+    
+    // Deleted copy and move operations (worker thread and queue)
+    SensorPipeline(const SensorPipeline&) = delete;
+    SensorPipeline& operator=(const SensorPipeline&) = delete;
+    SensorPipeline(SensorPipeline&&) = delete;
+    SensorPipeline& operator=(SensorPipeline&&) = delete;
+    
+    // Queue a vehicle's state at a simulated time; false if it was dropped (lock-free, any thread)
+    bool publish(const AircraftState& state, double simTime, std::uint32_t vehicleId = 0);
+    // Same as publish() (signature of Simulation::StepObserver)
+    void publishStep(const AircraftState& state, const ControlInputs& controls, double simTime,
+                     std::uint32_t vehicleId = 0);
+    
+    // Process everything queued so far, then stop the worker (idempotent); later publishes are dropped
+    void stop();
+    
+    [[nodiscard]] SensorPipelineStats getStats() const;
+
+private:
+    static constexpr std::chrono::milliseconds kPollInterval{1}; // Worker wake-up without a full batch
+    
+    void workerLoop();
+    void processQueued();
+    
+    SensorSuite m_suite;
+    Sink m_sink;
+    BoundedQueue<SensorSnapshot> m_queue;
+    std::size_t m_maxBatch{1};
+    
+    // Worker only
+    std::vector<SensorSnapshot> m_batch{};
+    std::vector<SensorSample> m_samples{};
+    
+    std::thread m_worker{};
+    std::mutex m_wakeMutex{};
+    std::condition_variable m_wake{};
+    std::atomic<bool> m_stopping{false};
+    std::once_flag m_stopped{};
+    
+    // Statistics
+    ShardedCounter m_published{};
+    ShardedCounter m_dropped{};
+    std::atomic<std::uint64_t> m_stale{0};
+    std::atomic<std::uint64_t> m_sampleCount{0};
+    std::atomic<std::uint64_t> m_batches{0};
+    Histogram m_batchTime{};
+};
+
+} // namespace falconsim
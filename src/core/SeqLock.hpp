@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace falconsim {
+
+/**
+ * @brief Single-writer, multi-reader sequence lock for small value types
+ *
+ * The writer never blocks and never waits for readers; readers retry until
+ * they observe a copy that was not overlapped by a write, so they never see a
+ * torn value. The payload is held in relaxed atomic words, which keeps the
+ * concurrent copy well-defined.
+ *
+ * T must be fully described by its bytes (trivially copyable types, or
+ * aggregates of fixed-size Eigen vectors/matrices and scalars).
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_default_constructible<T>::value, "SeqLock requires a default-constructible type");
+    static_assert(std::is_trivially_destructible<T>::value, "SeqLock requires a trivially destructible type");
+
+public:
+    SeqLock() {
+        store(T{});
+    }
+
+    explicit SeqLock(const T& value) {
+        store(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Publish a new value (single writer thread only)
+    void store(const T& value) noexcept {
+        std::uint64_t words[kWords]{};
+        std::memcpy(words, static_cast<const void*>(&value), sizeof(T));
+
+        const std::uint64_t sequence{m_sequence.load(std::memory_order_relaxed)};
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < kWords; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Read a consistent copy; returns the version of the value read
+    std::uint64_t load(T& out) const noexcept {
+        std::uint64_t words[kWords];
+        std::uint64_t before{0};
+
+        for (;;) {
+            before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1u) {
+                cpuRelax();
+                continue;
+            }
+
+            for (std::size_t i = 0; i < kWords; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+
+        std::memcpy(static_cast<void*>(&out), words, sizeof(T));
+        return before / 2;
+    }
+
+    [[nodiscard]] T load() const noexcept {
+        T value;
+        load(value);
+        return value;
+    }
+
+    // Number of values published so far
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr std::size_t kWords{(sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)};
+
+    static void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+
+    // Keep the sequence and payload away from neighbouring hot data
+    alignas(64) std::atomic<std::uint64_t> m_sequence{0};
+    std::atomic<std::uint64_t> m_words[kWords]{};
+};
+
+/**
+ * @brief Single-producer, single-consumer mailbox holding the latest posted value
+ *
+ * post() overwrites any value the consumer has not picked up yet; take()
+ * returns true only when something newer than the previous take() arrived.
+ * Neither side ever blocks.
+ */
+template <typename T>
+class LatestValueMailbox {
+public:
+    // Producer side
+    void post(const T& value) noexcept {
+        m_slot.store(value);
+    }
+
+    // Consumer side
+    bool take(T& out) noexcept {
+        if (m_slot.version() == m_lastTaken) {
+            return false;
+        }
+        m_lastTaken = m_slot.load(out);
+        return true;
+    }
+
+private:
+    SeqLock<T> m_slot{};
+    std::uint64_t m_lastTaken{1}; // The default-constructed value is version 1
+};
+
+} // namespace falconsim
@@ -1,14 +1,31 @@
 #include "Simulation.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
+#include <utility>
 
 namespace falconsim {
 
+namespace {
+
+std::int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 Simulation::Simulation(double timestep)
     : m_physics{std::make_unique<FlightDynamics>()}
     , m_running{false}
     , m_paused{false}
     , m_timestep{timestep}
     , m_controls{} {
+    if (!(timestep > 0.0)) {
+        throw std::invalid_argument{"Simulation timestep must be positive"};
+    }
+    publishSnapshots();
 }
 
 Simulation::~Simulation() {
@@ -21,6 +38,9 @@ void Simulation::start() {
     }
     m_running = true;
     m_paused = false;
+    resetSchedulerStats();
+    m_loopStartNs = steadyNanoseconds();
+    m_loopStopNs = 0;
     m_simThread = std::thread{&Simulation::simulationLoop, this};
 }
 
@@ -28,7 +48,12 @@ void Simulation::stop() {
     m_running = false;
     if (m_simThread.joinable()) {
         m_simThread.join();
+        m_loopStopNs = steadyNanoseconds();
     }
+    
+    // Don't lose inputs posted after the final step
+    applyPendingInputs();
+    publishSnapshots();
 }
 
 void Simulation::pause() {
@@ -39,17 +64,137 @@ void Simulation::resume() {
     m_paused = false;
 }
 
+std::uint64_t Simulation::step(std::uint64_t count, const ControlCallback& callback) {
+    if (m_running) {
+        throw std::runtime_error{"Cannot batch-step while the simulation is running"};
+    }
+    
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (callback) {
+            callback(*this, m_simTime.load(std::memory_order_relaxed));
+        }
+        advance(m_timestep);
+    }
+    return count;
+}
+
+std::uint64_t Simulation::run(double duration, double dt, const ControlCallback& callback) {
+    if (m_running) {
+        throw std::runtime_error{"Cannot batch-run while the simulation is running"};
+    }
+    if (!(dt > 0.0) || !(duration >= 0.0)) {
+        throw std::invalid_argument{"Batch run needs a positive dt and non-negative duration"};
+    }
+    
+    // Cover the whole duration, tolerating floating-point noise in duration/dt
+    const auto count{static_cast<std::uint64_t>(std::ceil(duration / dt - 1e-9))};
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (callback) {
+            callback(*this, m_simTime.load(std::memory_order_relaxed));
+        }
+        advance(dt);
+    }
+    return count;
+}
+
+double Simulation::getSimulationTime() const {
+    return m_simTime.load(std::memory_order_relaxed);
+}
+
+void Simulation::setStepObserver(StepObserver observer) {
+    if (m_running) {
+        throw std::runtime_error{"Cannot change the step observer while the simulation is running"};
+    }
+    m_stepObserver = std::move(observer);
+}
+
+SimulationSnapshot Simulation::snapshot() const {
+    if (m_running) {
+        throw std::runtime_error{"Cannot snapshot while the simulation is running"};
+    }
+    return SimulationSnapshot{m_physics->snapshot(), m_simTime.load(std::memory_order_relaxed)};
+}
+
+void Simulation::restore(const SimulationSnapshot& snapshot) {
+    if (m_running) {
+        throw std::runtime_error{"Cannot restore while the simulation is running"};
+    }
+    m_physics->restore(snapshot.dynamics);
+    m_simTime.store(snapshot.sim_time, std::memory_order_relaxed);
+    
+    // Later setThrust()/setControlSurfaces() calls modify the restored controls
+    m_controls = m_physics->getControls();
+    publishSnapshots();
+}
+
+std::unique_ptr<Simulation> Simulation::fork() const {
+    auto branch = std::make_unique<Simulation>(m_timestep);
+    branch->m_maxCatchUpSteps = m_maxCatchUpSteps;
+    branch->m_spinWindow = m_spinWindow;
+    branch->m_lateTolerance = m_lateTolerance;
+    branch->restore(snapshot());
+    
+    // Shared assets are not part of a snapshot; the branch flies through the same ones
+    branch->m_physics->setAeroTable(m_physics->getAeroTable());
+    branch->m_physics->setWindField(m_physics->getWindField());
+    return branch;
+}
+
+void Simulation::advance(double dt) {
+    applyPendingInputs();
+    // Two clock reads can cost as much as a cheap step, so only a sample of steps is timed
+    if (m_stepTimingCounter++ % kStepTimingInterval == 0) {
+        const auto stepStart{Clock::now()};
+        m_physics->update(dt);
+        m_stepTime.record(nanosecondsSince(stepStart));
+    } else {
+        m_physics->update(dt);
+    }
+    m_simTime.store(m_simTime.load(std::memory_order_relaxed) + dt, std::memory_order_relaxed);
+    publishSnapshots();
+    
+    if (m_stepObserver) {
+        m_stepObserver(m_physics->getState(), m_physics->getControls(), m_simTime.load(std::memory_order_relaxed));
+    }
+}
+
+void Simulation::applyPendingInputs() {
+    AircraftState state;
+    if (m_stateMailbox.take(state)) {
+        m_physics->setState(state);
+    }
+    
+    ControlInputs controls;
+    if (m_controlMailbox.take(controls)) {
+        m_physics->setControls(controls);
+    }
+}
+
+void Simulation::publishSnapshots() {
+    m_stateSnapshot.store(m_physics->getState());
+    m_controlsSnapshot.store(m_physics->getControls());
+}
+
 AircraftState Simulation::getState() const {
-    return m_physics->getState();
+    return m_stateSnapshot.load();
 }
 
 void Simulation::setState(const AircraftState& state) {
+    if (m_running) {
+        m_stateMailbox.post(state);
+        return;
+    }
     m_physics->setState(state);
+    publishSnapshots();
+}
+
+ControlInputs Simulation::getControls() const {
+    return m_controlsSnapshot.load();
 }
 
 void Simulation::setThrust(double throttle) {
     m_controls.throttle = std::max(0.0, std::min(throttle, 1.0)); // Normalize to [0,1]
-    m_physics->setControls(m_controls);
+    submitControls();
 }
 
 void Simulation::setControlSurfaces(const Eigen::Vector3d& controls) {
@@ -58,7 +203,16 @@ void Simulation::setControlSurfaces(const Eigen::Vector3d& controls) {
     m_controls.elevator = std::max(-1.0, std::min(controls.y(), 1.0));
     m_controls.rudder = std::max(-1.0, std::min(controls.z(), 1.0));
     
+    submitControls();
+}
+
+void Simulation::submitControls() {
+    if (m_running) {
+        m_controlMailbox.post(m_controls);
+        return;
+    }
     m_physics->setControls(m_controls);
+    publishSnapshots();
 }
 
 FlightDynamics& Simulation::getPhysics() {
@@ -69,23 +223,148 @@ const FlightDynamics& Simulation::getPhysics() const {
     return *m_physics;
 }
 
+double Simulation::getTimestep() const {
+    return m_timestep;
+}
+
+void Simulation::setMaxCatchUpSteps(int steps) {
+    m_maxCatchUpSteps = std::max(1, steps);
+}
+
+void Simulation::setSpinWindow(std::chrono::microseconds window) {
+    m_spinWindow = std::max(std::chrono::microseconds::zero(), window);
+}
+
+void Simulation::setLateTolerance(std::chrono::microseconds tolerance) {
+    m_lateTolerance = std::max(std::chrono::microseconds::zero(), tolerance);
+}
+
+SchedulerStats Simulation::getSchedulerStats() const {
+    SchedulerStats stats;
+    stats.ticks = m_ticks.load(std::memory_order_relaxed);
+    stats.steps = m_steps.load(std::memory_order_relaxed);
+    stats.overruns = m_overruns.load(std::memory_order_relaxed);
+    stats.late_ticks = m_lateTicks.load(std::memory_order_relaxed);
+    stats.dropped_steps = m_droppedSteps.load(std::memory_order_relaxed);
+    stats.max_lateness = static_cast<double>(m_maxLatenessNs.load(std::memory_order_relaxed)) * 1e-9;
+    return stats;
+}
+
+void Simulation::resetSchedulerStats() {
+    m_ticks = 0;
+    m_steps = 0;
+    m_overruns = 0;
+    m_lateTicks = 0;
+    m_droppedSteps = 0;
+    m_maxLatenessNs = 0;
+    m_stepTime.reset();
+    m_stepTimingCounter = 0;
+    m_tickTime.reset();
+    m_lateness.reset();
+}
+
+SimulationMetrics Simulation::getMetrics() const {
+    SimulationMetrics metrics;
+    metrics.scheduler = getSchedulerStats();
+    metrics.target_rate = 1.0 / m_timestep;
+    metrics.step_time = m_stepTime.summary();
+    metrics.tick_time = m_tickTime.summary();
+    metrics.lateness = m_lateness.summary();
+    
+    const std::int64_t startNs{m_loopStartNs.load(std::memory_order_relaxed)};
+    const std::int64_t stopNs{m_loopStopNs.load(std::memory_order_relaxed)};
+    if (startNs != 0) {
+        const std::int64_t endNs{stopNs != 0 ? stopNs : steadyNanoseconds()};
+        if (endNs > startNs) {
+            metrics.achieved_rate = static_cast<double>(metrics.scheduler.steps) * 1e9 / static_cast<double>(endNs - startNs);
+        }
+    }
+    return metrics;
+}
+
+void appendMetrics(MetricsReport& report, const SimulationMetrics& metrics) {
+    report.add("falconsim_sim_ticks_total", static_cast<double>(metrics.scheduler.ticks));
+    report.add("falconsim_sim_steps_total", static_cast<double>(metrics.scheduler.steps));
+    report.add("falconsim_sim_overruns_total", static_cast<double>(metrics.scheduler.overruns));
+    report.add("falconsim_sim_late_ticks_total", static_cast<double>(metrics.scheduler.late_ticks));
+    report.add("falconsim_sim_dropped_steps_total", static_cast<double>(metrics.scheduler.dropped_steps));
+    report.add("falconsim_sim_max_lateness_seconds", metrics.scheduler.max_lateness);
+    report.add("falconsim_sim_achieved_rate_hz", metrics.achieved_rate);
+    report.add("falconsim_sim_target_rate_hz", metrics.target_rate);
+    report.add("falconsim_sim_step_time_ns", metrics.step_time);
+    report.add("falconsim_sim_tick_time_ns", metrics.tick_time);
+    report.add("falconsim_sim_lateness_ns", metrics.lateness);
+}
+
+void Simulation::waitUntil(Clock::time_point deadline) const {
+    FALCONSIM_TRACE_ZONE("Simulation::sleep");
+    // Coarse OS sleep until shortly before the deadline...
+    const auto coarseWake{deadline - m_spinWindow};
+    if (Clock::now() < coarseWake) {
+        std::this_thread::sleep_until(coarseWake);
+    }
+    
+    // ...then spin for the last stretch, which sleep_until cannot hit precisely
+    while (Clock::now() < deadline) {
+    }
+}
+
 void Simulation::simulationLoop() {
-    using clock = std::chrono::high_resolution_clock;
-    auto lastTime{clock::now()};
+    FALCONSIM_TRACE_THREAD_NAME("simulation");
+    const auto period{std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>{m_timestep})};
+    const auto lateTolerance{std::chrono::duration_cast<Clock::duration>(m_lateTolerance)};
+    
+    // Absolute deadline of the next physics step. Deadlines advance by exactly one
+    // period per step, so the schedule never drifts; the span between nextStep and
+    // "now" is the accumulator of simulated time still owed to the physics.
+    auto nextStep{Clock::now() + period};
 
     while (m_running) {
-        if (!m_paused) {
-            auto currentTime{clock::now()};
-            double dt{std::chrono::duration<double>{currentTime - lastTime}.count()};
-            lastTime = currentTime;
+        waitUntil(nextStep);
 
-            // Update physics
-            m_physics->update(dt);
+        const auto wakeTime{Clock::now()};
+        const auto lateness{wakeTime - nextStep};
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+        if (lateness > lateTolerance) {
+            m_lateTicks.fetch_add(1, std::memory_order_relaxed);
+        }
+        const std::int64_t latenessNs{std::chrono::duration_cast<std::chrono::nanoseconds>(lateness).count()};
+        if (latenessNs > m_maxLatenessNs.load(std::memory_order_relaxed)) {
+            m_maxLatenessNs.store(latenessNs, std::memory_order_relaxed);
         }
+        m_lateness.record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, latenessNs)));
         
-        // Sleep to maintain desired timestep
-        std::this_thread::sleep_for(std::chrono::duration<double>{m_timestep});
+        if (m_paused) {
+            // Don't owe the physics any time spent paused
+            nextStep = wakeTime + period;
+            continue;
+        }
+
+        // Step once for every deadline that has passed, up to the catch-up budget
+        FALCONSIM_TRACE_ZONE("Simulation::tick");
+        int steps{0};
+        while (nextStep <= wakeTime && steps < m_maxCatchUpSteps) {
+            advance(m_timestep);
+            nextStep += period;
+            ++steps;
+        }
+        m_steps.fetch_add(static_cast<std::uint64_t>(steps), std::memory_order_relaxed);
+        if (steps > 0) {
+            m_tickTime.record(nanosecondsSince(wakeTime));
+        }
+        
+        // Still behind after the budget: drop the backlog instead of spiralling
+        if (nextStep <= wakeTime) {
+            const auto dropped{(wakeTime - nextStep) / period + 1};
+            nextStep += dropped * period;
+            m_droppedSteps.fetch_add(static_cast<std::uint64_t>(dropped), std::memory_order_relaxed);
+        }
+
+        if (Clock::now() > nextStep) {
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 }
 
-} // namespace falconsim 
\ No newline at end of file
+} // namespace falconsim 
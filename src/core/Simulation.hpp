@@ -5,8 +5,13 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
 
 #include "../physics/FlightDynamics.hpp"
+#include "Metrics.hpp"
+#include "SeqLock.hpp"
 
 namespace falconsim {
 
@@ -20,11 +25,80 @@ struct UAVState {
     Eigen::Vector3d angularVel{0, 0, 0}; // Angular velocity (rad/s)
 };
 
+/**
+ * @brief Counters describing how well the real-time scheduler keeps its deadlines
+ */
+struct SchedulerStats {
+    std::uint64_t ticks{0};         // Scheduler wake-ups
+    std::uint64_t steps{0};         // Physics steps executed (including catch-up sub-steps)
+    std::uint64_t overruns{0};      // Ticks whose work finished after the next deadline
+    std::uint64_t late_ticks{0};    // Ticks that woke later than the late tolerance
+    std::uint64_t dropped_steps{0}; // Steps discarded because the catch-up budget was exceeded
+    double max_lateness{0.0};       // Worst wake-up lateness observed (s)
+};
+
+/**
+ * @brief Runtime health of a simulation: is it keeping up, and how close to the edge
+ */
+struct SimulationMetrics {
+    SchedulerStats scheduler{};
+    double achieved_rate{0.0};   // Real-time loop steps per wall-clock second since start() (Hz)
+    double target_rate{0.0};     // 1 / timestep (Hz)
+    HistogramSummary step_time{}; // FlightDynamics::update() duration, one step in kStepTimingInterval (ns)
+    HistogramSummary tick_time{}; // Work per scheduler tick, including catch-up steps (ns)
+    HistogramSummary lateness{};  // Scheduler wake-up lateness (ns)
+};
+
+// Append metrics as falconsim_sim_* lines
+void appendMetrics(MetricsReport& report, const SimulationMetrics& metrics);
+
+/**
+ * @brief Everything needed to resume a simulation bit for bit (plain data)
+ */
+struct SimulationSnapshot {
+    DynamicsSnapshot dynamics{};
+    double sim_time{0.0};
+};
+static_assert(std::is_trivially_copyable<SimulationSnapshot>::value, "SimulationSnapshot must stay plain data");
+
 /**
  * @brief Core simulation class managing UAV dynamics and real-time updates
+ *
+ * The background thread advances the physics with a fixed timestep. Each tick
+ * sleeps until an absolute deadline on std::chrono::steady_clock, spin-waits
+ * for the final stretch to limit wake-up jitter, and then runs however many
+ * fixed steps the elapsed time calls for (bounded by the catch-up budget).
+ *
+ * For batch work (e.g. Monte Carlo runs) step() and run() advance the same
+ * physics on the calling thread as fast as the CPU allows, without sleeping.
+ *
+ * While the loop runs, the physics object is owned by the simulation thread.
+ * It publishes a state snapshot after every step, which getState() reads
+ * without blocking the integrator, and picks up control and state changes
+ * from lock-free mailboxes before the next step. The control setters form a
+ * single producer: call them from one thread at a time.
+ *
+ * Scheduler ticks and a sample of physics steps are timed into fixed-size
+ * histograms (a few nanoseconds per record, no allocation); getMetrics()
+ * summarizes them from any thread.
+ *
+ * A step observer sees every step as it happens, on whichever thread runs
+ * it, so it must be cheap and must not block (e.g. push into a queue).
+ *
+ * snapshot() captures the complete physics state and simulated time as
+ * plain data; restore() rewinds to it and fork() starts an independent copy
+ * from it. Stepping from the same snapshot with the same inputs replays the
+ * same trajectory bit for bit, so one warmed-up state can seed many cheap
+ * what-if branches.
  */
 class Simulation {
 public:
+    // Per-step hook for batch runs, called before each step with the current simulated time
+    using ControlCallback = std::function<void(Simulation& sim, double time)>;
+
+    // Per-step notification, called on the stepping thread after each step with the new simulated time
+    using StepObserver = std::function<void(const AircraftState& state, const ControlInputs& controls, double time)>;
+
     // Constructor with default timestep
     explicit Simulation(double timestep = 0.01);
     
@@ -45,29 +119,95 @@ public:
     void pause();
     void resume();
 
+    // Headless batch stepping on the calling thread (throws if the real-time loop is running)
+    std::uint64_t step(std::uint64_t count = 1, const ControlCallback& callback = {});
+    std::uint64_t run(double duration, double dt, const ControlCallback& callback = {});
+    [[nodiscard]] double getSimulationTime() const;
+
+    // Observe every physics step, e.g. to stream it (throws if the real-time loop is running)
+    void setStepObserver(StepObserver observer);
+    
+    // Deterministic capture and branching (throw if the real-time loop is running)
+    [[nodiscard]] SimulationSnapshot snapshot() const;
+    void restore(const SimulationSnapshot& snapshot);
+    [[nodiscard]] std::unique_ptr<Simulation> fork() const; // Same timestep and scheduler settings; no step observer
+
     // State access and modification
     [[nodiscard]] AircraftState getState() const;
     void setState(const AircraftState& state);
+    [[nodiscard]] ControlInputs getControls() const; // Controls applied to the latest step
 
     // Control inputs
     void setThrust(double throttle);
     void setControlSurfaces(const Eigen::Vector3d& controls); // aileron, elevator, rudder
 
-    // Get physics model
+    // Get physics model (direct access is unsynchronized while the loop is running)
     [[nodiscard]] FlightDynamics& getPhysics();
     [[nodiscard]] const FlightDynamics& getPhysics() const;
 
+    // Real-time scheduler configuration (takes effect on the next start())
+    [[nodiscard]] double getTimestep() const;
+    void setMaxCatchUpSteps(int steps);
+    void setSpinWindow(std::chrono::microseconds window);
+    void setLateTolerance(std::chrono::microseconds tolerance);
+
+    // Scheduler statistics (reset on start())
+    [[nodiscard]] SchedulerStats getSchedulerStats() const;
+
+    // Scheduler statistics plus latency histograms (safe from any thread; reset on start())
+    [[nodiscard]] SimulationMetrics getMetrics() const;
+    static constexpr std::uint64_t kStepTimingInterval{16};
+
 private:
+    using Clock = std::chrono::steady_clock;
+
     void simulationLoop();
+    void advance(double dt);
+    void applyPendingInputs();
+    void publishSnapshots();
+    void submitControls();
+    void waitUntil(Clock::time_point deadline) const;
+    void resetSchedulerStats();
     
     std::unique_ptr<FlightDynamics> m_physics{};
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_paused{false};
     double m_timestep{0.01};
+    std::atomic<double> m_simTime{0.0};
     std::thread m_simThread{};
+    StepObserver m_stepObserver{};
+
+    // Scheduler configuration
+    int m_maxCatchUpSteps{5};
+    std::chrono::microseconds m_spinWindow{200};
+    std::chrono::microseconds m_lateTolerance{50};
+
+    // Scheduler statistics, written by the simulation thread only
+    std::atomic<std::uint64_t> m_ticks{0};
+    std::atomic<std::uint64_t> m_steps{0};
+    std::atomic<std::uint64_t> m_overruns{0};
+    std::atomic<std::uint64_t> m_lateTicks{0};
+    std::atomic<std::uint64_t> m_droppedSteps{0};
+    std::atomic<std::int64_t> m_maxLatenessNs{0};
 
-    // Control inputs cache
+    // Latency histograms, recorded by whichever thread steps the physics
+    Histogram m_stepTime{};
+    Histogram m_tickTime{};
+    Histogram m_lateness{};
+    std::uint64_t m_stepTimingCounter{0};
+    std::atomic<std::int64_t> m_loopStartNs{0};
+    std::atomic<std::int64_t> m_loopStopNs{0};
+    
+    // Control inputs cache (caller side)
     ControlInputs m_controls{};
+
+    // Caller -> simulation thread
+    LatestValueMailbox<ControlInputs> m_controlMailbox{};
+    LatestValueMailbox<AircraftState> m_stateMailbox{};
+
+    // Simulation thread -> readers
+    SeqLock<AircraftState> m_stateSnapshot{};
+    SeqLock<ControlInputs> m_controlsSnapshot{};
 };
 
-} // namespace falconsim 
\ No newline at end of file
+} // namespace falconsim 
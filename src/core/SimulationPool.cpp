@@ -0,0 +1,273 @@
+#include "SimulationPool.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace falconsim {
+
+namespace {
+
+// Waits are sliced so a missed notification can only delay a thread, never park it
+constexpr std::chrono::milliseconds kWaitSlice{100};
+
+constexpr std::uint64_t packRange(std::uint32_t front, std::uint32_t back) {
+    return (static_cast<std::uint64_t>(front) << 32) | back;
+}
+
+constexpr std::uint32_t rangeFront(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range >> 32);
+}
+
+constexpr std::uint32_t rangeBack(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range & 0xffffffffu);
+}
+
+} // namespace
+
+SimulationPool::SimulationPool(std::size_t threadCount, bool pinThreads)
+    : m_threadCount{threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())}
+    , m_pinThreads{pinThreads}
+    , m_queues{std::make_unique<WorkQueue[]>(m_threadCount)} {
+    // The calling thread acts as worker 0 (and is left unpinned)
+    m_threads.reserve(m_threadCount - 1);
+    for (std::size_t i = 1; i < m_threadCount; ++i) {
+        m_threads.emplace_back(&SimulationPool::workerLoop, this, i);
+    }
+}
+
+SimulationPool::~SimulationPool() {
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+std::size_t SimulationPool::addVehicle(std::unique_ptr<FlightDynamics> vehicle) {
+    if (!vehicle) {
+        throw std::invalid_argument{"SimulationPool vehicle must not be null"};
+    }
+    m_vehicles.push_back(std::move(vehicle));
+    return m_vehicles.size() - 1;
+}
+
+std::size_t SimulationPool::size() const {
+    return m_vehicles.size();
+}
+
+FlightDynamics& SimulationPool::vehicle(std::size_t index) {
+    return *m_vehicles.at(index);
+}
+
+const FlightDynamics& SimulationPool::vehicle(std::size_t index) const {
+    return *m_vehicles.at(index);
+}
+
+std::size_t SimulationPool::threadCount() const {
+    return m_threadCount;
+}
+
+void SimulationPool::setVehiclesPerChunk(std::size_t count) {
+    m_vehiclesPerChunk = std::max<std::size_t>(1, count);
+}
+
+void SimulationPool::step(double dt, std::uint64_t ticks, const TickCallback& onTick) {
+    const RangeFunction body{[this, dt](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            m_vehicles[i]->update(dt);
+        }
+    }};
+    
+    for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+        parallelFor(m_vehicles.size(), m_vehiclesPerChunk, body);
+        if (onTick) {
+            onTick(tick);
+        }
+    }
+}
+
+void SimulationPool::run(double dt, std::uint64_t ticks) {
+    parallelFor(m_vehicles.size(), m_vehiclesPerChunk, [this, dt, ticks](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+                m_vehicles[i]->update(dt);
+            }
+        }
+    });
+}
+
+void SimulationPool::stepFleet(FleetDynamics& fleet, double dt, std::size_t chunkSize) {
+    // Keep chunk boundaries on whole AVX-512 vectors so only the last chunk has a scalar tail
+    constexpr std::size_t kVectorWidth{8};
+    const std::size_t grain{std::max(kVectorWidth, (chunkSize + kVectorWidth - 1) / kVectorWidth * kVectorWidth)};
+    
+    parallelFor(fleet.size(), grain, [&fleet, dt](std::size_t begin, std::size_t end) {
+        fleet.updateRange(begin, end, dt);
+    });
+}
+
+void SimulationPool::parallelFor(std::size_t count, std::size_t grain, const RangeFunction& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(1, grain);
+    const std::size_t chunks{(count + grain - 1) / grain};
+    if (chunks > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument{"parallelFor: too many chunks, increase the grain size"};
+    }
+    
+    // Nothing to share: run inline
+    if (m_threadCount == 1 || chunks == 1) {
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+    
+    // Publish the job before dealing out the chunks
+    m_body = &body;
+    m_count = count;
+    m_grain = grain;
+    m_error = nullptr;
+    m_remainingChunks.store(chunks, std::memory_order_relaxed);
+    for (std::size_t w = 0; w < m_threadCount; ++w) {
+        const auto front{static_cast<std::uint32_t>(chunks * w / m_threadCount)};
+        const auto back{static_cast<std::uint32_t>(chunks * (w + 1) / m_threadCount)};
+        m_queues[w].range.store(packRange(front, back), std::memory_order_release);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ++m_generation;
+    }
+    m_wake.notify_all();
+    
+    runChunks(0);
+    
+    // Barrier: every chunk finished and no worker still inside the job
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        const auto finished{[this] {
+            return m_remainingChunks.load(std::memory_order_acquire) == 0 && m_busyWorkers == 0;
+        }};
+        while (!m_done.wait_for(lock, kWaitSlice, finished)) {
+        }
+    }
+    
+    m_body = nullptr;
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void SimulationPool::workerLoop(std::size_t self) {
+    FALCONSIM_TRACE_THREAD_NAME("pool worker");
+    if (m_pinThreads) {
+        pinCurrentThread(self);
+    }
+    
+    std::uint64_t seenGeneration{0};
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            const auto woken{[this, seenGeneration] {
+                return m_stopping || m_generation != seenGeneration;
+            }};
+            while (!m_wake.wait_for(lock, kWaitSlice, woken)) {
+            }
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+            ++m_busyWorkers;
+        }
+        
+        runChunks(self);
+        
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            --m_busyWorkers;
+        }
+        m_done.notify_all();
+    }
+}
+
+void SimulationPool::runChunks(std::size_t self) {
+    FALCONSIM_TRACE_ZONE("SimulationPool::runChunks");
+    for (;;) {
+        std::uint32_t chunk{0};
+        bool found{popFront(self, chunk)};
+        
+        // Own block exhausted: steal from the back of the others
+        for (std::size_t offset = 1; !found && offset < m_threadCount; ++offset) {
+            found = popBack((self + offset) % m_threadCount, chunk);
+        }
+        if (!found) {
+            return;
+        }
+        
+        const std::size_t begin{static_cast<std::size_t>(chunk) * m_grain};
+        try {
+            (*m_body)(begin, std::min(m_count, begin + m_grain));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{m_errorMutex};
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+        m_remainingChunks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool SimulationPool::popFront(std::size_t queue, std::uint32_t& chunk) {
+    auto& range{m_queues[queue].range};
+    std::uint64_t current{range.load(std::memory_order_acquire)};
+    while (rangeFront(current) < rangeBack(current)) {
+        if (range.compare_exchange_weak(current, packRange(rangeFront(current) + 1, rangeBack(current)),
+                                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+            chunk = rangeFront(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SimulationPool::popBack(std::size_t queue, std::uint32_t& chunk) {
+    auto& range{m_queues[queue].range};
+    std::uint64_t current{range.load(std::memory_order_acquire)};
+    while (rangeFront(current) < rangeBack(current)) {
+        if (range.compare_exchange_weak(current, packRange(rangeFront(current), rangeBack(current) - 1),
+                                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+            chunk = rangeBack(current) - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimulationPool::pinCurrentThread(std::size_t core) {
+#if defined(__linux__)
+    const unsigned cores{std::max(1u, std::thread::hardware_concurrency())};
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(core % cores), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core; // Affinity is best-effort; only supported on Linux for now
+#endif
+}
+
+} // namespace falconsim
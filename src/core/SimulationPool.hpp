@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../physics/FleetDynamics.hpp"
+#include "../physics/FlightDynamics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Steps many independent vehicles across a fixed set of worker threads
+ *
+ * Work is split into chunks that are dealt out as contiguous blocks, one per
+ * thread. A thread that runs out steals chunks from the far end of another
+ * thread's block, so a few expensive vehicles don't leave the rest idle. The
+ * calling thread takes part as worker 0, and every call returns only once all
+ * chunks are finished, which is the per-tick barrier for lockstep stepping.
+ *
+ * Calls into the pool must come from one thread at a time.
+ */
+class SimulationPool {
+public:
+    // Body of a parallel loop over the half-open index range [begin, end)
+    using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+    // Called on the calling thread after every lockstep tick
+    using TickCallback = std::function<void(std::uint64_t tick)>;
+
+    // threadCount 0 uses every hardware thread; pinThreads binds worker thread i to core i
+    explicit SimulationPool(std::size_t threadCount = 0, bool pinThreads = false);
+    ~SimulationPool();
+
+    SimulationPool(const SimulationPool&) = delete;
+    SimulationPool& operator=(const SimulationPool&) = delete;
+    SimulationPool(SimulationPool&&) = delete;
+    SimulationPool& operator=(SimulationPool&&) = delete;
+
+    // Vehicle management
+    std::size_t addVehicle(std::unique_ptr<FlightDynamics> vehicle);
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] FlightDynamics& vehicle(std::size_t index);
+    [[nodiscard]] const FlightDynamics& vehicle(std::size_t index) const;
+
+    // Lockstep: all vehicles finish tick k before any starts tick k+1
+    void step(double dt, std::uint64_t ticks = 1, const TickCallback& onTick = {});
+
+    // Free running: each chunk of vehicles runs all ticks without waiting for the rest
+    void run(double dt, std::uint64_t ticks);
+
+    // One lockstep tick of a batch fleet, split into SIMD-friendly chunks
+    void stepFleet(FleetDynamics& fleet, double dt, std::size_t chunkSize = 256);
+
+    // Generic parallel loop over [0, count) in chunks of grain indices
+    void parallelFor(std::size_t count, std::size_t grain, const RangeFunction& body);
+
+    [[nodiscard]] std::size_t threadCount() const;
+
+    // Vehicles handed to each chunk by step() and run()
+    void setVehiclesPerChunk(std::size_t count);
+
+private:
+    // Chunk indices [front, back) owned by one worker, packed into one word so
+    // the owner (front) and thieves (back) can both claim with a single CAS
+    struct alignas(64) WorkQueue {
+        std::atomic<std::uint64_t> range{0};
+    };
+
+    void workerLoop(std::size_t self);
+    void runChunks(std::size_t self);
+    bool popFront(std::size_t queue, std::uint32_t& chunk);
+    bool popBack(std::size_t queue, std::uint32_t& chunk);
+    void pinCurrentThread(std::size_t core);
+
+    std::vector<std::unique_ptr<FlightDynamics>> m_vehicles{};
+    std::size_t m_vehiclesPerChunk{16};
+
+    // Workers
+    std::size_t m_threadCount{1};
+    bool m_pinThreads{false};
+    std::unique_ptr<WorkQueue[]> m_queues{};
+    std::vector<std::thread> m_threads{};
+
+    // Current job, published before the queues are filled
+    const RangeFunction* m_body{nullptr};
+    std::size_t m_count{0};
+    std::size_t m_grain{1};
+    std::atomic<std::size_t> m_remainingChunks{0};
+    std::exception_ptr m_error{};
+    std::mutex m_errorMutex{};
+
+    // Wake-up and completion signalling
+    std::mutex m_mutex{};
+    std::condition_variable m_wake{};
+    std::condition_variable m_done{};
+    std::uint64_t m_generation{0};
+    std::size_t m_busyWorkers{0};
+    bool m_stopping{false};
+};
+
+} // namespace falconsim
@@ -0,0 +1,277 @@
+#include "SweepRunner.hpp"
+#include "Trace.hpp"
+#include "../physics/CounterRng.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace falconsim {
+
+namespace {
+
+/**
+ * @brief Counter-based uniform draws for one Monte Carlo case (stream = case index)
+ */
+class CaseRandom {
+public:
+    CaseRandom(std::uint64_t seed, std::uint64_t index)
+        : m_key{counter_rng::streamKey(seed, index)} {
+    }
+    
+    // Uniform in [low, high]
+    double uniform(double low, double high) {
+        return low + (high - low) * counter_rng::uniform(m_key, m_draw++);
+    }
+    
+    // Uniform in [-spread, spread] on each axis
+    Eigen::Vector3d spread(const Eigen::Vector3d& spread) {
+        const double x{uniform(-spread.x(), spread.x())};
+        const double y{uniform(-spread.y(), spread.y())};
+        const double z{uniform(-spread.z(), spread.z())};
+        return Eigen::Vector3d{x, y, z};
+    }
+
+private:
+    std::uint64_t m_key;
+    std::uint64_t m_draw{0};
+};
+
+bool isFinite(const AircraftState& state) {
+    return state.position.allFinite() && state.velocity.allFinite() && state.angular_velocity.allFinite();
+}
+
+} // namespace
+
+SweepSpace::SweepSpace(std::uint64_t size, Generator generator)
+    : m_size{size}
+    , m_generator{std::move(generator)} {
+    if (m_size > 0 && !m_generator) {
+        throw std::invalid_argument{"Sweep space needs a case generator"};
+    }
+}
+
+SweepSpace SweepSpace::grid(const SweepGrid& grid) {
+    const std::uint64_t extents[6]{grid.mass.size(), grid.lift_coefficient.size(), grid.drag_coefficient.size(),
+                                   grid.wind.size(), grid.initial_state.size(), grid.schedule.size()};
+    std::uint64_t size{1};
+    for (const std::uint64_t extent : extents) {
+        if (extent == 0) {
+            throw std::invalid_argument{"Sweep grid axes need at least one value each"};
+        }
+        size *= extent;
+    }
+    
+    // Schedules are shared by every case that flies them
+    std::vector<std::shared_ptr<const ControlSchedule>> schedules;
+    for (const ControlSchedule& schedule : grid.schedule) {
+        schedules.push_back(schedule.empty() ? nullptr : std::make_shared<const ControlSchedule>(schedule));
+    }
+    
+    return SweepSpace{size, [grid, schedules = std::move(schedules)](std::uint64_t index) {
+        // Mixed-radix digits of the index, the schedule varying fastest
+        std::size_t digit[6];
+        const std::size_t extents[6]{grid.mass.size(), grid.lift_coefficient.size(), grid.drag_coefficient.size(),
+                                     grid.wind.size(), grid.initial_state.size(), grid.schedule.size()};
+        for (std::size_t axis = 6; axis-- > 0;) {
+            digit[axis] = static_cast<std::size_t>(index % extents[axis]);
+            index /= extents[axis];
+        }
+        SweepCase sweepCase;
+        sweepCase.mass = grid.mass[digit[0]];
+        sweepCase.lift_coefficient = grid.lift_coefficient[digit[1]];
+        sweepCase.drag_coefficient = grid.drag_coefficient[digit[2]];
+        sweepCase.wind = grid.wind[digit[3]];
+        sweepCase.initial_state = grid.initial_state[digit[4]];
+        sweepCase.schedule = schedules[digit[5]];
+        return sweepCase;
+    }};
+}
+
+SweepSpace SweepSpace::monteCarlo(const SweepRanges& ranges, std::uint64_t count) {
+    auto schedule = ranges.schedule.empty() ? nullptr : std::make_shared<const ControlSchedule>(ranges.schedule);
+    return SweepSpace{count, [ranges, schedule = std::move(schedule)](std::uint64_t index) {
+        CaseRandom random{ranges.seed, index};
+        SweepCase sweepCase;
+        sweepCase.mass = random.uniform(ranges.mass[0], ranges.mass[1]);
+        sweepCase.lift_coefficient = random.uniform(ranges.lift_coefficient[0], ranges.lift_coefficient[1]);
+        sweepCase.drag_coefficient = random.uniform(ranges.drag_coefficient[0], ranges.drag_coefficient[1]);
+        for (int axis = 0; axis < 3; ++axis) {
+            sweepCase.wind[axis] = random.uniform(ranges.wind_min[axis], ranges.wind_max[axis]);
+        }
+        sweepCase.initial_state = ranges.initial_state;
+        sweepCase.initial_state.position += random.spread(ranges.position_spread);
+        sweepCase.initial_state.velocity += random.spread(ranges.velocity_spread);
+        sweepCase.initial_state.euler_angles += random.spread(ranges.attitude_spread);
+        sweepCase.schedule = schedule;
+        return sweepCase;
+    }};
+}
+
+std::uint64_t SweepSpace::size() const {
+    return m_size;
+}
+
+SweepCase SweepSpace::caseAt(std::uint64_t index) const {
+    if (index >= m_size) {
+        throw std::out_of_range{"Sweep case index out of range"};
+    }
+    return m_generator(index);
+}
+
+void SweepAggregate::add(const SweepRunSummary& run) {
+    ++m_runs;
+    m_steps += run.steps;
+    ++m_outcomes[static_cast<std::size_t>(run.outcome)];
+    if (run.outcome == SweepOutcome::Diverged) {
+        return;
+    }
+    for (std::size_t metric = 0; metric < kSweepMetricCount; ++metric) {
+        m_stats[metric].add(run.metrics[metric]);
+        m_quantiles[metric].add(run.metrics[metric]);
+    }
+}
+
+void SweepAggregate::merge(const SweepAggregate& other) {
+    m_runs += other.m_runs;
+    m_steps += other.m_steps;
+    for (std::size_t outcome = 0; outcome < kSweepOutcomeCount; ++outcome) {
+        m_outcomes[outcome] += other.m_outcomes[outcome];
+    }
+    for (std::size_t metric = 0; metric < kSweepMetricCount; ++metric) {
+        m_stats[metric].merge(other.m_stats[metric]);
+        m_quantiles[metric].merge(other.m_quantiles[metric]);
+    }
+}
+
+std::uint64_t SweepAggregate::getRuns() const {
+    return m_runs;
+}
+
+std::uint64_t SweepAggregate::getSteps() const {
+    return m_steps;
+}
+
+std::uint64_t SweepAggregate::getOutcomeCount(SweepOutcome outcome) const {
+    return m_outcomes[static_cast<std::size_t>(outcome)];
+}
+
+const RunningStats& SweepAggregate::stats(SweepMetric metric) const {
+    return m_stats[static_cast<std::size_t>(metric)];
+}
+
+const QuantileSketch& SweepAggregate::quantiles(SweepMetric metric) const {
+    return m_quantiles[static_cast<std::size_t>(metric)];
+}
+
+SweepRunner::SweepRunner(std::size_t threadCount)
+    : m_pool{threadCount} {
+}
+
+SweepRunSummary SweepRunner::fly(const SweepCase& sweepCase, std::uint64_t index, const SweepSettings& settings,
+                                 FlightDynamics& dynamics) {
+    dynamics.setIntegrationMethod(settings.integration);
+    dynamics.setState(sweepCase.initial_state);
+    dynamics.setMass(sweepCase.mass);
+    dynamics.setLiftCoefficient(sweepCase.lift_coefficient);
+    dynamics.setDragCoefficient(sweepCase.drag_coefficient);
+    dynamics.setWind(sweepCase.wind);
+    dynamics.setControls(ControlInputs{});
+    
+    SweepRunSummary summary;
+    summary.case_index = index;
+    double minAltitude{std::numeric_limits<double>::infinity()};
+    double maxAltitude{-std::numeric_limits<double>::infinity()};
+    double maxSpeed{0.0};
+    double maxAngularRate{0.0};
+    AircraftState state{dynamics.getState()};
+    const auto track = [&](const AircraftState& s) {
+        minAltitude = std::min(minAltitude, -s.position.z());
+        maxAltitude = std::max(maxAltitude, -s.position.z());
+        maxSpeed = std::max(maxSpeed, s.velocity.norm());
+        maxAngularRate = std::max(maxAngularRate, s.angular_velocity.norm());
+    };
+    track(state);
+    
+    // Cover the whole duration, tolerating floating-point noise in duration/dt, as Simulation::run() does
+    const double dt{settings.timestep};
+    const auto count{static_cast<std::uint64_t>(std::ceil(settings.duration / dt - 1e-9))};
+    const ControlSchedule* schedule{sweepCase.schedule.get()};
+    std::size_t keyframe{0};
+    for (std::uint64_t step = 0; step < count; ++step) {
+        const double time{static_cast<double>(step) * dt};
+        for (; schedule && keyframe < schedule->size() && (*schedule)[keyframe].time <= time; ++keyframe) {
+            dynamics.setControls((*schedule)[keyframe].controls);
+        }
+        dynamics.update(dt);
+        ++summary.steps;
+        
+        const AircraftState next{dynamics.getState()};
+        if (!isFinite(next) || !(next.velocity.norm() <= settings.divergence_speed)) {
+            summary.outcome = SweepOutcome::Diverged;
+            break;
+        }
+        state = next;
+        track(state);
+        if (settings.stop_at_ground && -state.position.z() < settings.ground_altitude) {
+            summary.outcome = SweepOutcome::GroundImpact;
+            break;
+        }
+    }
+    
+    // A diverged run reports its last finite state
+    double* metrics{summary.metrics};
+    metrics[static_cast<std::size_t>(SweepMetric::EndTime)] = static_cast<double>(summary.steps) * dt;
+    metrics[static_cast<std::size_t>(SweepMetric::FinalNorth)] = state.position.x();
+    metrics[static_cast<std::size_t>(SweepMetric::FinalEast)] = state.position.y();
+    metrics[static_cast<std::size_t>(SweepMetric::FinalAltitude)] = -state.position.z();
+    metrics[static_cast<std::size_t>(SweepMetric::FinalSpeed)] = state.velocity.norm();
+    metrics[static_cast<std::size_t>(SweepMetric::MinAltitude)] = minAltitude;
+    metrics[static_cast<std::size_t>(SweepMetric::MaxAltitude)] = maxAltitude;
+    metrics[static_cast<std::size_t>(SweepMetric::MaxSpeed)] = maxSpeed;
+    metrics[static_cast<std::size_t>(SweepMetric::MaxAngularRate)] = maxAngularRate;
+    return summary;
+}
+
+SweepAggregate SweepRunner::run(const SweepSpace& space, const SweepSettings& settings, const RunSink& sink) {
+    if (!(settings.timestep > 0.0) || !(settings.duration >= 0.0)) {
+        throw std::invalid_argument{"Sweep needs a positive timestep and non-negative duration"};
+    }
+    
+    SweepAggregate aggregate;
+    std::mutex mutex;
+    const SimulationPool::RangeFunction body{[&](std::size_t begin, std::size_t end) {
+        FALCONSIM_TRACE_ZONE("SweepRunner::chunk");
+        
+        // One model per chunk, rewound to its pristine state between cases
+        FlightDynamics dynamics;
+        const DynamicsSnapshot pristine{dynamics.snapshot()};
+        std::vector<SweepRunSummary> runs;
+        runs.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+            if (i != begin) {
+                dynamics.restore(pristine);
+            }
+            runs.push_back(fly(space.caseAt(i), i, settings, dynamics));
+        }
+        
+        // Fold the chunk in at once, so the lock is taken once per chunk rather than per run
+        std::lock_guard<std::mutex> lock{mutex};
+        for (const SweepRunSummary& run : runs) {
+            aggregate.add(run);
+            if (sink) {
+                sink(run);
+            }
+        }
+    }};
+    m_pool.parallelFor(static_cast<std::size_t>(space.size()), settings.cases_per_chunk, body);
+    return aggregate;
+}
+
+std::size_t SweepRunner::threadCount() const {
+    return m_pool.threadCount();
+}
+
+} // namespace falconsim
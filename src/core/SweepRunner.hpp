@@ -0,0 +1,214 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../physics/FlightDynamics.hpp"
+#include "OnlineStats.hpp"
+#include "SimulationPool.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Controls that take effect at a point in a run
+ */
+struct ControlKeyframe {
+    double time{0.0}; // Simulated time from the start of the run (s)
+    ControlInputs controls{};
+};
+
+// Keyframes in ascending time; each holds until the next (no controls before the first)
+using ControlSchedule = std::vector<ControlKeyframe>;
+
+/**
+ * @brief Parameters of one sweep run
+ */
+struct SweepCase {
+    double mass{1.0};                   // kg
+    double lift_coefficient{1.2};
+    double drag_coefficient{0.1};
+    Eigen::Vector3d wind{0, 0, 0};      // Steady wind (NED, m/s)
+    AircraftState initial_state{};
+    std::shared_ptr<const ControlSchedule> schedule{}; // nullptr flies with neutral controls
+};
+
+/**
+ * @brief Full-factorial parameter grid: one case per combination of values
+ */
+struct SweepGrid {
+    std::vector<double> mass{1.0};
+    std::vector<double> lift_coefficient{1.2};
+    std::vector<double> drag_coefficient{0.1};
+    std::vector<Eigen::Vector3d> wind{Eigen::Vector3d::Zero()};
+    std::vector<AircraftState> initial_state{AircraftState{}};
+    std::vector<ControlSchedule> schedule{ControlSchedule{}};
+};
+
+/**
+ * @brief Monte Carlo parameter ranges, each drawn uniformly per case
+ */
+struct SweepRanges {
+    double mass[2]{1.0, 1.0};               // [min, max] (kg)
+    double lift_coefficient[2]{1.2, 1.2};
+    double drag_coefficient[2]{0.1, 0.1};
+    Eigen::Vector3d wind_min{0, 0, 0};      // Per NED axis (m/s)
+    Eigen::Vector3d wind_max{0, 0, 0};
+    AircraftState initial_state{};          // Nominal state, perturbed by the spreads below
+    Eigen::Vector3d position_spread{0, 0, 0}; // ± on each NED position axis (m)
+    Eigen::Vector3d velocity_spread{0, 0, 0}; // ± on each body velocity axis (m/s)
+    Eigen::Vector3d attitude_spread{0, 0, 0}; // ± on roll, pitch and yaw (rad)
+    ControlSchedule schedule{};
+    std::uint64_t seed{0};
+};
+
+/**
+ * @brief An indexed set of sweep cases, generated on demand
+ *
+ * Cases are never materialized: caseAt(i) builds case i from its index
+ * alone, on whichever thread runs it, so a space of millions of cases
+ * costs nothing up front and every case is reproducible on its own.
+ */
+class SweepSpace {
+public:
+    using Generator = std::function<SweepCase(std::uint64_t index)>;
+    
+    // A custom space of size cases (the generator is called concurrently)
+    SweepSpace(std::uint64_t size, Generator generator);
+    
+    // Every combination of the grid's values, mass varying slowest (throws std::invalid_argument on an empty axis)
+    static SweepSpace grid(const SweepGrid& grid);
+    
+    // count cases drawn from the ranges; case i depends only on the seed and i
+    static SweepSpace monteCarlo(const SweepRanges& ranges, std::uint64_t count);
+    
+    [[nodiscard]] std::uint64_t size() const;
+    [[nodiscard]] SweepCase caseAt(std::uint64_t index) const;
+
+private:
+    std::uint64_t m_size{0};
+    Generator m_generator{};
+};
+
+/**
+ * @brief How each sweep run is flown and when it ends
+ */
+struct SweepSettings {
+    double duration{60.0};      // Simulated time per run (s)
+    double timestep{0.01};      // Fixed physics step (s)
+    IntegrationMethod integration{IntegrationMethod::EulerAngles};
+    bool stop_at_ground{true};  // End a run once it descends below the ground altitude
+    double ground_altitude{0.0}; // m above the NED origin
+    double divergence_speed{1000.0}; // A run whose speed exceeds this has diverged (m/s)
+    std::size_t cases_per_chunk{4}; // Cases handed to a worker at a time
+};
+
+/**
+ * @brief How a run ended
+ */
+enum class SweepOutcome : std::uint32_t {
+    Completed,    // Flew the whole duration
+    GroundImpact, // Descended below the ground altitude
+    Diverged      // The state became non-finite or the speed ran away
+};
+constexpr std::size_t kSweepOutcomeCount{3};
+
+/**
+ * @brief Per-run summary values, in column order
+ */
+enum class SweepMetric : std::size_t {
+    EndTime,        // Simulated time at the end of the run (s)
+    FinalNorth,     // Final NED position (m)
+    FinalEast,
+    FinalAltitude,  // Final height above the NED origin (m)
+    FinalSpeed,     // Final speed over the ground (m/s)
+    MinAltitude,    // Extremes over the run
+    MaxAltitude,
+    MaxSpeed,
+    MaxAngularRate  // Largest body rate magnitude (rad/s)
+};
+constexpr std::size_t kSweepMetricCount{9};
+
+/**
+ * @brief Summary of one run; the trajectory itself is never kept
+ */
+struct SweepRunSummary {
+    std::uint64_t case_index{0};
+    std::uint64_t steps{0};
+    SweepOutcome outcome{SweepOutcome::Completed};
+    double metrics[kSweepMetricCount]{};
+    
+    [[nodiscard]] double metric(SweepMetric which) const {
+        return metrics[static_cast<std::size_t>(which)];
+    }
+};
+
+/**
+ * @brief Streaming statistics over the runs of a sweep
+ *
+ * Every metric has a RunningStats (mean, variance, range) and a
+ * QuantileSketch. Diverged runs are counted but left out of the metric
+ * statistics, whose values would be meaningless. Memory is fixed, however
+ * many runs are added.
+ */
+class SweepAggregate {
+public:
+    void add(const SweepRunSummary& run);
+    void merge(const SweepAggregate& other);
+    
+    [[nodiscard]] std::uint64_t getRuns() const;
+    [[nodiscard]] std::uint64_t getSteps() const; // Physics steps over all runs
+    [[nodiscard]] std::uint64_t getOutcomeCount(SweepOutcome outcome) const;
+    [[nodiscard]] const RunningStats& stats(SweepMetric metric) const;
+    [[nodiscard]] const QuantileSketch& quantiles(SweepMetric metric) const;
+
+private:
+    std::uint64_t m_runs{0};
+    std::uint64_t m_steps{0};
+    std::uint64_t m_outcomes[kSweepOutcomeCount]{};
+    RunningStats m_stats[kSweepMetricCount]{};
+    QuantileSketch m_quantiles[kSweepMetricCount]{};
+};
+
+/**
+ * @brief Runs a parameter sweep or Monte Carlo study across every core
+ *
+ * Each worker flies its cases headless on its own FlightDynamics, reset
+ * from a pristine snapshot between cases, as fast as the CPU allows. A
+ * run is reduced to a SweepRunSummary as it flies; finished summaries are
+ * folded into one SweepAggregate and handed to the optional sink (e.g. a
+ * SweepLogWriter) a chunk at a time, so memory stays constant in the
+ * number of cases.
+ *
+ * Run summaries and quantiles are bit-exact and independent of the thread
+ * count. Summaries reach the sink in completion order, tagged with their
+ * case index; means and variances accumulate in that order too, so they
+ * may differ between sweeps in the last bits.
+ *
+ * Calls to run() must come from one thread at a time.
+ */
+class SweepRunner {
+public:
+    // Receives each finished run; calls are serialized, from any worker thread
+    using RunSink = std::function<void(const SweepRunSummary& run)>;
+    
+    // threadCount 0 uses every hardware thread
+    explicit SweepRunner(std::size_t threadCount = 0);
+    
+    // Fly every case of the space (throws std::invalid_argument on bad settings; rethrows sink and generator errors)
+    [[nodiscard]] SweepAggregate run(const SweepSpace& space, const SweepSettings& settings, const RunSink& sink = {});
+    
+    // Fly one case on the caller's dynamics, which should start from a default-constructed state
+    static SweepRunSummary fly(const SweepCase& sweepCase, std::uint64_t index, const SweepSettings& settings,
+                               FlightDynamics& dynamics);
+    
+    [[nodiscard]] std::size_t threadCount() const;
+
+private:
+    SimulationPool m_pool;
+};
+
+} // namespace falconsim
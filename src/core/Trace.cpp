@@ -0,0 +1,182 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace falconsim {
+namespace trace {
+
+namespace {
+
+struct Event {
+    const char* name;
+    std::int64_t start;
+    std::int64_t end;
+};
+
+constexpr std::size_t kBlockEvents{4096};
+constexpr std::size_t kMaxBlocks{kMaxEventsPerThread / kBlockEvents};
+
+/**
+ * @brief One thread's events: written by that thread, read by the exporter
+ *
+ * Blocks are published before the count that covers them, so every event
+ * below an acquire-loaded count is complete and never written again.
+ */
+struct ThreadBuffer {
+    std::uint32_t id{0};
+    std::string name{}; // Guarded by the registry mutex
+    std::array<std::atomic<Event*>, kMaxBlocks> blocks{};
+    std::atomic<std::size_t> count{0};
+    
+    ~ThreadBuffer() {
+        for (auto& block : blocks) {
+            delete[] block.load();
+        }
+    }
+};
+
+/**
+ * @brief Every thread buffer ever created (kept after their threads exit)
+ */
+struct Registry {
+    std::mutex mutex{};
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers{};
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+Registry& registry() {
+    // Leaked on purpose: threads may still record during static destruction
+    static Registry* instance{new Registry};
+    return *instance;
+}
+
+void writeAtExit() {
+    if (const char* path{std::getenv("FALCONSIM_TRACE_FILE")}) {
+        if (!writeChromeTrace(path)) {
+            std::fprintf(stderr, "Failed to write trace to %s\n", path);
+        }
+    }
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer{nullptr};
+    if (!buffer) {
+        Registry& reg{registry()};
+        std::lock_guard<std::mutex> lock{reg.mutex};
+        if (reg.buffers.empty() && std::getenv("FALCONSIM_TRACE_FILE")) {
+            std::atexit(writeAtExit);
+        }
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = reg.buffers.back().get();
+        buffer->id = static_cast<std::uint32_t>(reg.buffers.size());
+    }
+    return *buffer;
+}
+
+void writeEscaped(std::FILE* file, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20) {
+            std::fputc(*c, file);
+        }
+    }
+}
+
+} // namespace
+
+std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(const char* name, std::int64_t startNs, std::int64_t endNs) noexcept {
+    ThreadBuffer& buffer{threadBuffer()};
+    const std::size_t index{buffer.count.load(std::memory_order_relaxed)};
+    if (index >= kMaxEventsPerThread) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    std::atomic<Event*>& slot{buffer.blocks[index / kBlockEvents]};
+    Event* block{slot.load(std::memory_order_relaxed)};
+    if (!block) {
+        block = new (std::nothrow) Event[kBlockEvents];
+        if (!block) {
+            registry().dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        slot.store(block, std::memory_order_release);
+    }
+    block[index % kBlockEvents] = Event{name, startNs, endNs};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void setThreadName(const char* name) {
+    ThreadBuffer& buffer{threadBuffer()};
+    std::lock_guard<std::mutex> lock{registry().mutex};
+    buffer.name = name;
+}
+
+std::uint64_t getDroppedEvents() {
+    return registry().dropped.load(std::memory_order_relaxed);
+}
+
+bool writeChromeTrace(const std::string& path) {
+    if (!kEnabled) {
+        return false;
+    }
+    std::FILE* file{std::fopen(path.c_str(), "w")};
+    if (!file) {
+        return false;
+    }
+    
+    Registry& reg{registry()};
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    
+    // Complete ("X") events with microsecond timestamps relative to the earliest
+    // zone (an enclosing zone is recorded after the zones nested in it)
+    std::int64_t origin{INT64_MAX};
+    for (const auto& buffer : reg.buffers) {
+        const std::size_t count{buffer->count.load(std::memory_order_acquire)};
+        for (std::size_t i = 0; i < count; ++i) {
+            origin = std::min(origin, buffer->blocks[i / kBlockEvents].load(std::memory_order_acquire)[i % kBlockEvents].start);
+        }
+    }
+    
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    bool first{true};
+    for (const auto& buffer : reg.buffers) {
+        if (!buffer->name.empty()) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                         first ? "" : ",\n", buffer->id);
+            writeEscaped(file, buffer->name.c_str());
+            std::fputs("\"}}", file);
+            first = false;
+        }
+        
+        const std::size_t count{buffer->count.load(std::memory_order_acquire)};
+        for (std::size_t i = 0; i < count; ++i) {
+            const Event& event{buffer->blocks[i / kBlockEvents].load(std::memory_order_acquire)[i % kBlockEvents]};
+            std::fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+            writeEscaped(file, event.name);
+            std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->id,
+                         static_cast<double>(event.start - origin) * 1e-3,
+                         static_cast<double>(event.end - event.start) * 1e-3);
+            first = false;
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+} // namespace trace
+} // namespace falconsim
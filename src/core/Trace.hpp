@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Timeline tracing zones, compiled out unless FALCONSIM_ENABLE_TRACING is defined
+ *
+ *     void Simulation::advance(double dt) {
+ *         FALCONSIM_TRACE_ZONE("Simulation::advance");
+ *         ...
+ *     }
+ *
+ * Each zone records its start and end timestamps into a buffer owned by
+ * the calling thread. There are no locks and no shared cache lines; a new
+ * 4096-event block is allocated once per 4096 zones. writeChromeTrace()
+ * exports every thread's events as Chrome Trace Event JSON. Perfetto
+ * (ui.perfetto.dev) and chrome://tracing open it directly, and Tracy
+ * imports it with its import-chrome tool. Setting FALCONSIM_TRACE_FILE in
+ * the environment writes the trace there on exit.
+ *
+ * Without the CMake option FALCONSIM_ENABLE_TRACING the macros expand to
+ * nothing, so zones cost nothing in normal builds. Zone and thread names
+ * must be string literals (only the pointer is stored).
+ */
+#if defined(FALCONSIM_ENABLE_TRACING)
+#define FALCONSIM_TRACE_CONCAT_IMPL(a, b) a##b
+#define FALCONSIM_TRACE_CONCAT(a, b) FALCONSIM_TRACE_CONCAT_IMPL(a, b)
+#define FALCONSIM_TRACE_ZONE(name) \
+    const ::falconsim::trace::Zone FALCONSIM_TRACE_CONCAT(falconsimTraceZone, __LINE__){name}
+#define FALCONSIM_TRACE_THREAD_NAME(name) ::falconsim::trace::setThreadName(name)
+#else
+#define FALCONSIM_TRACE_ZONE(name) static_cast<void>(0)
+#define FALCONSIM_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+namespace falconsim {
+namespace trace {
+
+#if defined(FALCONSIM_ENABLE_TRACING)
+constexpr bool kEnabled{true};
+#else
+constexpr bool kEnabled{false};
+#endif
+
+// Events kept per thread; later zones on a full thread are dropped and counted
+constexpr std::size_t kMaxEventsPerThread{std::size_t{1} << 20};
+
+// Label the calling thread in the exported timeline
+void setThreadName(const char* name);
+
+// Export everything recorded so far; false if tracing is compiled out or the file cannot be written
+bool writeChromeTrace(const std::string& path);
+
+// Zones dropped because a thread's buffer was full
+[[nodiscard]] std::uint64_t getDroppedEvents();
+
+// Monotonic timestamp in nanoseconds (steady clock)
+[[nodiscard]] std::int64_t now() noexcept;
+
+// Append one completed zone to the calling thread's buffer
+void record(const char* name, std::int64_t startNs, std::int64_t endNs) noexcept;
+
+/**
+ * @brief Scoped zone: records [construction, destruction) on the calling thread
+ */
+class Zone {
+public:
+    explicit Zone(const char* name) noexcept
+        : m_name{name}
+        , m_start{now()} {
+    }
+    
+    ~Zone() {
+        record(m_name, m_start, now());
+    }
+    
+    // Deleted copy and move operations
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+    Zone(Zone&&) = delete;
+    Zone& operator=(Zone&&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_start;
+};
+
+} // namespace trace
+} // namespace falconsim
@@ -1,77 +1,191 @@
 #include "Flight3DView.hpp"
+#include "core/Trace.hpp"
 
-#include <QOpenGLFunctions>
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QColor>
-#include <QOpenGLVersionFunctionsFactory>
+#include <QDebug>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+
+namespace {
+
+// Instanced aircraft: mesh vertices are rotated by the instance quaternion and moved to its position
+const char *kAircraftVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_color;
+layout(location = 2) in vec4 a_instancePosition;
+layout(location = 3) in vec4 a_instanceRotation;
+uniform mat4 u_viewProjection;
+out vec3 v_color;
+
+vec3 rotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main()
+{
+    vec3 world = a_instancePosition.xyz + rotate(a_instanceRotation, a_position);
+    gl_Position = u_viewProjection * vec4(world, 1.0);
+    v_color = mix(a_color * 0.55, a_color, a_instancePosition.w);
+}
+)";
+
+// Grid, axes and trail: plain colored lines in view coordinates
+const char *kLineVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_color;
+uniform mat4 u_viewProjection;
+out vec3 v_color;
+
+void main()
+{
+    gl_Position = u_viewProjection * vec4(a_position, 1.0);
+    v_color = a_color;
+}
+)";
+
+const char *kFragmentShader = R"(
+#version 330 core
+in vec3 v_color;
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = vec4(v_color, 1.0);
+}
+)";
+
+constexpr QVector3D kTrailColor{1.0f, 0.85f, 0.2f};
+
+// Trail points closer than this to the previous one are skipped (m)
+constexpr float kTrailMinSpacing{0.05f};
+
+} // namespace
 
 Flight3DView::Flight3DView(QWidget *parent)
-    : QOpenGLWidget(parent), m_glFunctions(nullptr)
+    : QOpenGLWidget(parent)
 {
     // Set focus policy to enable keyboard input
     setFocusPolicy(Qt::StrongFocus);
     
     // Enable mouse tracking for smooth camera movement
     setMouseTracking(true);
+    
+    // Slot 0 is the primary aircraft
+    const double origin[3]{0.0, 0.0, 0.0};
+    m_instances.push_back(makeInstance(origin, origin, true));
 }
 
 Flight3DView::~Flight3DView()
 {
-    // Clean up OpenGL resources if needed
+    // GL objects belong to the widget's context
+    makeCurrent();
+    releaseGL();
+    doneCurrent();
 }
 
-void Flight3DView::updateAircraftState(const double position[3], const double orientation[3])
+Flight3DView::AircraftInstance Flight3DView::makeInstance(const double position[3], const double orientation[3],
+                                                          bool primary)
 {
-    // Convert double arrays to Qt types
-    m_aircraftPosition = QVector3D(
-        static_cast<float>(position[0]),    // North
-        static_cast<float>(position[1]),    // East
-        static_cast<float>(-position[2])    // Down -> Up (invert for OpenGL)
-    );
-    
     // Convert Euler angles to quaternion
     // Note: Order matters here - we're converting from aerospace conventions (roll, pitch, yaw)
     // to OpenGL coordinate system
-    QQuaternion rollQuat = QQuaternion::fromAxisAndAngle(
-        QVector3D(1.0f, 0.0f, 0.0f),
-        static_cast<float>(orientation[0] * 180.0f / M_PI)
-    );
-    
-    QQuaternion pitchQuat = QQuaternion::fromAxisAndAngle(
-        QVector3D(0.0f, 1.0f, 0.0f),
-        static_cast<float>(orientation[1] * 180.0f / M_PI)
-    );
-    
-    QQuaternion yawQuat = QQuaternion::fromAxisAndAngle(
-        QVector3D(0.0f, 0.0f, 1.0f),
-        static_cast<float>(orientation[2] * 180.0f / M_PI)
-    );
+    const QQuaternion rollQuat = QQuaternion::fromAxisAndAngle(
+        QVector3D(1.0f, 0.0f, 0.0f), static_cast<float>(orientation[0] * 180.0 / M_PI));
+    const QQuaternion pitchQuat = QQuaternion::fromAxisAndAngle(
+        QVector3D(0.0f, 1.0f, 0.0f), static_cast<float>(orientation[1] * 180.0 / M_PI));
+    const QQuaternion yawQuat = QQuaternion::fromAxisAndAngle(
+        QVector3D(0.0f, 0.0f, 1.0f), static_cast<float>(orientation[2] * 180.0 / M_PI));
     
     // Combine rotations (note order: yaw, pitch, roll)
-    m_aircraftOrientation = yawQuat * pitchQuat * rollQuat;
+    const QQuaternion attitude = yawQuat * pitchQuat * rollQuat;
+    
+    AircraftInstance instance;
+    instance.position[0] = static_cast<float>(position[0]);  // North
+    instance.position[1] = static_cast<float>(position[1]);  // East
+    instance.position[2] = static_cast<float>(-position[2]); // Down -> Up (invert for OpenGL)
+    instance.position[3] = primary ? 1.0f : 0.0f;
+    instance.rotation[0] = attitude.x();
+    instance.rotation[1] = attitude.y();
+    instance.rotation[2] = attitude.z();
+    instance.rotation[3] = attitude.scalar();
+    return instance;
+}
+
+void Flight3DView::updateAircraftState(const double position[3], const double orientation[3])
+{
+    m_instances[0] = makeInstance(position, orientation, true);
+    m_aircraftPosition = QVector3D(m_instances[0].position[0], m_instances[0].position[1], m_instances[0].position[2]);
+    m_aircraftOrientation = QQuaternion(m_instances[0].rotation[3], m_instances[0].rotation[0],
+                                        m_instances[0].rotation[1], m_instances[0].rotation[2]);
+    m_instancesDirty = true;
+    
+    // Extend the trail; it is uploaded with the next frame
+    if (m_trailSize == 0 || (m_aircraftPosition - m_lastTrailPoint).lengthSquared() > kTrailMinSpacing * kTrailMinSpacing) {
+        // Hidden widgets do not paint; only the newest points can reach the ring anyway
+        if (m_pendingTrailPoints.size() >= 2 * static_cast<std::size_t>(kTrailCapacity)) {
+            m_pendingTrailPoints.erase(m_pendingTrailPoints.begin(), m_pendingTrailPoints.begin() + kTrailCapacity);
+        }
+        m_pendingTrailPoints.push_back(m_aircraftPosition);
+        m_lastTrailPoint = m_aircraftPosition;
+        m_trailSize = std::min(m_trailSize + 1, kTrailCapacity);
+    }
     
     // Update the view to show new position
     update();
 }
 
-void Flight3DView::initializeGL()
+void Flight3DView::updateVehicleState(std::uint32_t vehicleId, const double position[3], const double orientation[3])
 {
-    // Initialize OpenGL functions
-    m_glFunctions = QOpenGLVersionFunctionsFactory::get<QOpenGLFunctions_2_1>(QOpenGLContext::currentContext());
-    if (!m_glFunctions) {
-        qWarning("Could not obtain OpenGL 2.1 functions");
-        return;
+    auto it = m_vehicleSlots.find(vehicleId);
+    if (it == m_vehicleSlots.end()) {
+        it = m_vehicleSlots.emplace(vehicleId, m_instances.size()).first;
+        m_instances.emplace_back();
     }
+    m_instances[it->second] = makeInstance(position, orientation, false);
+    m_instancesDirty = true;
+    update();
+}
+
+void Flight3DView::clearVehicles()
+{
+    m_instances.resize(1);
+    m_vehicleSlots.clear();
+    m_instancesDirty = true;
     
-    m_glFunctions->initializeOpenGLFunctions();
+    m_pendingTrailPoints.clear();
+    m_trailHead = 0;
+    m_trailSize = 0;
+    update();
+}
+
+void Flight3DView::initializeGL()
+{
+    // Resolve the OpenGL 3.3 entry points of the current context
+    initializeOpenGLFunctions();
     
     // Set clear color (dark blue-gray)
-    m_glFunctions->glClearColor(0.2f, 0.2f, 0.3f, 1.0f);
+    glClearColor(0.2f, 0.2f, 0.3f, 1.0f);
     
     // Enable depth testing for 3D rendering
-    m_glFunctions->glEnable(GL_DEPTH_TEST);
+    glEnable(GL_DEPTH_TEST);
+    
+    createPrograms();
+    if (!m_aircraftProgram.isLinked() || !m_lineProgram.isLinked()) {
+        qWarning("Could not build the 3D view shaders; OpenGL 3.3 core is required");
+        return;
+    }
+    
+    // Static geometry is uploaded once; only instances and new trail points move afterwards
+    createAircraftGeometry();
+    createSceneGeometry();
+    createTrailBuffer();
+    m_glReady = true;
     
     // Initialize matrices
     updateMatrices();
@@ -79,38 +193,34 @@ void Flight3DView::initializeGL()
 
 void Flight3DView::paintGL()
 {
-    if (!m_glFunctions) return;
+    FALCONSIM_TRACE_ZONE("Flight3DView::paintGL");
+    if (!m_glReady) {
+        return;
+    }
 
     // Clear the color and depth buffers
-    m_glFunctions->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     // Update matrices based on current state
     updateMatrices();
     
-    // Set up view and projection matrices
-    m_glFunctions->glMatrixMode(GL_PROJECTION);
-    m_glFunctions->glLoadMatrixf(m_projectionMatrix.constData());
+    // Push whatever changed since the last frame
+    uploadInstances();
+    uploadTrail();
     
-    m_glFunctions->glMatrixMode(GL_MODELVIEW);
-    m_glFunctions->glLoadMatrixf(m_viewMatrix.constData());
-    
-    // Draw the aircraft, grid, and axes
+    // Draw the grid, axes, trail and aircraft
     drawGrid();
     drawAxes();
+    drawTrail();
     drawAircraft();
 }
 
 void Flight3DView::resizeGL(int width, int height)
 {
-    if (!m_glFunctions) return;
-
-    // Update viewport
-    m_glFunctions->glViewport(0, 0, width, height);
-    
     // Update projection matrix with new aspect ratio
-    float aspect = static_cast<float>(width) / static_cast<float>(height);
+    float aspect = static_cast<float>(width) / static_cast<float>(std::max(height, 1));
     m_projectionMatrix.setToIdentity();
-    m_projectionMatrix.perspective(m_cameraFOV, aspect, 0.1f, 100.0f);
+    m_projectionMatrix.perspective(m_cameraFOV, aspect, 0.1f, 1000.0f);
 }
 
 void Flight3DView::mousePressEvent(QMouseEvent *event)
@@ -217,159 +327,261 @@ void Flight3DView::updateMatrices()
     // Update view matrix based on camera position
     m_viewMatrix.setToIdentity();
     m_viewMatrix.lookAt(m_cameraPosition, m_cameraTarget, m_cameraUp);
+}
     
-    // Update model matrix based on aircraft position and orientation
-    m_modelMatrix.setToIdentity();
-    m_modelMatrix.translate(m_aircraftPosition);
-    m_modelMatrix.rotate(m_aircraftOrientation);
+void Flight3DView::createPrograms()
+{
+    m_aircraftProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, kAircraftVertexShader);
+    m_aircraftProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, kFragmentShader);
+    m_aircraftProgram.link();
+    
+    m_lineProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, kLineVertexShader);
+    m_lineProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, kFragmentShader);
+    m_lineProgram.link();
 }
 
-void Flight3DView::drawAircraft()
+void Flight3DView::createAircraftGeometry()
 {
-    if (!m_glFunctions) return;
-    
-    // Basic aircraft model using OpenGL primitives
-    // Save current matrix
-    m_glFunctions->glPushMatrix();
-    
-    // Apply model matrix for aircraft position and orientation
-    QMatrix4x4 mvMatrix = m_viewMatrix * m_modelMatrix;
-    m_glFunctions->glLoadMatrixf(mvMatrix.constData());
-    
-    // Draw a simple aircraft model
-    // This is a simplified aircraft model using basic OpenGL
+    // Simple aircraft model as triangles
     // In a real application, you would use proper 3D models
+    std::vector<Vertex> vertices;
+    const auto quad = [&vertices](const QVector3D &a, const QVector3D &b, const QVector3D &c, const QVector3D &d,
+                                  const QVector3D &color) {
+        for (const QVector3D *corner : {&a, &b, &c, &a, &c, &d}) {
+            vertices.push_back(Vertex{{corner->x(), corner->y(), corner->z()}, {color.x(), color.y(), color.z()}});
+        }
+    };
     
     // Body (fuselage) - blue
-    m_glFunctions->glColor3f(0.2f, 0.4f, 0.8f);
-    m_glFunctions->glBegin(GL_QUADS);
-    // Top
-    m_glFunctions->glVertex3f(-0.5f, 1.0f, 0.25f);
-    m_glFunctions->glVertex3f(0.5f, 1.0f, 0.25f);
-    m_glFunctions->glVertex3f(0.5f, -1.0f, 0.25f);
-    m_glFunctions->glVertex3f(-0.5f, -1.0f, 0.25f);
-    
-    // Bottom
-    m_glFunctions->glVertex3f(-0.5f, -1.0f, -0.25f);
-    m_glFunctions->glVertex3f(0.5f, -1.0f, -0.25f);
-    m_glFunctions->glVertex3f(0.5f, 1.0f, -0.25f);
-    m_glFunctions->glVertex3f(-0.5f, 1.0f, -0.25f);
-    
-    // Left
-    m_glFunctions->glVertex3f(-0.5f, 1.0f, 0.25f);
-    m_glFunctions->glVertex3f(-0.5f, -1.0f, 0.25f);
-    m_glFunctions->glVertex3f(-0.5f, -1.0f, -0.25f);
-    m_glFunctions->glVertex3f(-0.5f, 1.0f, -0.25f);
-    
-    // Right
-    m_glFunctions->glVertex3f(0.5f, 1.0f, -0.25f);
-    m_glFunctions->glVertex3f(0.5f, -1.0f, -0.25f);
-    m_glFunctions->glVertex3f(0.5f, -1.0f, 0.25f);
-    m_glFunctions->glVertex3f(0.5f, 1.0f, 0.25f);
-    
-    // Front
-    m_glFunctions->glVertex3f(-0.5f, -1.0f, 0.25f);
-    m_glFunctions->glVertex3f(0.5f, -1.0f, 0.25f);
-    m_glFunctions->glVertex3f(0.5f, -1.0f, -0.25f);
-    m_glFunctions->glVertex3f(-0.5f, -1.0f, -0.25f);
-    
-    // Back
-    m_glFunctions->glVertex3f(-0.5f, 1.0f, -0.25f);
-    m_glFunctions->glVertex3f(0.5f, 1.0f, -0.25f);
-    m_glFunctions->glVertex3f(0.5f, 1.0f, 0.25f);
-    m_glFunctions->glVertex3f(-0.5f, 1.0f, 0.25f);
-    m_glFunctions->glEnd();
+    const QVector3D body(0.2f, 0.4f, 0.8f);
+    quad({-0.5f, 1.0f, 0.25f}, {0.5f, 1.0f, 0.25f}, {0.5f, -1.0f, 0.25f}, {-0.5f, -1.0f, 0.25f}, body);      // Top
+    quad({-0.5f, -1.0f, -0.25f}, {0.5f, -1.0f, -0.25f}, {0.5f, 1.0f, -0.25f}, {-0.5f, 1.0f, -0.25f}, body);  // Bottom
+    quad({-0.5f, 1.0f, 0.25f}, {-0.5f, -1.0f, 0.25f}, {-0.5f, -1.0f, -0.25f}, {-0.5f, 1.0f, -0.25f}, body);  // Left
+    quad({0.5f, 1.0f, -0.25f}, {0.5f, -1.0f, -0.25f}, {0.5f, -1.0f, 0.25f}, {0.5f, 1.0f, 0.25f}, body);      // Right
+    quad({-0.5f, -1.0f, 0.25f}, {0.5f, -1.0f, 0.25f}, {0.5f, -1.0f, -0.25f}, {-0.5f, -1.0f, -0.25f}, body);  // Front
+    quad({-0.5f, 1.0f, -0.25f}, {0.5f, 1.0f, -0.25f}, {0.5f, 1.0f, 0.25f}, {-0.5f, 1.0f, 0.25f}, body);      // Back
     
     // Wings - gray
-    m_glFunctions->glColor3f(0.7f, 0.7f, 0.7f);
-    m_glFunctions->glBegin(GL_QUADS);
-    // Main wing
-    m_glFunctions->glVertex3f(-3.0f, -0.2f, 0.0f);
-    m_glFunctions->glVertex3f(3.0f, -0.2f, 0.0f);
-    m_glFunctions->glVertex3f(3.0f, 0.2f, 0.0f);
-    m_glFunctions->glVertex3f(-3.0f, 0.2f, 0.0f);
-    
-    // Tail horizontal stabilizer
-    m_glFunctions->glVertex3f(-1.0f, 0.9f, 0.0f);
-    m_glFunctions->glVertex3f(1.0f, 0.9f, 0.0f);
-    m_glFunctions->glVertex3f(1.0f, 1.1f, 0.0f);
-    m_glFunctions->glVertex3f(-1.0f, 1.1f, 0.0f);
-    m_glFunctions->glEnd();
+    const QVector3D wing(0.7f, 0.7f, 0.7f);
+    quad({-3.0f, -0.2f, 0.0f}, {3.0f, -0.2f, 0.0f}, {3.0f, 0.2f, 0.0f}, {-3.0f, 0.2f, 0.0f}, wing);  // Main wing
+    quad({-1.0f, 0.9f, 0.0f}, {1.0f, 0.9f, 0.0f}, {1.0f, 1.1f, 0.0f}, {-1.0f, 1.1f, 0.0f}, wing);    // Horizontal stabilizer
     
     // Tail vertical stabilizer - red
-    m_glFunctions->glColor3f(0.8f, 0.2f, 0.2f);
-    m_glFunctions->glBegin(GL_TRIANGLES);
-    m_glFunctions->glVertex3f(0.0f, 0.9f, 0.0f);
-    m_glFunctions->glVertex3f(0.0f, 1.1f, 0.0f);
-    m_glFunctions->glVertex3f(0.0f, 1.0f, 0.5f);
-    m_glFunctions->glEnd();
-    
-    // Restore matrix
-    m_glFunctions->glPopMatrix();
+    const QVector3D tail(0.8f, 0.2f, 0.2f);
+    for (const QVector3D &corner : {QVector3D(0.0f, 0.9f, 0.0f), QVector3D(0.0f, 1.1f, 0.0f), QVector3D(0.0f, 1.0f, 0.5f)}) {
+        vertices.push_back(Vertex{{corner.x(), corner.y(), corner.z()}, {tail.x(), tail.y(), tail.z()}});
+    }
+    m_aircraftVertexCount = static_cast<int>(vertices.size());
+    
+    m_aircraftVao.create();
+    m_aircraftVao.bind();
+    
+    m_aircraftMesh.create();
+    m_aircraftMesh.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_aircraftMesh.bind();
+    m_aircraftMesh.allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(Vertex)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, color)));
+    
+    // Per-instance position and attitude advance once per aircraft, not per vertex
+    m_instanceBuffer.create();
+    m_instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_instanceBuffer.bind();
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(AircraftInstance),
+                          reinterpret_cast<const void *>(offsetof(AircraftInstance, position)));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(AircraftInstance),
+                          reinterpret_cast<const void *>(offsetof(AircraftInstance, rotation)));
+    glVertexAttribDivisor(3, 1);
+    
+    m_aircraftVao.release();
+    m_instancesDirty = true;
 }
 
-void Flight3DView::drawGrid()
+void Flight3DView::createSceneGeometry()
 {
-    if (!m_glFunctions) return;
-
-    // Draw a reference grid
-    m_glFunctions->glPushMatrix();
+    std::vector<Vertex> vertices;
+    const auto line = [&vertices](const QVector3D &from, const QVector3D &to, const QVector3D &color) {
+        vertices.push_back(Vertex{{from.x(), from.y(), from.z()}, {color.x(), color.y(), color.z()}});
+        vertices.push_back(Vertex{{to.x(), to.y(), to.z()}, {color.x(), color.y(), color.z()}});
+    };
     
-    // Set grid color (light gray)
-    m_glFunctions->glColor3f(0.7f, 0.7f, 0.7f);
+    // Reference grid (light gray), 1 m spacing
+    const float gridSize = 10.0f;
+    const int gridLines = 20;
+    const QVector3D gridColor(0.7f, 0.7f, 0.7f);
+    for (int i = 0; i <= gridLines; ++i) {
+        const float offset = -gridSize + static_cast<float>(i) * (2.0f * gridSize / gridLines);
+        line({offset, -gridSize, 0.0f}, {offset, gridSize, 0.0f}, gridColor); // North-south lines (along X axis)
+        line({-gridSize, offset, 0.0f}, {gridSize, offset, 0.0f}, gridColor); // East-west lines (along Y axis)
+    }
+    m_gridVertexCount = static_cast<int>(vertices.size());
+    
+    // Coordinate axes: X red (North), Y green (East), Z blue (Up)
+    line({0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f});
+    line({0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    line({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f});
+    m_axesVertexCount = static_cast<int>(vertices.size()) - m_gridVertexCount;
+    
+    m_sceneVao.create();
+    m_sceneVao.bind();
+    m_sceneLines.create();
+    m_sceneLines.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_sceneLines.bind();
+    m_sceneLines.allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(Vertex)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, color)));
+    m_sceneVao.release();
+}
+
+void Flight3DView::createTrailBuffer()
+{
+    m_trailVao.create();
+    m_trailVao.bind();
+    m_trailBuffer.create();
+    m_trailBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_trailBuffer.bind();
+    m_trailBuffer.allocate((kTrailCapacity + 1) * static_cast<int>(sizeof(QVector3D)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QVector3D), nullptr);
+    m_trailVao.release();
+    
+    // Points recorded before the context existed are still in the pending list
+    m_trailHead = 0;
+    m_trailSize = std::min(static_cast<int>(m_pendingTrailPoints.size()), kTrailCapacity);
+}
+
+void Flight3DView::uploadInstances()
+{
+    if (!m_instancesDirty) {
+        return;
+    }
+    m_instancesDirty = false;
+    
+    m_instanceBuffer.bind();
+    const int bytes = static_cast<int>(m_instances.size() * sizeof(AircraftInstance));
+    if (static_cast<int>(m_instances.size()) > m_instanceCapacity) {
+        // Grow geometrically so a growing swarm reallocates rarely
+        m_instanceCapacity = std::max<int>(static_cast<int>(m_instances.size()), 2 * m_instanceCapacity);
+        m_instanceBuffer.allocate(m_instanceCapacity * static_cast<int>(sizeof(AircraftInstance)));
+    } else {
+        // Orphan the old storage so the driver need not wait for the previous frame
+        m_instanceBuffer.allocate(m_instanceCapacity * static_cast<int>(sizeof(AircraftInstance)));
+    }
+    m_instanceBuffer.write(0, m_instances.data(), bytes);
+    m_instanceBuffer.release();
+}
+
+void Flight3DView::uploadTrail()
+{
+    if (m_pendingTrailPoints.empty()) {
+        return;
+    }
     
-    // Draw grid lines
-    m_glFunctions->glBegin(GL_LINES);
+    // Only the newest kTrailCapacity points can survive
+    const std::size_t keep = std::min<std::size_t>(m_pendingTrailPoints.size(), kTrailCapacity);
+    const QVector3D *points = m_pendingTrailPoints.data() + (m_pendingTrailPoints.size() - keep);
+    
+    m_trailBuffer.bind();
+    const int stride = static_cast<int>(sizeof(QVector3D));
+    for (std::size_t written = 0; written < keep;) {
+        // Contiguous run up to the end of the ring
+        const int run = static_cast<int>(std::min<std::size_t>(keep - written, kTrailCapacity - m_trailHead));
+        m_trailBuffer.write(m_trailHead * stride, points + written, run * stride);
+        if (m_trailHead == 0) {
+            m_trailBuffer.write(kTrailCapacity * stride, points + written, stride);
+        }
+        m_trailHead = (m_trailHead + run) % kTrailCapacity;
+        written += static_cast<std::size_t>(run);
+    }
+    m_trailBuffer.release();
+    m_pendingTrailPoints.clear();
+}
+
+void Flight3DView::drawAircraft()
+{
+    m_aircraftProgram.bind();
+    m_aircraftProgram.setUniformValue("u_viewProjection", m_projectionMatrix * m_viewMatrix);
+    m_aircraftVao.bind();
     
-    // Grid size and spacing
-    const float gridSize = 10.0f;
-    const float gridStep = 1.0f;
+    // One draw call for the whole swarm
+    glDrawArraysInstanced(GL_TRIANGLES, 0, m_aircraftVertexCount, static_cast<GLsizei>(m_instances.size()));
     
-    // Draw north-south lines (along X axis)
-    for (float x = -gridSize; x <= gridSize; x += gridStep) {
-        m_glFunctions->glVertex3f(x, -gridSize, 0.0f);
-        m_glFunctions->glVertex3f(x, gridSize, 0.0f);
+    m_aircraftVao.release();
+    m_aircraftProgram.release();
+}
+
+void Flight3DView::drawGrid()
+{
+    m_lineProgram.bind();
+    m_lineProgram.setUniformValue("u_viewProjection", m_projectionMatrix * m_viewMatrix);
+    m_sceneVao.bind();
+    glDrawArrays(GL_LINES, 0, m_gridVertexCount);
+    m_sceneVao.release();
+    m_lineProgram.release();
+}
+
+void Flight3DView::drawAxes()
+{
+    m_lineProgram.bind();
+    m_lineProgram.setUniformValue("u_viewProjection", m_projectionMatrix * m_viewMatrix);
+    m_sceneVao.bind();
+    glDrawArrays(GL_LINES, m_gridVertexCount, m_axesVertexCount);
+    m_sceneVao.release();
+    m_lineProgram.release();
+}
+
+void Flight3DView::drawTrail()
+{
+    if (m_trailSize < 2) {
+        return;
     }
     
-    // Draw east-west lines (along Y axis)
-    for (float y = -gridSize; y <= gridSize; y += gridStep) {
-        m_glFunctions->glVertex3f(-gridSize, y, 0.0f);
-        m_glFunctions->glVertex3f(gridSize, y, 0.0f);
+    m_lineProgram.bind();
+    m_lineProgram.setUniformValue("u_viewProjection", m_projectionMatrix * m_viewMatrix);
+    m_trailVao.bind();
+    
+    // The trail has no color array; attribute 1 falls back to this constant
+    glVertexAttrib3f(1, kTrailColor.x(), kTrailColor.y(), kTrailColor.z());
+    
+    if (m_trailSize < kTrailCapacity) {
+        glDrawArrays(GL_LINE_STRIP, 0, m_trailSize);
+    } else if (m_trailHead == 0) {
+        // Oldest point in slot 0, newest in the last slot; the mirror would close the loop
+        glDrawArrays(GL_LINE_STRIP, 0, kTrailCapacity);
+    } else {
+        // Oldest point first: [head, capacity] ends on the mirror of slot 0, then [0, head)
+        glDrawArrays(GL_LINE_STRIP, m_trailHead, kTrailCapacity + 1 - m_trailHead);
+        if (m_trailHead > 1) {
+            glDrawArrays(GL_LINE_STRIP, 0, m_trailHead);
+        }
     }
     
-    m_glFunctions->glEnd();
-    m_glFunctions->glPopMatrix();
+    m_trailVao.release();
+    m_lineProgram.release();
 }
 
-void Flight3DView::drawAxes()
+void Flight3DView::releaseGL()
 {
-    if (!m_glFunctions) return;
-
-    // Draw coordinate axes
-    m_glFunctions->glPushMatrix();
-    
-    // X axis - red (North)
-    m_glFunctions->glColor3f(1.0f, 0.0f, 0.0f);
-    m_glFunctions->glBegin(GL_LINES);
-    m_glFunctions->glVertex3f(0.0f, 0.0f, 0.0f);
-    m_glFunctions->glVertex3f(1.0f, 0.0f, 0.0f);
-    m_glFunctions->glEnd();
-    
-    // Y axis - green (East)
-    m_glFunctions->glColor3f(0.0f, 1.0f, 0.0f);
-    m_glFunctions->glBegin(GL_LINES);
-    m_glFunctions->glVertex3f(0.0f, 0.0f, 0.0f);
-    m_glFunctions->glVertex3f(0.0f, 1.0f, 0.0f);
-    m_glFunctions->glEnd();
-    
-    // Z axis - blue (Up)
-    m_glFunctions->glColor3f(0.0f, 0.0f, 1.0f);
-    m_glFunctions->glBegin(GL_LINES);
-    m_glFunctions->glVertex3f(0.0f, 0.0f, 0.0f);
-    m_glFunctions->glVertex3f(0.0f, 0.0f, 1.0f);
-    m_glFunctions->glEnd();
-    
-    m_glFunctions->glPopMatrix();
+    if (!m_glReady) {
+        return;
+    }
+    m_glReady = false;
+    m_aircraftMesh.destroy();
+    m_instanceBuffer.destroy();
+    m_sceneLines.destroy();
+    m_trailBuffer.destroy();
+    m_aircraftVao.destroy();
+    m_sceneVao.destroy();
+    m_trailVao.destroy();
+    m_aircraftProgram.removeAllShaders();
+    m_lineProgram.removeAllShaders();
 }
 
 QVector3D Flight3DView::colorToVector(const QColor& color) const
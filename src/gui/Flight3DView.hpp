@@ -1,22 +1,34 @@
 #pragma once
 
 #include <QOpenGLWidget>
-#include <QOpenGLFunctions>
-// Add the compatibility header for Qt6
-#include <QOpenGLFunctions_2_1>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
 #include <QMatrix4x4>
 #include <QVector3D>
 #include <QQuaternion>
 #include <QTimer>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @brief 3D visualization widget for the UAV
  * 
  * This widget provides a 3D visualization of the UAV using OpenGL.
  * It shows the aircraft model, attitude, and position in 3D space.
+ *
+ * Rendering is retained-mode (OpenGL 3.3 core). The aircraft mesh, grid and
+ * axes are uploaded once in initializeGL(). Every aircraft is one instance:
+ * a position and an attitude quaternion in a per-instance buffer, which is
+ * re-uploaded only when a state changed. One instanced draw call covers the
+ * whole swarm. The flight path of the primary aircraft lives in a
+ * fixed-size GPU ring buffer, and each new point costs one small
+ * glBufferSubData.
  */
-class Flight3DView : public QOpenGLWidget {
+class Flight3DView : public QOpenGLWidget, protected QOpenGLExtraFunctions {
     Q_OBJECT
 
 public:
@@ -24,11 +36,25 @@ public:
     ~Flight3DView();
     
     /**
-     * Update the aircraft state
+     * Update the primary aircraft state (highlighted, and drawn with its trail)
      * @param position Array of 3 doubles [north, east, down]
      * @param orientation Array of 3 doubles [roll, pitch, yaw] in radians
      */
     void updateAircraftState(const double position[3], const double orientation[3]);
+    
+    /**
+     * Update another aircraft of a swarm (added on first sight)
+     * @param vehicleId Vehicle id from the telemetry stream
+     * @param position Array of 3 doubles [north, east, down]
+     * @param orientation Array of 3 doubles [roll, pitch, yaw] in radians
+     */
+    void updateVehicleState(std::uint32_t vehicleId, const double position[3], const double orientation[3]);
+    
+    // Forget every aircraft but the primary one, and its trail
+    void clearVehicles();
+    
+    // Number of trail points kept on the GPU
+    static constexpr int kTrailCapacity{8192};
 
 protected:
     // OpenGL initialization and rendering
@@ -43,8 +69,49 @@ protected:
     void wheelEvent(QWheelEvent *event) override;
 
 private:
-    // Add OpenGL compatibility functions
-    QOpenGLFunctions_2_1 *m_glFunctions;
+    /**
+     * @brief Per-instance attributes, as laid out in the instance buffer
+     */
+    struct AircraftInstance {
+        float position[4]; // xyz in view coordinates, w = 1 for the primary aircraft
+        float rotation[4]; // Attitude quaternion (x, y, z, w)
+    };
+    
+    /**
+     * @brief Static vertex: position and color
+     */
+    struct Vertex {
+        float position[3];
+        float color[3];
+    };
+    
+    bool m_glReady{false};
+    
+    // Shaders, static geometry and per-frame buffers
+    QOpenGLShaderProgram m_aircraftProgram{};
+    QOpenGLShaderProgram m_lineProgram{};
+    QOpenGLVertexArrayObject m_aircraftVao{};
+    QOpenGLVertexArrayObject m_sceneVao{};
+    QOpenGLVertexArrayObject m_trailVao{};
+    QOpenGLBuffer m_aircraftMesh{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer m_sceneLines{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer m_instanceBuffer{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer m_trailBuffer{QOpenGLBuffer::VertexBuffer};
+    int m_aircraftVertexCount{0};
+    int m_gridVertexCount{0};
+    int m_axesVertexCount{0};
+    int m_instanceCapacity{0};
+    
+    // Aircraft instances; slot 0 is the primary aircraft
+    std::vector<AircraftInstance> m_instances{};
+    std::unordered_map<std::uint32_t, std::size_t> m_vehicleSlots{};
+    bool m_instancesDirty{true};
+    
+    // Trail ring: slot kTrailCapacity mirrors slot 0 so the wrap draws as one path
+    std::vector<QVector3D> m_pendingTrailPoints{};
+    int m_trailHead{0};
+    int m_trailSize{0};
+    QVector3D m_lastTrailPoint{};
     
     // Aircraft state
     QVector3D m_aircraftPosition{0.0f, 0.0f, 0.0f};
@@ -62,16 +129,26 @@ private:
     bool m_panning{false};
     
     // Rendering matrices
-    QMatrix4x4 m_modelMatrix{};
     QMatrix4x4 m_viewMatrix{};
     QMatrix4x4 m_projectionMatrix{};
     
     // Helper methods
     void updateMatrices();
+    void createPrograms();
+    void createAircraftGeometry();
+    void createSceneGeometry();
+    void createTrailBuffer();
+    void uploadInstances();
+    void uploadTrail();
     void drawAircraft();
     void drawGrid();
     void drawAxes();
+    void drawTrail();
+    void releaseGL();
+    
+    // Conversion from NED position and Euler angles to view coordinates
+    static AircraftInstance makeInstance(const double position[3], const double orientation[3], bool primary);
     
     // Color helpers
     QVector3D colorToVector(const QColor& color) const;
-}; 
\ No newline at end of file
+}; 
@@ -3,27 +3,42 @@
 #include "TelemetryWidget.hpp"
 #include "ControlPanel.hpp"
 #include "Flight3DView.hpp"
+#include "core/Trace.hpp"
+#include "network/SharedTelemetry.hpp"
+#include "network/TelemetryReceiver.hpp"
+#include "recording/FlightLogReader.hpp"
 
-#include <QUdpSocket>
+#include <QHostAddress>
 #include <QMessageBox>
 #include <QDebug>
 #include <QDockWidget>
 #include <QStatusBar>
 #include <QSettings>
 #include <QCloseEvent>
+#include <QFileDialog>
+#include <QSlider>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , m_socket(new QUdpSocket(this))
 {
+    FALCONSIM_TRACE_THREAD_NAME("gui");
     ui->setupUi(this);
     setupUi();
     setupConnections();
     
-    // Set up update timer
+    // Set up the frame timer: telemetry is sampled and displays redrawn at most once per refresh,
+    // however fast packets or slider events arrive
+    const QScreen *screen = QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60.0;
     connect(&m_updateTimer, &QTimer::timeout, this, &MainWindow::onUpdateTimer);
-    m_updateTimer.start(1000 / m_updateRateHz); // 10 Hz default
+    m_updateTimer.setTimerType(Qt::PreciseTimer);
+    m_updateTimer.start(std::max(1, static_cast<int>(1000.0 / refreshRate)));
+    m_simulationClock.start();
     
     // Restore window state
     QSettings settings("FalconSim", "GUI");
@@ -68,6 +83,15 @@ void MainWindow::setupUi()
     controlDock->setWidget(m_controlPanel);
     addDockWidget(Qt::LeftDockWidgetArea, controlDock);
     
+    // Create replay scrubber as dock widget (enabled once a recording is open)
+    QDockWidget *replayDock = new QDockWidget("Replay", this);
+    replayDock->setAllowedAreas(Qt::BottomDockWidgetArea | Qt::TopDockWidgetArea);
+    m_replaySlider = new QSlider(Qt::Horizontal, replayDock);
+    m_replaySlider->setRange(0, kReplaySliderSteps);
+    m_replaySlider->setEnabled(false);
+    replayDock->setWidget(m_replaySlider);
+    addDockWidget(Qt::BottomDockWidgetArea, replayDock);
+    
     // Set window properties
     setWindowTitle("FalconSim - UAV Simulation Framework");
     setMinimumSize(800, 600);
@@ -81,6 +105,12 @@ void MainWindow::setupConnections()
     connect(ui->actionDisconnect, &QAction::triggered, this, &MainWindow::onDisconnectButtonClicked);
     connect(ui->actionExit, &QAction::triggered, this, &QWidget::close);
     
+    // Replay
+    QAction *openRecording = new QAction("Open Recording...", this);
+    ui->menuFile->insertAction(ui->actionExit, openRecording);
+    connect(openRecording, &QAction::triggered, this, &MainWindow::onOpenRecording);
+    connect(m_replaySlider, &QSlider::valueChanged, this, &MainWindow::onReplayScrub);
+    
     // Simulation control
     connect(ui->actionStart, &QAction::triggered, this, &MainWindow::onStartSimulation);
     connect(ui->actionPause, &QAction::triggered, this, &MainWindow::onPauseSimulation);
@@ -93,36 +123,33 @@ void MainWindow::setupConnections()
         connect(m_controlPanel, &ControlPanel::stopSimulation, this, &MainWindow::onStopSimulation);
     }
     
-    // Network connections
-    connect(m_socket, &QUdpSocket::readyRead, this, &MainWindow::onDataReceived);
-    
     // Connect control panel signals to the telemetry server (if local)
     connect(m_controlPanel, &ControlPanel::throttleChanged, [this](double value) {
         // Send control commands to server if needed
         qDebug() << "Throttle:" << value;
         
-        // For testing, update the control value directly
+        // For testing, update the control value directly; the next frame shows it
         m_telemetryData.controls[0] = value;
-        updateDisplays();
+        m_displaysDirty = true;
     });
     
     // Connect other control signals
     connect(m_controlPanel, &ControlPanel::aileronChanged, [this](double value) {
         qDebug() << "Aileron:" << value;
         m_telemetryData.controls[1] = value;
-        updateDisplays();
+        m_displaysDirty = true;
     });
     
     connect(m_controlPanel, &ControlPanel::elevatorChanged, [this](double value) {
         qDebug() << "Elevator:" << value;
         m_telemetryData.controls[2] = value;
-        updateDisplays();
+        m_displaysDirty = true;
     });
     
     connect(m_controlPanel, &ControlPanel::rudderChanged, [this](double value) {
         qDebug() << "Rudder:" << value;
         m_telemetryData.controls[3] = value;
-        updateDisplays();
+        m_displaysDirty = true;
     });
 }
 
@@ -134,13 +161,31 @@ void MainWindow::onConnectButtonClicked()
         return;
     }
     
-    // Bind to any port for receiving
-    if (!m_socket->bind(QHostAddress::Any, 0)) {
-        QMessageBox::critical(this, "Connection Error", 
-            "Could not bind socket: " + m_socket->errorString());
+    // A simulator on this machine can be read straight from shared memory
+    if (openSharedTelemetry()) {
+        m_connected = true;
+        ui->actionConnect->setEnabled(false);
+        ui->actionDisconnect->setEnabled(true);
+        statusBar()->showMessage("Connected to local simulator (shared memory)");
         return;
     }
     
+    // Ask the server to stream binary frames to a receiver thread; the frame timer polls it
+    const QString host = m_serverHost.isEmpty() ? QStringLiteral("127.0.0.1") : m_serverHost;
+    try {
+        m_receiver = std::make_unique<falconsim::TelemetryReceiver>(host.toStdString(), m_serverPort);
+        m_receiver->start();
+    } catch (const std::exception &e) {
+        m_receiver.reset();
+        QMessageBox::critical(this, "Connection Error", QString("Could not connect: %1").arg(e.what()));
+        return;
+    }
+    
+    // Receiver slots start afresh, so does the swarm in the 3D view
+    if (m_flight3DView) {
+        m_flight3DView->clearVehicles();
+    }
+    
     m_connected = true;
     ui->actionConnect->setEnabled(false);
     ui->actionDisconnect->setEnabled(true);
@@ -154,7 +199,9 @@ void MainWindow::onDisconnectButtonClicked()
         return;
     }
     
-    m_socket->close();
+    // The receiver unregisters from the server as it stops
+    m_sharedTelemetry.reset();
+    m_receiver.reset();
     m_connected = false;
     ui->actionConnect->setEnabled(true);
     ui->actionDisconnect->setEnabled(false);
@@ -162,53 +209,46 @@ void MainWindow::onDisconnectButtonClicked()
     statusBar()->showMessage("Disconnected from telemetry server");
 }
 
-void MainWindow::onDataReceived()
+bool MainWindow::readReceivedTelemetry()
 {
-    while (m_socket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(m_socket->pendingDatagramSize());
-        QHostAddress sender;
-        quint16 senderPort;
+    // Each vehicle that changed since the last frame is visited once, with its newest sample
+    FALCONSIM_TRACE_ZONE("MainWindow::readReceivedTelemetry");
+    const std::size_t updated = m_receiver->pollUpdates([this](std::size_t slot, const falconsim::TelemetrySample &sample) {
+        const falconsim::TelemetryData &frame{sample.data};
+        if (slot != 0) {
+            // The first vehicle heard from is the primary one; the rest are drawn as a swarm
+            if (m_flight3DView) {
+                const double position[3]{frame.position_north, frame.position_east, frame.position_down};
+                const double orientation[3]{frame.roll, frame.pitch, frame.yaw};
+                m_flight3DView->updateVehicleState(sample.vehicle_id, position, orientation);
+            }
+            return;
+        }
         
-        m_socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
-        
-        // Process the datagram
-        QString data = QString::fromUtf8(datagram);
-        parseTelemetryData(data);
-    }
-}
-
-void MainWindow::parseTelemetryData(const QString &data)
-{
-    // Parse CSV format from TelemetryServer
-    QStringList fields = data.split(',');
-    if (fields.size() >= 14) {  // Ensure we have enough fields
-        m_telemetryData.timestamp = fields[0].toDouble();
+        m_telemetryData.timestamp = frame.timestamp;
         
         // Position (NED)
-        m_telemetryData.position[0] = fields[1].toDouble();
-        m_telemetryData.position[1] = fields[2].toDouble();
-        m_telemetryData.position[2] = fields[3].toDouble();
-        
+        m_telemetryData.position[0] = frame.position_north;
+        m_telemetryData.position[1] = frame.position_east;
+        m_telemetryData.position[2] = frame.position_down;
+
         // Velocity (body)
-        m_telemetryData.velocity[0] = fields[4].toDouble();
-        m_telemetryData.velocity[1] = fields[5].toDouble();
-        m_telemetryData.velocity[2] = fields[6].toDouble();
+        m_telemetryData.velocity[0] = frame.velocity_x;
+        m_telemetryData.velocity[1] = frame.velocity_y;
+        m_telemetryData.velocity[2] = frame.velocity_z;
         
         // Orientation (euler)
-        m_telemetryData.orientation[0] = fields[7].toDouble();
-        m_telemetryData.orientation[1] = fields[8].toDouble();
-        m_telemetryData.orientation[2] = fields[9].toDouble();
+        m_telemetryData.orientation[0] = frame.roll;
+        m_telemetryData.orientation[1] = frame.pitch;
+        m_telemetryData.orientation[2] = frame.yaw;
         
         // Controls
-        m_telemetryData.controls[0] = fields[10].toDouble();
-        m_telemetryData.controls[1] = fields[11].toDouble();
-        m_telemetryData.controls[2] = fields[12].toDouble();
-        m_telemetryData.controls[3] = fields[13].toDouble();
-        
-        // Update displays immediately if we receive data
-        updateDisplays();
-    }
+        m_telemetryData.controls[0] = frame.throttle;
+        m_telemetryData.controls[1] = frame.aileron;
+        m_telemetryData.controls[2] = frame.elevator;
+        m_telemetryData.controls[3] = frame.rudder;
+    });
+    return updated > 0;
 }
 
 void MainWindow::updateSimulation()
@@ -219,6 +259,7 @@ void MainWindow::updateSimulation()
     
     // Simple physics model - just for demonstration
     const double deltaT = 0.1; // 100 ms simulation step
+    m_displaysDirty = true;
     
     // Update position based on velocity
     m_telemetryData.position[0] += m_telemetryData.velocity[0] * deltaT;
@@ -240,6 +281,108 @@ void MainWindow::updateSimulation()
     m_telemetryData.orientation[2] += (m_telemetryData.controls[3] - m_telemetryData.orientation[2]) * 0.1;
 }
 
+bool MainWindow::openSharedTelemetry()
+{
+    const QHostAddress server(m_serverHost.isEmpty() ? QStringLiteral("127.0.0.1") : m_serverHost);
+    if (!server.isLoopback() && m_serverHost.compare(QStringLiteral("localhost"), Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+    
+    // An empty name in the settings turns the shortcut off
+    QSettings settings("FalconSim", "GUI");
+    const QString name = settings.value("telemetry/sharedMemory",
+                                        QString::fromLatin1(falconsim::shm_wire::kDefaultName)).toString();
+    if (name.isEmpty()) {
+        return false;
+    }
+    
+    try {
+        m_sharedTelemetry = std::make_unique<falconsim::SharedTelemetrySubscriber>(name.toStdString());
+        m_sharedIndex = UINT64_MAX;
+    } catch (const std::exception &e) {
+        qDebug() << "Shared-memory telemetry unavailable, using UDP:" << e.what();
+        return false;
+    }
+    return true;
+}
+
+bool MainWindow::readSharedTelemetry()
+{
+    falconsim::SharedTelemetryRecord record;
+    if (!m_sharedTelemetry->latest(record) || record.index == m_sharedIndex) {
+        return false;
+    }
+    m_sharedIndex = record.index;
+    
+    m_telemetryData.timestamp = record.sim_time;
+    for (int i = 0; i < 3; ++i) {
+        m_telemetryData.position[i] = record.position[i];
+        m_telemetryData.velocity[i] = record.velocity[i];
+        m_telemetryData.orientation[i] = record.euler_angles[i];
+    }
+    m_telemetryData.controls[0] = record.throttle;
+    m_telemetryData.controls[1] = record.aileron;
+    m_telemetryData.controls[2] = record.elevator;
+    m_telemetryData.controls[3] = record.rudder;
+    return true;
+}
+
+void MainWindow::onOpenRecording()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "Open Recording", QString(),
+                                                      "Flight logs (*.fslog);;All files (*)");
+    if (!path.isEmpty()) {
+        openRecording(path);
+    }
+}
+
+void MainWindow::openRecording(const QString &path)
+{
+    try {
+        m_recording = std::make_unique<falconsim::FlightLogReader>(path.toStdString());
+    } catch (const std::exception &e) {
+        QMessageBox::critical(this, "Replay Error", QString("Could not open recording: %1").arg(e.what()));
+        return;
+    }
+    
+    m_replaySlider->setEnabled(!m_recording->empty());
+    m_replaySlider->setValue(0);
+    onReplayScrub(0);
+    statusBar()->showMessage(QString("Replaying %1 (%2 s, %3 steps)%4")
+                                 .arg(path)
+                                 .arg(m_recording->getEndTime() - m_recording->getStartTime(), 0, 'f', 1)
+                                 .arg(m_recording->size())
+                                 .arg(m_recording->wasRecovered() ? " - index rebuilt" : ""));
+}
+
+void MainWindow::onReplayScrub(int position)
+{
+    if (!m_recording || m_recording->empty()) {
+        return;
+    }
+    
+    // Slider position -> timestamp -> record, by binary search in the mapped log
+    const double start = m_recording->getStartTime();
+    const double end = m_recording->getEndTime();
+    const double time = start + (end - start) * position / kReplaySliderSteps;
+    const std::size_t index = std::min(m_recording->seek(time), m_recording->size() - 1);
+    const falconsim::FlightLogRecord record = m_recording->at(index);
+    
+    m_telemetryData.timestamp = record.sim_time;
+    for (int i = 0; i < 3; ++i) {
+        m_telemetryData.position[i] = record.state.position[i];
+        m_telemetryData.velocity[i] = record.state.velocity[i];
+        m_telemetryData.orientation[i] = record.state.euler_angles[i];
+    }
+    m_telemetryData.controls[0] = record.controls.throttle;
+    m_telemetryData.controls[1] = record.controls.aileron;
+    m_telemetryData.controls[2] = record.controls.elevator;
+    m_telemetryData.controls[3] = record.controls.rudder;
+    
+    // Scrubbing can outpace the display; the next frame shows the last position
+    m_displaysDirty = true;
+}
+
 void MainWindow::updateDisplays()
 {
     if (m_telemetryWidget) {
@@ -265,13 +408,28 @@ void MainWindow::updateDisplays()
 
 void MainWindow::onUpdateTimer()
 {
-    // This is called at regular intervals for smooth UI updates
-    // even when telemetry data is not coming in fast enough
+    // This is called once per display refresh; every source is sampled here
+    // and the widgets are redrawn only if something changed
+    
+    // The demo simulation keeps its own rate, independent of the refresh rate
+    const qint64 nowMs = m_simulationClock.elapsed();
+    if (nowMs >= m_simulationDueMs) {
+        updateSimulation();
+        m_simulationDueMs = std::max(m_simulationDueMs + 1000 / m_updateRateHz, nowMs);
+    }
     
-    // Add a call to update the simulation before updating displays
-    updateSimulation();
+    // Newest shared-memory record, or whatever the receiver thread decoded since the last frame
+    if (m_sharedTelemetry && readSharedTelemetry()) {
+        m_displaysDirty = true;
+    }
+    if (m_receiver && readReceivedTelemetry()) {
+        m_displaysDirty = true;
+    }
     
-    updateDisplays();
+    if (m_displaysDirty) {
+        m_displaysDirty = false;
+        updateDisplays();
+    }
 }
 
 void MainWindow::onStartSimulation()
@@ -312,7 +470,7 @@ void MainWindow::onStopSimulation()
     // Reset displays
     TelemetryData resetData;
     m_telemetryData = resetData;
-    updateDisplays();
+    m_displaysDirty = true;
     
     // Update UI state
     ui->actionStart->setEnabled(true);
@@ -326,8 +484,8 @@ void MainWindow::onStopSimulation()
 
 void MainWindow::onUpdateSimulationRate(int value)
 {
-    m_updateRateHz = value;
-    m_updateTimer.setInterval(1000 / m_updateRateHz);
+    // Only the demo simulation follows this rate; displays stay on the refresh timer
+    m_updateRateHz = std::max(1, value);
     
     statusBar()->showMessage(QString("Update rate: %1 Hz").arg(m_updateRateHz));
 } 
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <QMainWindow>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "TelemetryData.hpp"
@@ -14,7 +16,14 @@ class MainWindow;
 class TelemetryWidget;
 class ControlPanel;
 class Flight3DView;
-class QUdpSocket;
+
+class QSlider;
+
+namespace falconsim {
+class SharedTelemetrySubscriber;
+class TelemetryReceiver;
+class FlightLogReader;
+}
 
 /**
  * @brief Main window for the FalconSim GUI application.
@@ -36,11 +45,16 @@ public:
      */
     void connectToServer(const QString &host, quint16 port);
 
+    /**
+     * Open a flight log for replay; the Replay slider scrubs through it
+     * @param path Log written by falconsim::FlightRecorder
+     */
+    void openRecording(const QString &path);
+
 private slots:
     // Network slots
     void onConnectButtonClicked();
     void onDisconnectButtonClicked();
-    void onDataReceived();
     
     // UI interaction slots
     void onStartSimulation();
@@ -48,34 +62,50 @@ private slots:
     void onStopSimulation();
     void onUpdateSimulationRate(int value);
     
-    // Timer for updating UI
+    // Frame timer: the only place displays are refreshed
     void onUpdateTimer();
 
+    // Replay slots
+    void onOpenRecording();
+    void onReplayScrub(int position);
+
 private:
     // UI components
     std::unique_ptr<Ui::MainWindow> ui;
     TelemetryWidget* m_telemetryWidget{nullptr};
     ControlPanel* m_controlPanel{nullptr};
     Flight3DView* m_flight3DView{nullptr};
+    QSlider* m_replaySlider{nullptr};
+    static constexpr int kReplaySliderSteps{10000};
     
     // Network components
-    QUdpSocket* m_socket{nullptr};
+    std::unique_ptr<falconsim::TelemetryReceiver> m_receiver; // Decodes UDP telemetry off the UI thread
     QString m_serverHost;
     quint16 m_serverPort{12345};
     bool m_connected{false};
+    std::unique_ptr<falconsim::SharedTelemetrySubscriber> m_sharedTelemetry; // Same-host shortcut around UDP
     
     // Telemetry data
     TelemetryData m_telemetryData;
+    std::uint64_t m_sharedIndex{UINT64_MAX}; // Newest shared-memory record shown so far
+    bool m_displaysDirty{true};              // Something changed since the last frame
     
     // Simulation parameters
     bool m_simRunning{false};
-    int m_updateRateHz{10};
-    QTimer m_updateTimer;
+    int m_updateRateHz{10};         // Demo simulation steps per second
+    QTimer m_updateTimer;           // Fires once per display refresh
+    QElapsedTimer m_simulationClock;
+    qint64 m_simulationDueMs{0};
+    
+    // Replay (memory-mapped, so hours-long logs are not loaded into RAM)
+    std::unique_ptr<falconsim::FlightLogReader> m_recording;
     
     // Methods
     void setupUi();
     void setupConnections();
-    void parseTelemetryData(const QString &data);
+    bool openSharedTelemetry();
+    bool readSharedTelemetry();
+    bool readReceivedTelemetry();
     void updateDisplays();
     void updateSimulation();
 }; 
\ No newline at end of file
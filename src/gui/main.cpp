@@ -1,10 +1,18 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDebug>
+#include <QSurfaceFormat>
 #include "MainWindow.hpp"
 
 int main(int argc, char *argv[])
 {
+    // The 3D view renders with OpenGL 3.3 core shaders; request it before any context exists
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setDepthBufferSize(24);
+    QSurfaceFormat::setDefaultFormat(format);
+    
     QApplication app(argc, argv);
     app.setApplicationName("FalconSim");
     app.setApplicationDisplayName("FalconSim - UAV Simulation Framework");
@@ -0,0 +1,313 @@
+#include "CompactTelemetry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace falconsim {
+
+namespace {
+
+constexpr std::size_t kFieldCount{9};
+
+// Quantize position, velocity and attitude to their integer steps
+void quantizeFields(const TelemetryData& data, std::int64_t (&fields)[kFieldCount]) {
+    const double values[kFieldCount]{
+        data.position_north, data.position_east, data.position_down,
+        data.velocity_x, data.velocity_y, data.velocity_z,
+        data.roll, data.pitch, data.yaw};
+    for (std::size_t i = 0; i < kFieldCount; ++i) {
+        const double step{i < 3 ? compact_wire::kPositionStep
+                        : i < 6 ? compact_wire::kVelocityStep
+                                : compact_wire::kAngleStep};
+        fields[i] = static_cast<std::int64_t>(std::llround(values[i] / step));
+    }
+}
+
+void dequantizeFields(const std::int64_t (&fields)[kFieldCount], TelemetryData& data) {
+    data.position_north = static_cast<double>(fields[0]) * compact_wire::kPositionStep;
+    data.position_east = static_cast<double>(fields[1]) * compact_wire::kPositionStep;
+    data.position_down = static_cast<double>(fields[2]) * compact_wire::kPositionStep;
+    data.velocity_x = static_cast<double>(fields[3]) * compact_wire::kVelocityStep;
+    data.velocity_y = static_cast<double>(fields[4]) * compact_wire::kVelocityStep;
+    data.velocity_z = static_cast<double>(fields[5]) * compact_wire::kVelocityStep;
+    data.roll = static_cast<double>(fields[6]) * compact_wire::kAngleStep;
+    data.pitch = static_cast<double>(fields[7]) * compact_wire::kAngleStep;
+    data.yaw = static_cast<double>(fields[8]) * compact_wire::kAngleStep;
+}
+
+/**
+ * @brief Bounds-checked byte cursor over a frame buffer
+ */
+class Writer {
+public:
+    Writer(std::uint8_t* out, std::size_t capacity) : m_out{out}, m_capacity{capacity} {}
+    
+    void byte(std::uint8_t value) {
+        if (m_size < m_capacity) {
+            m_out[m_size] = value;
+        }
+        ++m_size;
+    }
+    
+    void varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            byte(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        byte(static_cast<std::uint8_t>(value));
+    }
+    
+    void zigzag(std::int64_t value) {
+        varint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+    
+    void float64(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; ++i) {
+            byte(static_cast<std::uint8_t>(bits >> (8 * i)));
+        }
+    }
+    
+    // Size written, or 0 if the frame overflowed the buffer
+    [[nodiscard]] std::size_t size() const { return m_size <= m_capacity ? m_size : 0; }
+
+private:
+    std::uint8_t* m_out;
+    std::size_t m_capacity;
+    std::size_t m_size{0};
+};
+
+class Reader {
+public:
+    Reader(const std::uint8_t* in, std::size_t size) : m_in{in}, m_size{size} {}
+    
+    bool byte(std::uint8_t& value) {
+        if (m_offset >= m_size) {
+            return false;
+        }
+        value = m_in[m_offset++];
+        return true;
+    }
+    
+    bool varint(std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t b;
+            if (!byte(b)) {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool zigzag(std::int64_t& value) {
+        std::uint64_t raw;
+        if (!varint(raw)) {
+            return false;
+        }
+        value = static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+        return true;
+    }
+    
+    bool float64(double& value) {
+        std::uint64_t bits{0};
+        for (int i = 0; i < 8; ++i) {
+            std::uint8_t b;
+            if (!byte(b)) {
+                return false;
+            }
+            bits |= static_cast<std::uint64_t>(b) << (8 * i);
+        }
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+private:
+    const std::uint8_t* m_in;
+    std::size_t m_size;
+    std::size_t m_offset{0};
+};
+
+void writeControls(Writer& writer, const TelemetryData& data) {
+    const auto surface = [](double value) {
+        const long q{std::lround(std::max(-1.0, std::min(value, 1.0)) * 127.0)};
+        return static_cast<std::uint8_t>(static_cast<std::int8_t>(q));
+    };
+    writer.byte(static_cast<std::uint8_t>(std::lround(std::max(0.0, std::min(data.throttle, 1.0)) * 255.0)));
+    writer.byte(surface(data.aileron));
+    writer.byte(surface(data.elevator));
+    writer.byte(surface(data.rudder));
+}
+
+bool readControls(Reader& reader, TelemetryData& data) {
+    std::uint8_t bytes[4];
+    for (auto& b : bytes) {
+        if (!reader.byte(b)) {
+            return false;
+        }
+    }
+    data.throttle = bytes[0] / 255.0;
+    data.aileron = static_cast<std::int8_t>(bytes[1]) / 127.0;
+    data.elevator = static_cast<std::int8_t>(bytes[2]) / 127.0;
+    data.rudder = static_cast<std::int8_t>(bytes[3]) / 127.0;
+    return true;
+}
+
+} // namespace
+
+bool isCompactTelemetryFrame(const std::uint8_t* bytes, std::size_t size) {
+    return bytes && size >= compact_wire::kHeaderSize && bytes[0] == compact_wire::kMarker;
+}
+
+CompactTelemetryEncoder::CompactTelemetryEncoder(std::uint32_t keyframeInterval)
+    : m_keyframeInterval{std::max<std::uint32_t>(1, keyframeInterval)} {
+}
+
+void CompactTelemetryEncoder::setKeyframeInterval(std::uint32_t interval) {
+    m_keyframeInterval = std::max<std::uint32_t>(1, interval);
+}
+
+std::uint32_t CompactTelemetryEncoder::getKeyframeInterval() const {
+    return m_keyframeInterval;
+}
+
+void CompactTelemetryEncoder::forceKeyframe() {
+    for (auto& stream : m_streams) {
+        stream.needsKeyframe = true;
+    }
+}
+
+CompactTelemetryEncoder::VehicleStream& CompactTelemetryEncoder::streamFor(std::uint32_t vehicleId) {
+    auto it = std::find_if(m_streams.begin(), m_streams.end(),
+                           [vehicleId](const VehicleStream& s) { return s.vehicleId == vehicleId; });
+    if (it != m_streams.end()) {
+        return *it;
+    }
+    m_streams.push_back(VehicleStream{});
+    m_streams.back().vehicleId = vehicleId;
+    return m_streams.back();
+}
+
+std::size_t CompactTelemetryEncoder::encode(const TelemetrySample& sample, TelemetryFrameBuffer& frame) {
+    VehicleStream& stream{streamFor(sample.vehicle_id)};
+    std::int64_t fields[kFieldCount];
+    quantizeFields(sample.data, fields);
+    
+    // Deltas whose timestamp offset would not fit comfortably force a keyframe
+    const double offset{(sample.data.timestamp - stream.keyTimestamp) / compact_wire::kTimeStep};
+    const bool keyframe{stream.needsKeyframe || stream.framesSinceKey + 1 >= m_keyframeInterval ||
+                        !(std::fabs(offset) < 1e12)};
+    
+    Writer writer{frame.bytes.data(), frame.bytes.size()};
+    writer.byte(compact_wire::kMarker);
+    writer.byte(static_cast<std::uint8_t>(keyframe ? compact_wire::FrameType::Keyframe
+                                                   : compact_wire::FrameType::Delta));
+    writer.byte(static_cast<std::uint8_t>(m_sequence));
+    writer.byte(static_cast<std::uint8_t>(m_sequence >> 8));
+    ++m_sequence;
+    
+    if (keyframe) {
+        ++stream.keyId;
+        stream.framesSinceKey = 0;
+        stream.needsKeyframe = false;
+        stream.keyTimestamp = sample.data.timestamp;
+        std::copy(std::begin(fields), std::end(fields), stream.keyFields);
+        
+        writer.varint(sample.vehicle_id);
+        writer.byte(stream.keyId);
+        writer.float64(sample.data.timestamp);
+        for (std::int64_t field : fields) {
+            writer.zigzag(field);
+        }
+    } else {
+        ++stream.framesSinceKey;
+        
+        writer.varint(sample.vehicle_id);
+        writer.byte(stream.keyId);
+        writer.zigzag(std::llround(offset));
+        for (std::size_t i = 0; i < kFieldCount; ++i) {
+            writer.zigzag(fields[i] - stream.keyFields[i]);
+        }
+    }
+    writeControls(writer, sample.data);
+    
+    frame.size = writer.size();
+    return frame.size;
+}
+
+bool CompactTelemetryDecoder::decode(const std::uint8_t* bytes, std::size_t size, TelemetrySample& sample) {
+    if (!isCompactTelemetryFrame(bytes, size)) {
+        return false;
+    }
+    
+    Reader reader{bytes + compact_wire::kHeaderSize, size - compact_wire::kHeaderSize};
+    std::uint64_t vehicleId;
+    std::uint8_t keyId;
+    if (!reader.varint(vehicleId) || !reader.byte(keyId)) {
+        return false;
+    }
+    
+    auto key = std::find_if(m_keys.begin(), m_keys.end(),
+                            [vehicleId](const VehicleKey& k) { return k.vehicleId == vehicleId; });
+    
+    TelemetryData data;
+    std::int64_t fields[kFieldCount];
+    
+    if (bytes[1] == static_cast<std::uint8_t>(compact_wire::FrameType::Keyframe)) {
+        if (!reader.float64(data.timestamp)) {
+            return false;
+        }
+        for (auto& field : fields) {
+            if (!reader.zigzag(field)) {
+                return false;
+            }
+        }
+        if (!readControls(reader, data)) {
+            return false;
+        }
+        
+        if (key == m_keys.end()) {
+            m_keys.push_back(VehicleKey{});
+            key = m_keys.end() - 1;
+        }
+        key->vehicleId = static_cast<std::uint32_t>(vehicleId);
+        key->keyId = keyId;
+        key->timestamp = data.timestamp;
+        std::copy(std::begin(fields), std::end(fields), key->fields);
+    } else if (bytes[1] == static_cast<std::uint8_t>(compact_wire::FrameType::Delta)) {
+        // A delta is only usable against the keyframe it was taken from
+        if (key == m_keys.end() || key->keyId != keyId) {
+            return false;
+        }
+        
+        std::int64_t offset;
+        if (!reader.zigzag(offset)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < kFieldCount; ++i) {
+            std::int64_t delta;
+            if (!reader.zigzag(delta)) {
+                return false;
+            }
+            fields[i] = key->fields[i] + delta;
+        }
+        if (!readControls(reader, data)) {
+            return false;
+        }
+        data.timestamp = key->timestamp + static_cast<double>(offset) * compact_wire::kTimeStep;
+    } else {
+        return false;
+    }
+    
+    dequantizeFields(fields, data);
+    sample.vehicle_id = static_cast<std::uint32_t>(vehicleId);
+    sample.data = data;
+    return true;
+}
+
+} // namespace falconsim
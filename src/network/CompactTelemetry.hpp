@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TelemetryCodec.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Quantized keyframe/delta encoding for bandwidth-constrained links
+ *
+ * Compact frames use a 4-byte header instead of the 16-byte binary one:
+ *
+ *   offset  size  field
+ *        0     1  marker (0xFC, never valid CSV text)
+ *        1     1  frame type (1 = keyframe, 2 = delta)
+ *        2     2  sequence number (little-endian, wraps)
+ *
+ * Both frame types continue with a varint vehicle id and a one-byte key id.
+ * A keyframe then carries the timestamp as a little-endian double and the
+ * nine quantized kinematic fields as zigzag varints. A delta frame carries
+ * the timestamp offset in milliseconds and the nine fields, each as a zigzag
+ * varint difference against the keyframe with the same key id. Deltas are
+ * taken against the keyframe rather than the previous frame, so a lost delta
+ * costs nothing and a lost keyframe costs at most one keyframe interval.
+ * Both end with the four controls as single bytes.
+ *
+ * Quantization: position 1 cm, velocity 1 cm/s, angles 0.01°, throttle
+ * 1/255, control surfaces 1/127.
+ */
+namespace compact_wire {
+
+constexpr std::uint8_t kMarker{0xFC};
+constexpr std::size_t kHeaderSize{4};
+
+enum class FrameType : std::uint8_t {
+    Keyframe = 1,
+    Delta = 2
+};
+
+constexpr double kPositionStep{0.01};                               // m
+constexpr double kVelocityStep{0.01};                               // m/s
+constexpr double kAngleStep{0.01 * 3.14159265358979323846 / 180.0}; // rad
+constexpr double kTimeStep{0.001};                                  // s (delta frames)
+
+} // namespace compact_wire
+
+// True if the datagram starts with the compact frame marker
+bool isCompactTelemetryFrame(const std::uint8_t* bytes, std::size_t size);
+
+/**
+ * @brief Stateful encoder: a keyframe every keyframeInterval frames per vehicle, deltas in between
+ */
+class CompactTelemetryEncoder {
+public:
+    explicit CompactTelemetryEncoder(std::uint32_t keyframeInterval = 10);
+    
+    // Encode one sample; returns the frame size
+    std::size_t encode(const TelemetrySample& sample, TelemetryFrameBuffer& frame);
+    
+    // Make the next frame of every vehicle a keyframe (e.g. when a receiver joins)
+    void forceKeyframe();
+    
+    void setKeyframeInterval(std::uint32_t interval);
+    [[nodiscard]] std::uint32_t getKeyframeInterval() const;
+
+private:
+    struct VehicleStream {
+        std::uint32_t vehicleId{0};
+        std::uint8_t keyId{0};
+        std::uint32_t framesSinceKey{0};
+        bool needsKeyframe{true};
+        double keyTimestamp{0.0};
+        std::int64_t keyFields[9]{};
+    };
+    
+    VehicleStream& streamFor(std::uint32_t vehicleId);
+    
+    std::vector<VehicleStream> m_streams{};
+    std::uint32_t m_keyframeInterval{10};
+    std::uint16_t m_sequence{0};
+};
+
+/**
+ * @brief Stateful decoder matching CompactTelemetryEncoder
+ */
+class CompactTelemetryDecoder {
+public:
+    // Decode one frame; false if malformed or its keyframe has not been seen
+    bool decode(const std::uint8_t* bytes, std::size_t size, TelemetrySample& sample);
+
+private:
+    struct VehicleKey {
+        std::uint32_t vehicleId{0};
+        std::uint8_t keyId{0};
+        double timestamp{0.0};
+        std::int64_t fields[9]{};
+    };
+    
+    std::vector<VehicleKey> m_keys{};
+};
+
+} // namespace falconsim
@@ -0,0 +1,531 @@
+#include "DistributedFleet.hpp"
+#include "../core/Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#endif
+
+namespace falconsim {
+
+namespace {
+
+using lockstep_wire::kHeaderSize;
+
+void storeLE(std::uint8_t* out, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint64_t loadLE(const std::uint8_t* in, std::size_t bytes) {
+    std::uint64_t value{0};
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Start a fragment of the given kind in the next free datagram of the outbox; the header is filled in later
+template <typename Outbox>
+std::vector<std::uint8_t>& appendFragment(Outbox& outbox, lockstep_wire::FragmentKind kind) {
+    if (outbox.datagrams.size() == outbox.count) {
+        outbox.datagrams.emplace_back();
+    }
+    std::vector<std::uint8_t>& datagram{outbox.datagrams[outbox.count++]};
+    datagram.assign(kHeaderSize, 0);
+    datagram[5] = static_cast<std::uint8_t>(kind);
+    return datagram;
+}
+
+} // namespace
+
+DistributedFleet::DistributedFleet(const DistributedFleetSettings& settings)
+    : m_settings{settings} {
+    const std::vector<double>& boundaries{settings.boundaries};
+    for (std::size_t i = 0; i < boundaries.size(); ++i) {
+        if (!std::isfinite(boundaries[i]) || (i > 0 && !(boundaries[i] > boundaries[i - 1]))) {
+            throw std::invalid_argument{"Partition boundaries must be finite and strictly ascending"};
+        }
+    }
+    if (settings.node > boundaries.size()) {
+        throw std::invalid_argument{"Distributed fleet node is outside the partitioning"};
+    }
+    if (!(settings.halo >= 0.0)) {
+        throw std::invalid_argument{"Ghost halo must not be negative"};
+    }
+    if (settings.retransmit_interval.count() <= 0 || settings.timeout.count() <= 0) {
+        throw std::invalid_argument{"Retransmit interval and timeout must be positive"};
+    }
+    
+    // This node's slab [lower, upper) and the neighbours on either side
+    constexpr double kInfinity{std::numeric_limits<double>::infinity()};
+    m_lowerBound = settings.node > 0 ? boundaries[settings.node - 1] : -kInfinity;
+    m_upperBound = settings.node < boundaries.size() ? boundaries[settings.node] : kInfinity;
+    Neighbour& lower{neighbour(Side::Lower)};
+    lower.exists = settings.node > 0;
+    lower.node = static_cast<std::uint32_t>(settings.node - (lower.exists ? 1 : 0));
+    Neighbour& upper{neighbour(Side::Upper)};
+    upper.exists = settings.node < boundaries.size();
+    upper.node = static_cast<std::uint32_t>(settings.node + 1);
+    
+    const boost::asio::ip::udp::endpoint local{boost::asio::ip::make_address(settings.bind_address), settings.port};
+    m_socket.open(local.protocol());
+    m_socket.bind(local);
+    m_socket.non_blocking(true);
+    
+    // Room for a neighbour's whole message while this node is still stepping
+    boost::system::error_code ignored;
+    m_socket.set_option(boost::asio::socket_base::receive_buffer_size{1 << 20}, ignored);
+}
+
+void DistributedFleet::setNeighbour(Side side, const std::string& address, std::uint16_t port) {
+    Neighbour& peer{neighbour(side)};
+    if (!peer.exists) {
+        throw std::invalid_argument{"Distributed fleet node has no neighbour on that side"};
+    }
+    peer.endpoint = boost::asio::ip::udp::endpoint{boost::asio::ip::make_address(address), port};
+    peer.connected = true;
+}
+
+bool DistributedFleet::hasNeighbour(Side side) const {
+    return m_neighbours[static_cast<std::size_t>(side)].exists;
+}
+
+std::uint16_t DistributedFleet::getPort() const {
+    return m_socket.local_endpoint().port();
+}
+
+std::size_t DistributedFleet::getNode() const {
+    return m_settings.node;
+}
+
+std::size_t DistributedFleet::getNodeCount() const {
+    return m_settings.boundaries.size() + 1;
+}
+
+std::size_t DistributedFleet::partitionOf(double north) const {
+    const std::vector<double>& boundaries{m_settings.boundaries};
+    return static_cast<std::size_t>(std::upper_bound(boundaries.begin(), boundaries.end(), north) - boundaries.begin());
+}
+
+std::size_t DistributedFleet::addVehicle(std::uint32_t id, const AircraftState& state) {
+    // The turbulence stream follows the global id, so gusts don't depend on which node flies the vehicle
+    const std::size_t index{m_fleet.addVehicle(state)};
+    m_fleet.setTurbulenceStream(index, id);
+    m_ids.push_back(id);
+    m_vehicleCount.store(m_ids.size(), std::memory_order_relaxed);
+    return index;
+}
+
+std::size_t DistributedFleet::addVehicle(std::uint32_t id, const FleetVehicleSnapshot& snapshot) {
+    const std::size_t index{m_fleet.addVehicle(snapshot)};
+    m_ids.push_back(id);
+    m_vehicleCount.store(m_ids.size(), std::memory_order_relaxed);
+    return index;
+}
+
+FleetDynamics& DistributedFleet::getFleet() {
+    return m_fleet;
+}
+
+const FleetDynamics& DistributedFleet::getFleet() const {
+    return m_fleet;
+}
+
+const std::vector<std::uint32_t>& DistributedFleet::getIds() const {
+    return m_ids;
+}
+
+const std::vector<TelemetrySample>& DistributedFleet::getGhosts() const {
+    return m_ghosts;
+}
+
+std::uint64_t DistributedFleet::getTick() const {
+    return m_tick;
+}
+
+double DistributedFleet::getTime() const {
+    return m_time;
+}
+
+void DistributedFleet::checkNeighbours() const {
+    for (const Neighbour& peer : m_neighbours) {
+        if (peer.exists && !peer.connected) {
+            throw std::runtime_error{"Distributed fleet neighbour has no address; call setNeighbour() first"};
+        }
+    }
+}
+
+void DistributedFleet::step(double dt) {
+    checkNeighbours();
+    m_fleet.update(dt);
+    exchange(dt);
+}
+
+void DistributedFleet::step(double dt, SimulationPool& pool) {
+    checkNeighbours();
+    pool.stepFleet(m_fleet, dt);
+    exchange(dt);
+}
+
+void DistributedFleet::exchange(double dt) {
+    FALCONSIM_TRACE_ZONE("DistributedFleet::exchange");
+    const std::uint64_t tick{m_tick + 1};
+    const double time{m_time + dt};
+    m_ghosts.clear();
+    sortOutgoing(time);
+    for (Neighbour& peer : m_neighbours) {
+        if (peer.exists) {
+            encodeMessage(peer, tick);
+            sendOutbox(peer, tick);
+        }
+    }
+    
+    const auto waitStart = std::chrono::steady_clock::now();
+    waitForNeighbours(tick);
+    m_barrierWait.record(nanosecondsSince(waitStart));
+    
+    // Lower neighbour first, so every node adds migrants in the same order on every run
+    for (Neighbour& peer : m_neighbours) {
+        if (peer.exists) {
+            acceptMessage(peer, tick);
+        }
+    }
+    m_tick = tick;
+    m_time = time;
+    
+    m_ticks.store(m_tick, std::memory_order_relaxed);
+    m_vehicleCount.store(m_ids.size(), std::memory_order_relaxed);
+    m_ghostCount.store(m_ghosts.size(), std::memory_order_relaxed);
+}
+
+void DistributedFleet::sortOutgoing(double time) {
+    for (Neighbour& peer : m_neighbours) {
+        peer.outgoingGhosts.clear();
+        peer.outgoingMigrants.clear();
+    }
+    Neighbour& lower{neighbour(Side::Lower)};
+    Neighbour& upper{neighbour(Side::Upper)};
+    const double halo{m_settings.halo};
+    
+    // Backwards, so removing a vehicle only moves one that was already sorted into its place
+    for (std::size_t i = m_fleet.size(); i-- > 0;) {
+        const double north{m_fleet.positionNorth()[i]};
+        Neighbour* destination{north < m_lowerBound ? &lower : (north >= m_upperBound ? &upper : nullptr)};
+        if (destination) {
+            // Just across the boundary, a migrant is one of our ghosts from now on
+            if (destination == &lower ? north >= m_lowerBound - halo : north < m_upperBound + halo) {
+                m_ghosts.push_back(makeSample(i, time));
+            }
+            destination->outgoingMigrants.push_back({m_ids[i], m_fleet.snapshotVehicle(i)});
+            m_fleet.removeVehicle(i);
+            m_ids[i] = m_ids.back();
+            m_ids.pop_back();
+            m_migratedOut.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        
+        if (lower.exists && north < m_lowerBound + halo) {
+            lower.outgoingGhosts.push_back(makeSample(i, time));
+        }
+        if (upper.exists && north >= m_upperBound - halo) {
+            upper.outgoingGhosts.push_back(makeSample(i, time));
+        }
+    }
+}
+
+TelemetrySample DistributedFleet::makeSample(std::size_t index, double time) const {
+    const AircraftState state{m_fleet.getState(index)};
+    const ControlInputs controls{m_fleet.getControls(index)};
+    
+    TelemetrySample sample;
+    sample.vehicle_id = m_ids[index];
+    sample.data.timestamp = time;
+    sample.data.position_north = state.position.x();
+    sample.data.position_east = state.position.y();
+    sample.data.position_down = state.position.z();
+    sample.data.velocity_x = state.velocity.x();
+    sample.data.velocity_y = state.velocity.y();
+    sample.data.velocity_z = state.velocity.z();
+    sample.data.roll = state.euler_angles.x();
+    sample.data.pitch = state.euler_angles.y();
+    sample.data.yaw = state.euler_angles.z();
+    sample.data.throttle = controls.throttle;
+    sample.data.aileron = controls.aileron;
+    sample.data.elevator = controls.elevator;
+    sample.data.rudder = controls.rudder;
+    return sample;
+}
+
+void DistributedFleet::encodeMessage(Neighbour& peer, std::uint64_t tick) {
+    using lockstep_wire::FragmentKind;
+    Outbox& outbox{peer.outboxes[tick & 1]};
+    outbox.tick = tick;
+    outbox.count = 0;
+    
+    // Ghosts as telemetry Batch frames, one per fragment
+    const std::vector<TelemetrySample>& ghosts{peer.outgoingGhosts};
+    for (std::size_t first = 0; first < ghosts.size(); first += lockstep_wire::kGhostsPerFragment) {
+        TelemetryFrameBuffer frame;
+        encodeTelemetryBatch(ghosts.data() + first, std::min(lockstep_wire::kGhostsPerFragment, ghosts.size() - first),
+                             static_cast<std::uint32_t>(tick), frame);
+        std::vector<std::uint8_t>& datagram{appendFragment(outbox, FragmentKind::Ghosts)};
+        datagram.insert(datagram.end(), frame.bytes.begin(), frame.bytes.begin() + frame.size);
+    }
+    
+    // Migrants as raw snapshots
+    const std::vector<Migrant>& migrants{peer.outgoingMigrants};
+    for (std::size_t first = 0; first < migrants.size(); first += lockstep_wire::kMigrantsPerFragment) {
+        const std::size_t count{std::min(lockstep_wire::kMigrantsPerFragment, migrants.size() - first)};
+        std::vector<std::uint8_t>& datagram{appendFragment(outbox, FragmentKind::Migrants)};
+        datagram.resize(kHeaderSize + lockstep_wire::kMigrantPrefixSize + count * lockstep_wire::kMigrantRecordSize, 0);
+        std::uint8_t* payload{datagram.data() + kHeaderSize};
+        storeLE(payload, count, 2);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint8_t* record{payload + lockstep_wire::kMigrantPrefixSize + i * lockstep_wire::kMigrantRecordSize};
+            storeLE(record, migrants[first + i].id, 4);
+            std::memcpy(record + 8, &migrants[first + i].snapshot, sizeof(FleetVehicleSnapshot));
+        }
+    }
+    
+    // Nothing to say still needs saying: the message is the barrier
+    if (outbox.count == 0) {
+        appendFragment(outbox, FragmentKind::Ghosts);
+    }
+    if (outbox.count > 0xFFFF) {
+        throw std::runtime_error{"Distributed fleet message exceeds 65535 fragments"};
+    }
+    
+    for (std::size_t index = 0; index < outbox.count; ++index) {
+        std::uint8_t* header{outbox.datagrams[index].data()};
+        std::copy(lockstep_wire::kMagic.begin(), lockstep_wire::kMagic.end(), header);
+        header[4] = lockstep_wire::kVersion;
+        storeLE(header + 8, tick, 8);
+        storeLE(header + 16, index, 2);
+        storeLE(header + 18, outbox.count, 2);
+        storeLE(header + 20, m_settings.node, 4);
+    }
+}
+
+void DistributedFleet::sendOutbox(Neighbour& peer, std::uint64_t tick) {
+    const Outbox& outbox{peer.outboxes[tick & 1]};
+    if (outbox.tick != tick) {
+        return;
+    }
+    for (std::size_t index = 0; index < outbox.count; ++index) {
+        boost::system::error_code ec;
+        m_socket.send_to(boost::asio::buffer(outbox.datagrams[index]), peer.endpoint, 0, ec);
+        if (ec) {
+            m_sendErrors.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_datagramsSent.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void DistributedFleet::waitForNeighbours(std::uint64_t tick) {
+    const auto hasMessage = [tick](const Neighbour& peer) {
+        const Inbox& inbox{peer.inboxes[tick & 1]};
+        return !peer.exists || (inbox.tick == tick && inbox.complete());
+    };
+    
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + m_settings.timeout;
+    auto resendAt = start + m_settings.retransmit_interval;
+    for (;;) {
+        receiveAvailable();
+        if (std::all_of(std::begin(m_neighbours), std::end(m_neighbours), hasMessage)) {
+            return;
+        }
+        
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            throw std::runtime_error{"Distributed fleet node " + std::to_string(m_settings.node) +
+                                     " timed out waiting for its neighbours at tick " + std::to_string(tick)};
+        }
+        
+        // Our message may be the one that was lost
+        if (now >= resendAt) {
+            for (Neighbour& peer : m_neighbours) {
+                if (!hasMessage(peer)) {
+                    sendOutbox(peer, tick);
+                    m_retransmits.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            resendAt = now + m_settings.retransmit_interval;
+        }
+        waitReadable(std::min(resendAt, deadline) - now);
+    }
+}
+
+void DistributedFleet::linger(std::chrono::milliseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    for (;;) {
+        receiveAvailable();
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= until) {
+            return;
+        }
+        waitReadable(until - now);
+    }
+}
+
+void DistributedFleet::receiveAvailable() {
+    for (;;) {
+        boost::asio::ip::udp::endpoint sender;
+        boost::system::error_code ec;
+        const std::size_t size{m_socket.receive_from(boost::asio::buffer(m_receiveBuffer), sender, 0, ec)};
+        if (ec) {
+            return; // would_block once the socket is drained
+        }
+        m_datagramsReceived.fetch_add(1, std::memory_order_relaxed);
+        handleDatagram(size);
+    }
+}
+
+void DistributedFleet::handleDatagram(std::size_t size) {
+    const std::uint8_t* bytes{m_receiveBuffer.data()};
+    if (size < kHeaderSize || !std::equal(lockstep_wire::kMagic.begin(), lockstep_wire::kMagic.end(), bytes) ||
+        bytes[4] != lockstep_wire::kVersion) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const std::uint8_t kind{bytes[5]};
+    const std::uint64_t tick{loadLE(bytes + 8, 8)};
+    const std::size_t index{static_cast<std::size_t>(loadLE(bytes + 16, 2))};
+    const std::size_t count{static_cast<std::size_t>(loadLE(bytes + 18, 2))};
+    const std::uint64_t node{loadLE(bytes + 20, 4)};
+    
+    Neighbour* from{nullptr};
+    for (Neighbour& peer : m_neighbours) {
+        if (peer.exists && peer.node == node) {
+            from = &peer;
+        }
+    }
+    if (!from || index >= count ||
+        (kind != static_cast<std::uint8_t>(lockstep_wire::FragmentKind::Ghosts) &&
+         kind != static_cast<std::uint8_t>(lockstep_wire::FragmentKind::Migrants))) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    // A message we already have, sent again: the neighbour is still waiting for ours
+    Inbox& inbox{from->inboxes[tick & 1]};
+    if (tick <= m_tick || (inbox.tick == tick && inbox.complete())) {
+        if (index == 0 && from->outboxes[tick & 1].tick == tick) {
+            sendOutbox(*from, tick);
+            m_retransmits.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    
+    // Neighbours are at most one tick ahead of the tick we're completing
+    if (tick > m_tick + 2) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (inbox.tick != tick || inbox.count != count) {
+        inbox.tick = tick;
+        inbox.count = count;
+        inbox.received = 0;
+        inbox.fragments.resize(count);
+        inbox.present.assign(count, false);
+    }
+    if (!inbox.present[index]) {
+        inbox.fragments[index].assign(bytes, bytes + size);
+        inbox.present[index] = true;
+        ++inbox.received;
+    }
+}
+
+void DistributedFleet::waitReadable(std::chrono::steady_clock::duration timeout) {
+#if defined(__unix__) || defined(__APPLE__)
+    pollfd descriptor{};
+    descriptor.fd = m_socket.native_handle();
+    descriptor.events = POLLIN;
+    const auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+    ::poll(&descriptor, 1, static_cast<int>(std::max<decltype(milliseconds)>(milliseconds, 0)));
+#else
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(timeout, std::chrono::milliseconds{1}));
+#endif
+}
+
+void DistributedFleet::acceptMessage(Neighbour& peer, std::uint64_t tick) {
+    const Inbox& inbox{peer.inboxes[tick & 1]};
+    TelemetrySample samples[telemetry_wire::kMaxBatchSamples];
+    for (std::size_t index = 0; index < inbox.count; ++index) {
+        const std::vector<std::uint8_t>& fragment{inbox.fragments[index]};
+        const std::uint8_t* payload{fragment.data() + kHeaderSize};
+        const std::size_t payloadSize{fragment.size() - kHeaderSize};
+        
+        if (fragment[5] == static_cast<std::uint8_t>(lockstep_wire::FragmentKind::Ghosts)) {
+            if (payloadSize == 0) {
+                continue;
+            }
+            const std::size_t decoded{decodeTelemetrySamples(payload, payloadSize, samples,
+                                                              telemetry_wire::kMaxBatchSamples)};
+            if (decoded == 0) {
+                m_rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_ghosts.insert(m_ghosts.end(), samples, samples + decoded);
+            continue;
+        }
+        
+        const std::size_t records{payloadSize >= lockstep_wire::kMigrantPrefixSize ?
+                                  static_cast<std::size_t>(loadLE(payload, 2)) : 0};
+        if (payloadSize < lockstep_wire::kMigrantPrefixSize + records * lockstep_wire::kMigrantRecordSize) {
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        for (std::size_t i = 0; i < records; ++i) {
+            const std::uint8_t* record{payload + lockstep_wire::kMigrantPrefixSize + i * lockstep_wire::kMigrantRecordSize};
+            FleetVehicleSnapshot snapshot;
+            std::memcpy(&snapshot, record + 8, sizeof(snapshot));
+            addVehicle(static_cast<std::uint32_t>(loadLE(record, 4)), snapshot);
+            m_migratedIn.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+DistributedFleet::Neighbour& DistributedFleet::neighbour(Side side) {
+    return m_neighbours[static_cast<std::size_t>(side)];
+}
+
+DistributedFleetStats DistributedFleet::getStats() const {
+    DistributedFleetStats stats;
+    stats.ticks = m_ticks.load(std::memory_order_relaxed);
+    stats.vehicles = m_vehicleCount.load(std::memory_order_relaxed);
+    stats.ghosts = m_ghostCount.load(std::memory_order_relaxed);
+    stats.migrated_out = m_migratedOut.load(std::memory_order_relaxed);
+    stats.migrated_in = m_migratedIn.load(std::memory_order_relaxed);
+    stats.datagrams_sent = m_datagramsSent.load(std::memory_order_relaxed);
+    stats.datagrams_received = m_datagramsReceived.load(std::memory_order_relaxed);
+    stats.retransmits = m_retransmits.load(std::memory_order_relaxed);
+    stats.rejected = m_rejected.load(std::memory_order_relaxed);
+    stats.send_errors = m_sendErrors.load(std::memory_order_relaxed);
+    stats.barrier_wait = m_barrierWait.summary();
+    return stats;
+}
+
+void appendMetrics(MetricsReport& report, const DistributedFleetStats& stats) {
+    report.add("falconsim_distributed_ticks_total", static_cast<double>(stats.ticks));
+    report.add("falconsim_distributed_vehicles", static_cast<double>(stats.vehicles));
+    report.add("falconsim_distributed_ghosts", static_cast<double>(stats.ghosts));
+    report.add("falconsim_distributed_migrated_out_total", static_cast<double>(stats.migrated_out));
+    report.add("falconsim_distributed_migrated_in_total", static_cast<double>(stats.migrated_in));
+    report.add("falconsim_distributed_datagrams_sent_total", static_cast<double>(stats.datagrams_sent));
+    report.add("falconsim_distributed_datagrams_received_total", static_cast<double>(stats.datagrams_received));
+    report.add("falconsim_distributed_retransmits_total", static_cast<double>(stats.retransmits));
+    report.add("falconsim_distributed_rejected_total", static_cast<double>(stats.rejected));
+    report.add("falconsim_distributed_send_errors_total", static_cast<double>(stats.send_errors));
+    report.add("falconsim_distributed_barrier_wait_ns", stats.barrier_wait);
+}
+
+} // namespace falconsim
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TelemetryCodec.hpp"
+#include "../core/Metrics.hpp"
+#include "../core/SimulationPool.hpp"
+#include "../physics/FleetDynamics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Layout of the lockstep datagrams exchanged between neighbouring nodes
+ *
+ * Every datagram starts with a 24-byte little-endian header:
+ *
+ *   offset  size  field
+ *        0     4  magic ("FSLK")
+ *        4     1  version
+ *        5     1  fragment kind
+ *        6     2  reserved (zero)
+ *        8     8  tick the message belongs to
+ *       16     2  fragment index
+ *       18     2  fragment count (the whole message, at least 1)
+ *       20     4  sending node
+ *
+ * A node's message to a neighbour for one tick is split into fragments that
+ * each fit one datagram. A Ghosts fragment carries a telemetry Batch frame
+ * (see TelemetryCodec.hpp) whose vehicle ids are global vehicle ids. A
+ * Migrants fragment carries a u16 count and u16 reserved, then that many
+ * records: u32 global vehicle id, u32 reserved, then the raw bytes of a
+ * FleetVehicleSnapshot (host byte order; all supported hosts are
+ * little-endian). A message with nothing to say is a single empty Ghosts
+ * fragment, since the message itself is what releases the neighbour.
+ */
+namespace lockstep_wire {
+
+constexpr std::array<std::uint8_t, 4> kMagic{'F', 'S', 'L', 'K'};
+constexpr std::uint8_t kVersion{1};
+constexpr std::size_t kHeaderSize{24};
+
+enum class FragmentKind : std::uint8_t {
+    Ghosts = 1,
+    Migrants = 2
+};
+
+constexpr std::size_t kMigrantPrefixSize{4};
+constexpr std::size_t kMigrantRecordSize{8 + sizeof(FleetVehicleSnapshot)};
+constexpr std::size_t kMigrantsPerFragment{(telemetry_wire::kMaxDatagramSize - kHeaderSize - kMigrantPrefixSize) /
+                                           kMigrantRecordSize};
+constexpr std::size_t kGhostsPerFragment{(telemetry_wire::kMaxDatagramSize - kHeaderSize -
+                                          telemetry_wire::kHeaderSize - telemetry_wire::kBatchPrefixSize) /
+                                         telemetry_wire::kBatchRecordSize};
+
+} // namespace lockstep_wire
+
+/**
+ * @brief Where a node sits in the partitioning and how patient it is with its neighbours
+ */
+struct DistributedFleetSettings {
+    std::size_t node{0};              // This node's partition, 0 .. boundaries.size()
+    std::vector<double> boundaries{}; // Ascending north coordinates (m) between partitions; N - 1 for N nodes
+    double halo{50.0};                // Vehicles this close to a boundary are shared with the neighbour as ghosts (m)
+    std::string bind_address{"0.0.0.0"};
+    std::uint16_t port{0};            // 0 picks a free port (see getPort())
+    std::chrono::milliseconds retransmit_interval{5}; // Resend an unanswered message this often
+    std::chrono::milliseconds timeout{2000};          // step() throws once a neighbour is silent this long
+};
+
+/**
+ * @brief Lockstep counters for the metrics endpoint
+ */
+struct DistributedFleetStats {
+    std::uint64_t ticks{0};              // Completed steps
+    std::uint64_t vehicles{0};           // Vehicles owned after the latest step
+    std::uint64_t ghosts{0};             // Ghosts held after the latest step
+    std::uint64_t migrated_out{0};       // Vehicles handed to a neighbour
+    std::uint64_t migrated_in{0};        // Vehicles taken over from a neighbour
+    std::uint64_t datagrams_sent{0};
+    std::uint64_t datagrams_received{0};
+    std::uint64_t retransmits{0};        // Messages sent again, on timeout or at a neighbour's request
+    std::uint64_t rejected{0};           // Datagrams that were malformed, from a stranger or out of step
+    std::uint64_t send_errors{0};
+    HistogramSummary barrier_wait{};     // Time step() waited for its neighbours (ns)
+};
+
+// Append stats as falconsim_distributed_* lines
+void appendMetrics(MetricsReport& report, const DistributedFleetStats& stats);
+
+/**
+ * @brief One node of a swarm partitioned into north slabs across processes or hosts
+ *
+ * The boundaries cut the world into N slabs along north; node k owns every
+ * vehicle in slab k and keeps it in a local FleetDynamics, addressed by a
+ * global vehicle id. Each step() advances the local fleet, then trades one
+ * message with each neighbouring node over UDP:
+ *
+ *   - migrants: vehicles that left the slab, as full FleetVehicleSnapshots,
+ *     so the neighbour carries on with them bit for bit;
+ *   - ghosts: owned vehicles within the halo of the shared boundary, as
+ *     binary telemetry samples, for the neighbour's proximity checks.
+ *
+ * The exchange doubles as the time synchronisation: a node does not leave
+ * step() for tick t before it has the complete tick-t message of every
+ * neighbour. This conservative barrier is local, so distant nodes never
+ * wait on each other directly, yet no node runs more than one tick ahead
+ * of a neighbour. Lost datagrams are recovered by resending the whole
+ * message every retransmit interval until the neighbour's message arrives,
+ * and by answering a neighbour's repeated message with our own; the last
+ * two messages per neighbour are kept for this. A run is deterministic,
+ * and with identical settings on every node it follows stepping the whole
+ * swarm in one FleetDynamics; bit for bit with the Scalar kernel, and to
+ * the last-bit differences between SIMD lanes and the scalar tail
+ * otherwise, since a vehicle's slot in its fleet changes as others migrate.
+ *
+ * A vehicle crosses at most one boundary per step; one that clears a whole
+ * slab is passed on again by the next node at the next step. Aero tables do
+ * not travel with migrants; wind, turbulence and the other fleet-wide
+ * settings must be set identically on every node's fleet.
+ *
+ * Not thread-safe: one thread drives a node. getStats() may be called from
+ * any thread.
+ */
+class DistributedFleet {
+public:
+    enum class Side : std::size_t {
+        Lower, // The neighbour south of this slab (node - 1)
+        Upper  // The neighbour north of this slab (node + 1)
+    };
+    
+    // Binds the socket; throws std::invalid_argument for inconsistent settings
+    explicit DistributedFleet(const DistributedFleetSettings& settings);
+    ~DistributedFleet() = default;
+    
+    // Deleted copy and move operations (socket and histogram)
+    DistributedFleet(const DistributedFleet&) = delete;
+    DistributedFleet& operator=(const DistributedFleet&) = delete;
+    DistributedFleet(DistributedFleet&&) = delete;
+    DistributedFleet& operator=(DistributedFleet&&) = delete;
+    
+    // Where the neighbour on one side listens; throws std::invalid_argument if this node has none there
+    void setNeighbour(Side side, const std::string& address, std::uint16_t port);
+    [[nodiscard]] bool hasNeighbour(Side side) const;
+    [[nodiscard]] std::uint16_t getPort() const;
+    
+    // Partitioning
+    [[nodiscard]] std::size_t getNode() const;
+    [[nodiscard]] std::size_t getNodeCount() const;
+    [[nodiscard]] std::size_t partitionOf(double north) const;
+    
+    // Add a vehicle under its global id; returns its local index (vehicles outside the slab move on after a step)
+    std::size_t addVehicle(std::uint32_t id, const AircraftState& state = {});
+    std::size_t addVehicle(std::uint32_t id, const FleetVehicleSnapshot& snapshot);
+    
+    // Owned vehicles: the local fleet and the global id of each local index. Indices
+    // change whenever vehicles migrate, so look vehicles up by id after each step.
+    [[nodiscard]] FleetDynamics& getFleet();
+    [[nodiscard]] const FleetDynamics& getFleet() const;
+    [[nodiscard]] const std::vector<std::uint32_t>& getIds() const;
+    
+    // Neighbours' vehicles within the halo of this slab after the latest step (timestamps are simulation time)
+    [[nodiscard]] const std::vector<TelemetrySample>& getGhosts() const;
+    
+    // Advance one tick and exchange with the neighbours; every node must use the same dt.
+    // Throws std::runtime_error if a neighbour has no address, or stays silent past the
+    // timeout, after which the node is out of step with the swarm and should be discarded.
+    void step(double dt);
+    void step(double dt, SimulationPool& pool);
+    
+    // Keep answering the neighbours' resend requests for a while, e.g. after the final step
+    void linger(std::chrono::milliseconds duration);
+    
+    [[nodiscard]] std::uint64_t getTick() const;
+    [[nodiscard]] double getTime() const;
+    
+    // Counters and barrier wait times (safe from any thread)
+    [[nodiscard]] DistributedFleetStats getStats() const;
+
+private:
+    struct Migrant {
+        std::uint32_t id{0};
+        FleetVehicleSnapshot snapshot{};
+    };
+    
+    // Our message for one tick to one neighbour, kept until it can no longer be asked for
+    struct Outbox {
+        std::uint64_t tick{0};
+        std::size_t count{0}; // Datagrams in use
+        std::vector<std::vector<std::uint8_t>> datagrams{};
+    };
+    
+    // A neighbour's message for one tick as its fragments arrive
+    struct Inbox {
+        std::uint64_t tick{0};
+        std::size_t count{0};    // Fragments in the message, 0 until the first arrives
+        std::size_t received{0};
+        std::vector<std::vector<std::uint8_t>> fragments{};
+        std::vector<bool> present{};
+        
+        [[nodiscard]] bool complete() const { return count > 0 && received == count; }
+    };
+    
+    struct Neighbour {
+        bool exists{false};
+        bool connected{false};
+        std::uint32_t node{0};
+        boost::asio::ip::udp::endpoint endpoint{};
+        std::vector<TelemetrySample> outgoingGhosts{};
+        std::vector<Migrant> outgoingMigrants{};
+        Outbox outboxes[2]{}; // By tick parity
+        Inbox inboxes[2]{};   // By tick parity
+    };
+    
+    void checkNeighbours() const;
+    void exchange(double dt);
+    void sortOutgoing(double time);
+    [[nodiscard]] TelemetrySample makeSample(std::size_t index, double time) const;
+    void encodeMessage(Neighbour& neighbour, std::uint64_t tick);
+    void sendOutbox(Neighbour& neighbour, std::uint64_t tick);
+    void waitForNeighbours(std::uint64_t tick);
+    void receiveAvailable();
+    void handleDatagram(std::size_t size);
+    void waitReadable(std::chrono::steady_clock::duration timeout);
+    void acceptMessage(Neighbour& neighbour, std::uint64_t tick);
+    [[nodiscard]] Neighbour& neighbour(Side side);
+    
+    DistributedFleetSettings m_settings{};
+    double m_lowerBound{0.0}; // This node's slab [lower, upper) along north (m)
+    double m_upperBound{0.0};
+    
+    // Network
+    boost::asio::io_context m_ioContext{};
+    boost::asio::ip::udp::socket m_socket{m_ioContext};
+    std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> m_receiveBuffer{};
+    Neighbour m_neighbours[2]{};
+    
+    // Owned vehicles and neighbours' ghosts
+    FleetDynamics m_fleet{};
+    std::vector<std::uint32_t> m_ids{};
+    std::vector<TelemetrySample> m_ghosts{};
+    std::uint64_t m_tick{0};
+    double m_time{0.0};
+    
+    // Published for getStats(), written by the stepping thread only
+    std::atomic<std::uint64_t> m_ticks{0};
+    std::atomic<std::uint64_t> m_vehicleCount{0};
+    std::atomic<std::uint64_t> m_ghostCount{0};
+    std::atomic<std::uint64_t> m_migratedOut{0};
+    std::atomic<std::uint64_t> m_migratedIn{0};
+    std::atomic<std::uint64_t> m_datagramsSent{0};
+    std::atomic<std::uint64_t> m_datagramsReceived{0};
+    std::atomic<std::uint64_t> m_retransmits{0};
+    std::atomic<std::uint64_t> m_rejected{0};
+    std::atomic<std::uint64_t> m_sendErrors{0};
+    Histogram m_barrierWait{};
+};
+
+} // namespace falconsim
@@ -0,0 +1,122 @@
+#include "MetricsServer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace falconsim {
+
+MetricsServer::MetricsServer(uint16_t port)
+    : m_port{port} {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::addSource(Source source) {
+    if (m_running) {
+        throw std::runtime_error{"Cannot add a metrics source while the server is running"};
+    }
+    m_sources.push_back(std::move(source));
+}
+
+void MetricsServer::start() {
+    if (m_running) {
+        return;
+    }
+    
+    m_running = true;
+    try {
+        m_socket = std::make_unique<boost::asio::ip::udp::socket>(
+            m_ioContext,
+            boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), m_port)
+        );
+        m_port = m_socket->local_endpoint().port(); // Resolves an ephemeral port 0
+        
+        startReceive();
+        m_serverThread = std::thread{[this] { m_ioContext.run(); }};
+        
+        std::cout << "Metrics server started on port " << m_port << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to start metrics server: " << e.what() << std::endl;
+        m_socket.reset();
+        m_running = false;
+    }
+}
+
+void MetricsServer::stop() {
+    if (!m_running) {
+        return;
+    }
+    
+    m_running = false;
+    boost::asio::post(m_ioContext, [this] {
+        boost::system::error_code ec;
+        m_socket->close(ec);
+    });
+    if (m_serverThread.joinable()) {
+        m_serverThread.join();
+    }
+    
+    m_ioContext.restart();
+    m_socket.reset();
+}
+
+uint16_t MetricsServer::getPort() const {
+    return m_port;
+}
+
+std::string MetricsServer::collect() const {
+    MetricsReport report;
+    for (const auto& source : m_sources) {
+        source(report);
+    }
+    return report.str();
+}
+
+std::uint64_t MetricsServer::getRequestCount() const {
+    return m_requests.load(std::memory_order_relaxed);
+}
+
+void MetricsServer::startReceive() {
+    m_socket->async_receive_from(
+        boost::asio::buffer(m_receiveBuffer), m_remoteEndpoint,
+        [this](const boost::system::error_code& ec, std::size_t bytes) {
+            onReceive(ec, bytes);
+        });
+}
+
+void MetricsServer::onReceive(const boost::system::error_code& ec, std::size_t bytes) {
+    if (ec == boost::asio::error::operation_aborted || !m_running) {
+        return;
+    }
+    
+    std::string command{m_receiveBuffer.data(), bytes};
+    command.erase(std::remove_if(command.begin(), command.end(),
+                                 [](char c) { return std::isspace(static_cast<unsigned char>(c)); }),
+                  command.end());
+    std::transform(command.begin(), command.end(), command.begin(),
+                   [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+    
+    if (!ec && command == "STATS") {
+        m_requests.fetch_add(1, std::memory_order_relaxed);
+        std::string reply{collect()};
+        if (reply.size() > kMaxReportSize) {
+            const std::size_t lastLine{reply.rfind('\n', kMaxReportSize - 1)};
+            reply.resize(lastLine == std::string::npos ? 0 : lastLine + 1);
+        }
+        
+        // One small reply per request; a blocking send is fine on this thread
+        boost::system::error_code sendError;
+        m_socket->send_to(boost::asio::buffer(reply), m_remoteEndpoint, 0, sendError);
+        if (sendError) {
+            std::cerr << "Error sending metrics: " << sendError.message() << std::endl;
+        }
+    }
+    startReceive();
+}
+
+} // namespace falconsim
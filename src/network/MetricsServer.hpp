@@ -0,0 +1,73 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core/Metrics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Stats endpoint: answers "STATS" datagrams with a text metrics report
+ *
+ * The server listens on its own UDP port and thread, away from the
+ * telemetry stream. Every request runs the registered sources on that
+ * thread. Sources must be safe to call concurrently with the simulation,
+ * which Simulation::getMetrics() and TelemetryServer::getMetrics() are:
+ *
+ *     metrics.addSource([&sim](MetricsReport& r) { appendMetrics(r, sim.getMetrics()); });
+ *
+ * Query it with e.g. `echo STATS | nc -u -w1 localhost 12346`. A report
+ * longer than one datagram is cut at the last complete line.
+ */
+class MetricsServer {
+public:
+    using Source = std::function<void(MetricsReport& report)>;
+    
+    explicit MetricsServer(uint16_t port = 12346);
+    ~MetricsServer();
+    
+    // Deleted copy and move operations
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    MetricsServer(MetricsServer&&) = delete;
+    MetricsServer& operator=(MetricsServer&&) = delete;
+    
+    // Register a report section (throws std::runtime_error while running)
+    void addSource(Source source);
+    
+    // Server control (port 0 binds an ephemeral port, reported by getPort() once started)
+    void start();
+    void stop();
+    [[nodiscard]] uint16_t getPort() const;
+    
+    // Render every source now, exactly as a STATS request would
+    [[nodiscard]] std::string collect() const;
+    
+    [[nodiscard]] std::uint64_t getRequestCount() const;
+    
+    // Largest UDP payload over IPv4
+    static constexpr std::size_t kMaxReportSize{65507};
+
+private:
+    void startReceive();
+    void onReceive(const boost::system::error_code& ec, std::size_t bytes);
+    
+    boost::asio::io_context m_ioContext{};
+    std::unique_ptr<boost::asio::ip::udp::socket> m_socket{};
+    std::array<char, 64> m_receiveBuffer{};
+    boost::asio::ip::udp::endpoint m_remoteEndpoint{};
+    std::vector<Source> m_sources{};
+    
+    std::atomic<bool> m_running{false};
+    std::atomic<std::uint64_t> m_requests{0};
+    std::thread m_serverThread{};
+    uint16_t m_port{12346};
+};
+
+} // namespace falconsim
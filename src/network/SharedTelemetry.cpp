@@ -0,0 +1,320 @@
+#include "SharedTelemetry.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FALCONSIM_HAS_POSIX_SHM 1
+#endif
+
+namespace falconsim {
+
+namespace {
+
+constexpr std::size_t kRecordWords{(sizeof(SharedTelemetryRecord) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)};
+
+static_assert(std::is_trivially_copyable<SharedTelemetryRecord>::value && offsetof(SharedTelemetryRecord, index) == 0,
+              "Records are copied as words with the index first");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Shared-memory telemetry needs address-free 64-bit atomics");
+
+/**
+ * @brief Start of the shared region
+ */
+struct RegionHeader {
+    std::atomic<std::uint32_t> magic{0}; // Written last, once the header is valid
+    std::uint32_t version{0};
+    std::uint32_t capacity{0};
+    std::uint32_t recordSize{0};
+    alignas(64) std::atomic<std::uint64_t> published{0};
+};
+
+/**
+ * @brief One sequence-locked record
+ */
+struct alignas(64) RegionSlot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<std::uint64_t> words[kRecordWords]{};
+};
+
+constexpr std::size_t kHeaderBytes{(sizeof(RegionHeader) + alignof(RegionSlot) - 1) / alignof(RegionSlot) * alignof(RegionSlot)};
+
+std::size_t regionSize(std::size_t capacity) {
+    return kHeaderBytes + capacity * sizeof(RegionSlot);
+}
+
+RegionHeader* header(void* region) {
+    return static_cast<RegionHeader*>(region);
+}
+
+const RegionHeader* header(const void* region) {
+    return static_cast<const RegionHeader*>(region);
+}
+
+RegionSlot* slots(void* region) {
+    return reinterpret_cast<RegionSlot*>(static_cast<char*>(region) + kHeaderBytes);
+}
+
+const RegionSlot* slots(const void* region) {
+    return reinterpret_cast<const RegionSlot*>(static_cast<const char*>(region) + kHeaderBytes);
+}
+
+std::string shmName(const std::string& name) {
+    return !name.empty() && name.front() == '/' ? name : "/" + name;
+}
+
+[[noreturn]] void throwSystemError(const std::string& what, const std::string& name) {
+    throw std::runtime_error{what + " " + name + ": " + std::strerror(errno)};
+}
+
+} // namespace
+
+AircraftState SharedTelemetryRecord::state() const {
+    AircraftState state;
+    state.position = Eigen::Vector3d(position[0], position[1], position[2]);
+    state.velocity = Eigen::Vector3d(velocity[0], velocity[1], velocity[2]);
+    state.euler_angles = Eigen::Vector3d(euler_angles[0], euler_angles[1], euler_angles[2]);
+    state.angular_velocity = Eigen::Vector3d(angular_velocity[0], angular_velocity[1], angular_velocity[2]);
+    state.mass = mass;
+    return state;
+}
+
+ControlInputs SharedTelemetryRecord::controls() const {
+    ControlInputs controls;
+    controls.throttle = throttle;
+    controls.aileron = aileron;
+    controls.elevator = elevator;
+    controls.rudder = rudder;
+    return controls;
+}
+
+SharedTelemetryPublisher::SharedTelemetryPublisher(const std::string& name, std::size_t capacity)
+    : m_name{shmName(name)} {
+    // Power-of-two capacity so the slot is a mask away from the index
+    m_capacity = 2;
+    while (m_capacity < capacity) {
+        m_capacity <<= 1;
+    }
+    m_size = regionSize(m_capacity);
+
+#if defined(FALCONSIM_HAS_POSIX_SHM)
+    // Replace any region left behind by a previous publisher; its readers keep the old mapping
+    ::shm_unlink(m_name.c_str());
+    const int fd{::shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)};
+    if (fd < 0) {
+        throwSystemError("Failed to create shared memory", m_name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+        ::close(fd);
+        ::shm_unlink(m_name.c_str());
+        throwSystemError("Failed to size shared memory", m_name);
+    }
+    void* region{::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        ::shm_unlink(m_name.c_str());
+        throwSystemError("Failed to map shared memory", m_name);
+    }
+    m_region = region;
+    
+    // ftruncate zero-fills the region; construct the atomics in place over it
+    RegionHeader* head{new (m_region) RegionHeader{}};
+    RegionSlot* ring{slots(m_region)};
+    for (std::size_t i = 0; i < m_capacity; ++i) {
+        new (&ring[i]) RegionSlot{};
+    }
+    head->version = shm_wire::kVersion;
+    head->capacity = static_cast<std::uint32_t>(m_capacity);
+    head->recordSize = static_cast<std::uint32_t>(sizeof(SharedTelemetryRecord));
+    head->magic.store(shm_wire::kMagic, std::memory_order_release);
+#else
+    throw std::runtime_error{"Shared-memory telemetry is not supported on this platform"};
+#endif
+}
+
+SharedTelemetryPublisher::~SharedTelemetryPublisher() {
+#if defined(FALCONSIM_HAS_POSIX_SHM)
+    if (m_region) {
+        ::munmap(m_region, m_size);
+        ::shm_unlink(m_name.c_str());
+    }
+#endif
+}
+
+std::uint64_t SharedTelemetryPublisher::publish(const SharedTelemetryRecord& record) {
+    RegionHeader* head{header(m_region)};
+    const std::uint64_t index{head->published.load(std::memory_order_relaxed)};
+    RegionSlot& slot{slots(m_region)[index & (m_capacity - 1)]};
+    
+    std::uint64_t words[kRecordWords]{};
+    std::memcpy(words, &record, sizeof(record));
+    words[0] = index; // SharedTelemetryRecord::index is the first member
+    
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kRecordWords; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    
+    head->published.store(index + 1, std::memory_order_release);
+    return index;
+}
+
+std::uint64_t SharedTelemetryPublisher::publish(const AircraftState& state, const ControlInputs& controls,
+                                                double simTime, std::uint32_t vehicleId) {
+    SharedTelemetryRecord record;
+    record.sim_time = simTime;
+    record.vehicle_id = vehicleId;
+    for (int i = 0; i < 3; ++i) {
+        record.position[i] = state.position[i];
+        record.velocity[i] = state.velocity[i];
+        record.euler_angles[i] = state.euler_angles[i];
+        record.angular_velocity[i] = state.angular_velocity[i];
+    }
+    record.mass = state.mass;
+    record.throttle = controls.throttle;
+    record.aileron = controls.aileron;
+    record.elevator = controls.elevator;
+    record.rudder = controls.rudder;
+    return publish(record);
+}
+
+const std::string& SharedTelemetryPublisher::getName() const {
+    return m_name;
+}
+
+std::size_t SharedTelemetryPublisher::getCapacity() const {
+    return m_capacity;
+}
+
+std::uint64_t SharedTelemetryPublisher::getPublished() const {
+    return header(m_region)->published.load(std::memory_order_acquire);
+}
+
+SharedTelemetrySubscriber::SharedTelemetrySubscriber(const std::string& name) {
+#if defined(FALCONSIM_HAS_POSIX_SHM)
+    const std::string shm{shmName(name)};
+    const int fd{::shm_open(shm.c_str(), O_RDONLY, 0)};
+    if (fd < 0) {
+        throwSystemError("Failed to open shared memory", shm);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kHeaderBytes) {
+        ::close(fd);
+        throw std::runtime_error{"Shared memory " + shm + " is not a telemetry ring"};
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    const void* region{::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0)};
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        throwSystemError("Failed to map shared memory", shm);
+    }
+    m_region = region;
+    
+    // Validate the header before trusting the capacity
+    const RegionHeader* head{header(m_region)};
+    const bool valid{head->magic.load(std::memory_order_acquire) == shm_wire::kMagic &&
+                     head->version == shm_wire::kVersion &&
+                     head->recordSize == sizeof(SharedTelemetryRecord) &&
+                     head->capacity >= 2 && (head->capacity & (head->capacity - 1)) == 0 &&
+                     regionSize(head->capacity) <= m_size};
+    if (!valid) {
+        ::munmap(const_cast<void*>(m_region), m_size);
+        m_region = nullptr;
+        throw std::runtime_error{"Shared memory " + shm + " is not a telemetry ring"};
+    }
+    m_capacity = head->capacity;
+    m_nextIndex = head->published.load(std::memory_order_acquire);
+#else
+    (void)name;
+    throw std::runtime_error{"Shared-memory telemetry is not supported on this platform"};
+#endif
+}
+
+SharedTelemetrySubscriber::~SharedTelemetrySubscriber() {
+#if defined(FALCONSIM_HAS_POSIX_SHM)
+    if (m_region) {
+        ::munmap(const_cast<void*>(m_region), m_size);
+    }
+#endif
+}
+
+bool SharedTelemetrySubscriber::read(std::uint64_t index, SharedTelemetryRecord& record) const {
+    const RegionSlot& slot{slots(m_region)[index & (m_capacity - 1)]};
+    const std::uint64_t expected{2 * index + 2};
+    
+    // Either not written yet, being written, or already from a later lap
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    
+    std::uint64_t words[kRecordWords];
+    for (std::size_t i = 0; i < kRecordWords; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+        return false; // Overwritten while copying
+    }
+    
+    std::memcpy(&record, words, sizeof(record));
+    return true;
+}
+
+bool SharedTelemetrySubscriber::latest(SharedTelemetryRecord& record) const {
+    const RegionHeader* head{header(m_region)};
+    for (;;) {
+        const std::uint64_t published{head->published.load(std::memory_order_acquire)};
+        if (published == 0) {
+            return false;
+        }
+        if (read(published - 1, record)) {
+            return true;
+        }
+        // The publisher lapped the slot mid-copy; try the newer record
+    }
+}
+
+std::size_t SharedTelemetrySubscriber::poll(SharedTelemetryRecord* records, std::size_t maxRecords) {
+    const std::uint64_t published{getPublished()};
+    
+    // Anything more than one ring behind is gone already
+    if (published - m_nextIndex > m_capacity) {
+        m_missed += published - m_nextIndex - m_capacity;
+        m_nextIndex = published - m_capacity;
+    }
+    
+    std::size_t count{0};
+    while (m_nextIndex < published && count < maxRecords) {
+        if (read(m_nextIndex, records[count])) {
+            ++count;
+        } else {
+            ++m_missed; // Overwritten before we got to it
+        }
+        ++m_nextIndex;
+    }
+    return count;
+}
+
+std::size_t SharedTelemetrySubscriber::getCapacity() const {
+    return m_capacity;
+}
+
+std::uint64_t SharedTelemetrySubscriber::getPublished() const {
+    return header(m_region)->published.load(std::memory_order_acquire);
+}
+
+std::uint64_t SharedTelemetrySubscriber::getMissed() const {
+    return m_missed;
+}
+
+} // namespace falconsim
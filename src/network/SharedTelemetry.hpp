@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../physics/FlightDynamics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief One step of one vehicle as stored in the shared-memory ring
+ *
+ * Plain doubles with a fixed layout, so processes built against other
+ * Eigen versions (or written in other languages) can read the region.
+ */
+struct SharedTelemetryRecord {
+    std::uint64_t index{0};      // Position in the stream, assigned by the publisher
+    double sim_time{0.0};        // Simulated time (s)
+    std::uint32_t vehicle_id{0};
+    std::uint32_t reserved{0};
+    double position[3]{};         // NED (m)
+    double velocity[3]{};         // Body frame (m/s)
+    double euler_angles[3]{};     // Roll, pitch, yaw (rad)
+    double angular_velocity[3]{}; // Body rates (rad/s)
+    double mass{0.0};             // kg
+    double throttle{0.0};
+    double aileron{0.0};
+    double elevator{0.0};
+    double rudder{0.0};
+    
+    [[nodiscard]] AircraftState state() const;
+    [[nodiscard]] ControlInputs controls() const;
+};
+
+/**
+ * @brief Shared-memory region layout
+ *
+ * The POSIX shm object holds a header (magic, version, capacity, record
+ * size, published-record counter) followed by a power-of-two ring of slots.
+ * Each slot is a sequence lock: the publisher marks record n as being
+ * written with sequence 2n+1 and as complete with 2n+2. A reader accepts a
+ * copy only if it saw 2n+2 both before and after, so it will never return a
+ * torn record or a record from a different lap.
+ */
+namespace shm_wire {
+
+constexpr std::uint32_t kMagic{0x4D485346}; // "FSHM" little-endian
+constexpr std::uint32_t kVersion{1};
+constexpr std::size_t kDefaultCapacity{1024};
+constexpr const char* kDefaultName{"/falconsim_telemetry"};
+
+} // namespace shm_wire
+
+/**
+ * @brief Single-writer side of the shared-memory telemetry ring
+ *
+ * Creates (or replaces) the named shm object and unlinks it on destruction.
+ * publish() never blocks and makes no system calls, so it can run as a
+ * Simulation step observer. Only one thread may publish.
+ */
+class SharedTelemetryPublisher {
+public:
+    // Throws std::runtime_error if the region cannot be created
+    explicit SharedTelemetryPublisher(const std::string& name = shm_wire::kDefaultName,
+                                      std::size_t capacity = shm_wire::kDefaultCapacity);
+    ~SharedTelemetryPublisher();
+    
+    SharedTelemetryPublisher(const SharedTelemetryPublisher&) = delete;
+    SharedTelemetryPublisher& operator=(const SharedTelemetryPublisher&) = delete;
+    SharedTelemetryPublisher(SharedTelemetryPublisher&&) = delete;
+    SharedTelemetryPublisher& operator=(SharedTelemetryPublisher&&) = delete;
+    
+    // Append a record (its index is overwritten); returns the index assigned
+    std::uint64_t publish(const SharedTelemetryRecord& record);
+    // Same, from simulation state (signature of Simulation::StepObserver plus a vehicle id)
+    std::uint64_t publish(const AircraftState& state, const ControlInputs& controls, double simTime,
+                          std::uint32_t vehicleId = 0);
+    
+    [[nodiscard]] const std::string& getName() const;
+    [[nodiscard]] std::size_t getCapacity() const;
+    [[nodiscard]] std::uint64_t getPublished() const;
+
+private:
+    std::string m_name;
+    std::size_t m_capacity{0};
+    std::size_t m_size{0};
+    void* m_region{nullptr};
+};
+
+/**
+ * @brief Read-only view of a shared-memory telemetry ring
+ *
+ * Readers never block the publisher and never take a lock. A reader copies
+ * the record it wants out of the mapping; nothing is serialized or passed
+ * through the kernel. A reader that falls more than one ring behind skips
+ * ahead and counts the records it missed.
+ *
+ * If the publisher restarts it creates a new object, so open a new
+ * subscriber to follow it.
+ */
+class SharedTelemetrySubscriber {
+public:
+    // Throws std::runtime_error if the region does not exist or is not a telemetry ring
+    explicit SharedTelemetrySubscriber(const std::string& name = shm_wire::kDefaultName);
+    ~SharedTelemetrySubscriber();
+    
+    SharedTelemetrySubscriber(const SharedTelemetrySubscriber&) = delete;
+    SharedTelemetrySubscriber& operator=(const SharedTelemetrySubscriber&) = delete;
+    SharedTelemetrySubscriber(SharedTelemetrySubscriber&&) = delete;
+    SharedTelemetrySubscriber& operator=(SharedTelemetrySubscriber&&) = delete;
+    
+    // Newest record; false if nothing has been published yet
+    bool latest(SharedTelemetryRecord& record) const;
+    
+    // Records published since the previous poll() (or since opening), oldest first; returns how many were copied
+    std::size_t poll(SharedTelemetryRecord* records, std::size_t maxRecords);
+    
+    [[nodiscard]] std::size_t getCapacity() const;
+    [[nodiscard]] std::uint64_t getPublished() const;
+    [[nodiscard]] std::uint64_t getMissed() const; // Records overwritten before poll() reached them
+
+private:
+    bool read(std::uint64_t index, SharedTelemetryRecord& record) const;
+    
+    std::size_t m_capacity{0};
+    std::size_t m_size{0};
+    const void* m_region{nullptr};
+    std::uint64_t m_nextIndex{0};
+    std::uint64_t m_missed{0};
+};
+
+} // namespace falconsim
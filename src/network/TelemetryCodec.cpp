@@ -0,0 +1,340 @@
+#include "TelemetryCodec.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace falconsim {
+
+namespace {
+
+using telemetry_wire::kHeaderSize;
+using telemetry_wire::kStateFieldCount;
+
+// Field order shared by both wire formats
+std::array<double, kStateFieldCount> telemetryFields(const TelemetryData& data) {
+    return {data.timestamp,
+            data.position_north, data.position_east, data.position_down,
+            data.velocity_x, data.velocity_y, data.velocity_z,
+            data.roll, data.pitch, data.yaw,
+            data.throttle, data.aileron, data.elevator, data.rudder};
+}
+
+void assignTelemetryFields(const double* fields, TelemetryData& data) {
+    data.timestamp = fields[0];
+    data.position_north = fields[1];
+    data.position_east = fields[2];
+    data.position_down = fields[3];
+    data.velocity_x = fields[4];
+    data.velocity_y = fields[5];
+    data.velocity_z = fields[6];
+    data.roll = fields[7];
+    data.pitch = fields[8];
+    data.yaw = fields[9];
+    data.throttle = fields[10];
+    data.aileron = fields[11];
+    data.elevator = fields[12];
+    data.rudder = fields[13];
+}
+
+void storeLE(std::uint8_t* out, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint64_t loadLE(const std::uint8_t* in, std::size_t bytes) {
+    std::uint64_t value{0};
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void storeDouble(std::uint8_t* out, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeLE(out, bits, sizeof(bits));
+}
+
+double loadDouble(const std::uint8_t* in) {
+    const std::uint64_t bits{loadLE(in, sizeof(std::uint64_t))};
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void storeState(std::uint8_t* out, const TelemetryData& data) {
+    const auto fields = telemetryFields(data);
+    for (std::size_t i = 0; i < kStateFieldCount; ++i) {
+        storeDouble(out + i * sizeof(double), fields[i]);
+    }
+}
+
+void loadState(const std::uint8_t* in, TelemetryData& data) {
+    std::array<double, kStateFieldCount> fields{};
+    for (std::size_t i = 0; i < kStateFieldCount; ++i) {
+        fields[i] = loadDouble(in + i * sizeof(double));
+    }
+    assignTelemetryFields(fields.data(), data);
+}
+
+void storeHeader(std::uint8_t* out, telemetry_wire::FrameType type, std::size_t payloadSize,
+                 std::uint32_t sequence) {
+    std::copy(telemetry_wire::kMagic.begin(), telemetry_wire::kMagic.end(), out);
+    out[4] = telemetry_wire::kVersion;
+    out[5] = static_cast<std::uint8_t>(type);
+    storeLE(out + 6, payloadSize, 2);
+    storeLE(out + 8, sequence, 4);
+    storeLE(out + 12, 0, 4);
+}
+
+// Validates the header; returns the payload size, or 0 if the frame cannot be used
+std::size_t checkHeader(const std::uint8_t* bytes, std::size_t size, telemetry_wire::FrameType type) {
+    if (size < kHeaderSize || bytes[4] != telemetry_wire::kVersion ||
+        bytes[5] != static_cast<std::uint8_t>(type)) {
+        return 0;
+    }
+    
+    const std::size_t payloadSize{static_cast<std::size_t>(loadLE(bytes + 6, 2))};
+    return size < kHeaderSize + payloadSize ? 0 : payloadSize;
+}
+
+bool decodeBinary(const std::uint8_t* bytes, std::size_t size, TelemetryData& data,
+                  std::uint32_t* sequence) {
+    const std::size_t payloadSize{checkHeader(bytes, size, telemetry_wire::FrameType::State)};
+    if (payloadSize < telemetry_wire::kStatePayloadSize) {
+        return false;
+    }
+    
+    loadState(bytes + kHeaderSize, data);
+    
+    if (sequence) {
+        *sequence = static_cast<std::uint32_t>(loadLE(bytes + 8, 4));
+    }
+    return true;
+}
+
+std::size_t decodeBatch(const std::uint8_t* bytes, std::size_t size, TelemetrySample* samples,
+                        std::size_t capacity, std::uint32_t* sequence) {
+    const std::size_t payloadSize{checkHeader(bytes, size, telemetry_wire::FrameType::Batch)};
+    if (payloadSize < telemetry_wire::kBatchPrefixSize) {
+        return 0;
+    }
+    
+    const std::uint8_t* payload{bytes + kHeaderSize};
+    const std::size_t count{static_cast<std::size_t>(loadLE(payload, 2))};
+    const std::size_t recordSize{static_cast<std::size_t>(loadLE(payload + 2, 2))};
+    if (recordSize < telemetry_wire::kBatchRecordSize ||
+        payloadSize < telemetry_wire::kBatchPrefixSize + count * recordSize) {
+        return 0;
+    }
+    
+    const std::size_t decoded{std::min(count, capacity)};
+    for (std::size_t i = 0; i < decoded; ++i) {
+        const std::uint8_t* record{payload + telemetry_wire::kBatchPrefixSize + i * recordSize};
+        samples[i].vehicle_id = static_cast<std::uint32_t>(loadLE(record, 4));
+        loadState(record + 8, samples[i].data);
+    }
+    
+    if (sequence) {
+        *sequence = static_cast<std::uint32_t>(loadLE(bytes + 8, 4));
+    }
+    return decoded;
+}
+
+void storeSensor(std::uint8_t* record, const SensorSample& sample) {
+    storeLE(record, sample.vehicle_id, 4);
+    record[4] = static_cast<std::uint8_t>(sample.kind);
+    storeLE(record + 5, 0, 3);
+    storeDouble(record + 8, sample.time);
+    for (std::size_t i = 0; i < kSensorValueCount; ++i) {
+        storeDouble(record + 16 + i * sizeof(double), sample.values[i]);
+    }
+}
+
+bool loadSensor(const std::uint8_t* record, SensorSample& sample) {
+    const std::uint8_t kind{record[4]};
+    if (kind == 0 || kind > kSensorKindCount) {
+        return false;
+    }
+    sample.vehicle_id = static_cast<std::uint32_t>(loadLE(record, 4));
+    sample.kind = static_cast<SensorKind>(kind);
+    sample.time = loadDouble(record + 8);
+    for (std::size_t i = 0; i < kSensorValueCount; ++i) {
+        sample.values[i] = loadDouble(record + 16 + i * sizeof(double));
+    }
+    return true;
+}
+
+bool hasMagic(const std::uint8_t* bytes, std::size_t size) {
+    return size >= telemetry_wire::kMagic.size() &&
+           std::equal(telemetry_wire::kMagic.begin(), telemetry_wire::kMagic.end(), bytes);
+}
+
+bool decodeCsv(const std::uint8_t* bytes, std::size_t size, TelemetryData& data) {
+    // Copy into a terminated scratch buffer so strtod cannot run past the datagram
+    constexpr std::size_t kCsvFields{kStateFieldCount};
+    std::array<char, telemetry_wire::kMaxCsvSize + 1> text{};
+    const std::size_t length{std::min(size, telemetry_wire::kMaxCsvSize)};
+    std::memcpy(text.data(), bytes, length);
+    
+    std::array<double, kStateFieldCount> fields{};
+    const char* cursor{text.data()};
+    for (std::size_t i = 0; i < kCsvFields; ++i) {
+        char* end{nullptr};
+        fields[i] = std::strtod(cursor, &end);
+        if (end == cursor || (i + 1 < kCsvFields && *end != ',')) {
+            return false;
+        }
+        cursor = end + 1;
+    }
+    assignTelemetryFields(fields.data(), data);
+    return true;
+}
+
+} // namespace
+
+std::size_t encodeTelemetryBinary(const TelemetryData& data, std::uint32_t sequence,
+                                  TelemetryFrameBuffer& frame) {
+    std::uint8_t* out{frame.bytes.data()};
+    storeHeader(out, telemetry_wire::FrameType::State, telemetry_wire::kStatePayloadSize, sequence);
+    storeState(out + kHeaderSize, data);
+    
+    frame.size = telemetry_wire::kStateFrameSize;
+    return frame.size;
+}
+
+std::size_t encodeTelemetryBatch(const TelemetrySample* samples, std::size_t count,
+                                 std::uint32_t sequence, TelemetryFrameBuffer& frame) {
+    const std::size_t packed{std::min(count, telemetry_wire::kMaxBatchSamples)};
+    const std::size_t payloadSize{telemetry_wire::kBatchPrefixSize + packed * telemetry_wire::kBatchRecordSize};
+    
+    std::uint8_t* out{frame.bytes.data()};
+    storeHeader(out, telemetry_wire::FrameType::Batch, payloadSize, sequence);
+    
+    std::uint8_t* payload{out + kHeaderSize};
+    storeLE(payload, packed, 2);
+    storeLE(payload + 2, telemetry_wire::kBatchRecordSize, 2);
+    for (std::size_t i = 0; i < packed; ++i) {
+        std::uint8_t* record{payload + telemetry_wire::kBatchPrefixSize + i * telemetry_wire::kBatchRecordSize};
+        storeLE(record, samples[i].vehicle_id, 4);
+        storeLE(record + 4, 0, 4);
+        storeState(record + 8, samples[i].data);
+    }
+    
+    frame.size = kHeaderSize + payloadSize;
+    return packed;
+}
+
+std::size_t encodeSensorBatch(const SensorSample* samples, std::size_t count,
+                              std::uint32_t sequence, TelemetryFrameBuffer& frame) {
+    const std::size_t packed{std::min(count, telemetry_wire::kMaxSensorSamples)};
+    const std::size_t payloadSize{telemetry_wire::kSensorPrefixSize + packed * telemetry_wire::kSensorRecordSize};
+    
+    std::uint8_t* out{frame.bytes.data()};
+    storeHeader(out, telemetry_wire::FrameType::Sensor, payloadSize, sequence);
+    
+    std::uint8_t* payload{out + kHeaderSize};
+    storeLE(payload, packed, 2);
+    storeLE(payload + 2, telemetry_wire::kSensorRecordSize, 2);
+    for (std::size_t i = 0; i < packed; ++i) {
+        storeSensor(payload + telemetry_wire::kSensorPrefixSize + i * telemetry_wire::kSensorRecordSize, samples[i]);
+    }
+    
+    frame.size = kHeaderSize + payloadSize;
+    return packed;
+}
+
+std::size_t encodeTelemetryCsv(const TelemetryData& data, TelemetryFrameBuffer& frame) {
+    // Same text as the original stringstream format (std::fixed, precision 6)
+    char* out{reinterpret_cast<char*>(frame.bytes.data())};
+    const int written{std::snprintf(
+        out, frame.bytes.size(),
+        "%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f",
+        data.timestamp,
+        data.position_north, data.position_east, data.position_down,
+        data.velocity_x, data.velocity_y, data.velocity_z,
+        data.roll, data.pitch, data.yaw,
+        data.throttle, data.aileron, data.elevator, data.rudder)};
+    
+    // Truncated lines (absurdly large values) are dropped rather than sent partial
+    frame.size = (written > 0 && static_cast<std::size_t>(written) < frame.bytes.size())
+                     ? static_cast<std::size_t>(written)
+                     : 0;
+    return frame.size;
+}
+
+std::size_t encodeTelemetry(TelemetryEncoding encoding, const TelemetryData& data,
+                            std::uint32_t sequence, TelemetryFrameBuffer& frame) {
+    switch (encoding) {
+        case TelemetryEncoding::Csv:
+            return encodeTelemetryCsv(data, frame);
+        case TelemetryEncoding::Binary:
+        case TelemetryEncoding::Compact:
+            break;
+    }
+    return encodeTelemetryBinary(data, sequence, frame);
+}
+
+bool decodeTelemetry(const std::uint8_t* bytes, std::size_t size, TelemetryData& data,
+                     std::uint32_t* sequence) {
+    if (!bytes || size == 0) {
+        return false;
+    }
+    
+    if (hasMagic(bytes, size)) {
+        return decodeBinary(bytes, size, data, sequence);
+    }
+    return decodeCsv(bytes, size, data);
+}
+
+std::size_t decodeTelemetrySamples(const std::uint8_t* bytes, std::size_t size,
+                                   TelemetrySample* samples, std::size_t capacity,
+                                   std::uint32_t* sequence) {
+    if (!bytes || size == 0 || capacity == 0) {
+        return 0;
+    }
+    
+    if (hasMagic(bytes, size) && size > 5 &&
+        bytes[5] == static_cast<std::uint8_t>(telemetry_wire::FrameType::Batch)) {
+        return decodeBatch(bytes, size, samples, capacity, sequence);
+    }
+    
+    samples[0].vehicle_id = 0;
+    return decodeTelemetry(bytes, size, samples[0].data, sequence) ? 1 : 0;
+}
+
+std::size_t decodeSensorSamples(const std::uint8_t* bytes, std::size_t size,
+                                SensorSample* samples, std::size_t capacity,
+                                std::uint32_t* sequence) {
+    if (!bytes || capacity == 0 || !hasMagic(bytes, size)) {
+        return 0;
+    }
+    const std::size_t payloadSize{checkHeader(bytes, size, telemetry_wire::FrameType::Sensor)};
+    if (payloadSize < telemetry_wire::kSensorPrefixSize) {
+        return 0;
+    }
+    
+    const std::uint8_t* payload{bytes + kHeaderSize};
+    const std::size_t count{static_cast<std::size_t>(loadLE(payload, 2))};
+    const std::size_t recordSize{static_cast<std::size_t>(loadLE(payload + 2, 2))};
+    if (recordSize < telemetry_wire::kSensorRecordSize ||
+        payloadSize < telemetry_wire::kSensorPrefixSize + count * recordSize) {
+        return 0;
+    }
+    
+    const std::size_t decoded{std::min(count, capacity)};
+    for (std::size_t i = 0; i < decoded; ++i) {
+        if (!loadSensor(payload + telemetry_wire::kSensorPrefixSize + i * recordSize, samples[i])) {
+            return 0;
+        }
+    }
+    
+    if (sequence) {
+        *sequence = static_cast<std::uint32_t>(loadLE(bytes + 8, 4));
+    }
+    return decoded;
+}
+
+} // namespace falconsim
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "../physics/Sensors.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Telemetry data structure for network transmission
+ */
+struct TelemetryData {
+    // Timestamp
+    double timestamp{0.0};
+    
+    // Position (NED frame)
+    double position_north{0.0};
+    double position_east{0.0};
+    double position_down{0.0};
+    
+    // Velocity (body frame)
+    double velocity_x{0.0};
+    double velocity_y{0.0};
+    double velocity_z{0.0};
+    
+    // Orientation (euler angles in radians)
+    double roll{0.0};
+    double pitch{0.0};
+    double yaw{0.0};
+    
+    // Control inputs
+    double throttle{0.0};
+    double aileron{0.0};
+    double elevator{0.0};
+    double rudder{0.0};
+};
+
+/**
+ * @brief One vehicle's telemetry, as carried in a Batch frame
+ */
+struct TelemetrySample {
+    std::uint32_t vehicle_id{0};
+    TelemetryData data{};
+};
+
+/**
+ * @brief Wire format negotiated per telemetry client
+ */
+enum class TelemetryEncoding : std::uint8_t {
+    Binary,  // Versioned fixed-layout frame (default)
+    Csv,     // Human-readable debug fallback
+    Compact  // Quantized keyframe/delta frames (stateful, see CompactTelemetry.hpp)
+};
+
+/**
+ * @brief Layout of the binary telemetry frame
+ *
+ * Every frame starts with a 16-byte little-endian header:
+ *
+ *   offset  size  field
+ *        0     4  magic ("FSIM")
+ *        4     1  version
+ *        5     1  frame type
+ *        6     2  payload length (bytes)
+ *        8     4  sequence number
+ *       12     4  reserved (zero)
+ *
+ * A State frame carries the 14 TelemetryData fields as little-endian IEEE-754
+ * doubles, in declaration order.
+ *
+ * A Batch frame packs several samples into one datagram. Its payload starts
+ * with a u16 sample count and a u16 record size, followed by that many
+ * records: u32 vehicle id, u32 reserved, then the 14 State doubles. The
+ * record size lets later versions append fields that old receivers skip.
+ *
+ * A Sensor frame carries simulated sensor measurements (see Sensors.hpp) in
+ * the same layout: a u16 count and u16 record size, then records of u32
+ * vehicle id, u8 sensor kind, u8 and u16 reserved, the measurement time and
+ * the 6 sensor values, all doubles.
+ *
+ * Receivers must reject unknown versions and may ignore unknown frame types.
+ */
+namespace telemetry_wire {
+
+constexpr std::array<std::uint8_t, 4> kMagic{'F', 'S', 'I', 'M'};
+constexpr std::uint8_t kVersion{1};
+constexpr std::size_t kHeaderSize{16};
+
+enum class FrameType : std::uint8_t {
+    State = 1,
+    Batch = 2,
+    Sensor = 3
+};
+
+constexpr std::size_t kStateFieldCount{14};
+constexpr std::size_t kStatePayloadSize{kStateFieldCount * sizeof(double)};
+constexpr std::size_t kStateFrameSize{kHeaderSize + kStatePayloadSize};
+
+// Largest datagram we emit: a 1500-byte Ethernet MTU minus IPv4 and UDP headers
+constexpr std::size_t kMaxDatagramSize{1472};
+
+constexpr std::size_t kBatchPrefixSize{4};
+constexpr std::size_t kBatchRecordSize{8 + kStatePayloadSize};
+constexpr std::size_t kMaxBatchSamples{(kMaxDatagramSize - kHeaderSize - kBatchPrefixSize) / kBatchRecordSize};
+
+constexpr std::size_t kSensorPrefixSize{4};
+constexpr std::size_t kSensorRecordSize{8 + (1 + kSensorValueCount) * sizeof(double)};
+constexpr std::size_t kMaxSensorSamples{(kMaxDatagramSize - kHeaderSize - kSensorPrefixSize) / kSensorRecordSize};
+
+// CSV lines that would not fit (absurd magnitudes) are dropped
+constexpr std::size_t kMaxCsvSize{512};
+
+} // namespace telemetry_wire
+
+/**
+ * @brief Fixed-capacity buffer a telemetry frame is encoded into (no allocation)
+ */
+struct TelemetryFrameBuffer {
+    std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> bytes{};
+    std::size_t size{0};
+};
+
+// Encode a binary State frame; returns the frame size
+std::size_t encodeTelemetryBinary(const TelemetryData& data, std::uint32_t sequence,
+                                  TelemetryFrameBuffer& frame);
+
+// Encode up to kMaxBatchSamples samples as one Batch frame; returns how many were packed
+std::size_t encodeTelemetryBatch(const TelemetrySample* samples, std::size_t count,
+                                 std::uint32_t sequence, TelemetryFrameBuffer& frame);
+
+// Encode up to kMaxSensorSamples sensor samples as one Sensor frame; returns how many were packed
+std::size_t encodeSensorBatch(const SensorSample* samples, std::size_t count,
+                              std::uint32_t sequence, TelemetryFrameBuffer& frame);
+
+// Encode the CSV debug format (timestamp first, 6 decimal places); returns its size
+std::size_t encodeTelemetryCsv(const TelemetryData& data, TelemetryFrameBuffer& frame);
+
+// Encode with the given wire format (Compact needs a CompactTelemetryEncoder and encodes as Binary here)
+std::size_t encodeTelemetry(TelemetryEncoding encoding, const TelemetryData& data,
+                            std::uint32_t sequence, TelemetryFrameBuffer& frame);
+
+// Decode a State frame or CSV line (detected by the magic); false if malformed or a Batch frame
+bool decodeTelemetry(const std::uint8_t* bytes, std::size_t size, TelemetryData& data,
+                     std::uint32_t* sequence = nullptr);
+
+// Decode any frame type into samples (State and CSV yield vehicle 0); returns the
+// number of samples written, at most capacity, or 0 if malformed
+std::size_t decodeTelemetrySamples(const std::uint8_t* bytes, std::size_t size,
+                                   TelemetrySample* samples, std::size_t capacity,
+                                   std::uint32_t* sequence = nullptr);
+
+// Decode a Sensor frame; returns the number of samples written, at most capacity,
+// or 0 if malformed or another frame type
+std::size_t decodeSensorSamples(const std::uint8_t* bytes, std::size_t size,
+                                SensorSample* samples, std::size_t capacity,
+                                std::uint32_t* sequence = nullptr);
+
+} // namespace falconsim
@@ -0,0 +1,145 @@
+#include "TelemetryReceiver.hpp"
+#include "../core/Trace.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace falconsim {
+
+TelemetryReceiver::TelemetryReceiver(std::string host, uint16_t port, std::string registration)
+    : m_host{std::move(host)},
+      m_port{port},
+      m_registration{std::move(registration)},
+      m_slots{std::make_unique<SeqLock<TelemetrySample>[]>(kMaxVehicles)} {
+}
+
+TelemetryReceiver::~TelemetryReceiver() {
+    stop();
+}
+
+void TelemetryReceiver::start() {
+    if (m_running) {
+        return;
+    }
+    
+    try {
+        boost::asio::ip::udp::resolver resolver{m_ioContext};
+        m_serverEndpoint = *resolver.resolve(boost::asio::ip::udp::v4(), m_host, std::to_string(m_port)).begin();
+        m_socket = std::make_unique<boost::asio::ip::udp::socket>(
+            m_ioContext,
+            boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0)
+        );
+        m_socket->send_to(boost::asio::buffer(m_registration), m_serverEndpoint);
+    }
+    catch (const std::exception& e) {
+        m_socket.reset();
+        throw std::runtime_error{"Cannot receive telemetry from " + m_host + ":" + std::to_string(m_port) +
+                                 ": " + e.what()};
+    }
+    
+    m_running = true;
+    startReceive();
+    m_receiveThread = std::thread{[this] {
+        FALCONSIM_TRACE_THREAD_NAME("telemetry receiver");
+        m_ioContext.run();
+    }};
+}
+
+void TelemetryReceiver::stop() {
+    if (!m_running) {
+        return;
+    }
+    
+    m_running = false;
+    boost::asio::post(m_ioContext, [this] {
+        boost::system::error_code ec;
+        m_socket->send_to(boost::asio::buffer(std::string{"UNREGISTER"}), m_serverEndpoint, 0, ec);
+        m_socket->close(ec);
+    });
+    if (m_receiveThread.joinable()) {
+        m_receiveThread.join();
+    }
+    
+    m_ioContext.restart();
+    m_socket.reset();
+}
+
+bool TelemetryReceiver::isRunning() const {
+    return m_running;
+}
+
+uint16_t TelemetryReceiver::getLocalPort() const {
+    return m_socket ? m_socket->local_endpoint().port() : 0;
+}
+
+std::uint64_t TelemetryReceiver::getDatagrams() const {
+    return m_datagrams.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TelemetryReceiver::getMalformed() const {
+    return m_malformed.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TelemetryReceiver::getDroppedVehicles() const {
+    return m_droppedVehicles.load(std::memory_order_relaxed);
+}
+
+std::size_t TelemetryReceiver::getVehicleCount() const {
+    return m_vehicleCount.load(std::memory_order_acquire);
+}
+
+void TelemetryReceiver::startReceive() {
+    m_socket->async_receive_from(
+        boost::asio::buffer(m_receiveBuffer), m_senderEndpoint,
+        [this](const boost::system::error_code& ec, std::size_t bytes) {
+            onReceive(ec, bytes);
+        });
+}
+
+void TelemetryReceiver::onReceive(const boost::system::error_code& ec, std::size_t bytes) {
+    if (ec == boost::asio::error::operation_aborted || !m_running) {
+        return;
+    }
+    
+    FALCONSIM_TRACE_ZONE("TelemetryReceiver::onReceive");
+    if (!ec) {
+        m_datagrams.fetch_add(1, std::memory_order_relaxed);
+        
+        // Compact frames carry a single vehicle; everything else may be a batch
+        std::size_t count{0};
+        if (isCompactTelemetryFrame(m_receiveBuffer.data(), bytes)) {
+            count = m_compactDecoder.decode(m_receiveBuffer.data(), bytes, m_samples[0]) ? 1 : 0;
+        } else {
+            count = decodeTelemetrySamples(m_receiveBuffer.data(), bytes, m_samples.data(), m_samples.size());
+        }
+        if (count == 0) {
+            m_malformed.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        // A batch may hold several steps of one vehicle; the slot keeps the last
+        for (std::size_t i = 0; i < count; ++i) {
+            publish(m_samples[i]);
+        }
+    } else {
+        std::cerr << "Error receiving telemetry: " << ec.message() << std::endl;
+    }
+    startReceive();
+}
+
+void TelemetryReceiver::publish(const TelemetrySample& sample) {
+    auto it = m_vehicleSlots.find(sample.vehicle_id);
+    if (it == m_vehicleSlots.end()) {
+        const std::size_t slot{m_vehicleSlots.size()};
+        if (slot == kMaxVehicles) {
+            m_droppedVehicles.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_slots[slot].store(sample);
+        m_vehicleSlots.emplace(sample.vehicle_id, slot);
+        m_vehicleCount.store(slot + 1, std::memory_order_release);
+        return;
+    }
+    m_slots[it->second].store(sample);
+}
+
+} // namespace falconsim
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "CompactTelemetry.hpp"
+#include "TelemetryCodec.hpp"
+#include "../core/SeqLock.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Client side of the telemetry stream; decodes it on a thread of its own
+ *
+ * The receiver registers with a TelemetryServer and decodes every datagram
+ * (binary, batch, compact or CSV) on its own thread. Each vehicle's newest
+ * sample goes into a fixed slot guarded by a SeqLock. A consumer, usually a
+ * UI frame timer, calls pollUpdates() whenever it is ready to draw. It then
+ * sees each vehicle that changed since the last poll exactly once, however
+ * many datagrams arrived in between. Neither side blocks the other.
+ *
+ * Vehicles get slots in the order they are first heard from; slot 0 is the
+ * primary vehicle. Slots are kept for the receiver's lifetime.
+ */
+class TelemetryReceiver {
+public:
+    // Vehicles beyond this many are counted as dropped
+    static constexpr std::size_t kMaxVehicles{16384};
+    
+    explicit TelemetryReceiver(std::string host, uint16_t port = 12345,
+                               std::string registration = "REGISTER BINARY");
+    ~TelemetryReceiver();
+    
+    // Deleted copy and move operations
+    TelemetryReceiver(const TelemetryReceiver&) = delete;
+    TelemetryReceiver& operator=(const TelemetryReceiver&) = delete;
+    TelemetryReceiver(TelemetryReceiver&&) = delete;
+    TelemetryReceiver& operator=(TelemetryReceiver&&) = delete;
+    
+    // Bind, register with the server and start receiving (throws std::runtime_error)
+    void start();
+    
+    // Unregister and join the receive thread
+    void stop();
+    [[nodiscard]] bool isRunning() const;
+    
+    // Local port the stream arrives on (valid once started)
+    [[nodiscard]] uint16_t getLocalPort() const;
+    
+    // Call visit(slot, sample) for every vehicle updated since the previous
+    // poll; returns how many were visited (single consumer thread only)
+    template <typename Visitor>
+    std::size_t pollUpdates(Visitor&& visit);
+    
+    // Statistics
+    [[nodiscard]] std::uint64_t getDatagrams() const;
+    [[nodiscard]] std::uint64_t getMalformed() const;       // Datagrams that did not decode
+    [[nodiscard]] std::uint64_t getDroppedVehicles() const; // Samples of vehicles that found no free slot
+    [[nodiscard]] std::size_t getVehicleCount() const;
+
+private:
+    void startReceive();
+    void onReceive(const boost::system::error_code& ec, std::size_t bytes);
+    void publish(const TelemetrySample& sample);
+    
+    std::string m_host;
+    uint16_t m_port{12345};
+    std::string m_registration;
+    
+    boost::asio::io_context m_ioContext{};
+    std::unique_ptr<boost::asio::ip::udp::socket> m_socket{};
+    boost::asio::ip::udp::endpoint m_serverEndpoint{};
+    boost::asio::ip::udp::endpoint m_senderEndpoint{};
+    std::array<std::uint8_t, 65536> m_receiveBuffer{};
+    std::thread m_receiveThread{};
+    std::atomic<bool> m_running{false};
+    
+    // Receive thread only
+    std::array<TelemetrySample, telemetry_wire::kMaxBatchSamples> m_samples{};
+    CompactTelemetryDecoder m_compactDecoder{};
+    std::unordered_map<std::uint32_t, std::size_t> m_vehicleSlots{};
+    
+    // Latest sample per vehicle; a slot is filled before m_vehicleCount covers it
+    std::unique_ptr<SeqLock<TelemetrySample>[]> m_slots;
+    std::atomic<std::size_t> m_vehicleCount{0};
+    
+    // Consumer only: version of each slot as of the previous poll
+    std::vector<std::uint64_t> m_seenVersions{};
+    
+    // Statistics
+    std::atomic<std::uint64_t> m_datagrams{0};
+    std::atomic<std::uint64_t> m_malformed{0};
+    std::atomic<std::uint64_t> m_droppedVehicles{0};
+};
+
+template <typename Visitor>
+std::size_t TelemetryReceiver::pollUpdates(Visitor&& visit) {
+    const std::size_t count{m_vehicleCount.load(std::memory_order_acquire)};
+    if (m_seenVersions.size() < count) {
+        m_seenVersions.resize(count, 1); // A default-constructed SeqLock is at version 1
+    }
+    
+    std::size_t updated{0};
+    TelemetrySample sample;
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        if (m_slots[slot].version() == m_seenVersions[slot]) {
+            continue;
+        }
+        m_seenVersions[slot] = m_slots[slot].load(sample);
+        visit(slot, static_cast<const TelemetrySample&>(sample));
+        ++updated;
+    }
+    return updated;
+}
+
+} // namespace falconsim
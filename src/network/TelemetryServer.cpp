@@ -1,13 +1,73 @@
 #include "TelemetryServer.hpp"
+#include "../core/Trace.hpp"
+#include <algorithm>
+#include <cctype>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
 #include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 namespace falconsim {
 
-TelemetryServer::TelemetryServer(uint16_t port)
-    : m_port{port} {
+namespace {
+
+TelemetryData makeTelemetry(const AircraftState& state, const ControlInputs& controls, double timestamp) {
+    TelemetryData data;
+    data.timestamp = timestamp;
+    
+    // Position
+    data.position_north = state.position.x();
+    data.position_east = state.position.y();
+    data.position_down = state.position.z();
+    
+    // Velocity
+    data.velocity_x = state.velocity.x();
+    data.velocity_y = state.velocity.y();
+    data.velocity_z = state.velocity.z();
+    
+    // Orientation
+    data.roll = state.euler_angles.x();
+    data.pitch = state.euler_angles.y();
+    data.yaw = state.euler_angles.z();
+    
+    // Control inputs
+    data.throttle = controls.throttle;
+    data.aileron = controls.aileron;
+    data.elevator = controls.elevator;
+    data.rudder = controls.rudder;
+    return data;
+}
+
+// Parse a decimation factor (a positive integer); false for anything else
+bool parseDecimation(const std::string& word, std::uint32_t& decimation) {
+    if (word.empty() || word.size() > 9 ||
+        !std::all_of(word.begin(), word.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        return false;
+    }
+    const unsigned long value{std::stoul(word)};
+    if (value == 0) {
+        return false;
+    }
+    decimation = static_cast<std::uint32_t>(value);
+    return true;
+}
+
+} // namespace
+
+TelemetryServer::TelemetryServer(uint16_t port, std::size_t queueCapacity, std::size_t sensorQueueCapacity)
+    : m_telemetryQueue{queueCapacity}
+    , m_sensorQueue{sensorQueueCapacity}
+    , m_port{port} {
+    m_tickSamples.reserve(m_telemetryQueue.capacity());
+    m_sampleIndices.reserve(m_telemetryQueue.capacity());
+    m_groupSamples.reserve(m_telemetryQueue.capacity());
+    m_sensorSamples.reserve(m_sensorQueue.capacity());
 }
 
 TelemetryServer::~TelemetryServer() {
@@ -20,6 +80,8 @@ void TelemetryServer::start() {
     }
     
     m_running = true;
+    m_flushPending = false;
+    m_sensorFlushPending = false;
     
     try {
         // Initialize networking components
@@ -27,14 +89,24 @@ void TelemetryServer::start() {
             m_ioContext, 
             boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), m_port)
         );
+        m_port = m_socket->local_endpoint().port(); // Resolves an ephemeral port 0
+        applyMulticastOptions();
         
-        // Start server thread
-        m_serverThread = std::thread{&TelemetryServer::serverLoop, this};
+        // Arm the receive and the send timer, then run the io_context
+        boost::asio::post(m_strand, [this] {
+            startReceive();
+            scheduleTick();
+        });
+        m_serverThread = std::thread{[this] {
+            FALCONSIM_TRACE_THREAD_NAME("telemetry");
+            m_ioContext.run();
+        }};
         
         std::cout << "Telemetry server started on port " << m_port << std::endl;
     }
     catch (const std::exception& e) {
         std::cerr << "Failed to start telemetry server: " << e.what() << std::endl;
+        m_socket.reset();
         m_running = false;
     }
 }
@@ -46,166 +118,772 @@ void TelemetryServer::stop() {
     
     m_running = false;
     
-    // Close socket
-    if (m_socket && m_socket->is_open()) {
-        boost::system::error_code ec;
-        m_socket->close(ec);
-    }
-    
-    // Stop IO context
-    m_ioContext.stop();
+    // Close the socket and cancel the timer on the strand; outstanding
+    // operations complete with operation_aborted and run() returns
+    boost::asio::post(m_strand, [this] {
+        m_timer.cancel();
+        if (m_socket && m_socket->is_open()) {
+            boost::system::error_code ec;
+            m_socket->close(ec);
+        }
+    });
     
     // Join server thread
     if (m_serverThread.joinable()) {
         m_serverThread.join();
     }
     
+    // Allow a later start(); every aborted send has released its slot by now
+    m_ioContext.restart();
+    m_socket.reset();
+    
     std::cout << "Telemetry server stopped" << std::endl;
 }
 
-void TelemetryServer::serverLoop() {
-    auto lastUpdateTime = std::chrono::high_resolution_clock::now();
-    double updateIntervalSec = 1.0 / m_updateRate;
+void TelemetryServer::scheduleTick() {
+    const std::chrono::duration<double> interval{1.0 / m_updateRate.load()};
+    m_timer.expires_after(std::chrono::duration_cast<boost::asio::steady_timer::duration>(interval));
+    m_timer.async_wait(boost::asio::bind_executor(m_strand, [this](const boost::system::error_code& ec) {
+        onTick(ec);
+    }));
+}
     
-    while (m_running) {
-        // Process any pending telemetry data
-        processTelemetryQueue();
-        
-        // Sleep to maintain desired update rate
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = currentTime - lastUpdateTime;
-        
-        if (elapsed.count() < updateIntervalSec) {
-            std::this_thread::sleep_for(std::chrono::duration<double>(
-                updateIntervalSec - elapsed.count()
-            ));
-        }
+void TelemetryServer::onTick(const boost::system::error_code& ec) {
+    if (ec || !m_running) {
+        return;
+    }
         
-        lastUpdateTime = std::chrono::high_resolution_clock::now();
+    // In PhysicsStep mode the producers drive sending and the timer just idles
+    if (m_streamMode.load(std::memory_order_relaxed) == TelemetryStreamMode::Timer) {
+        flush();
+    }
+    scheduleTick();
+}
+
+void TelemetryServer::onStepFlush() {
+    // Clear the flag before draining, so a sample queued from here on posts a new flush
+    m_flushPending.store(false);
+    if (!m_running) {
+        return;
+    }
+    
+    flush();
+    
+    // The drain budget may have left samples behind
+    if (m_telemetryQueue.sizeApprox() > 0 && !m_flushPending.exchange(true)) {
+        boost::asio::post(m_strand, [this] { onStepFlush(); });
     }
 }
 
-void TelemetryServer::processTelemetryQueue() {
-    std::lock_guard<std::mutex> lock{m_queueMutex};
+void TelemetryServer::onSensorFlush() {
+    m_sensorFlushPending.store(false);
+    if (!m_running) {
+        return;
+    }
     
-    if (m_telemetryQueue.empty()) {
+    // Drain at most one ring's worth, then come back for the rest
+    m_sensorSamples.clear();
+    const std::size_t budget{m_sensorQueue.capacity()};
+    SensorSample sample;
+    while (m_sensorSamples.size() < budget && m_sensorQueue.tryPop(sample)) {
+        m_sensorSamples.push_back(sample);
+    }
+    if (!m_sensorSamples.empty()) {
+        broadcastSensors();
+    }
+    
+    if (m_sensorQueue.sizeApprox() > 0 && !m_sensorFlushPending.exchange(true)) {
+        boost::asio::post(m_strand, [this] { onSensorFlush(); });
+    }
+}
+
+void TelemetryServer::flush() {
+    FALCONSIM_TRACE_ZONE("TelemetryServer::flush");
+    const auto flushStart{std::chrono::steady_clock::now()};
+    const std::size_t depth{m_telemetryQueue.sizeApprox()};
+    if (depth > m_maxDepth.load(std::memory_order_relaxed)) {
+        m_maxDepth.store(depth, std::memory_order_relaxed);
+    }
+        
+    drainQueue();
+    if (m_tickSamples.empty()) {
         return;
     }
+    broadcast();
     
-    // Get next telemetry data to send
-    TelemetryData data = m_telemetryQueue.front();
-    m_telemetryQueue.pop();
+    m_queueDepth.record(depth);
+    m_flushTime.record(nanosecondsSince(flushStart));
+    publishClientMetrics();
+}
+
+void TelemetryServer::publishClientMetrics() {
+    // Copying into the existing vector reuses its capacity
+    std::lock_guard<std::mutex> lock{m_clientMetricsMutex};
+    m_clientMetrics.assign(m_clients.begin(), m_clients.end());
+}
+
+void TelemetryServer::drainQueue() {
+    m_tickSamples.clear();
     
-    // Serialize data
-    std::string message = serializeTelemetry(data);
+    // Never drain more than one queue's worth per tick, so a producer that
+    // outruns the consumer cannot keep this handler spinning
+    const std::size_t budget{m_telemetryQueue.capacity()};
+    const bool conflate{m_queuePolicy.load(std::memory_order_relaxed) == TelemetryQueuePolicy::ConflateLatest};
+    TelemetrySample sample;
+    std::size_t drained{0};
+    ++m_drainTick;
     
-    // Send to all clients
-    {
-        std::lock_guard<std::mutex> clientsLock{m_clientsMutex};
+    while (drained < budget && m_telemetryQueue.tryPop(sample)) {
+        ++drained;
         
-        for (const auto& endpoint : m_clients) {
-            try {
-                m_socket->send_to(
-                    boost::asio::buffer(message), 
-                    endpoint
-                );
-            } catch (const std::exception& e) {
-                std::cerr << "Error sending telemetry: " << e.what() << std::endl;
+        // Conflation keeps the newest sample per vehicle, in first-seen order
+        if (conflate) {
+            VehicleSlot& slot{vehicleSlot(sample.vehicle_id)};
+            if (slot.drainTick == m_drainTick) {
+                m_tickSamples[slot.tickSample] = sample;
+                continue;
             }
+            slot.drainTick = m_drainTick;
+            slot.tickSample = m_tickSamples.size();
         }
+        m_tickSamples.push_back(sample);
+    }
+    
+    if (conflate) {
+        m_conflated.fetch_add(drained - m_tickSamples.size(), std::memory_order_relaxed);
     }
 }
 
-void TelemetryServer::sendTelemetry(const TelemetryData& data) {
-    std::lock_guard<std::mutex> lock{m_queueMutex};
+void TelemetryServer::broadcast() {
+    m_sent.fetch_add(m_tickSamples.size(), std::memory_order_relaxed);
+    
+    // Number each vehicle's samples, so a client with decimation N gets every Nth one
+    m_sampleIndices.clear();
+    for (const auto& sample : m_tickSamples) {
+        m_sampleIndices.push_back(vehicleSlot(sample.vehicle_id).samplesSent++);
+    }
+    
+    // Clients sharing a decimation share the encoded frames
+    m_decimations.clear();
+    for (const auto& client : m_clients) {
+        if (std::find(m_decimations.begin(), m_decimations.end(), client.decimation) == m_decimations.end()) {
+            m_decimations.push_back(client.decimation);
+        }
+    }
     
-    // Add to queue (limit queue size to prevent memory issues)
-    if (m_telemetryQueue.size() < 100) {
-        m_telemetryQueue.push(data);
+    for (std::uint32_t decimation : m_decimations) {
+        m_groupSamples.clear();
+        for (std::size_t i = 0; i < m_tickSamples.size(); ++i) {
+            if (m_sampleIndices[i] % decimation == 0) {
+                m_groupSamples.push_back(m_tickSamples[i]);
+            }
+        }
+        if (!m_groupSamples.empty()) {
+            broadcastGroup(decimation);
+        }
     }
 }
 
-void TelemetryServer::updateFromState(const AircraftState& state, const ControlInputs& controls) {
-    TelemetryData data;
+void TelemetryServer::broadcastGroup(std::uint32_t decimation) {
+    bool binaryClients{false};
+    bool csvClients{false};
+    bool compactClients{false};
+    for (const auto& client : m_clients) {
+        if (client.decimation != decimation) {
+            continue;
+        }
+        switch (client.encoding) {
+            case TelemetryEncoding::Binary: binaryClients = true; break;
+            case TelemetryEncoding::Csv: csvClients = true; break;
+            case TelemetryEncoding::Compact: compactClients = true; break;
+        }
+    }
     
-    // Set timestamp
-    data.timestamp = std::chrono::duration<double>(
-        std::chrono::high_resolution_clock::now().time_since_epoch()
-    ).count();
+    // Binary clients get State frames, or Batch frames packing several samples
+    if (binaryClients) {
+        const std::size_t perDatagram{m_samplesPerDatagram.load(std::memory_order_relaxed)};
+        for (std::size_t first = 0; first < m_groupSamples.size();) {
+            FrameSlot* slot{acquireSlot()};
+            if (!slot) {
+                break;
+            }
     
-    // Position
-    data.position_north = state.position.x();
-    data.position_east = state.position.y();
-    data.position_down = state.position.z();
+            const auto encodeStart{std::chrono::steady_clock::now()};
+            std::size_t packed{1};
+            if (perDatagram > 1) {
+                packed = encodeTelemetryBatch(m_groupSamples.data() + first,
+                                              std::min(perDatagram, m_groupSamples.size() - first),
+                                              m_sequence++, slot->frame);
+            } else {
+                encodeTelemetryBinary(m_groupSamples[first].data, m_sequence++, slot->frame);
+            }
+            m_encodeTime.record(nanosecondsSince(encodeStart));
+            fanOut(*slot, TelemetryEncoding::Binary, decimation);
+            first += packed;
+        }
+    }
     
-    // Velocity
-    data.velocity_x = state.velocity.x();
-    data.velocity_y = state.velocity.y();
-    data.velocity_z = state.velocity.z();
+    // Compact frames are per sample; the encoder tracks keyframes per vehicle
+    if (compactClients) {
+        CompactTelemetryEncoder& encoder{compactEncoderFor(decimation)};
+        for (const auto& sample : m_groupSamples) {
+            FrameSlot* slot{acquireSlot()};
+            if (!slot) {
+                break;
+            }
+            const auto encodeStart{std::chrono::steady_clock::now()};
+            const std::size_t size{encoder.encode(sample, slot->frame)};
+            m_encodeTime.record(nanosecondsSince(encodeStart));
+            if (size > 0) {
+                fanOut(*slot, TelemetryEncoding::Compact, decimation);
+            }
+        }
+    }
     
-    // Orientation
-    data.roll = state.euler_angles.x();
-    data.pitch = state.euler_angles.y();
-    data.yaw = state.euler_angles.z();
+    // The CSV fallback stays one line per sample
+    if (csvClients) {
+        for (const auto& sample : m_groupSamples) {
+            FrameSlot* slot{acquireSlot()};
+            if (!slot) {
+                break;
+            }
+            const auto encodeStart{std::chrono::steady_clock::now()};
+            const std::size_t size{encodeTelemetryCsv(sample.data, slot->frame)};
+            m_encodeTime.record(nanosecondsSince(encodeStart));
+            if (size > 0) {
+                fanOut(*slot, TelemetryEncoding::Csv, decimation);
+            }
+        }
+    }
+}
+
+void TelemetryServer::broadcastSensors() {
+    const std::vector<SensorSample>& samples{m_sensorSamples};
     
-    // Control inputs
-    data.throttle = controls.throttle;
-    data.aileron = controls.aileron;
-    data.elevator = controls.elevator;
-    data.rudder = controls.rudder;
+    // Subscribed clients get every measurement whatever their decimation
+    bool subscribers{false};
+    for (const auto& client : m_clients) {
+        subscribers = subscribers || client.sensors;
+    }
+    if (!subscribers) {
+        m_sensorSent.fetch_add(samples.size(), std::memory_order_relaxed);
+        return;
+    }
+    
+    for (std::size_t first = 0; first < samples.size();) {
+        FrameSlot* slot{acquireSlot()};
+        if (!slot) {
+            // Every slot is in flight: the rest of the batch is lost to every subscriber
+            m_sensorDropped.fetch_add(samples.size() - first, std::memory_order_relaxed);
+            for (auto& client : m_clients) {
+                if (client.sensors) {
+                    ++client.skipped;
+                    m_clientSkips.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            break;
+        }
+        const auto encodeStart{std::chrono::steady_clock::now()};
+        const std::size_t packed{encodeSensorBatch(samples.data() + first, samples.size() - first, m_sequence++,
+                                                   slot->frame)};
+        m_encodeTime.record(nanosecondsSince(encodeStart));
+        
+        m_fanOutClients.clear();
+        for (std::size_t i = 0; i < m_clients.size(); ++i) {
+            if (!m_clients[i].sensors) {
+                continue;
+            }
+            if (m_clients[i].pendingSends >= kMaxPendingSendsPerClient) {
+                ++m_clients[i].skipped;
+                m_clientSkips.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            m_fanOutClients.push_back(i);
+        }
+        sendToSelected(*slot);
+        m_sensorSent.fetch_add(packed, std::memory_order_relaxed);
+        first += packed;
+    }
+    publishClientMetrics();
+}
+
+void TelemetryServer::fanOut(FrameSlot& slot, TelemetryEncoding encoding, std::uint32_t decimation) {
+    // Clients of this encoding and decimation that are not backed up
+    m_fanOutClients.clear();
+    for (std::size_t i = 0; i < m_clients.size(); ++i) {
+        if (m_clients[i].encoding != encoding || m_clients[i].decimation != decimation) {
+            continue;
+        }
+        if (m_clients[i].pendingSends >= kMaxPendingSendsPerClient) {
+            ++m_clients[i].skipped;
+            m_clientSkips.fetch_add(1, std::memory_order_relaxed);
+            continue; // Backed-up client skips this frame
+        }
+        m_fanOutClients.push_back(i);
+    }
+    sendToSelected(slot);
+}
+
+void TelemetryServer::sendToSelected(FrameSlot& slot) {
+    FALCONSIM_TRACE_ZONE("TelemetryServer::send");
+    std::size_t sent{0};
     
-    // Send telemetry
-    sendTelemetry(data);
+#if defined(__linux__)
+    // One sendmmsg call hands the frame to every endpoint; the kernel copies
+    // the shared iovec per message, so the slot is free again on return. This
+    // is tried for a single client too, so a burst of physics steps does not
+    // pile up async sends behind the per-client limit
+    if (!m_fanOutClients.empty()) {
+        m_messageHeaders.resize(m_fanOutClients.size());
+        iovec payload{slot.frame.bytes.data(), slot.frame.size};
+        for (std::size_t i = 0; i < m_fanOutClients.size(); ++i) {
+            auto& endpoint = m_clients[m_fanOutClients[i]].endpoint;
+            mmsghdr& header{m_messageHeaders[i]};
+            header = mmsghdr{};
+            header.msg_hdr.msg_name = endpoint.data();
+            header.msg_hdr.msg_namelen = static_cast<socklen_t>(endpoint.size());
+            header.msg_hdr.msg_iov = &payload;
+            header.msg_hdr.msg_iovlen = 1;
+        }
+        
+        while (sent < m_fanOutClients.size()) {
+            m_sendCalls.fetch_add(1, std::memory_order_relaxed);
+            const int result{::sendmmsg(m_socket->native_handle(), m_messageHeaders.data() + sent,
+                                        static_cast<unsigned int>(m_fanOutClients.size() - sent), MSG_DONTWAIT)};
+            if (result > 0) {
+                for (std::size_t i = sent; i < sent + static_cast<std::size_t>(result); ++i) {
+                    ++m_clients[m_fanOutClients[i]].datagramsSent;
+                }
+                sent += static_cast<std::size_t>(result);
+                m_datagramsSent.fetch_add(static_cast<std::uint64_t>(result), std::memory_order_relaxed);
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break; // Socket buffer full: finish asynchronously below
+            } else {
+                // Skip the message that failed and keep going with the rest
+                m_sendErrors.fetch_add(1, std::memory_order_relaxed);
+                ++m_clients[m_fanOutClients[sent]].sendErrors;
+                ++sent;
+            }
+        }
+    }
+#endif
+    
+    for (std::size_t i = sent; i < m_fanOutClients.size(); ++i) {
+        TelemetryClient& client{m_clients[m_fanOutClients[i]]};
+        ++slot.pendingSends;
+        ++client.pendingSends;
+        m_sendCalls.fetch_add(1, std::memory_order_relaxed);
+        
+        FrameSlot* slotPtr{&slot};
+        const boost::asio::ip::udp::endpoint endpoint{client.endpoint};
+        m_socket->async_send_to(
+            boost::asio::buffer(slot.frame.bytes.data(), slot.frame.size), endpoint,
+            boost::asio::bind_executor(m_strand, [this, slotPtr, endpoint](const boost::system::error_code& sendError,
+                                                                          std::size_t) {
+                --slotPtr->pendingSends;
+                
+                // The client may have unregistered while the send was in flight
+                auto it = std::find_if(m_clients.begin(), m_clients.end(),
+                                       [&endpoint](const TelemetryClient& c) { return c.endpoint == endpoint; });
+                const bool registered{it != m_clients.end()};
+                if (registered && it->pendingSends > 0) {
+                    --it->pendingSends;
+                }
+                
+                if (!sendError) {
+                    m_datagramsSent.fetch_add(1, std::memory_order_relaxed);
+                    if (registered) {
+                        ++it->datagramsSent;
+                    }
+                } else if (sendError != boost::asio::error::operation_aborted) {
+                    m_sendErrors.fetch_add(1, std::memory_order_relaxed);
+                    if (registered) {
+                        ++it->sendErrors;
+                    }
+                    std::cerr << "Error sending telemetry: " << sendError.message() << std::endl;
+                }
+            }));
+    }
 }
 
-void TelemetryServer::addClient(const std::string& address, uint16_t port) {
-    std::lock_guard<std::mutex> lock{m_clientsMutex};
+TelemetryServer::FrameSlot* TelemetryServer::acquireSlot() {
+    for (std::size_t i = 0; i < kFrameSlots; ++i) {
+        FrameSlot& slot{m_frameSlots[(m_nextSlot + i) % kFrameSlots]};
+        if (slot.pendingSends == 0) {
+            m_nextSlot = (m_nextSlot + i + 1) % kFrameSlots;
+            return &slot;
+        }
+    }
     
-    boost::asio::ip::udp::endpoint endpoint{
-        boost::asio::ip::make_address(address),
-        port
-    };
+    // Every slot is waiting on slow sends; the frame is dropped
+    m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+TelemetryServer::VehicleSlot& TelemetryServer::vehicleSlot(std::uint32_t vehicleId) {
+    // Slots are never reclaimed, so a steady fleet hashes into a fixed table
+    auto it = m_vehicleSlotIndex.find(vehicleId);
+    if (it == m_vehicleSlotIndex.end()) {
+        it = m_vehicleSlotIndex.emplace(vehicleId, m_vehicleSlots.size()).first;
+        m_vehicleSlots.emplace_back();
+    }
+    return m_vehicleSlots[it->second];
+}
+
+CompactTelemetryEncoder& TelemetryServer::compactEncoderFor(std::uint32_t decimation) {
+    // Compact receivers with different decimations see different frames, so
+    // each decimation keeps its own keyframe schedule
+    auto it = std::find_if(m_compactStreams.begin(), m_compactStreams.end(),
+                           [decimation](const CompactStream& c) { return c.decimation == decimation; });
+    if (it != m_compactStreams.end()) {
+        return it->encoder;
+    }
+    m_compactStreams.push_back(CompactStream{decimation, CompactTelemetryEncoder{m_compactKeyframeInterval}});
+    return m_compactStreams.back().encoder;
+}
+
+void TelemetryServer::startReceive() {
+    m_socket->async_receive_from(
+        boost::asio::buffer(m_receiveBuffer), m_remoteEndpoint,
+        boost::asio::bind_executor(m_strand, [this](const boost::system::error_code& ec, std::size_t bytes) {
+            onReceive(ec, bytes);
+        }));
+}
+
+void TelemetryServer::onReceive(const boost::system::error_code& ec, std::size_t bytes) {
+    if (ec == boost::asio::error::operation_aborted || !m_running) {
+        return;
+    }
+    
+    // ICMP errors from earlier sends surface here on some platforms; keep listening
+    if (!ec) {
+        handleCommand(std::string(m_receiveBuffer.data(), bytes), m_remoteEndpoint);
+    }
+    startReceive();
+}
+
+void TelemetryServer::handleCommand(const std::string& command, const boost::asio::ip::udp::endpoint& sender) {
+    // Commands are case-insensitive words, optionally newline-terminated:
+    // REGISTER [BINARY|COMPACT|CSV] [decimation] [SENSORS], or UNREGISTER
+    std::string normalized;
+    for (char c : command) {
+        normalized += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    std::istringstream stream{normalized};
+    std::vector<std::string> words;
+    for (std::string word; stream >> word;) {
+        words.push_back(word);
+    }
+    
+    if (words.size() == 1 && words[0] == "UNREGISTER") {
+        unregisterClient(sender);
+        return;
+    }
+    
+    if (!words.empty() && words.size() <= 4 && words[0] == "REGISTER") {
+        TelemetryEncoding encoding{TelemetryEncoding::Binary};
+        std::uint32_t decimation{1};
+        std::size_t next{1};
+        if (next < words.size() && words[next] == "BINARY") {
+            ++next;
+        } else if (next < words.size() && words[next] == "COMPACT") {
+            encoding = TelemetryEncoding::Compact;
+            ++next;
+        } else if (next < words.size() && words[next] == "CSV") {
+            encoding = TelemetryEncoding::Csv;
+            ++next;
+        }
+        if (next < words.size() && parseDecimation(words[next], decimation)) {
+            ++next;
+        }
+        
+        // Sensor frames are binary, so only binary clients can subscribe to them
+        bool sensors{false};
+        if (next < words.size() && words[next] == "SENSORS" && encoding == TelemetryEncoding::Binary) {
+            sensors = true;
+            ++next;
+        }
+        if (next == words.size()) {
+            registerClient(sender, encoding, decimation, sensors);
+            return;
+        }
+    }
+    
+    std::cerr << "Ignoring unknown telemetry command from " << sender << std::endl;
+}
+
+void TelemetryServer::registerClient(const boost::asio::ip::udp::endpoint& endpoint, TelemetryEncoding encoding,
+                                     std::uint32_t decimation, bool sensors) {
+    decimation = std::max<std::uint32_t>(1, decimation);
+    sensors = sensors && encoding == TelemetryEncoding::Binary;
+    
+    // A new compact receiver cannot decode deltas until it has seen a keyframe
+    if (encoding == TelemetryEncoding::Compact) {
+        compactEncoderFor(decimation).forceKeyframe();
+    }
     
     // Check if client already exists
-    auto it = std::find(m_clients.begin(), m_clients.end(), endpoint);
+    auto it = std::find_if(m_clients.begin(), m_clients.end(),
+                           [&endpoint](const TelemetryClient& client) { return client.endpoint == endpoint; });
     if (it == m_clients.end()) {
-        m_clients.push_back(endpoint);
-        std::cout << "Added telemetry client: " << address << ":" << port << std::endl;
+        m_clients.push_back(TelemetryClient{endpoint, encoding, decimation, sensors});
+        m_clientCount = m_clients.size();
+        std::cout << "Added telemetry client: " << endpoint << " ("
+                  << (encoding == TelemetryEncoding::Csv ? "CSV" : encoding == TelemetryEncoding::Compact ? "compact" : "binary");
+        if (decimation > 1) {
+            std::cout << ", every " << decimation << " samples";
+        }
+        if (sensors) {
+            std::cout << ", with sensors";
+        }
+        std::cout << ")" << std::endl;
+    } else {
+        it->encoding = encoding;
+        it->decimation = decimation;
+        it->sensors = sensors;
+    }
+    publishClientMetrics();
+}
+
+void TelemetryServer::unregisterClient(const boost::asio::ip::udp::endpoint& endpoint) {
+    auto it = std::find_if(m_clients.begin(), m_clients.end(),
+                           [&endpoint](const TelemetryClient& client) { return client.endpoint == endpoint; });
+    if (it != m_clients.end()) {
+        m_clients.erase(it);
+        m_clientCount = m_clients.size();
+        std::cout << "Removed telemetry client: " << endpoint << std::endl;
+    }
+    publishClientMetrics();
+}
+
+void TelemetryServer::sendTelemetry(const TelemetryData& data, std::uint32_t vehicleId) {
+    const TelemetrySample sample{vehicleId, data};
+    
+    // DrainAll keeps every queued sample and refuses new ones when full; the
+    // other policies make room by evicting the oldest sample
+    if (m_queuePolicy.load(std::memory_order_relaxed) == TelemetryQueuePolicy::DrainAll) {
+        if (!m_telemetryQueue.tryPush(sample)) {
+            m_rejected.add();
+            return;
+        }
+    } else {
+        const std::size_t evicted{m_telemetryQueue.pushEvictingOldest(sample)};
+        if (evicted > 0) {
+            m_evicted.add(evicted);
+        }
+    }
+    m_enqueued.add();
+    
+    // In PhysicsStep mode every sample schedules a flush; one pending flush
+    // covers everything queued before it runs, so a burst costs a single post
+    if (m_streamMode.load(std::memory_order_relaxed) == TelemetryStreamMode::PhysicsStep && m_running &&
+        !m_flushPending.exchange(true)) {
+        boost::asio::post(m_strand, [this] { onStepFlush(); });
     }
 }
 
+void TelemetryServer::updateFromState(const AircraftState& state, const ControlInputs& controls,
+                                      std::uint32_t vehicleId) {
+    const double timestamp{std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()
+    ).count()};
+    sendTelemetry(makeTelemetry(state, controls, timestamp), vehicleId);
+}
+    
+void TelemetryServer::publishStep(const AircraftState& state, const ControlInputs& controls, double simTime,
+                                  std::uint32_t vehicleId) {
+    sendTelemetry(makeTelemetry(state, controls, simTime), vehicleId);
+}
+
+void TelemetryServer::sendSensorSamples(const SensorSample* samples, std::size_t count) {
+    if (!m_running || count == 0) {
+        return;
+    }
+    
+    // Same policy as state samples: DrainAll refuses what does not fit, the others evict the oldest
+    const bool drainAll{m_queuePolicy.load(std::memory_order_relaxed) == TelemetryQueuePolicy::DrainAll};
+    std::size_t accepted{0};
+    for (std::size_t i = 0; i < count; ++i) {
+        if (drainAll) {
+            if (!m_sensorQueue.tryPush(samples[i])) {
+                m_sensorRejected.add(count - i);
+                break;
+            }
+        } else {
+            const std::size_t evicted{m_sensorQueue.pushEvictingOldest(samples[i])};
+            if (evicted > 0) {
+                m_sensorEvicted.add(evicted);
+            }
+        }
+        ++accepted;
+    }
+    if (accepted > 0) {
+        m_sensorEnqueued.add(accepted);
+    }
+    
+    // One pending flush covers every batch queued before it runs
+    if (!m_sensorFlushPending.exchange(true)) {
+        boost::asio::post(m_strand, [this] { onSensorFlush(); });
+    }
+}
+
+boost::asio::ip::udp::endpoint TelemetryServer::makeEndpoint(const std::string& address, uint16_t port) {
+    return boost::asio::ip::udp::endpoint{boost::asio::ip::make_address(address), port};
+}
+
+void TelemetryServer::addClient(const std::string& address, uint16_t port,
+                                TelemetryEncoding encoding, std::uint32_t decimation, bool sensors) {
+    // Client state is strand-only; this runs once the io_context is running
+    boost::asio::post(m_strand, [this, endpoint = makeEndpoint(address, port), encoding, decimation, sensors] {
+        registerClient(endpoint, encoding, decimation, sensors);
+    });
+}
+
 void TelemetryServer::removeClient(const std::string& address, uint16_t port) {
-    std::lock_guard<std::mutex> lock{m_clientsMutex};
+    boost::asio::post(m_strand, [this, endpoint = makeEndpoint(address, port)] {
+        unregisterClient(endpoint);
+    });
+}
+
+void TelemetryServer::addMulticastGroup(const std::string& group, uint16_t port,
+                                        TelemetryEncoding encoding, int hops) {
+    const boost::asio::ip::udp::endpoint endpoint{makeEndpoint(group, port)};
+    if (!endpoint.address().is_multicast()) {
+        throw std::invalid_argument("Not a multicast address: " + group);
+    }
     
-    boost::asio::ip::udp::endpoint endpoint{
-        boost::asio::ip::make_address(address),
-        port
-    };
+    // A multicast group is just one more destination; the kernel fans it out
+    boost::asio::post(m_strand, [this, endpoint, encoding, hops] {
+        m_multicastHops = std::max(1, hops);
+        applyMulticastOptions();
+        registerClient(endpoint, encoding, 1);
+    });
+}
+
+void TelemetryServer::applyMulticastOptions() {
+    const int hops{m_multicastHops.load()};
+    if (!m_socket || !m_socket->is_open() || hops == 0) {
+        return;
+    }
     
-    auto it = std::find(m_clients.begin(), m_clients.end(), endpoint);
-    if (it != m_clients.end()) {
-        m_clients.erase(it);
-        std::cout << "Removed telemetry client: " << address << ":" << port << std::endl;
+    boost::system::error_code ec;
+    m_socket->set_option(boost::asio::ip::multicast::hops(hops), ec);
+    m_socket->set_option(boost::asio::ip::multicast::enable_loopback(true), ec);
+    if (ec) {
+        std::cerr << "Failed to configure multicast: " << ec.message() << std::endl;
     }
 }
 
-void TelemetryServer::setUpdateRate(double rate) {
-    m_updateRate = std::max(1.0, std::min(rate, 100.0)); // Clamp between 1 and 100 Hz
+void TelemetryServer::setSamplesPerDatagram(std::size_t samples) {
+    m_samplesPerDatagram = std::max<std::size_t>(1, std::min(samples, telemetry_wire::kMaxBatchSamples));
+}
+
+void TelemetryServer::setCompactKeyframeInterval(std::uint32_t frames) {
+    boost::asio::post(m_strand, [this, frames] {
+        m_compactKeyframeInterval = frames;
+        for (auto& stream : m_compactStreams) {
+            stream.encoder.setKeyframeInterval(frames);
+        }
+    });
+}
+
+TelemetryTransportStats TelemetryServer::getTransportStats() const {
+    TelemetryTransportStats stats;
+    stats.datagrams_sent = m_datagramsSent.load(std::memory_order_relaxed);
+    stats.send_calls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.send_errors = m_sendErrors.load(std::memory_order_relaxed);
+    stats.frames_dropped = m_framesDropped.load(std::memory_order_relaxed);
+    stats.client_skips = m_clientSkips.load(std::memory_order_relaxed);
+    return stats;
+}
+    
+void TelemetryServer::setQueuePolicy(TelemetryQueuePolicy policy) {
+    m_queuePolicy = policy;
+}
+
+TelemetryQueuePolicy TelemetryServer::getQueuePolicy() const {
+    return m_queuePolicy.load();
+}
+
+TelemetryQueueStats TelemetryServer::getQueueStats() const {
+    TelemetryQueueStats stats;
+    stats.enqueued = m_enqueued.value();
+    stats.evicted = m_evicted.value();
+    stats.rejected = m_rejected.value();
+    stats.conflated = m_conflated.load(std::memory_order_relaxed);
+    stats.sent = m_sent.load(std::memory_order_relaxed);
+    stats.depth = m_telemetryQueue.sizeApprox();
+    stats.max_depth = m_maxDepth.load(std::memory_order_relaxed);
+    stats.sensor_enqueued = m_sensorEnqueued.value();
+    stats.sensor_evicted = m_sensorEvicted.value();
+    stats.sensor_rejected = m_sensorRejected.value();
+    stats.sensor_sent = m_sensorSent.load(std::memory_order_relaxed);
+    stats.sensor_dropped = m_sensorDropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+TelemetryMetrics TelemetryServer::getMetrics() const {
+    TelemetryMetrics metrics;
+    metrics.queue = getQueueStats();
+    metrics.transport = getTransportStats();
+    metrics.flush_time = m_flushTime.summary();
+    metrics.encode_time = m_encodeTime.summary();
+    metrics.queue_depth = m_queueDepth.summary();
+    
+    std::lock_guard<std::mutex> lock{m_clientMetricsMutex};
+    metrics.clients = m_clientMetrics;
+    return metrics;
 }
 
-std::string TelemetryServer::serializeTelemetry(const TelemetryData& data) {
-    // Simple CSV format for now
-    // In a real application, consider using Protocol Buffers or a more efficient format
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(6);
+void appendMetrics(MetricsReport& report, const TelemetryMetrics& metrics) {
+    report.add("falconsim_telemetry_enqueued_total", static_cast<double>(metrics.queue.enqueued));
+    report.add("falconsim_telemetry_evicted_total", static_cast<double>(metrics.queue.evicted));
+    report.add("falconsim_telemetry_rejected_total", static_cast<double>(metrics.queue.rejected));
+    report.add("falconsim_telemetry_conflated_total", static_cast<double>(metrics.queue.conflated));
+    report.add("falconsim_telemetry_sent_total", static_cast<double>(metrics.queue.sent));
+    report.add("falconsim_telemetry_queue_depth", static_cast<double>(metrics.queue.depth));
+    report.add("falconsim_telemetry_sensor_enqueued_total", static_cast<double>(metrics.queue.sensor_enqueued));
+    report.add("falconsim_telemetry_sensor_evicted_total", static_cast<double>(metrics.queue.sensor_evicted));
+    report.add("falconsim_telemetry_sensor_rejected_total", static_cast<double>(metrics.queue.sensor_rejected));
+    report.add("falconsim_telemetry_sensor_sent_total", static_cast<double>(metrics.queue.sensor_sent));
+    report.add("falconsim_telemetry_sensor_dropped_total", static_cast<double>(metrics.queue.sensor_dropped));
+    report.add("falconsim_telemetry_datagrams_sent_total", static_cast<double>(metrics.transport.datagrams_sent));
+    report.add("falconsim_telemetry_send_calls_total", static_cast<double>(metrics.transport.send_calls));
+    report.add("falconsim_telemetry_send_errors_total", static_cast<double>(metrics.transport.send_errors));
+    report.add("falconsim_telemetry_frames_dropped_total", static_cast<double>(metrics.transport.frames_dropped));
+    report.add("falconsim_telemetry_client_skips_total", static_cast<double>(metrics.transport.client_skips));
+    report.add("falconsim_telemetry_flush_time_ns", metrics.flush_time);
+    report.add("falconsim_telemetry_encode_time_ns", metrics.encode_time);
+    report.add("falconsim_telemetry_queue_depth_samples", metrics.queue_depth);
     
-    ss << data.timestamp << ","
-       << data.position_north << "," << data.position_east << "," << data.position_down << ","
-       << data.velocity_x << "," << data.velocity_y << "," << data.velocity_z << ","
-       << data.roll << "," << data.pitch << "," << data.yaw << ","
-       << data.throttle << "," << data.aileron << "," << data.elevator << "," << data.rudder;
+    for (const auto& client : metrics.clients) {
+        std::ostringstream label;
+        label << "client=\"" << client.endpoint << "\"";
+        report.add("falconsim_telemetry_client_datagrams_sent_total", static_cast<double>(client.datagramsSent), label.str());
+        report.add("falconsim_telemetry_client_skipped_total", static_cast<double>(client.skipped), label.str());
+        report.add("falconsim_telemetry_client_send_errors_total", static_cast<double>(client.sendErrors), label.str());
+        report.add("falconsim_telemetry_client_pending_sends", static_cast<double>(client.pendingSends), label.str());
+    }
+}
+
+uint16_t TelemetryServer::getPort() const {
+    return m_port;
+}
     
-    return ss.str();
+std::size_t TelemetryServer::getClientCount() const {
+    return m_clientCount.load();
+}
+
+void TelemetryServer::setUpdateRate(double rate) {
+    m_updateRate = std::max(1.0, std::min(rate, kMaxUpdateRate));
+}
+
+void TelemetryServer::setStreamMode(TelemetryStreamMode mode) {
+    m_streamMode = mode;
+}
+
+TelemetryStreamMode TelemetryServer::getStreamMode() const {
+    return m_streamMode.load();
 }
 
-} // namespace falconsim 
\ No newline at end of file
+} // namespace falconsim 
@@ -1,52 +1,142 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <array>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <atomic>
 #include <string>
 #include <functional>
-#include <queue>
-#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "TelemetryCodec.hpp"
+#include "CompactTelemetry.hpp"
+#include "../core/BoundedQueue.hpp"
+#include "../core/Metrics.hpp"
 #include "../physics/FlightDynamics.hpp"
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
 namespace falconsim {
 
 /**
- * @brief Telemetry data structure for network transmission
+ * @brief A registered telemetry receiver and the wire format it asked for
+ */
+struct TelemetryClient {
+    boost::asio::ip::udp::endpoint endpoint{};
+    TelemetryEncoding encoding{TelemetryEncoding::Binary};
+    std::uint32_t decimation{1}; // Receives every Nth sample of each vehicle
+    bool sensors{false};         // Also receives every Sensor frame (binary clients only)
+    std::size_t pendingSends{0}; // Datagrams handed to the socket but not yet completed
+    
+    // Per-client counters (cumulative since registration)
+    std::uint64_t datagramsSent{0};
+    std::uint64_t skipped{0};    // Frames skipped while the client was backed up
+    std::uint64_t sendErrors{0};
+};
+
+/**
+ * @brief What drives transmission
+ */
+enum class TelemetryStreamMode {
+    Timer,      // A steady timer sends queued samples at the update rate (default)
+    PhysicsStep // Every sample is sent as soon as it is queued, e.g. once per physics step
+};
+
+/**
+ * @brief How queued telemetry is handed to clients when the producer outpaces the send rate
+ */
+enum class TelemetryQueuePolicy {
+    ConflateLatest, // Each tick sends only the newest sample (bounded latency, default)
+    DropOldest,     // Each tick sends every queued sample; a full queue evicts the oldest
+    DrainAll        // Each tick sends every queued sample; a full queue rejects new samples
+};
+
+/**
+ * @brief Telemetry queue counters (cumulative since construction)
  */
-struct TelemetryData {
-    // Timestamp
-    double timestamp{0.0};
-    
-    // Position (NED frame)
-    double position_north{0.0};
-    double position_east{0.0};
-    double position_down{0.0};
-    
-    // Velocity (body frame)
-    double velocity_x{0.0};
-    double velocity_y{0.0};
-    double velocity_z{0.0};
-    
-    // Orientation (euler angles in radians)
-    double roll{0.0};
-    double pitch{0.0};
-    double yaw{0.0};
-    
-    // Control inputs
-    double throttle{0.0};
-    double aileron{0.0};
-    double elevator{0.0};
-    double rudder{0.0};
+struct TelemetryQueueStats {
+    std::uint64_t enqueued{0};   // Samples accepted by sendTelemetry()
+    std::uint64_t evicted{0};    // Oldest samples discarded to make room (DropOldest, ConflateLatest)
+    std::uint64_t rejected{0};   // New samples refused because the queue was full (DrainAll)
+    std::uint64_t conflated{0};  // Samples superseded by a newer one before they were sent
+    std::uint64_t sent{0};       // Samples broadcast to clients
+    std::size_t depth{0};        // Current queue depth
+    std::size_t max_depth{0};    // Deepest queue observed at a tick
+    
+    // Sensor samples, queued in their own ring under the same policy
+    std::uint64_t sensor_enqueued{0}; // Sensor samples accepted by sendSensorSamples()
+    std::uint64_t sensor_evicted{0};  // Oldest sensor samples discarded to make room
+    std::uint64_t sensor_rejected{0}; // New sensor samples refused because the ring was full (DrainAll)
+    std::uint64_t sensor_sent{0};     // Sensor samples broadcast to clients
+    std::uint64_t sensor_dropped{0};  // Sensor samples lost because every frame slot was in flight
 };
 
+/**
+ * @brief Socket-level counters (cumulative since construction)
+ */
+struct TelemetryTransportStats {
+    std::uint64_t datagrams_sent{0};  // Datagrams accepted by the kernel
+    std::uint64_t send_calls{0};      // sendmmsg/async_send_to calls issued
+    std::uint64_t send_errors{0};     // Datagrams that failed to send
+    std::uint64_t frames_dropped{0};  // Frames dropped because every slot was in flight
+    std::uint64_t client_skips{0};    // Frames skipped for backed-up clients
+};
+
+/**
+ * @brief Everything the telemetry server measures, gathered by getMetrics()
+ */
+struct TelemetryMetrics {
+    TelemetryQueueStats queue{};
+    TelemetryTransportStats transport{};
+    std::vector<TelemetryClient> clients{}; // As of the latest flush or (un)registration
+    HistogramSummary flush_time{};  // Drain + encode + send per flush (ns)
+    HistogramSummary encode_time{}; // Per encoded frame (ns)
+    HistogramSummary queue_depth{}; // Queue depth at each flush (samples)
+};
+
+// Append metrics as falconsim_telemetry_* lines (per-client lines carry a client label)
+void appendMetrics(MetricsReport& report, const TelemetryMetrics& metrics);
+
 /**
  * @brief Telemetry server for UAV data streaming over UDP
+ *
+ * The server runs an io_context on its own thread. A steady timer paces
+ * transmission at the update rate and each tick empties the telemetry queue
+ * according to the queue policy. Producers push into a lock-free bounded
+ * ring and never block. Sends are asynchronous, and client state, encode
+ * buffers and completions are only touched on a single strand.
+ *
+ * Clients can be added programmatically or register themselves by sending
+ * a "REGISTER", "REGISTER BINARY", "REGISTER COMPACT" or "REGISTER CSV"
+ * datagram to the server port, and leave with "UNREGISTER". A client with too many sends in flight
+ * skips frames rather than holding back the others. Sensor frames are opt-in: only binary clients
+ * that register with a trailing "SENSORS" ("REGISTER BINARY SENSORS") receive them.
+ *
+ * In PhysicsStep mode the timer stops sending; instead each sample queued
+ * by sendTelemetry() or publishStep() schedules a send at once, so attaching
+ * publishStep() as a Simulation step observer streams every physics step
+ * (1 kHz and up over loopback). Each client can ask for every Nth sample of
+ * each vehicle ("REGISTER BINARY 100"), so a plotting tool and a 10 Hz
+ * display can share one full-rate stream.
+ *
+ * With setSamplesPerDatagram() above 1, binary clients receive Batch frames
+ * that pack several samples (typically several vehicles) into one MTU-sized
+ * datagram. On Linux each frame is fanned out to all clients with a single
+ * sendmmsg() call, falling back to async sends when the socket buffer is
+ * full. A multicast group can stand in for any number of LAN receivers.
+ *
+ * getMetrics() adds per-client counters and flush, encode and queue-depth
+ * histograms to the queue and transport statistics.
  */
 class TelemetryServer {
 public:
-    explicit TelemetryServer(uint16_t port = 12345);
+    explicit TelemetryServer(uint16_t port = 12345, std::size_t queueCapacity = 128,
+                             std::size_t sensorQueueCapacity = kSensorQueueCapacity);
     ~TelemetryServer();
     
     // Deleted copy and move operations
@@ -55,45 +145,184 @@ public:
     TelemetryServer(TelemetryServer&&) = delete;
     TelemetryServer& operator=(TelemetryServer&&) = delete;
     
-    // Server control
+    // Server control (port 0 binds an ephemeral port, reported by getPort() once started)
     void start();
     void stop();
+    [[nodiscard]] uint16_t getPort() const;
     
-    // Telemetry data handling
-    void sendTelemetry(const TelemetryData& data);
-    void updateFromState(const AircraftState& state, const ControlInputs& controls);
+    // Telemetry data handling (lock-free, safe from any number of producer threads)
+    void sendTelemetry(const TelemetryData& data, std::uint32_t vehicleId = 0);
+    void updateFromState(const AircraftState& state, const ControlInputs& controls,
+                         std::uint32_t vehicleId = 0);
+    // Same as updateFromState(), but stamped with the simulated time (signature of Simulation::StepObserver)
+    void publishStep(const AircraftState& state, const ControlInputs& controls, double simTime,
+                     std::uint32_t vehicleId = 0);
+    // Send simulated sensor measurements as Sensor frames to the clients subscribed to them, whatever
+    // their decimation (the samples are copied into a bounded ring under the queue policy; lock-free)
+    void sendSensorSamples(const SensorSample* samples, std::size_t count);
     
-    // Client handling
-    void addClient(const std::string& address, uint16_t port);
+    // Client handling (re-adding a client updates its encoding, decimation and sensor subscription)
+    void addClient(const std::string& address, uint16_t port,
+                   TelemetryEncoding encoding = TelemetryEncoding::Binary, std::uint32_t decimation = 1,
+                   bool sensors = false);
     void removeClient(const std::string& address, uint16_t port);
+    [[nodiscard]] std::size_t getClientCount() const;
+    
+    // Send to a multicast group (throws std::invalid_argument for unicast addresses)
+    void addMulticastGroup(const std::string& group, uint16_t port,
+                           TelemetryEncoding encoding = TelemetryEncoding::Binary, int hops = 1);
     
     // Configuration
-    void setUpdateRate(double rate); // Hz
+    void setUpdateRate(double rate); // Hz, clamped to [1, kMaxUpdateRate]; Timer mode only
+    void setStreamMode(TelemetryStreamMode mode);
+    [[nodiscard]] TelemetryStreamMode getStreamMode() const;
+    void setSamplesPerDatagram(std::size_t samples); // 1 sends State frames; clamped to kMaxBatchSamples
+    void setCompactKeyframeInterval(std::uint32_t frames); // Compact frames per vehicle between keyframes
+    void setQueuePolicy(TelemetryQueuePolicy policy);
+    [[nodiscard]] TelemetryQueuePolicy getQueuePolicy() const;
+    
+    // Statistics
+    [[nodiscard]] TelemetryQueueStats getQueueStats() const;
+    [[nodiscard]] TelemetryTransportStats getTransportStats() const;
+    [[nodiscard]] TelemetryMetrics getMetrics() const;
+    
+    // Sends still in flight per client before it starts skipping frames
+    static constexpr std::size_t kMaxPendingSendsPerClient{8};
+
+    static constexpr double kMaxUpdateRate{1000.0}; // Hz
     
+    // Default sensor ring size: several milliseconds of a large IMU fleet
+    static constexpr std::size_t kSensorQueueCapacity{4096};
+
 private:
-    void serverLoop();
-    void processTelemetryQueue();
-    std::string serializeTelemetry(const TelemetryData& data);
+    /**
+     * @brief Encoded frame that stays alive until all its async sends complete
+     */
+    struct FrameSlot {
+        TelemetryFrameBuffer frame{};
+        std::size_t pendingSends{0};
+    };
+    
+    /**
+     * @brief Per-vehicle bookkeeping, kept across ticks so a drain allocates nothing
+     */
+    struct VehicleSlot {
+        std::uint64_t drainTick{0};  // Drain that last queued a sample of this vehicle
+        std::size_t tickSample{0};   // Its position in m_tickSamples during that drain
+        std::uint64_t samplesSent{0}; // Samples numbered so far, for decimation
+    };
+    
+    /**
+     * @brief Compact encoder shared by the compact clients of one decimation
+     */
+    struct CompactStream {
+        std::uint32_t decimation{1};
+        CompactTelemetryEncoder encoder{};
+    };
+    static constexpr std::size_t kFrameSlots{64};
+    
+    // Strand handlers
+    void scheduleTick();
+    void onTick(const boost::system::error_code& ec);
+    void onStepFlush();
+    void onSensorFlush();
+    void flush();
+    void startReceive();
+    void onReceive(const boost::system::error_code& ec, std::size_t bytes);
+    void handleCommand(const std::string& command, const boost::asio::ip::udp::endpoint& sender);
+    void drainQueue();
+    void broadcast();
+    void broadcastGroup(std::uint32_t decimation);
+    void broadcastSensors();
+    void fanOut(FrameSlot& slot, TelemetryEncoding encoding, std::uint32_t decimation);
+    void sendToSelected(FrameSlot& slot);
+    void applyMulticastOptions();
+    void registerClient(const boost::asio::ip::udp::endpoint& endpoint, TelemetryEncoding encoding,
+                        std::uint32_t decimation, bool sensors = false);
+    void unregisterClient(const boost::asio::ip::udp::endpoint& endpoint);
+    void publishClientMetrics();
+    [[nodiscard]] FrameSlot* acquireSlot();
+    [[nodiscard]] VehicleSlot& vehicleSlot(std::uint32_t vehicleId);
+    [[nodiscard]] CompactTelemetryEncoder& compactEncoderFor(std::uint32_t decimation);
+    [[nodiscard]] static boost::asio::ip::udp::endpoint makeEndpoint(const std::string& address, uint16_t port);
     
     // Network components
     boost::asio::io_context m_ioContext{};
+    boost::asio::strand<boost::asio::io_context::executor_type> m_strand{m_ioContext.get_executor()};
     std::unique_ptr<boost::asio::ip::udp::socket> m_socket{};
+    boost::asio::steady_timer m_timer{m_ioContext};
+    
+    // Receive state for the registration handshake (strand only)
+    std::array<char, 256> m_receiveBuffer{};
+    boost::asio::ip::udp::endpoint m_remoteEndpoint{};
+    
+    // Client list (strand only)
+    std::vector<TelemetryClient> m_clients{};
+    std::atomic<std::size_t> m_clientCount{0};
+    
+    // Telemetry queue and its counters (producer-side counters are sharded per thread)
+    BoundedQueue<TelemetrySample> m_telemetryQueue;
+    std::atomic<TelemetryQueuePolicy> m_queuePolicy{TelemetryQueuePolicy::ConflateLatest};
+    ShardedCounter m_enqueued{};
+    ShardedCounter m_evicted{};
+    ShardedCounter m_rejected{};
+    std::atomic<std::uint64_t> m_conflated{0};
+    std::atomic<std::uint64_t> m_sent{0};
+    std::atomic<std::size_t> m_maxDepth{0};
+    
+    // Sensor ring, drained on the strand into reused scratch
+    BoundedQueue<SensorSample> m_sensorQueue;
+    ShardedCounter m_sensorEnqueued{};
+    ShardedCounter m_sensorEvicted{};
+    ShardedCounter m_sensorRejected{};
+    std::atomic<std::uint64_t> m_sensorSent{0};
+    std::atomic<std::uint64_t> m_sensorDropped{0};
+    std::vector<SensorSample> m_sensorSamples{};
+    
+    // Encode slots and per-tick scratch, reused for every frame (strand only)
+    std::array<FrameSlot, kFrameSlots> m_frameSlots{};
+    std::size_t m_nextSlot{0};
+    std::uint32_t m_sequence{0};
+    std::vector<TelemetrySample> m_tickSamples{};
+    std::vector<std::uint64_t> m_sampleIndices{};
+    std::unordered_map<std::uint32_t, std::size_t> m_vehicleSlotIndex{};
+    std::vector<VehicleSlot> m_vehicleSlots{};
+    std::uint64_t m_drainTick{0};
+    std::vector<std::uint32_t> m_decimations{};
+    std::vector<TelemetrySample> m_groupSamples{};
+    std::vector<CompactStream> m_compactStreams{};
+    std::uint32_t m_compactKeyframeInterval{10};
+    std::vector<std::size_t> m_fanOutClients{};
+#if defined(__linux__)
+    std::vector<mmsghdr> m_messageHeaders{};
+#endif
+    std::atomic<int> m_multicastHops{0}; // Set on the strand, read again by start()
     
-    // Client list
-    std::vector<boost::asio::ip::udp::endpoint> m_clients{};
-    std::mutex m_clientsMutex{};
+    // Transport counters
+    std::atomic<std::uint64_t> m_datagramsSent{0};
+    std::atomic<std::uint64_t> m_sendCalls{0};
+    std::atomic<std::uint64_t> m_sendErrors{0};
+    std::atomic<std::uint64_t> m_framesDropped{0};
+    std::atomic<std::uint64_t> m_clientSkips{0};
     
-    // Telemetry queue
-    std::queue<TelemetryData> m_telemetryQueue{};
-    std::mutex m_queueMutex{};
+    // Latency histograms (strand only) and the client list as last published for readers
+    Histogram m_flushTime{};
+    Histogram m_encodeTime{};
+    Histogram m_queueDepth{};
+    mutable std::mutex m_clientMetricsMutex{};
+    std::vector<TelemetryClient> m_clientMetrics{};
     
     // Threading
     std::atomic<bool> m_running{false};
+    std::atomic<bool> m_flushPending{false};
+    std::atomic<bool> m_sensorFlushPending{false};
     std::thread m_serverThread{};
     
     // Configuration
     uint16_t m_port{12345};
-    double m_updateRate{10.0}; // 10 Hz default
+    std::atomic<double> m_updateRate{10.0}; // 10 Hz default
+    std::atomic<std::size_t> m_samplesPerDatagram{1};
+    std::atomic<TelemetryStreamMode> m_streamMode{TelemetryStreamMode::Timer};
 };
 
-} // namespace falconsim 
\ No newline at end of file
+} // namespace falconsim 
@@ -0,0 +1,230 @@
+#include "AeroTable.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace falconsim {
+
+namespace {
+
+const char* const kAxisNames[AeroTable::kDimensions]{"alpha", "beta", "mach", "deflection"};
+
+std::vector<double>* axisByIndex(AeroTableAxes& axes, std::size_t dimension) {
+    std::vector<double>* const all[AeroTable::kDimensions]{&axes.alpha, &axes.beta, &axes.mach, &axes.deflection};
+    return all[dimension];
+}
+
+// Position of value among the breakpoints, which must contain it exactly
+std::size_t breakpointIndex(const std::vector<double>& breakpoints, double value) {
+    const auto it = std::lower_bound(breakpoints.begin(), breakpoints.end(), value);
+    if (it == breakpoints.end() || *it != value) {
+        return breakpoints.size();
+    }
+    return static_cast<std::size_t>(it - breakpoints.begin());
+}
+
+} // namespace
+
+AeroTable::AeroTable(AeroTableAxes axes, const std::vector<AeroCoefficients>& values)
+    : m_sourceAxes{std::move(axes)} {
+    // Strides with deflection varying fastest
+    std::size_t nodes{1};
+    for (std::size_t d = kDimensions; d-- > 0;) {
+        const std::vector<double>& breakpoints{*axisByIndex(m_sourceAxes, d)};
+        if (breakpoints.empty()) {
+            throw std::invalid_argument{std::string{"Aero table axis has no breakpoints: "} + kAxisNames[d]};
+        }
+        for (std::size_t i = 1; i < breakpoints.size(); ++i) {
+            if (!(breakpoints[i] > breakpoints[i - 1])) {
+                throw std::invalid_argument{std::string{"Aero table axis is not strictly increasing: "} + kAxisNames[d]};
+            }
+        }
+        
+        Axis& axis{m_axes[d]};
+        axis.stride = nodes;
+        if (breakpoints.size() == 1) {
+            // Both corners read the same node, so the weight split is irrelevant
+            axis.breakpoints = {breakpoints[0], breakpoints[0] + 1.0};
+            axis.upperStride = 0;
+        } else {
+            axis.breakpoints = breakpoints;
+            axis.upperStride = nodes;
+        }
+        for (std::size_t i = 0; i + 1 < axis.breakpoints.size(); ++i) {
+            axis.inverseWidths.push_back(1.0 / (axis.breakpoints[i + 1] - axis.breakpoints[i]));
+        }
+        nodes *= breakpoints.size();
+    }
+    
+    if (values.size() != nodes) {
+        throw std::invalid_argument{"Aero table has " + std::to_string(values.size()) + " values for " +
+                                    std::to_string(nodes) + " grid nodes"};
+    }
+    m_nodes.assign(nodes * kNodeWidth, 0.0);
+    for (std::size_t node = 0; node < nodes; ++node) {
+        m_nodes[node * kNodeWidth + 0] = values[node].lift;
+        m_nodes[node * kNodeWidth + 1] = values[node].drag;
+        m_nodes[node * kNodeWidth + 2] = values[node].pitch_moment;
+    }
+}
+
+std::shared_ptr<const AeroTable> AeroTable::load(const std::string& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error{"Cannot open aero table " + path};
+    }
+    
+    AeroTableAxes axes;
+    struct Row {
+        double key[kDimensions];
+        AeroCoefficients coefficients;
+        std::size_t line;
+    };
+    std::vector<Row> rows;
+    
+    std::string text;
+    for (std::size_t line = 1; std::getline(file, text); ++line) {
+        text = text.substr(0, text.find('#'));
+        std::istringstream tokens{text};
+        std::string first;
+        if (!(tokens >> first)) {
+            continue;
+        }
+        const auto error = [&path, line](const std::string& what) {
+            return std::runtime_error{"Aero table " + path + ":" + std::to_string(line) + ": " + what};
+        };
+        
+        // Axis definition
+        const auto name = std::find(std::begin(kAxisNames), std::end(kAxisNames), first);
+        if (name != std::end(kAxisNames)) {
+            std::vector<double>& breakpoints{*axisByIndex(axes, static_cast<std::size_t>(name - std::begin(kAxisNames)))};
+            breakpoints.clear();
+            for (double value; tokens >> value;) {
+                breakpoints.push_back(value);
+            }
+            if (!tokens.eof()) {
+                throw error("malformed breakpoint");
+            }
+            continue;
+        }
+        
+        // Data row: four keys, then CL, CD and Cm
+        tokens.clear();
+        tokens.str(text);
+        Row row{};
+        row.line = line;
+        for (double& key : row.key) {
+            tokens >> key;
+        }
+        tokens >> row.coefficients.lift >> row.coefficients.drag >> row.coefficients.pitch_moment;
+        std::string rest;
+        if (tokens.fail() || (tokens >> rest)) {
+            throw error("expected 'alpha beta mach deflection CL CD Cm'");
+        }
+        rows.push_back(row);
+    }
+    
+    // Place every row on its node; each node must appear exactly once
+    const std::vector<double>* breakpoints[kDimensions]{&axes.alpha, &axes.beta, &axes.mach, &axes.deflection};
+    std::size_t nodes{1};
+    for (const auto* axis : breakpoints) {
+        nodes *= std::max<std::size_t>(axis->size(), 1);
+    }
+    std::vector<AeroCoefficients> values(nodes);
+    std::vector<bool> filled(nodes, false);
+    for (const Row& row : rows) {
+        std::size_t node{0};
+        for (std::size_t d = 0; d < kDimensions; ++d) {
+            const std::size_t index{breakpointIndex(*breakpoints[d], row.key[d])};
+            if (index == breakpoints[d]->size()) {
+                throw std::runtime_error{"Aero table " + path + ":" + std::to_string(row.line) + ": " +
+                                         kAxisNames[d] + " " + std::to_string(row.key[d]) + " is not a breakpoint"};
+            }
+            node = node * breakpoints[d]->size() + index;
+        }
+        if (filled[node]) {
+            throw std::runtime_error{"Aero table " + path + ":" + std::to_string(row.line) + ": duplicate grid node"};
+        }
+        filled[node] = true;
+        values[node] = row.coefficients;
+    }
+    const auto missing = static_cast<std::size_t>(std::count(filled.begin(), filled.end(), false));
+    if (missing > 0) {
+        throw std::runtime_error{"Aero table " + path + ": " + std::to_string(missing) + " of " +
+                                 std::to_string(nodes) + " grid nodes have no row"};
+    }
+    
+    try {
+        return std::make_shared<const AeroTable>(std::move(axes), values);
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error{"Aero table " + path + ": " + e.what()};
+    }
+}
+
+std::size_t AeroTable::locate(const Axis& axis, double x, double& fraction) noexcept {
+    const double* const breakpoints{axis.breakpoints.data()};
+    const std::size_t cells{axis.breakpoints.size() - 1};
+    x = std::min(std::max(x, breakpoints[0]), breakpoints[cells]);
+    
+    // Last cell whose lower breakpoint is <= x; the trip count depends only on the axis size
+    const double* base{breakpoints};
+    for (std::size_t n = cells; n > 1; n -= n / 2) {
+        base = base[n / 2] <= x ? base + n / 2 : base;
+    }
+    const auto cell = static_cast<std::size_t>(base - breakpoints);
+    fraction = (x - *base) * axis.inverseWidths[cell];
+    return cell;
+}
+
+AeroCoefficients AeroTable::lookup(double alpha, double beta, double mach, double deflection) const noexcept {
+    const double query[kDimensions]{alpha, beta, mach, deflection};
+    constexpr std::size_t kCorners{std::size_t{1} << kDimensions};
+    
+    // Expand the corner weights and offsets one axis at a time: after axis d the
+    // first 2^(d+1) entries cover every combination of lower and upper faces so far
+    double weights[kCorners];
+    std::size_t offsets[kCorners];
+    weights[0] = 1.0;
+    offsets[0] = 0;
+    for (std::size_t d = 0, count = 1; d < kDimensions; ++d, count *= 2) {
+        const Axis& axis{m_axes[d]};
+        double fraction;
+        const std::size_t lower{locate(axis, query[d], fraction) * axis.stride};
+        for (std::size_t j = 0; j < count; ++j) {
+            weights[j + count] = weights[j] * fraction;
+            offsets[j + count] = offsets[j] + lower + axis.upperStride;
+            weights[j] *= 1.0 - fraction;
+            offsets[j] += lower;
+        }
+    }
+    
+    // Blend the 16 corners, four coefficients (one 32-byte node) at a time
+    double sum[kNodeWidth]{};
+    for (std::size_t corner = 0; corner < kCorners; ++corner) {
+        const double* node{m_nodes.data() + offsets[corner] * kNodeWidth};
+        for (std::size_t k = 0; k < kNodeWidth; ++k) {
+            sum[k] += weights[corner] * node[k];
+        }
+    }
+    return AeroCoefficients{sum[0], sum[1], sum[2]};
+}
+
+const AeroTableAxes& AeroTable::getAxes() const {
+    return m_sourceAxes;
+}
+
+std::size_t AeroTable::getNodeCount() const {
+    return m_nodes.size() / kNodeWidth;
+}
+
+AeroCoefficients AeroTable::getNode(std::size_t node) const {
+    if (node >= getNodeCount()) {
+        throw std::out_of_range{"Aero table node out of range"};
+    }
+    const double* values{m_nodes.data() + node * kNodeWidth};
+    return AeroCoefficients{values[0], values[1], values[2]};
+}
+
+} // namespace falconsim
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Aerodynamic coefficients at one flight condition
+ */
+struct AeroCoefficients {
+    double lift{0.0};         // CL
+    double drag{0.0};         // CD
+    double pitch_moment{0.0}; // Cm (positive = nose up)
+};
+
+/**
+ * @brief Breakpoints of an aerodynamic table, each strictly increasing
+ *
+ * An axis with a single breakpoint makes the table constant along it.
+ */
+struct AeroTableAxes {
+    std::vector<double> alpha{0.0};      // Angle of attack (rad)
+    std::vector<double> beta{0.0};       // Sideslip angle (rad)
+    std::vector<double> mach{0.0};       // Mach number
+    std::vector<double> deflection{0.0}; // Normalized elevator deflection [-1, 1]
+};
+
+/**
+ * @brief Tabulated CL/CD/Cm over alpha, beta, Mach and control deflection
+ *
+ * The grid is stored as one dense, cache-line aligned array with the four
+ * coefficients of a node packed into 32 bytes (CL, CD, Cm, padding). A
+ * corner therefore costs a single vector load. lookup() clamps each query
+ * to the table's range and finds its cell with a fixed-iteration binary
+ * search. It then blends the 16 surrounding nodes by multilinear weights,
+ * with no data-dependent branches.
+ *
+ * Tables are immutable once built. One instance, held through
+ * std::shared_ptr<const AeroTable>, can be shared by every aircraft of a
+ * type across threads.
+ */
+class AeroTable {
+public:
+    static constexpr std::size_t kDimensions{4};
+    
+    // values holds one entry per grid node, deflection varying fastest and alpha
+    // slowest; throws std::invalid_argument on malformed axes or a size mismatch
+    AeroTable(AeroTableAxes axes, const std::vector<AeroCoefficients>& values);
+    
+    /**
+     * Load a table from a text file (throws std::runtime_error)
+     *
+     *     # Comments and blank lines are ignored
+     *     alpha -0.2 0 0.2
+     *     beta 0
+     *     mach 0.1 0.5
+     *     deflection -1 0 1
+     *     # alpha beta mach deflection CL CD Cm, one row per node in any order
+     *     -0.2 0 0.1 -1  -0.6 0.08 0.05
+     *     ...
+     *
+     * Axes left out have a single breakpoint at 0.
+     */
+    [[nodiscard]] static std::shared_ptr<const AeroTable> load(const std::string& path);
+    
+    // Interpolated coefficients; queries outside the table are clamped to its edge
+    [[nodiscard]] AeroCoefficients lookup(double alpha, double beta, double mach, double deflection) const noexcept;
+    
+    [[nodiscard]] const AeroTableAxes& getAxes() const;
+    [[nodiscard]] std::size_t getNodeCount() const;
+    
+    // Coefficients of one grid node, in constructor order (throws std::out_of_range)
+    [[nodiscard]] AeroCoefficients getNode(std::size_t node) const;
+
+private:
+    /**
+     * @brief One interpolation axis in lookup form
+     */
+    struct Axis {
+        std::vector<double> breakpoints{};   // At least two; a single breakpoint b is stored as {b, b + 1}
+        std::vector<double> inverseWidths{}; // 1 / (breakpoints[i + 1] - breakpoints[i])
+        std::size_t stride{0};               // Nodes between neighbours along this axis
+        std::size_t upperStride{0};          // stride, or 0 for a single-breakpoint axis
+    };
+    
+    static constexpr std::size_t kNodeWidth{4}; // CL, CD, Cm, padding
+    
+    [[nodiscard]] static std::size_t locate(const Axis& axis, double x, double& fraction) noexcept;
+    
+    AeroTableAxes m_sourceAxes{};
+    std::array<Axis, kDimensions> m_axes{};
+    AlignedVector<double> m_nodes{};
+};
+
+} // namespace falconsim
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+namespace falconsim {
+
+/**
+ * @brief The default small UAV, fixed at compile time
+ *
+ * A compile-time airframe for FlightDynamicsT is any struct with these
+ * static constexpr members. Its inertia is principal-axis only, so the
+ * inverse is three constant reciprocals, and a zero moment gain removes
+ * that control term from the step altogether. RuntimeAirframe and
+ * UAVPhysicalProperties take their defaults from it.
+ */
+struct SmallUavAirframe {
+    static constexpr double wing_area{0.5};
+    static constexpr double wingspan{1.5};
+    static constexpr double thrust_max{20.0};
+    static constexpr double roll_gain{2.0};
+    static constexpr double pitch_gain{1.5};
+    static constexpr double yaw_gain{1.0};
+    static constexpr double mass{1.0};
+    static constexpr double inertia[3]{0.5, 0.8, 1.0}; // Principal moments Ixx, Iyy, Izz (kg·m²)
+};
+
+/**
+ * @brief Airframe constants as runtime values, for ad-hoc tuning
+ *
+ * The policy behind FlightDynamics: wing geometry, thrust and inertia can
+ * be changed at any time through setWingspanArea() and setProperties().
+ * The defaults are SmallUavAirframe's. The control moment gains are fixed
+ * here as they always have been.
+ */
+struct RuntimeAirframe {
+    double wing_area{SmallUavAirframe::wing_area};                   // Wing area (m²)
+    double wingspan{SmallUavAirframe::wingspan};                     // Wingspan (m)
+    double thrust_max{SmallUavAirframe::thrust_max};                 // Maximum thrust (N)
+    static constexpr double roll_gain{SmallUavAirframe::roll_gain};  // Roll moment per unit aileron and metre of span (N)
+    static constexpr double pitch_gain{SmallUavAirframe::pitch_gain}; // Pitch moment per unit elevator (N·m)
+    static constexpr double yaw_gain{SmallUavAirframe::yaw_gain};    // Yaw moment per unit rudder (N·m)
+    static constexpr double mass{SmallUavAirframe::mass};            // Initial mass (kg)
+    
+    // Inertia tensor and its inverse, cached whenever the tensor changes
+    Eigen::Matrix3d inertia{
+        Eigen::Vector3d{SmallUavAirframe::inertia[0], SmallUavAirframe::inertia[1], SmallUavAirframe::inertia[2]}.asDiagonal()};
+    Eigen::Matrix3d inverse_inertia{inertia.inverse()};
+};
+
+/**
+ * @brief Long-endurance flying wing for survey work (no rudder)
+ */
+struct SurveyWingAirframe {
+    static constexpr double wing_area{0.8};
+    static constexpr double wingspan{2.4};
+    static constexpr double thrust_max{30.0};
+    static constexpr double roll_gain{1.6};
+    static constexpr double pitch_gain{2.0};
+    static constexpr double yaw_gain{0.0};
+    static constexpr double mass{2.5};
+    static constexpr double inertia[3]{0.9, 0.6, 1.4};
+};
+
+/**
+ * @brief Small, fast, high-thrust interceptor
+ */
+struct InterceptorAirframe {
+    static constexpr double wing_area{0.3};
+    static constexpr double wingspan{1.0};
+    static constexpr double thrust_max{45.0};
+    static constexpr double roll_gain{3.0};
+    static constexpr double pitch_gain{2.0};
+    static constexpr double yaw_gain{1.2};
+    static constexpr double mass{1.4};
+    static constexpr double inertia[3]{0.2, 0.35, 0.5};
+};
+
+} // namespace falconsim
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace falconsim {
+
+/**
+ * @brief Minimal allocator returning storage aligned to a fixed boundary
+ *
+ * Used for the structure-of-arrays containers so every column starts on a
+ * cache line and can be loaded with aligned vector instructions.
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    static_assert(Alignment >= alignof(T), "Alignment must satisfy the element type");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+// Cache-line aligned vector used for SoA columns
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} // namespace falconsim
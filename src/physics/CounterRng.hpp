@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace falconsim {
+
+/**
+ * @brief Counter-based random numbers: every draw is a pure hash of (stream key, counter)
+ *
+ * Nothing is carried from one draw to the next, so a draw can be made on
+ * any thread, in any order, in batches of any size, and always comes out
+ * the same. Streams are keyed by hashing a seed with a stream number (a
+ * vehicle, a sensor channel, ...).
+ */
+namespace counter_rng {
+
+constexpr double kTwoPi{6.283185307179586};
+
+// splitmix64 finalizer
+inline std::uint64_t mix(std::uint64_t x) noexcept {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Uniform in (0, 1] from the top 53 bits
+inline double unitInterval(std::uint64_t bits) noexcept {
+    return static_cast<double>((bits >> 11) + 1) * 0x1.0p-53;
+}
+
+// Uniform in [0, 1) from the top 53 bits of draw `counter` of a stream
+inline double uniform(std::uint64_t key, std::uint64_t counter) noexcept {
+    return static_cast<double>(mix(key + counter) >> 11) * 0x1.0p-53;
+}
+
+// Key of one stream of a seed
+inline std::uint64_t streamKey(std::uint64_t seed, std::uint64_t stream) noexcept {
+    return mix(seed ^ mix(stream));
+}
+
+// Unit normal number `counter` of a stream (Box-Muller on two hashed uniforms)
+inline double normal(std::uint64_t key, std::uint64_t counter) noexcept {
+    const std::uint64_t base{key + 2 * counter};
+    return std::sqrt(-2.0 * std::log(unitInterval(mix(base)))) * std::cos(kTwoPi * unitInterval(mix(base + 1)));
+}
+
+} // namespace counter_rng
+
+} // namespace falconsim
@@ -0,0 +1,452 @@
+#include "FleetDynamics.hpp"
+#include "Airframe.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace falconsim {
+
+// Airframe defaults: the small UAV that FlightDynamics starts as
+namespace {
+constexpr double kDefaultWingArea{SmallUavAirframe::wing_area};
+constexpr double kDefaultWingspan{SmallUavAirframe::wingspan};
+constexpr double kDefaultLiftCoefficient{1.2};
+constexpr double kDefaultDragCoefficient{0.1};
+constexpr double kDefaultThrustMax{SmallUavAirframe::thrust_max};
+} // namespace
+
+template <typename Self, typename Fn>
+void FleetDynamics::forEachColumn(Self& self, Fn&& fn) {
+    decltype(&self.m_posN) const columns[]{
+        &self.m_posN, &self.m_posE, &self.m_posD, &self.m_velU, &self.m_velV, &self.m_velW,
+        &self.m_roll, &self.m_pitch, &self.m_yaw, &self.m_rateP, &self.m_rateQ, &self.m_rateR, &self.m_mass,
+        &self.m_throttle, &self.m_aileron, &self.m_elevator, &self.m_rudder,
+        &self.m_wingArea, &self.m_wingspan, &self.m_liftCoefficient, &self.m_dragCoefficient,
+        &self.m_thrustMax, &self.m_invIxx, &self.m_invIyy, &self.m_invIzz,
+        &self.m_stepLift, &self.m_stepDrag, &self.m_pitchMoment,
+        &self.m_windU, &self.m_windV, &self.m_windW, &self.m_gustU, &self.m_gustV, &self.m_gustW,
+        &self.m_environmentTime};
+    static_assert(std::size(columns) == FleetVehicleSnapshot::kColumnCount,
+                  "FleetVehicleSnapshot must hold every fleet column");
+    for (auto* column : columns) {
+        fn(*column);
+    }
+}
+
+std::size_t FleetDynamics::addVehicle(const AircraftState& state) {
+    const std::size_t index{size()};
+    forEachColumn(*this, [](AlignedVector<double>& column) { column.push_back(0.0); });
+    m_aeroTables.emplace_back();
+    m_turbulenceSteps.push_back(0);
+    m_turbulenceStreams.push_back(index);
+    
+    m_wingArea[index] = kDefaultWingArea;
+    m_wingspan[index] = kDefaultWingspan;
+    m_liftCoefficient[index] = kDefaultLiftCoefficient;
+    m_dragCoefficient[index] = kDefaultDragCoefficient;
+    m_thrustMax[index] = kDefaultThrustMax;
+    m_invIxx[index] = 1.0 / SmallUavAirframe::inertia[0];
+    m_invIyy[index] = 1.0 / SmallUavAirframe::inertia[1];
+    m_invIzz[index] = 1.0 / SmallUavAirframe::inertia[2];
+    
+    setState(index, state);
+    return index;
+}
+
+std::size_t FleetDynamics::addVehicles(const double* const columns[kFleetInputColumnCount], std::size_t count) {
+    const std::size_t first{size()};
+    const std::size_t total{first + count};
+    forEachColumn(*this, [total](AlignedVector<double>& column) { column.resize(total, 0.0); });
+    m_aeroTables.resize(total);
+    m_turbulenceSteps.resize(total, 0);
+    m_turbulenceStreams.reserve(total);
+    for (std::size_t index = first; index < total; ++index) {
+        m_turbulenceStreams.push_back(index);
+    }
+    
+    const auto fill = [first, total](AlignedVector<double>& column, double value) {
+        std::fill(column.begin() + first, column.begin() + total, value);
+    };
+    fill(m_wingArea, kDefaultWingArea);
+    fill(m_wingspan, kDefaultWingspan);
+    fill(m_liftCoefficient, kDefaultLiftCoefficient);
+    fill(m_dragCoefficient, kDefaultDragCoefficient);
+    fill(m_thrustMax, kDefaultThrustMax);
+    fill(m_invIxx, 1.0 / SmallUavAirframe::inertia[0]);
+    fill(m_invIyy, 1.0 / SmallUavAirframe::inertia[1]);
+    fill(m_invIzz, 1.0 / SmallUavAirframe::inertia[2]);
+    
+    AlignedVector<double>* const state[]{&m_posN, &m_posE, &m_posD, &m_velU, &m_velV, &m_velW,
+                                         &m_roll, &m_pitch, &m_yaw, &m_rateP, &m_rateQ, &m_rateR, &m_mass};
+    static_assert(std::size(state) == static_cast<std::size_t>(FleetInputColumn::Throttle),
+                  "State columns must come before the controls");
+    for (std::size_t c = 0; c < std::size(state); ++c) {
+        std::copy(columns[c], columns[c] + count, state[c]->begin() + first);
+    }
+    const auto clamp = [first, count](const double* values, AlignedVector<double>& column, double low) {
+        std::transform(values, values + count, column.begin() + first,
+                       [low](double value) { return std::max(low, std::min(value, 1.0)); });
+    };
+    clamp(columns[static_cast<std::size_t>(FleetInputColumn::Throttle)], m_throttle, 0.0);
+    clamp(columns[static_cast<std::size_t>(FleetInputColumn::Aileron)], m_aileron, -1.0);
+    clamp(columns[static_cast<std::size_t>(FleetInputColumn::Elevator)], m_elevator, -1.0);
+    clamp(columns[static_cast<std::size_t>(FleetInputColumn::Rudder)], m_rudder, -1.0);
+    return first;
+}
+
+void FleetDynamics::reserve(std::size_t count) {
+    forEachColumn(*this, [count](AlignedVector<double>& column) { column.reserve(count); });
+    m_aeroTables.reserve(count);
+    m_turbulenceSteps.reserve(count);
+    m_turbulenceStreams.reserve(count);
+}
+
+void FleetDynamics::clear() {
+    forEachColumn(*this, [](AlignedVector<double>& column) { column.clear(); });
+    m_aeroTables.clear();
+    m_aeroTableCount = 0;
+    m_turbulenceSteps.clear();
+    m_turbulenceStreams.clear();
+}
+
+std::size_t FleetDynamics::size() const {
+    return m_posN.size();
+}
+
+FleetVehicleSnapshot FleetDynamics::snapshotVehicle(std::size_t index) const {
+    checkIndex(index);
+    
+    FleetVehicleSnapshot snapshot;
+    std::size_t column{0};
+    forEachColumn(*this, [&](const AlignedVector<double>& values) { snapshot.columns[column++] = values[index]; });
+    snapshot.turbulence_step = m_turbulenceSteps[index];
+    snapshot.turbulence_stream = m_turbulenceStreams[index];
+    return snapshot;
+}
+
+std::size_t FleetDynamics::addVehicle(const FleetVehicleSnapshot& snapshot) {
+    const std::size_t index{size()};
+    std::size_t column{0};
+    forEachColumn(*this, [&](AlignedVector<double>& values) { values.push_back(snapshot.columns[column++]); });
+    m_aeroTables.emplace_back();
+    m_turbulenceSteps.push_back(snapshot.turbulence_step);
+    m_turbulenceStreams.push_back(snapshot.turbulence_stream);
+    return index;
+}
+
+void FleetDynamics::removeVehicle(std::size_t index) {
+    checkIndex(index);
+    
+    const std::size_t last{size() - 1};
+    forEachColumn(*this, [index, last](AlignedVector<double>& values) {
+        values[index] = values[last];
+        values.pop_back();
+    });
+    m_aeroTableCount -= m_aeroTables[index] ? 1 : 0;
+    m_aeroTables[index] = std::move(m_aeroTables[last]);
+    m_aeroTables.pop_back();
+    m_turbulenceSteps[index] = m_turbulenceSteps[last];
+    m_turbulenceSteps.pop_back();
+    m_turbulenceStreams[index] = m_turbulenceStreams[last];
+    m_turbulenceStreams.pop_back();
+}
+
+void FleetDynamics::checkIndex(std::size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range{"Fleet vehicle index out of range"};
+    }
+}
+
+AircraftState FleetDynamics::getState(std::size_t index) const {
+    checkIndex(index);
+    
+    AircraftState state;
+    state.position = Eigen::Vector3d{m_posN[index], m_posE[index], m_posD[index]};
+    state.velocity = Eigen::Vector3d{m_velU[index], m_velV[index], m_velW[index]};
+    state.euler_angles = Eigen::Vector3d{m_roll[index], m_pitch[index], m_yaw[index]};
+    state.angular_velocity = Eigen::Vector3d{m_rateP[index], m_rateQ[index], m_rateR[index]};
+    state.mass = m_mass[index];
+    return state;
+}
+
+void FleetDynamics::setState(std::size_t index, const AircraftState& state) {
+    checkIndex(index);
+    
+    m_posN[index] = state.position.x();
+    m_posE[index] = state.position.y();
+    m_posD[index] = state.position.z();
+    m_velU[index] = state.velocity.x();
+    m_velV[index] = state.velocity.y();
+    m_velW[index] = state.velocity.z();
+    m_roll[index] = state.euler_angles.x();
+    m_pitch[index] = state.euler_angles.y();
+    m_yaw[index] = state.euler_angles.z();
+    m_rateP[index] = state.angular_velocity.x();
+    m_rateQ[index] = state.angular_velocity.y();
+    m_rateR[index] = state.angular_velocity.z();
+    m_mass[index] = state.mass;
+}
+
+void FleetDynamics::setControls(std::size_t index, const ControlInputs& controls) {
+    checkIndex(index);
+    
+    // Clamp control inputs to valid ranges
+    m_throttle[index] = std::max(0.0, std::min(controls.throttle, 1.0));
+    m_aileron[index] = std::max(-1.0, std::min(controls.aileron, 1.0));
+    m_elevator[index] = std::max(-1.0, std::min(controls.elevator, 1.0));
+    m_rudder[index] = std::max(-1.0, std::min(controls.rudder, 1.0));
+}
+
+ControlInputs FleetDynamics::getControls(std::size_t index) const {
+    checkIndex(index);
+    
+    ControlInputs controls;
+    controls.throttle = m_throttle[index];
+    controls.aileron = m_aileron[index];
+    controls.elevator = m_elevator[index];
+    controls.rudder = m_rudder[index];
+    return controls;
+}
+
+void FleetDynamics::setProperties(std::size_t index, const UAVPhysicalProperties& properties) {
+    checkIndex(index);
+    
+    setMass(index, properties.mass);
+    m_thrustMax[index] = std::max(0.0, properties.thrust_max);
+    m_invIxx[index] = 1.0 / properties.inertia.x();
+    m_invIyy[index] = 1.0 / properties.inertia.y();
+    m_invIzz[index] = 1.0 / properties.inertia.z();
+}
+
+void FleetDynamics::setMass(std::size_t index, double mass) {
+    checkIndex(index);
+    m_mass[index] = std::max(0.1, mass); // Minimum mass of 0.1kg
+}
+
+void FleetDynamics::setWingspanArea(std::size_t index, double area) {
+    checkIndex(index);
+    m_wingArea[index] = std::max(0.01, area); // Minimum area of 0.01m²
+}
+
+void FleetDynamics::setLiftCoefficient(std::size_t index, double cl) {
+    checkIndex(index);
+    m_liftCoefficient[index] = cl;
+}
+
+void FleetDynamics::setDragCoefficient(std::size_t index, double cd) {
+    checkIndex(index);
+    m_dragCoefficient[index] = std::max(0.0, cd);
+}
+
+void FleetDynamics::setAeroTable(std::size_t index, std::shared_ptr<const AeroTable> table) {
+    checkIndex(index);
+    m_aeroTableCount -= m_aeroTables[index] ? 1 : 0;
+    m_aeroTableCount += table ? 1 : 0;
+    m_aeroTables[index] = std::move(table);
+}
+
+void FleetDynamics::setAirDensity(double density) {
+    m_airDensity = std::max(0.01, density); // Ensure positive air density
+}
+
+void FleetDynamics::setWind(const Eigen::Vector3d& wind) {
+    m_wind[0] = wind.x();
+    m_wind[1] = wind.y();
+    m_wind[2] = wind.z();
+}
+
+void FleetDynamics::setWindField(std::shared_ptr<const WindField> field) {
+    m_windField = std::move(field);
+}
+
+void FleetDynamics::setTurbulence(const TurbulenceParameters& parameters) {
+    m_turbulence = parameters;
+    m_turbulence.wind_speed_20ft = std::max(0.0, parameters.wind_speed_20ft);
+}
+
+void FleetDynamics::setTurbulenceStream(std::size_t index, std::uint64_t stream) {
+    checkIndex(index);
+    m_turbulenceStreams[index] = stream;
+}
+
+std::uint64_t FleetDynamics::getTurbulenceStream(std::size_t index) const {
+    checkIndex(index);
+    return m_turbulenceStreams[index];
+}
+
+bool FleetDynamics::hasWind() const {
+    return m_windField || m_turbulence.wind_speed_20ft > 0.0 ||
+           m_wind[0] != 0.0 || m_wind[1] != 0.0 || m_wind[2] != 0.0;
+}
+
+void FleetDynamics::update(double dt) {
+    updateRange(0, size(), dt);
+}
+
+void FleetDynamics::updateRange(std::size_t begin, std::size_t end, double dt) {
+    end = std::min(end, size());
+    if (begin >= end) {
+        return;
+    }
+    if (hasWind()) {
+        sampleWind(begin, end, dt);
+    }
+    if (m_aeroTableCount > 0) {
+        lookupAeroTables(begin, end);
+    }
+    m_kernel(kernelArgs(dt), begin, end);
+}
+
+void FleetDynamics::sampleWind(std::size_t begin, std::size_t end, double dt) {
+    // Far enough ahead for the lines to arrive, near enough to stay in cache
+    constexpr std::size_t kPrefetchDistance{8};
+    constexpr std::size_t kBlock{DrydenTurbulence::kBlockSteps};
+    const WindField* field{m_windField.get()};
+    const bool turbulent{m_turbulence.wind_speed_20ft > 0.0};
+    
+    double noise[kBlock][3];
+    for (std::size_t block = begin; block < end; block += kBlock) {
+        const std::size_t blockEnd{std::min(block + kBlock, end)};
+        if (turbulent) {
+            for (std::size_t i = block; i < blockEnd; ++i) {
+                DrydenTurbulence::whiteNoise(m_turbulence.seed + m_turbulenceStreams[i], m_turbulenceSteps[i],
+                                             noise[i - block]);
+            }
+        }
+        
+        for (std::size_t i = block; i < blockEnd; ++i) {
+            if (field && i + kPrefetchDistance < end) {
+                const std::size_t ahead{i + kPrefetchDistance};
+                field->prefetch(m_posN[ahead], m_posE[ahead], m_posD[ahead], m_environmentTime[ahead]);
+            }
+            
+            // Mean NED wind at the vehicle
+            double wind[3]{m_wind[0], m_wind[1], m_wind[2]};
+            if (field) {
+                double sampled[3];
+                field->sample(m_posN[i], m_posE[i], m_posD[i], m_environmentTime[i], sampled);
+                wind[0] += sampled[0];
+                wind[1] += sampled[1];
+                wind[2] += sampled[2];
+            }
+            m_environmentTime[i] += dt;
+            
+            // Rotate into body axes with the transpose of the kernel's body-to-NED matrix
+            const double cphi{std::cos(m_roll[i])};
+            const double sphi{std::sin(m_roll[i])};
+            const double ctheta{std::cos(m_pitch[i])};
+            const double stheta{std::sin(m_pitch[i])};
+            const double cpsi{std::cos(m_yaw[i])};
+            const double spsi{std::sin(m_yaw[i])};
+            double windU{cpsi * ctheta * wind[0] + spsi * ctheta * wind[1] - stheta * wind[2]};
+            double windV{(cpsi * stheta * sphi - spsi * cphi) * wind[0] + (spsi * stheta * sphi + cpsi * cphi) * wind[1] +
+                         ctheta * sphi * wind[2]};
+            double windW{(cpsi * stheta * cphi + spsi * sphi) * wind[0] + (spsi * stheta * cphi - cpsi * sphi) * wind[1] +
+                         ctheta * cphi * wind[2]};
+            
+            // Gusts, filtered at the airspeed through the mean wind
+            if (turbulent) {
+                const double airU{m_velU[i] - windU};
+                const double airV{m_velV[i] - windV};
+                const double airW{m_velW[i] - windW};
+                double gust[3]{m_gustU[i], m_gustV[i], m_gustW[i]};
+                DrydenTurbulence::filter(m_turbulence, -m_posD[i], std::sqrt(airU * airU + airV * airV + airW * airW),
+                                         dt, noise[i - block], gust);
+                ++m_turbulenceSteps[i];
+                m_gustU[i] = gust[0];
+                m_gustV[i] = gust[1];
+                m_gustW[i] = gust[2];
+                windU += gust[0];
+                windV += gust[1];
+                windW += gust[2];
+            }
+            m_windU[i] = windU;
+            m_windV[i] = windV;
+            m_windW[i] = windW;
+        }
+    }
+}
+
+void FleetDynamics::lookupAeroTables(std::size_t begin, std::size_t end) {
+    // Same air data as FlightDynamics, from the air velocity at the start of the step
+    const bool windy{hasWind()};
+    for (std::size_t i = begin; i < end; ++i) {
+        const AeroTable* table{m_aeroTables[i].get()};
+        if (!table) {
+            m_stepLift[i] = m_liftCoefficient[i];
+            m_stepDrag[i] = m_dragCoefficient[i];
+            m_pitchMoment[i] = 0.0;
+            continue;
+        }
+        
+        const double u{windy ? m_velU[i] - m_windU[i] : m_velU[i]};
+        const double v{windy ? m_velV[i] - m_windV[i] : m_velV[i]};
+        const double w{windy ? m_velW[i] - m_windW[i] : m_velW[i]};
+        const double airspeed{std::sqrt(u * u + v * v + w * w)};
+        const double beta{airspeed > 0.0 ? std::asin(v / airspeed) : 0.0};
+        const AeroCoefficients coefficients{table->lookup(std::atan2(w, u), beta, airspeed / m_speedOfSound,
+                                                          m_elevator[i])};
+        m_stepLift[i] = coefficients.lift;
+        m_stepDrag[i] = coefficients.drag;
+        
+        // M = 0.5 * ρ * v² * S * c * Cm with mean chord c = S / b, none below 0.1 m/s
+        const double dynamicPressureArea{airspeed >= 0.1 ? 0.5 * m_airDensity * airspeed * airspeed * m_wingArea[i] : 0.0};
+        m_pitchMoment[i] = dynamicPressureArea * (m_wingArea[i] / m_wingspan[i]) * coefficients.pitch_moment;
+    }
+}
+
+void FleetDynamics::setSimdIsa(SimdIsa isa) {
+    if (!isSimdIsaAvailable(isa)) {
+        throw std::invalid_argument{std::string{"SIMD kernel not available: "} + simdIsaName(isa)};
+    }
+    m_isa = isa;
+    m_kernel = fleetKernelFor(isa);
+}
+
+SimdIsa FleetDynamics::getSimdIsa() const {
+    return m_isa;
+}
+
+FleetKernelArgs FleetDynamics::kernelArgs(double dt) {
+    FleetKernelArgs args;
+    args.posN = m_posN.data();
+    args.posE = m_posE.data();
+    args.posD = m_posD.data();
+    args.velU = m_velU.data();
+    args.velV = m_velV.data();
+    args.velW = m_velW.data();
+    args.roll = m_roll.data();
+    args.pitch = m_pitch.data();
+    args.yaw = m_yaw.data();
+    args.rateP = m_rateP.data();
+    args.rateQ = m_rateQ.data();
+    args.rateR = m_rateR.data();
+    args.mass = m_mass.data();
+    args.throttle = m_throttle.data();
+    args.aileron = m_aileron.data();
+    args.elevator = m_elevator.data();
+    args.rudder = m_rudder.data();
+    args.wingArea = m_wingArea.data();
+    args.wingspan = m_wingspan.data();
+    args.liftCoefficient = m_aeroTableCount > 0 ? m_stepLift.data() : m_liftCoefficient.data();
+    args.dragCoefficient = m_aeroTableCount > 0 ? m_stepDrag.data() : m_dragCoefficient.data();
+    args.thrustMax = m_thrustMax.data();
+    args.invIxx = m_invIxx.data();
+    args.invIyy = m_invIyy.data();
+    args.invIzz = m_invIzz.data();
+    args.pitchMoment = m_pitchMoment.data();
+    if (hasWind()) {
+        args.windU = m_windU.data();
+        args.windV = m_windV.data();
+        args.windW = m_windW.data();
+    }
+    args.halfRho = 0.5 * m_airDensity;
+    args.gravity = m_gravity;
+    args.dt = dt;
+    return args;
+}
+
+} // namespace falconsim
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "AeroTable.hpp"
+#include "AlignedAllocator.hpp"
+#include "FleetKernels.hpp"
+#include "FlightDynamics.hpp"
+#include "Turbulence.hpp"
+#include "WindField.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Everything a FleetDynamics holds for one vehicle except its aero table
+ *
+ * Plain, trivially copyable data, so a vehicle can be moved to another
+ * fleet (or sent over the wire as raw bytes between hosts of the same
+ * byte order) and carry on bit for bit as if it had stayed: state,
+ * controls, airframe, gust filter state, environment clock and turbulence
+ * stream. Aero tables are shared objects and do not travel; reattach them
+ * with setAeroTable().
+ */
+struct FleetVehicleSnapshot {
+    static constexpr std::size_t kColumnCount{35};
+    double columns[kColumnCount]{};       // One value per fleet column, in the fleet's internal order
+    std::uint64_t turbulence_step{0};     // Dryden noise counter
+    std::uint64_t turbulence_stream{0};   // Turbulence stream, offset from the fleet seed
+};
+
+/**
+ * @brief Per-vehicle inputs a fleet can be loaded from in bulk: the AircraftState fields, then the ControlInputs
+ */
+enum class FleetInputColumn : std::size_t {
+    North, East, Down,                 // Position in NED frame (m)
+    VelocityU, VelocityV, VelocityW,   // Velocity in body frame (m/s)
+    Roll, Pitch, Yaw,                  // Euler angles (rad)
+    RateP, RateQ, RateR,               // Angular velocity (rad/s)
+    Mass,                              // Aircraft mass (kg)
+    Throttle, Aileron, Elevator, Rudder
+};
+constexpr std::size_t kFleetInputColumnCount{17};
+
+/**
+ * @brief Batch flight dynamics engine for many independent aircraft
+ *
+ * Runs the same force, moment and integration model as FlightDynamics, but
+ * keeps every quantity of the fleet in contiguous structure-of-arrays columns
+ * so a step is a linear sweep over memory instead of one object per vehicle.
+ * Vehicles are addressed by the index returned from addVehicle().
+ *
+ * The step kernel is chosen at runtime: the widest SIMD instruction set the
+ * CPU supports (AVX-512, AVX2, NEON) processes 8/4/2 vehicles per
+ * instruction, with a scalar kernel for the remainder and as a fallback.
+ *
+ * Vehicles given an AeroTable (typically one shared table per aircraft
+ * type) have their CL, CD and pitching moment looked up in a scalar pass
+ * over the range just before the kernel runs. Fleets without tables skip
+ * that pass entirely.
+ *
+ * Wind works the same way. Once the fleet has a steady wind, a WindField or
+ * turbulence, a pre-pass samples the field at every vehicle, prefetching
+ * the bricks of vehicles a few places ahead. It advances each vehicle's
+ * Dryden gusts, drawing noise for a block of vehicles at a time, and hands
+ * the kernel the result in body axes. Each vehicle draws turbulence stream
+ * seed + its stream number, which defaults to the index addVehicle()
+ * returned, so vehicle i matches a FlightDynamics seeded with seed + i. Each
+ * vehicle keeps its own environment clock, advanced by its steps while wind
+ * is set, so ranges may be stepped from any thread.
+ */
+class FleetDynamics {
+public:
+    FleetDynamics() = default;
+    ~FleetDynamics() = default;
+    
+    // Columns are plain values and tables are shared, so the fleet can be copied and moved freely
+    FleetDynamics(const FleetDynamics&) = default;
+    FleetDynamics& operator=(const FleetDynamics&) = default;
+    FleetDynamics(FleetDynamics&&) noexcept = default;
+    FleetDynamics& operator=(FleetDynamics&&) noexcept = default;
+    
+    // Fleet management
+    std::size_t addVehicle(const AircraftState& state = {});
+    // Append count default vehicles whose state and controls come from columns[FleetInputColumn], count
+    // values each (controls are clamped as by setControls()); every column grows once. Returns the first index
+    std::size_t addVehicles(const double* const columns[kFleetInputColumnCount], std::size_t count);
+    void reserve(std::size_t count);
+    void clear();
+    [[nodiscard]] std::size_t size() const;
+    
+    // Whole-vehicle transfer: remove moves the last vehicle into the freed index
+    [[nodiscard]] FleetVehicleSnapshot snapshotVehicle(std::size_t index) const;
+    std::size_t addVehicle(const FleetVehicleSnapshot& snapshot);
+    void removeVehicle(std::size_t index);
+    
+    // Per-vehicle state access and manipulation
+    [[nodiscard]] AircraftState getState(std::size_t index) const;
+    void setState(std::size_t index, const AircraftState& state);
+    
+    // Per-vehicle control input
+    void setControls(std::size_t index, const ControlInputs& controls);
+    [[nodiscard]] ControlInputs getControls(std::size_t index) const;
+    
+    // Per-vehicle aircraft parameters (defaults match FlightDynamics)
+    void setProperties(std::size_t index, const UAVPhysicalProperties& properties);
+    void setMass(std::size_t index, double mass);
+    void setWingspanArea(std::size_t index, double area);
+    void setLiftCoefficient(std::size_t index, double cl);
+    void setDragCoefficient(std::size_t index, double cd);
+    
+    // Tabulated aerodynamics for one vehicle (nullptr restores its constant coefficients)
+    void setAeroTable(std::size_t index, std::shared_ptr<const AeroTable> table);
+    
+    // Environment (shared by the whole fleet)
+    void setAirDensity(double density);
+    void setWind(const Eigen::Vector3d& wind);                  // Steady NED wind (m/s)
+    void setWindField(std::shared_ptr<const WindField> field);  // Gridded wind on top; nullptr removes it
+    void setTurbulence(const TurbulenceParameters& parameters); // Streams are parameters.seed + stream number
+    
+    // Per-vehicle turbulence stream number (offset from parameters.seed; defaults to the index at addVehicle())
+    void setTurbulenceStream(std::size_t index, std::uint64_t stream);
+    [[nodiscard]] std::uint64_t getTurbulenceStream(std::size_t index) const;
+    
+    // Kernel selection; throws std::invalid_argument if the ISA isn't available here
+    void setSimdIsa(SimdIsa isa);
+    [[nodiscard]] SimdIsa getSimdIsa() const;
+    
+    // Physics update for every vehicle, or for the half-open range [begin, end)
+    void update(double dt);
+    void updateRange(std::size_t begin, std::size_t end, double dt);
+    
+    // Read-only column access (NED position in metres)
+    [[nodiscard]] const double* positionNorth() const { return m_posN.data(); }
+    [[nodiscard]] const double* positionEast() const { return m_posE.data(); }
+    [[nodiscard]] const double* positionDown() const { return m_posD.data(); }
+
+private:
+    void checkIndex(std::size_t index) const;
+    [[nodiscard]] FleetKernelArgs kernelArgs(double dt);
+    void lookupAeroTables(std::size_t begin, std::size_t end);
+    void sampleWind(std::size_t begin, std::size_t end, double dt);
+    [[nodiscard]] bool hasWind() const;
+    
+    // Visits every double column in snapshot order; Self is FleetDynamics or const FleetDynamics
+    template <typename Self, typename Fn>
+    static void forEachColumn(Self& self, Fn&& fn);
+    
+    // State columns
+    AlignedVector<double> m_posN{}, m_posE{}, m_posD{};       // Position in NED frame (m)
+    AlignedVector<double> m_velU{}, m_velV{}, m_velW{};       // Velocity in body frame (m/s)
+    AlignedVector<double> m_roll{}, m_pitch{}, m_yaw{};       // Euler angles (rad)
+    AlignedVector<double> m_rateP{}, m_rateQ{}, m_rateR{};    // Angular velocity (rad/s)
+    AlignedVector<double> m_mass{};                           // Aircraft mass (kg)
+    
+    // Control columns
+    AlignedVector<double> m_throttle{}, m_aileron{}, m_elevator{}, m_rudder{};
+    
+    // Airframe and aerodynamic coefficient columns
+    AlignedVector<double> m_wingArea{};        // Wing area (m²)
+    AlignedVector<double> m_wingspan{};        // Wingspan (m)
+    AlignedVector<double> m_liftCoefficient{}; // Basic lift coefficient
+    AlignedVector<double> m_dragCoefficient{}; // Basic drag coefficient
+    AlignedVector<double> m_thrustMax{};       // Maximum thrust (N)
+    AlignedVector<double> m_invIxx{}, m_invIyy{}, m_invIzz{}; // Inverse principal moments of inertia
+    
+    // Tabulated aerodynamics: per-vehicle tables and the coefficients looked up for this step
+    std::vector<std::shared_ptr<const AeroTable>> m_aeroTables{};
+    std::size_t m_aeroTableCount{0};                  // Vehicles with a table
+    AlignedVector<double> m_stepLift{}, m_stepDrag{}; // CL and CD the kernel uses while any table is set
+    AlignedVector<double> m_pitchMoment{};            // Tabulated pitching moment (N·m), zero without a table
+    
+    // Wind: body-axis wind and gust the kernel sees this step, gust filter state and per-vehicle clocks
+    AlignedVector<double> m_windU{}, m_windV{}, m_windW{};
+    AlignedVector<double> m_gustU{}, m_gustV{}, m_gustW{};
+    AlignedVector<double> m_environmentTime{};        // Wind field sample time (s)
+    std::vector<std::uint64_t> m_turbulenceSteps{};   // Dryden noise counter
+    std::vector<std::uint64_t> m_turbulenceStreams{}; // Dryden noise stream, offset from the seed
+    double m_wind[3]{0.0, 0.0, 0.0};                  // Steady NED wind (m/s)
+    std::shared_ptr<const WindField> m_windField{};
+    TurbulenceParameters m_turbulence{};
+    
+    // Environment
+    double m_airDensity{1.225};    // Air density at sea level (kg/m³)
+    double m_gravity{9.81};        // Gravity acceleration (m/s²)
+    double m_speedOfSound{340.29}; // Speed of sound at sea level (m/s)
+    
+    // Step kernel
+    SimdIsa m_isa{bestAvailableSimdIsa()};
+    FleetKernel m_kernel{fleetKernelFor(m_isa)};
+};
+
+} // namespace falconsim
@@ -0,0 +1,149 @@
+#include "FleetKernels.hpp"
+#include <cmath>
+#include <initializer_list>
+
+namespace falconsim {
+
+void stepFleetScalar(const FleetKernelArgs& a, std::size_t begin, std::size_t end) {
+    const double dt{a.dt};
+    
+    for (std::size_t i = begin; i < end; ++i) {
+        // Trig terms shared by the rotation, gravity and Euler-rate transform
+        const double cphi{std::cos(a.roll[i])};
+        const double sphi{std::sin(a.roll[i])};
+        const double ctheta{std::cos(a.pitch[i])};
+        const double stheta{std::sin(a.pitch[i])};
+        const double cpsi{std::cos(a.yaw[i])};
+        const double spsi{std::sin(a.yaw[i])};
+        
+        double u{a.velU[i]};
+        double v{a.velV[i]};
+        double w{a.velW[i]};
+        const double mass{a.mass[i]};
+        
+        // Forces in body frame: thrust along x, gravity rotated from NED
+        double fx{a.throttle[i] * a.thrustMax[i] - mass * a.gravity * stheta};
+        double fy{mass * a.gravity * ctheta * sphi};
+        double fz{mass * a.gravity * ctheta * cphi};
+        
+        // Velocity through the air, the same as the body velocity in still air
+        double airU{u};
+        double airV{v};
+        double airW{w};
+        if (a.windU) {
+            airU -= a.windU[i];
+            airV -= a.windV[i];
+            airW -= a.windW[i];
+        }
+        
+        // Lift (body -z) and drag (against the airflow), none below 0.1 m/s
+        const double airspeed{std::sqrt(airU * airU + airV * airV + airW * airW)};
+        if (airspeed >= 0.1) {
+            const double dynamicPressureArea{a.halfRho * airspeed * airspeed * a.wingArea[i]};
+            const double drag{dynamicPressureArea * a.dragCoefficient[i] / airspeed};
+            fx -= drag * airU;
+            fy -= drag * airV;
+            fz -= drag * airW + dynamicPressureArea * a.liftCoefficient[i];
+        }
+        
+        // a = F/m, integrate velocity
+        u += fx / mass * dt;
+        v += fy / mass * dt;
+        w += fz / mass * dt;
+        
+        // Control surface moments and angular acceleration α = I⁻¹ * M
+        const double p{a.rateP[i] + a.aileron[i] * 2.0 * a.wingspan[i] * a.invIxx[i] * dt};
+        const double q{a.rateQ[i] + (a.elevator[i] * 1.5 + a.pitchMoment[i]) * a.invIyy[i] * dt};
+        const double r{a.rateR[i] + a.rudder[i] * 1.0 * a.invIzz[i] * dt};
+        
+        // Position update with body velocity rotated to NED
+        a.posN[i] += (cpsi * ctheta * u + (cpsi * stheta * sphi - spsi * cphi) * v
+                      + (cpsi * stheta * cphi + spsi * sphi) * w) * dt;
+        a.posE[i] += (spsi * ctheta * u + (spsi * stheta * sphi + cpsi * cphi) * v
+                      + (spsi * stheta * cphi - cpsi * sphi) * w) * dt;
+        a.posD[i] += (-stheta * u + ctheta * sphi * v + ctheta * cphi * w) * dt;
+        
+        // Body rates to Euler rates
+        const double ttheta{stheta / ctheta};
+        a.roll[i] += (p + (sphi * q + cphi * r) * ttheta) * dt;
+        a.pitch[i] += (cphi * q - sphi * r) * dt;
+        a.yaw[i] += (sphi * q + cphi * r) / ctheta * dt;
+        
+        a.velU[i] = u;
+        a.velV[i] = v;
+        a.velW[i] = w;
+        a.rateP[i] = p;
+        a.rateQ[i] = q;
+        a.rateR[i] = r;
+    }
+}
+
+bool isSimdIsaAvailable(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::Scalar:
+            return true;
+        case SimdIsa::Neon:
+#if defined(FALCONSIM_HAVE_NEON_KERNELS)
+            return true; // Advanced SIMD is mandatory on AArch64
+#else
+            return false;
+#endif
+        case SimdIsa::Avx2:
+#if defined(FALCONSIM_HAVE_AVX2_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+            return false;
+#endif
+        case SimdIsa::Avx512:
+#if defined(FALCONSIM_HAVE_AVX512_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx512f");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+SimdIsa bestAvailableSimdIsa() {
+    for (SimdIsa isa : {SimdIsa::Avx512, SimdIsa::Avx2, SimdIsa::Neon}) {
+        if (isSimdIsaAvailable(isa)) {
+            return isa;
+        }
+    }
+    return SimdIsa::Scalar;
+}
+
+FleetKernel fleetKernelFor(SimdIsa isa) {
+    if (!isSimdIsaAvailable(isa)) {
+        return &stepFleetScalar;
+    }
+    
+    switch (isa) {
+#if defined(FALCONSIM_HAVE_AVX512_KERNELS)
+        case SimdIsa::Avx512:
+            return &stepFleetAvx512;
+#endif
+#if defined(FALCONSIM_HAVE_AVX2_KERNELS)
+        case SimdIsa::Avx2:
+            return &stepFleetAvx2;
+#endif
+#if defined(FALCONSIM_HAVE_NEON_KERNELS)
+        case SimdIsa::Neon:
+            return &stepFleetNeon;
+#endif
+        default:
+            return &stepFleetScalar;
+    }
+}
+
+const char* simdIsaName(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::Scalar: return "scalar";
+        case SimdIsa::Neon: return "neon";
+        case SimdIsa::Avx2: return "avx2";
+        case SimdIsa::Avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace falconsim
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+
+namespace falconsim {
+
+/**
+ * @brief Instruction sets the fleet step kernels can be dispatched to
+ */
+enum class SimdIsa {
+    Scalar,
+    Neon,   // 2 doubles per vector (AArch64)
+    Avx2,   // 4 doubles per vector (AVX2 + FMA)
+    Avx512  // 8 doubles per vector (AVX-512F)
+};
+
+/**
+ * @brief Raw column pointers and shared parameters for one fleet step
+ *
+ * Kept free of Eigen and other inline-heavy headers on purpose: the ISA
+ * specific kernels are compiled with extra target flags, and must not emit
+ * shared inline code that could leak wide instructions into generic code.
+ */
+struct FleetKernelArgs {
+    // State columns (updated in place)
+    double* posN{nullptr};
+    double* posE{nullptr};
+    double* posD{nullptr};
+    double* velU{nullptr};
+    double* velV{nullptr};
+    double* velW{nullptr};
+    double* roll{nullptr};
+    double* pitch{nullptr};
+    double* yaw{nullptr};
+    double* rateP{nullptr};
+    double* rateQ{nullptr};
+    double* rateR{nullptr};
+    
+    // Read-only columns
+    const double* mass{nullptr};
+    const double* throttle{nullptr};
+    const double* aileron{nullptr};
+    const double* elevator{nullptr};
+    const double* rudder{nullptr};
+    const double* wingArea{nullptr};
+    const double* wingspan{nullptr};
+    const double* liftCoefficient{nullptr};
+    const double* dragCoefficient{nullptr};
+    const double* thrustMax{nullptr};
+    const double* invIxx{nullptr};
+    const double* invIyy{nullptr};
+    const double* invIzz{nullptr};
+    const double* pitchMoment{nullptr}; // Tabulated aerodynamic pitching moment (N·m)
+    const double* windU{nullptr};       // Wind and gust at the vehicle in body axes (m/s); nullptr in still air
+    const double* windV{nullptr};
+    const double* windW{nullptr};
+    
+    // Shared parameters
+    double halfRho{0.5 * 1.225};
+    double gravity{9.81};
+    double dt{0.0};
+};
+
+// Steps vehicles [begin, end) of the fleet described by args
+using FleetKernel = void (*)(const FleetKernelArgs& args, std::size_t begin, std::size_t end);
+
+void stepFleetScalar(const FleetKernelArgs& args, std::size_t begin, std::size_t end);
+#if defined(FALCONSIM_HAVE_AVX2_KERNELS)
+void stepFleetAvx2(const FleetKernelArgs& args, std::size_t begin, std::size_t end);
+#endif
+#if defined(FALCONSIM_HAVE_AVX512_KERNELS)
+void stepFleetAvx512(const FleetKernelArgs& args, std::size_t begin, std::size_t end);
+#endif
+#if defined(FALCONSIM_HAVE_NEON_KERNELS)
+void stepFleetNeon(const FleetKernelArgs& args, std::size_t begin, std::size_t end);
+#endif
+
+// Runtime CPU dispatch
+[[nodiscard]] bool isSimdIsaAvailable(SimdIsa isa);
+[[nodiscard]] SimdIsa bestAvailableSimdIsa();
+[[nodiscard]] FleetKernel fleetKernelFor(SimdIsa isa);
+[[nodiscard]] const char* simdIsaName(SimdIsa isa);
+
+} // namespace falconsim
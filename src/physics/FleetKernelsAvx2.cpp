@@ -0,0 +1,37 @@
+// Compiled with -mavx2 -mfma; only reached after runtime CPU detection
+#include "FleetKernelsSimd.hpp"
+#include <immintrin.h>
+
+namespace falconsim {
+
+namespace {
+
+struct Avx2Traits {
+    using Reg = __m256d;
+    using Mask = __m256d;
+    static constexpr std::size_t width{4};
+    
+    static Reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, Reg a) { _mm256_storeu_pd(p, a); }
+    static Reg set1(double value) { return _mm256_set1_pd(value); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+    static Reg div(Reg a, Reg b) { return _mm256_div_pd(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static Reg sqrt(Reg a) { return _mm256_sqrt_pd(a); }
+    static Reg roundNearest(Reg a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Reg floor(Reg a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Mask cmpGe(Reg a, Reg b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static Mask cmpEq(Reg a, Reg b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static Mask maskOr(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+    static Reg select(Mask m, Reg ifTrue, Reg ifFalse) { return _mm256_blendv_pd(ifFalse, ifTrue, m); }
+};
+
+} // namespace
+
+void stepFleetAvx2(const FleetKernelArgs& args, std::size_t begin, std::size_t end) {
+    simd_detail::stepFleet<Avx2Traits>(args, begin, end);
+}
+
+} // namespace falconsim
@@ -0,0 +1,42 @@
+// Compiled with -mavx512f -mfma; only reached after runtime CPU detection
+#include "FleetKernelsSimd.hpp"
+#include <immintrin.h>
+
+namespace falconsim {
+
+namespace {
+
+struct Avx512Traits {
+    using Reg = __m512d;
+    using Mask = __mmask8;
+    static constexpr std::size_t width{8};
+    
+    static Reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, Reg a) { _mm512_storeu_pd(p, a); }
+    static Reg set1(double value) { return _mm512_set1_pd(value); }
+    static Reg add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+    static Reg div(Reg a, Reg b) { return _mm512_div_pd(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_pd(a, b, c); }
+    // The masked forms pass `a` through as the merge source; GCC's unmasked
+    // sqrt and roundscale merge into an undefined register and trip
+    // -Wmaybe-uninitialized once inlined
+    static Reg sqrt(Reg a) { return _mm512_mask_sqrt_pd(a, 0xFF, a); }
+    static Reg roundNearest(Reg a) {
+        return _mm512_mask_roundscale_pd(a, 0xFF, a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    static Reg floor(Reg a) { return _mm512_mask_roundscale_pd(a, 0xFF, a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Mask cmpGe(Reg a, Reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static Mask cmpEq(Reg a, Reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static Mask maskOr(Mask a, Mask b) { return static_cast<Mask>(a | b); }
+    static Reg select(Mask m, Reg ifTrue, Reg ifFalse) { return _mm512_mask_blend_pd(m, ifFalse, ifTrue); }
+};
+
+} // namespace
+
+void stepFleetAvx512(const FleetKernelArgs& args, std::size_t begin, std::size_t end) {
+    simd_detail::stepFleet<Avx512Traits>(args, begin, end);
+}
+
+} // namespace falconsim
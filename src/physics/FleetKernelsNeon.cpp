@@ -0,0 +1,37 @@
+// AArch64 Advanced SIMD kernels; NEON is always present on this target
+#include "FleetKernelsSimd.hpp"
+#include <arm_neon.h>
+
+namespace falconsim {
+
+namespace {
+
+struct NeonTraits {
+    using Reg = float64x2_t;
+    using Mask = uint64x2_t;
+    static constexpr std::size_t width{2};
+    
+    static Reg load(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, Reg a) { vst1q_f64(p, a); }
+    static Reg set1(double value) { return vdupq_n_f64(value); }
+    static Reg add(Reg a, Reg b) { return vaddq_f64(a, b); }
+    static Reg sub(Reg a, Reg b) { return vsubq_f64(a, b); }
+    static Reg mul(Reg a, Reg b) { return vmulq_f64(a, b); }
+    static Reg div(Reg a, Reg b) { return vdivq_f64(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return vfmaq_f64(c, a, b); }
+    static Reg sqrt(Reg a) { return vsqrtq_f64(a); }
+    static Reg roundNearest(Reg a) { return vrndnq_f64(a); }
+    static Reg floor(Reg a) { return vrndmq_f64(a); }
+    static Mask cmpGe(Reg a, Reg b) { return vcgeq_f64(a, b); }
+    static Mask cmpEq(Reg a, Reg b) { return vceqq_f64(a, b); }
+    static Mask maskOr(Mask a, Mask b) { return vorrq_u64(a, b); }
+    static Reg select(Mask m, Reg ifTrue, Reg ifFalse) { return vbslq_f64(m, ifTrue, ifFalse); }
+};
+
+} // namespace
+
+void stepFleetNeon(const FleetKernelArgs& args, std::size_t begin, std::size_t end) {
+    simd_detail::stepFleet<NeonTraits>(args, begin, end);
+}
+
+} // namespace falconsim
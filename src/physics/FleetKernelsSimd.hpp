@@ -0,0 +1,203 @@
+#pragma once
+
+// Generic SIMD implementation of the fleet step, instantiated once per ISA by
+// FleetKernelsAvx2.cpp, FleetKernelsAvx512.cpp and FleetKernelsNeon.cpp.
+//
+// Everything here is templated on the per-ISA register traits V, which each
+// translation unit defines in an anonymous namespace. That keeps every
+// instantiation (and any wide instruction it contains) private to the TU that
+// was compiled with the matching target flags.
+//
+// V must provide:
+//   Reg, Mask, width
+//   load, store, set1, add, sub, mul, div, fmadd (a*b+c), sqrt
+//   roundNearest, floor, cmpGe, cmpEq, maskOr, select(mask, ifTrue, ifFalse)
+
+#include <cstddef>
+
+#include "FleetKernels.hpp"
+
+namespace falconsim {
+namespace simd_detail {
+
+template <typename V>
+struct Vec {
+    typename V::Reg r;
+    
+    Vec() = default;
+    Vec(typename V::Reg reg) : r{reg} {}
+    explicit Vec(double value) : r{V::set1(value)} {}
+    
+    static Vec load(const double* p) { return Vec{V::load(p)}; }
+    void store(double* p) const { V::store(p, r); }
+};
+
+template <typename V> inline Vec<V> operator+(Vec<V> a, Vec<V> b) { return V::add(a.r, b.r); }
+template <typename V> inline Vec<V> operator-(Vec<V> a, Vec<V> b) { return V::sub(a.r, b.r); }
+template <typename V> inline Vec<V> operator*(Vec<V> a, Vec<V> b) { return V::mul(a.r, b.r); }
+template <typename V> inline Vec<V> operator/(Vec<V> a, Vec<V> b) { return V::div(a.r, b.r); }
+template <typename V> inline Vec<V> operator-(Vec<V> a) { return V::sub(V::set1(0.0), a.r); }
+template <typename V> inline Vec<V> fmadd(Vec<V> a, Vec<V> b, Vec<V> c) { return V::fmadd(a.r, b.r, c.r); }
+template <typename V> inline Vec<V> sqrt(Vec<V> a) { return V::sqrt(a.r); }
+template <typename V> inline Vec<V> select(typename V::Mask m, Vec<V> t, Vec<V> f) { return V::select(m, t.r, f.r); }
+
+/**
+ * Vectorized sine and cosine of the same argument
+ *
+ * Cody-Waite reduction by π/2 followed by the Cephes minimax polynomials on
+ * [-π/4, π/4]; accurate to a couple of ulp for the angle magnitudes the
+ * simulation produces (|x| well below 1e6 rad).
+ */
+template <typename V>
+inline void sincos(Vec<V> x, Vec<V>& sinOut, Vec<V>& cosOut) {
+    using W = Vec<V>;
+    
+    // π/2 split into three parts whose products with k are exact
+    const W twoOverPi{0.63661977236758134308};
+    const W dp1{1.57079625129699707031};
+    const W dp2{7.54978941586159635336e-8};
+    const W dp3{5.39030285815811905290e-15};
+    
+    const W k{V::roundNearest((x * twoOverPi).r)};
+    W r{fmadd(-k, dp1, x)};
+    r = fmadd(-k, dp2, r);
+    r = fmadd(-k, dp3, r);
+    const W z{r * r};
+    
+    W sinPoly{1.58962301576546568060e-10};
+    sinPoly = fmadd(sinPoly, z, W{-2.50507477628578072866e-8});
+    sinPoly = fmadd(sinPoly, z, W{2.75573136213857245213e-6});
+    sinPoly = fmadd(sinPoly, z, W{-1.98412698295895385996e-4});
+    sinPoly = fmadd(sinPoly, z, W{8.33333333332211858878e-3});
+    sinPoly = fmadd(sinPoly, z, W{-1.66666666666666307295e-1});
+    const W sinR{fmadd(r * z, sinPoly, r)};
+    
+    W cosPoly{-1.13585365213876817300e-11};
+    cosPoly = fmadd(cosPoly, z, W{2.08757008419747316778e-9});
+    cosPoly = fmadd(cosPoly, z, W{-2.75573141792967388112e-7});
+    cosPoly = fmadd(cosPoly, z, W{2.48015872888517045348e-5});
+    cosPoly = fmadd(cosPoly, z, W{-1.38888888888730564116e-3});
+    cosPoly = fmadd(cosPoly, z, W{4.16666666666665929218e-2});
+    const W cosR{fmadd(z * z, cosPoly, W{1.0} - W{0.5} * z)};
+    
+    // Quadrant k mod 4 picks the polynomial and the signs
+    const W quadrant{k - W{4.0} * W{V::floor((k * W{0.25}).r)}};
+    const auto q1{V::cmpEq(quadrant.r, V::set1(1.0))};
+    const auto q2{V::cmpEq(quadrant.r, V::set1(2.0))};
+    const auto q3{V::cmpEq(quadrant.r, V::set1(3.0))};
+    const auto swap{V::maskOr(q1, q3)};
+    const auto sinNegative{V::cmpGe(quadrant.r, V::set1(2.0))};
+    const auto cosNegative{V::maskOr(q1, q2)};
+    
+    const W s{select<V>(swap, cosR, sinR)};
+    const W c{select<V>(swap, sinR, cosR)};
+    sinOut = select<V>(sinNegative, -s, s);
+    cosOut = select<V>(cosNegative, -c, c);
+}
+
+/**
+ * Fleet step over whole vectors, mirroring stepFleetScalar term by term;
+ * the remainder that doesn't fill a vector goes through the scalar kernel.
+ * Wind is a template flag so the still-air loop carries no trace of it;
+ * each variant stays out of line, or their hoisted constants would share
+ * one register budget and spill.
+ */
+template <typename V, bool kWind>
+[[gnu::noinline]] std::size_t stepFleetVectors(const FleetKernelArgs& a, std::size_t begin, std::size_t end) {
+    using W = Vec<V>;
+    
+    const W dt{a.dt};
+    const W halfRho{a.halfRho};
+    const W gravity{a.gravity};
+    const W zero{0.0};
+    const W minAirspeed{0.1};
+    const W aileronGain{2.0};
+    const W elevatorGain{1.5};
+    const W rudderGain{1.0};
+    
+    std::size_t i{begin};
+    for (; i + V::width <= end; i += V::width) {
+        W sphi, cphi, stheta, ctheta, spsi, cpsi;
+        sincos<V>(W::load(a.roll + i), sphi, cphi);
+        sincos<V>(W::load(a.pitch + i), stheta, ctheta);
+        sincos<V>(W::load(a.yaw + i), spsi, cpsi);
+        
+        W u{W::load(a.velU + i)};
+        W v{W::load(a.velV + i)};
+        W w{W::load(a.velW + i)};
+        const W mass{W::load(a.mass + i)};
+        const W weight{mass * gravity};
+        
+        // Forces in body frame: thrust along x, gravity rotated from NED
+        W fx{W::load(a.throttle + i) * W::load(a.thrustMax + i) - weight * stheta};
+        W fy{weight * ctheta * sphi};
+        W fz{weight * ctheta * cphi};
+        
+        // Velocity through the air, the same as the body velocity in still air
+        W airU{u};
+        W airV{v};
+        W airW{w};
+        if (kWind) {
+            airU = u - W::load(a.windU + i);
+            airV = v - W::load(a.windV + i);
+            airW = w - W::load(a.windW + i);
+        }
+        
+        // Lift and drag, masked off below the minimum airspeed
+        const W speedSquared{fmadd(airU, airU, fmadd(airV, airV, airW * airW))};
+        const W airspeed{sqrt(speedSquared)};
+        const auto flying{V::cmpGe(airspeed.r, minAirspeed.r)};
+        const W safeAirspeed{select<V>(flying, airspeed, W{1.0})};
+        const W dynamicPressureArea{select<V>(flying, halfRho * speedSquared * W::load(a.wingArea + i), zero)};
+        const W drag{dynamicPressureArea * W::load(a.dragCoefficient + i) / safeAirspeed};
+        fx = fx - drag * airU;
+        fy = fy - drag * airV;
+        fz = fz - (drag * airW + dynamicPressureArea * W::load(a.liftCoefficient + i));
+        
+        // a = F/m, integrate velocity
+        const W dtOverMass{dt / mass};
+        u = fmadd(fx, dtOverMass, u);
+        v = fmadd(fy, dtOverMass, v);
+        w = fmadd(fz, dtOverMass, w);
+        
+        // Control surface moments and angular acceleration α = I⁻¹ * M
+        const W p{fmadd(W::load(a.aileron + i) * aileronGain * W::load(a.wingspan + i), W::load(a.invIxx + i) * dt,
+                        W::load(a.rateP + i))};
+        const W q{fmadd(W::load(a.elevator + i) * elevatorGain + W::load(a.pitchMoment + i), W::load(a.invIyy + i) * dt,
+                        W::load(a.rateQ + i))};
+        const W r{fmadd(W::load(a.rudder + i) * rudderGain, W::load(a.invIzz + i) * dt, W::load(a.rateR + i))};
+        
+        // Position update with body velocity rotated to NED
+        const W stsphi{stheta * sphi};
+        const W stcphi{stheta * cphi};
+        const W velN{cpsi * ctheta * u + (cpsi * stsphi - spsi * cphi) * v + (cpsi * stcphi + spsi * sphi) * w};
+        const W velE{spsi * ctheta * u + (spsi * stsphi + cpsi * cphi) * v + (spsi * stcphi - cpsi * sphi) * w};
+        const W velD{ctheta * sphi * v + ctheta * cphi * w - stheta * u};
+        fmadd(velN, dt, W::load(a.posN + i)).store(a.posN + i);
+        fmadd(velE, dt, W::load(a.posE + i)).store(a.posE + i);
+        fmadd(velD, dt, W::load(a.posD + i)).store(a.posD + i);
+        
+        // Body rates to Euler rates
+        const W yawTerm{sphi * q + cphi * r};
+        fmadd(p + yawTerm * stheta / ctheta, dt, W::load(a.roll + i)).store(a.roll + i);
+        fmadd(cphi * q - sphi * r, dt, W::load(a.pitch + i)).store(a.pitch + i);
+        fmadd(yawTerm / ctheta, dt, W::load(a.yaw + i)).store(a.yaw + i);
+        
+        u.store(a.velU + i);
+        v.store(a.velV + i);
+        w.store(a.velW + i);
+        p.store(a.rateP + i);
+        q.store(a.rateQ + i);
+        r.store(a.rateR + i);
+    }
+    return i;
+}
+
+template <typename V>
+void stepFleet(const FleetKernelArgs& a, std::size_t begin, std::size_t end) {
+    const std::size_t i{a.windU ? stepFleetVectors<V, true>(a, begin, end) : stepFleetVectors<V, false>(a, begin, end)};
+    stepFleetScalar(a, i, end);
+}
+
+} // namespace simd_detail
+} // namespace falconsim
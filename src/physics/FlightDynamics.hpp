@@ -1,7 +1,15 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
+
+#include "AeroTable.hpp"
+#include "Airframe.hpp"
+#include "Turbulence.hpp"
+#include "WindField.hpp"
 
 namespace falconsim {
 
@@ -10,7 +18,8 @@ namespace falconsim {
  */
 struct UAVPhysicalProperties {
     double mass{1.0};                      // Mass in kg
-    Eigen::Vector3d inertia{1.0, 1.0, 1.0}; // Moment of inertia (Ixx, Iyy, Izz) in kg*m^2
+    Eigen::Vector3d inertia{SmallUavAirframe::inertia[0], SmallUavAirframe::inertia[1],
+                            SmallUavAirframe::inertia[2]}; // Moment of inertia (Ixx, Iyy, Izz) in kg*m^2
     Eigen::Vector3d dimensions{1.0, 1.0, 0.2}; // Length, wingspan, height in meters
     double thrust_max{20.0};              // Maximum thrust in Newtons
 };
@@ -40,18 +49,113 @@ struct AircraftState {
 };
 
 /**
- * @brief 6-DOF flight dynamics model for UAV simulation
+ * @brief Attitude representation and integration scheme used by FlightDynamics::update()
+ *
+ * EulerAngles is the original first-order scheme that integrates Euler angle
+ * rates directly; it is singular at ±90° pitch. The quaternion schemes carry
+ * attitude as a unit quaternion and report Euler angles as a derived output,
+ * wrapped to (-π, π] for roll and yaw and [-π/2, π/2] for pitch.
+ */
+enum class IntegrationMethod {
+    EulerAngles,        // Explicit Euler on Euler angles (legacy default)
+    SemiImplicitEuler,  // Rates first, then position/attitude with the new rates (quaternion)
+    RK4                 // Classical fourth-order Runge-Kutta on the full rigid-body state (quaternion)
+};
+
+/**
+ * @brief Complete FlightDynamics state as plain data
+ *
+ * Everything update() reads is captured as raw doubles, including cached
+ * rotation matrices and the inverse inertia, so restoring a snapshot and
+ * stepping reproduces the original trajectory bit for bit. The struct is
+ * trivially copyable: snapshots can be memcpy'd, stored in arrays or
+ * written to disk (same build only; see kVersion).
+ *
+ * Aero tables and wind fields are shared, not captured: restore() keeps
+ * the ones the target already has, and fork() hands the copy the same ones.
+ * Turbulence is captured in full (its noise depends only on seed and step).
+ * A compile-time airframe writes its constants and ignores them on restore.
+ */
+struct DynamicsSnapshot {
+    static constexpr std::uint32_t kVersion{2};
+    
+    std::uint32_t version{kVersion};
+    std::uint32_t integration_method{0};
+    
+    // AircraftState
+    double position[3]{};
+    double velocity[3]{};
+    double euler_angles[3]{};
+    double angular_velocity[3]{};
+    double mass{1.0};
+    
+    // ControlInputs
+    double throttle{0.0};
+    double aileron{0.0};
+    double elevator{0.0};
+    double rudder{0.0};
+    
+    // UAVPhysicalProperties as last applied
+    double properties_mass{1.0};
+    double properties_inertia[3]{};
+    double properties_dimensions[3]{};
+    double properties_thrust_max{0.0};
+    
+    // Integrator and cached kinematics
+    double attitude[4]{0.0, 0.0, 0.0, 1.0};  // Quaternion (x, y, z, w)
+    double rotation_body_to_ned[9]{};        // Column-major
+    double rotation_ned_to_body[9]{};
+    double inertia_tensor[9]{};
+    double inverse_inertia_tensor[9]{};
+    
+    // Aerodynamic parameters and environment
+    double wing_area{0.0};
+    double wingspan{0.0};
+    double lift_coefficient{0.0};
+    double drag_coefficient{0.0};
+    double thrust_max{0.0};
+    double air_density{0.0};
+    double gravity{0.0};
+    
+    // Wind and turbulence
+    double wind[3]{};
+    double environment_time{0.0};
+    double turbulence_wind_speed_20ft{0.0};
+    std::uint64_t turbulence_seed{0};
+    std::uint64_t turbulence_step{0};
+    double gust[3]{};
+};
+static_assert(std::is_trivially_copyable<DynamicsSnapshot>::value, "DynamicsSnapshot must stay plain data");
+
+/**
+ * @brief 6-DOF flight dynamics model for UAV simulation, for one airframe policy
+ *
+ * Airframe supplies wing area, wingspan, maximum thrust, the control moment
+ * gains, the initial mass and the inertia. With RuntimeAirframe (the
+ * FlightDynamics alias) they are ordinary values that can be retuned at
+ * any time. With a struct of static constexpr constants such as those in
+ * Airframe.hpp they are compile-time constants: the compiler folds them
+ * into the step, the principal inertia is inverted at compile time, and a
+ * control surface with zero gain is dropped from the moment sum. Either
+ * way the force, moment and integration model is the same.
+ *
+ * The runtime airframe and the built-in airframes are instantiated once in
+ * FlightDynamics.cpp; see FlightDynamicsImpl.hpp to add another.
  */
-class FlightDynamics {
+template <typename Airframe>
+class FlightDynamicsT {
 public:
-    FlightDynamics();
-    ~FlightDynamics() = default;
+    // Whether the airframe constants can be changed at runtime
+    static constexpr bool kTunable{std::is_same<Airframe, RuntimeAirframe>::value};
+    
+    FlightDynamicsT();
+    ~FlightDynamicsT() = default;
     
     // Disable copy and move for now
-    FlightDynamics(const FlightDynamics&) = delete;
-    FlightDynamics& operator=(const FlightDynamics&) = delete;
-    FlightDynamics(FlightDynamics&&) = delete;
-    FlightDynamics& operator=(FlightDynamics&&) = delete;
+    FlightDynamicsT(const FlightDynamicsT&) = delete;
+    FlightDynamicsT& operator=(const FlightDynamicsT&) = delete;
+    FlightDynamicsT(FlightDynamicsT&&) = delete;
+    FlightDynamicsT& operator=(FlightDynamicsT&&) = delete;
     
     // State access and manipulation
     [[nodiscard]] AircraftState getState() const;
@@ -61,66 +165,204 @@ public:
     void setControls(const ControlInputs& controls);
     [[nodiscard]] ControlInputs getControls() const;
     
-    // Physical properties
+    // Physical properties (applies mass, principal inertia and maximum thrust; runtime airframe only)
+    template <typename A = Airframe, typename = std::enable_if_t<std::is_same<A, RuntimeAirframe>::value>>
     void setProperties(const UAVPhysicalProperties& properties);
     [[nodiscard]] const UAVPhysicalProperties& getProperties() const;
+    [[nodiscard]] const Airframe& getAirframe() const;
     
     // Environment
     void setAirDensity(double density);
+    
+    // Steady wind: velocity of the air over the ground in NED (m/s)
     void setWind(const Eigen::Vector3d& wind);
+    [[nodiscard]] Eigen::Vector3d getWind() const;
+    
+    // Gridded wind added to the steady wind, sampled at the aircraft every step; nullptr removes it.
+    // One field may be shared by any number of aircraft
+    void setWindField(std::shared_ptr<const WindField> field);
+    [[nodiscard]] const std::shared_ptr<const WindField>& getWindField() const;
+    
+    // Dryden turbulence on top of the mean wind
+    void setTurbulence(const TurbulenceParameters& parameters);
+    [[nodiscard]] const TurbulenceParameters& getTurbulence() const;
+    [[nodiscard]] Eigen::Vector3d getGust() const; // Gust of the latest step (body frame, m/s)
+    
+    // Time the wind field is sampled at, advanced by update() while any wind is set (s)
+    void setEnvironmentTime(double time);
+    [[nodiscard]] double getEnvironmentTime() const;
     
     // Physics update
     void update(double dt);
     
-    // Aircraft parameters
+    // Integration scheme (switching keeps the current attitude)
+    void setIntegrationMethod(IntegrationMethod method);
+    [[nodiscard]] IntegrationMethod getIntegrationMethod() const;
+    
+    // Body-to-NED attitude quaternion
+    [[nodiscard]] Eigen::Quaterniond getAttitude() const;
+    
+    // Bit-exact state capture for what-if branching (restore throws std::invalid_argument on a version mismatch)
+    [[nodiscard]] DynamicsSnapshot snapshot() const;
+    void restore(const DynamicsSnapshot& snapshot);
+    [[nodiscard]] std::unique_ptr<FlightDynamicsT> fork() const;
+    
+    // Aircraft parameters (the wing area only with the runtime airframe)
     void setMass(double mass);
+    template <typename A = Airframe, typename = std::enable_if_t<std::is_same<A, RuntimeAirframe>::value>>
     void setWingspanArea(double area);
     void setLiftCoefficient(double cl);
     void setDragCoefficient(double cd);
     
+    // Tabulated CL/CD/Cm replacing the constant coefficients; nullptr restores them.
+    // One table may be shared by any number of aircraft
+    void setAeroTable(std::shared_ptr<const AeroTable> table);
+    [[nodiscard]] const std::shared_ptr<const AeroTable>& getAeroTable() const;
+
 private:
+    /**
+     * @brief Per-step quantities shared by every force, moment and integration term
+     *
+     * Computed once at the start of update() so airspeed, the velocity
+     * direction and the attitude trig terms are each evaluated exactly once.
+     */
+    struct KinematicContext {
+        double airspeed{0.0};                          // |v| (m/s)
+        Eigen::Vector3d velocityUnit{0, 0, 0};         // v / |v|, zero below the lift threshold
+        double dynamicPressureArea{0.0};               // 0.5 * ρ * v² * S (N per unit coefficient)
+        AeroCoefficients coefficients{};               // CL, CD and Cm for this air data
+        double sinRoll{0.0}, cosRoll{1.0};
+        double sinPitch{0.0}, cosPitch{1.0}, tanPitch{0.0};
+        double sinYaw{0.0}, cosYaw{1.0};
+    };
+    
+    /**
+     * @brief Rigid-body state integrated by the quaternion schemes
+     */
+    struct RigidBodyState {
+        Eigen::Vector3d position{0, 0, 0};          // NED (m)
+        Eigen::Vector3d velocity{0, 0, 0};          // Body frame (m/s)
+        Eigen::Quaterniond attitude{Eigen::Quaterniond::Identity()}; // Body to NED
+        Eigen::Vector3d angularVelocity{0, 0, 0};   // Body rates (rad/s)
+    };
+    
+    /**
+     * @brief Time derivative of a RigidBodyState
+     */
+    struct RigidBodyRates {
+        Eigen::Vector3d position{0, 0, 0};
+        Eigen::Vector3d velocity{0, 0, 0};
+        Eigen::Vector4d attitude{0, 0, 0, 0};       // Quaternion coefficients (x, y, z, w)
+        Eigen::Vector3d angularVelocity{0, 0, 0};
+    };
+    
+    // Shared kinematic terms for this step
+    [[nodiscard]] KinematicContext computeKinematics() const;
+    void computeAirData(const Eigen::Vector3d& velocity, KinematicContext& kinematics) const;
+    
+    // Mean wind and gust for the step about to be taken, and the air-relative body velocity they give
+    [[nodiscard]] bool hasWind() const;
+    void updateWind(const Eigen::Matrix3d& nedToBody, double dt);
+    [[nodiscard]] Eigen::Vector3d airVelocity(const Eigen::Vector3d& velocity, const Eigen::Matrix3d& nedToBody) const;
+    
+    // Total body-frame force and moment for a given air data and attitude
+    [[nodiscard]] Eigen::Vector3d bodyForce(const KinematicContext& kinematics,
+                                            const Eigen::Matrix3d& nedToBody) const;
+    [[nodiscard]] Eigen::Vector3d bodyMoment(const KinematicContext& kinematics) const;
+    
+    // Quaternion integration schemes
+    void integrateSemiImplicit(double dt);
+    void integrateRK4(double dt);
+    [[nodiscard]] RigidBodyRates computeRates(const RigidBodyState& body) const;
+    [[nodiscard]] RigidBodyState rigidBodyState() const;
+    void applyRigidBodyState(const RigidBodyState& body);
+    
     // Forces and moments calculation
-    void updateForces(double dt);
-    void updateMoments(double dt);
+    void updateForces(const KinematicContext& kinematics, double dt);
+    void updateMoments(const KinematicContext& kinematics, double dt);
     
     // Individual force calculations
-    [[nodiscard]] Eigen::Vector3d calculateLift() const;
-    [[nodiscard]] Eigen::Vector3d calculateDrag() const;
+    [[nodiscard]] Eigen::Vector3d calculateLift(const KinematicContext& kinematics) const;
+    [[nodiscard]] Eigen::Vector3d calculateDrag(const KinematicContext& kinematics) const;
     [[nodiscard]] Eigen::Vector3d calculateThrust() const;
-    [[nodiscard]] Eigen::Vector3d calculateGravity() const;
+    [[nodiscard]] Eigen::Vector3d calculateGravity(const Eigen::Matrix3d& nedToBody) const;
     
     // Individual moment calculations
     [[nodiscard]] Eigen::Vector3d calculateAileronMoment() const;
     [[nodiscard]] Eigen::Vector3d calculateElevatorMoment() const;
     [[nodiscard]] Eigen::Vector3d calculateRudderMoment() const;
+    [[nodiscard]] Eigen::Vector3d calculateAeroMoment(const KinematicContext& kinematics) const;
+    
+    // α = I⁻¹ M
+    [[nodiscard]] Eigen::Vector3d angularAcceleration(const Eigen::Vector3d& moment) const;
     
     // Integrate state
-    void integrateState(double dt);
+    void integrateState(const KinematicContext& kinematics, double dt);
     
-    // Update rotation matrices
-    void updateRotationMatrices();
+    // Update rotation matrices from the step's trig terms
+    void updateRotationMatrices(const KinematicContext& kinematics);
     
     AircraftState m_state{};
     ControlInputs m_controls{};
     UAVPhysicalProperties m_properties{};
     
+    // Attitude integration (m_attitude is authoritative for the quaternion schemes)
+    IntegrationMethod m_integrationMethod{IntegrationMethod::EulerAngles};
+    Eigen::Quaterniond m_attitude{Eigen::Quaterniond::Identity()};
+    
     // Cached rotation matrices
     Eigen::Matrix3d m_rotationBodyToNED{Eigen::Matrix3d::Identity()};
     Eigen::Matrix3d m_rotationNEDToBody{Eigen::Matrix3d::Identity()};
     
-    // Aircraft parameters (defaults are for a small UAV)
-    double m_wingArea{0.5};         // Wing area (m²)
-    double m_wingspan{1.5};         // Wingspan (m)
+    // Airframe constants (geometry, thrust, moment gains and inertia) and aerodynamic coefficients
+    Airframe m_airframe{};
     double m_liftCoefficient{1.2};  // Basic lift coefficient
     double m_dragCoefficient{0.1};  // Basic drag coefficient
-    double m_thrust_max{20.0};      // Maximum thrust (N)
+    std::shared_ptr<const AeroTable> m_aeroTable{}; // Optional tabulated coefficients
     
     // Environment
     double m_airDensity{1.225};     // Air density at sea level (kg/m³)
+    double m_speedOfSound{340.29};  // Speed of sound at sea level (m/s), for the table's Mach axis
     double m_gravity{9.81};         // Gravity acceleration (m/s²)
     
-    // Inertia tensor (3x3 matrix representing moments of inertia)
-    Eigen::Matrix3d m_inertiaTensor{Eigen::Matrix3d::Identity()};
+    // Wind
+    Eigen::Vector3d m_wind{0, 0, 0};                 // Steady wind (NED, m/s)
+    std::shared_ptr<const WindField> m_windField{};  // Optional gridded wind
+    TurbulenceParameters m_turbulence{};
+    DrydenTurbulence m_dryden{};
+    double m_environmentTime{0.0};                   // Wind field sample time (s)
+    Eigen::Vector3d m_stepWind{0, 0, 0};             // Mean wind at the aircraft for this step (NED, m/s)
 };
 
+template <typename Airframe>
+template <typename A, typename>
+void FlightDynamicsT<Airframe>::setProperties(const UAVPhysicalProperties& properties) {
+    m_properties = properties;
+    
+    setMass(properties.mass);
+    m_airframe.thrust_max = std::max(0.0, properties.thrust_max);
+    m_airframe.inertia = properties.inertia.asDiagonal();
+    m_airframe.inverse_inertia = m_airframe.inertia.inverse();
+}
+
+template <typename Airframe>
+template <typename A, typename>
+void FlightDynamicsT<Airframe>::setWingspanArea(double area) {
+    m_airframe.wing_area = std::max(0.01, area); // Minimum area of 0.01m²
+}
+
+// The runtime-parameterized model, for ad-hoc tuning
+using FlightDynamics = FlightDynamicsT<RuntimeAirframe>;
+
+// The fleet's airframe types, fixed at compile time
+using SmallUavDynamics = FlightDynamicsT<SmallUavAirframe>;
+using SurveyWingDynamics = FlightDynamicsT<SurveyWingAirframe>;
+using InterceptorDynamics = FlightDynamicsT<InterceptorAirframe>;
+
+// Instantiated in FlightDynamics.cpp
+extern template class FlightDynamicsT<RuntimeAirframe>;
+extern template class FlightDynamicsT<SmallUavAirframe>;
+extern template class FlightDynamicsT<SurveyWingAirframe>;
+extern template class FlightDynamicsT<InterceptorAirframe>;
+
 } // namespace falconsim 
\ No newline at end of file
@@ -0,0 +1,709 @@
+#pragma once
+
+// Member definitions of FlightDynamicsT. FlightDynamics.cpp includes this to
+// instantiate the runtime airframe and the airframes of Airframe.hpp; include
+// it in one translation unit of your own to instantiate another airframe:
+//
+//     #include "physics/FlightDynamicsImpl.hpp"
+//     template class falconsim::FlightDynamicsT<MyAirframe>;
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "../core/Trace.hpp"
+#include "FlightDynamics.hpp"
+
+namespace falconsim {
+namespace flight_detail {
+
+// ZYX (yaw, pitch, roll) Euler angles to a body-to-NED quaternion
+inline Eigen::Quaterniond quaternionFromEuler(const Eigen::Vector3d& euler) {
+    return Eigen::Quaterniond{Eigen::AngleAxisd{euler.z(), Eigen::Vector3d::UnitZ()} *
+                              Eigen::AngleAxisd{euler.y(), Eigen::Vector3d::UnitY()} *
+                              Eigen::AngleAxisd{euler.x(), Eigen::Vector3d::UnitX()}};
+}
+
+// Body-to-NED quaternion to ZYX Euler angles (roll, pitch, yaw)
+inline Eigen::Vector3d eulerFromQuaternion(const Eigen::Quaterniond& q) {
+    const double sinPitch{std::max(-1.0, std::min(2.0 * (q.w() * q.y() - q.z() * q.x()), 1.0))};
+    return Eigen::Vector3d{
+        std::atan2(2.0 * (q.w() * q.x() + q.y() * q.z()), 1.0 - 2.0 * (q.x() * q.x() + q.y() * q.y())),
+        std::asin(sinPitch),
+        std::atan2(2.0 * (q.w() * q.z() + q.x() * q.y()), 1.0 - 2.0 * (q.y() * q.y() + q.z() * q.z()))};
+}
+
+// q̇ = ½ q ⊗ (0, ω) with ω in the body frame, as (x, y, z, w) coefficients
+inline Eigen::Vector4d quaternionRate(const Eigen::Quaterniond& q, const Eigen::Vector3d& omega) {
+    const Eigen::Quaterniond rate{q * Eigen::Quaterniond{0.0, omega.x(), omega.y(), omega.z()}};
+    return 0.5 * rate.coeffs();
+}
+
+} // namespace flight_detail
+
+template <typename Airframe>
+FlightDynamicsT<Airframe>::FlightDynamicsT() {
+    m_state.mass = Airframe::mass;
+    
+    // A compile-time airframe reports its constants as the properties last applied
+    if constexpr (!kTunable) {
+        m_properties.mass = Airframe::mass;
+        m_properties.inertia = Eigen::Vector3d{Airframe::inertia[0], Airframe::inertia[1], Airframe::inertia[2]};
+        m_properties.dimensions.y() = Airframe::wingspan;
+        m_properties.thrust_max = Airframe::thrust_max;
+    }
+}
+
+template <typename Airframe>
+AircraftState FlightDynamicsT<Airframe>::getState() const {
+    return m_state;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setState(const AircraftState& state) {
+    m_state = state;
+    m_attitude = flight_detail::quaternionFromEuler(state.euler_angles);
+    
+    if (m_integrationMethod != IntegrationMethod::EulerAngles) {
+        m_state.euler_angles = flight_detail::eulerFromQuaternion(m_attitude);
+    }
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setControls(const ControlInputs& controls) {
+    // Clamp control inputs to valid ranges
+    m_controls.throttle = std::max(0.0, std::min(controls.throttle, 1.0));
+    m_controls.aileron = std::max(-1.0, std::min(controls.aileron, 1.0));
+    m_controls.elevator = std::max(-1.0, std::min(controls.elevator, 1.0));
+    m_controls.rudder = std::max(-1.0, std::min(controls.rudder, 1.0));
+}
+
+template <typename Airframe>
+ControlInputs FlightDynamicsT<Airframe>::getControls() const {
+    return m_controls;
+}
+
+template <typename Airframe>
+const UAVPhysicalProperties& FlightDynamicsT<Airframe>::getProperties() const {
+    return m_properties;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setAirDensity(double density) {
+    m_airDensity = std::max(0.01, density); // Ensure positive air density
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setWind(const Eigen::Vector3d& wind) {
+    m_wind = wind;
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::getWind() const {
+    return m_wind;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setWindField(std::shared_ptr<const WindField> field) {
+    m_windField = std::move(field);
+}
+
+template <typename Airframe>
+const std::shared_ptr<const WindField>& FlightDynamicsT<Airframe>::getWindField() const {
+    return m_windField;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setTurbulence(const TurbulenceParameters& parameters) {
+    m_turbulence = parameters;
+    m_turbulence.wind_speed_20ft = std::max(0.0, parameters.wind_speed_20ft);
+}
+
+template <typename Airframe>
+const TurbulenceParameters& FlightDynamicsT<Airframe>::getTurbulence() const {
+    return m_turbulence;
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::getGust() const {
+    if (m_turbulence.wind_speed_20ft <= 0.0) {
+        return Eigen::Vector3d::Zero();
+    }
+    return Eigen::Map<const Eigen::Vector3d>{m_dryden.getGust()};
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setEnvironmentTime(double time) {
+    m_environmentTime = time;
+}
+
+template <typename Airframe>
+double FlightDynamicsT<Airframe>::getEnvironmentTime() const {
+    return m_environmentTime;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::update(double dt) {
+    FALCONSIM_TRACE_ZONE("FlightDynamics::update");
+    switch (m_integrationMethod) {
+        case IntegrationMethod::SemiImplicitEuler:
+            integrateSemiImplicit(dt);
+            return;
+        case IntegrationMethod::RK4:
+            integrateRK4(dt);
+            return;
+        case IntegrationMethod::EulerAngles:
+            break;
+    }
+    
+    // Attitude trig terms, computed once for the whole step
+    KinematicContext kinematics{computeKinematics()};
+    
+    // Update rotation matrices based on current orientation, so gravity and
+    // position integration both see the attitude at the start of this step
+    updateRotationMatrices(kinematics);
+    
+    // Airspeed, relative to the wind at the aircraft
+    updateWind(m_rotationNEDToBody, dt);
+    computeAirData(airVelocity(m_state.velocity, m_rotationNEDToBody), kinematics);
+    
+    // Calculate all forces and moments
+    updateForces(kinematics, dt);
+    updateMoments(kinematics, dt);
+    
+    // Integrate state forward in time
+    integrateState(kinematics, dt);
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setIntegrationMethod(IntegrationMethod method) {
+    if (method == m_integrationMethod) {
+        return;
+    }
+    
+    // The outgoing scheme owns the attitude; hand it over to the incoming one
+    if (m_integrationMethod == IntegrationMethod::EulerAngles) {
+        m_attitude = flight_detail::quaternionFromEuler(m_state.euler_angles);
+    }
+    m_integrationMethod = method;
+    if (method != IntegrationMethod::EulerAngles) {
+        m_state.euler_angles = flight_detail::eulerFromQuaternion(m_attitude);
+    }
+}
+
+template <typename Airframe>
+IntegrationMethod FlightDynamicsT<Airframe>::getIntegrationMethod() const {
+    return m_integrationMethod;
+}
+
+template <typename Airframe>
+Eigen::Quaterniond FlightDynamicsT<Airframe>::getAttitude() const {
+    if (m_integrationMethod == IntegrationMethod::EulerAngles) {
+        return flight_detail::quaternionFromEuler(m_state.euler_angles);
+    }
+    return m_attitude;
+}
+
+template <typename Airframe>
+DynamicsSnapshot FlightDynamicsT<Airframe>::snapshot() const {
+    DynamicsSnapshot snapshot;
+    snapshot.integration_method = static_cast<std::uint32_t>(m_integrationMethod);
+    
+    Eigen::Map<Eigen::Vector3d>{snapshot.position} = m_state.position;
+    Eigen::Map<Eigen::Vector3d>{snapshot.velocity} = m_state.velocity;
+    Eigen::Map<Eigen::Vector3d>{snapshot.euler_angles} = m_state.euler_angles;
+    Eigen::Map<Eigen::Vector3d>{snapshot.angular_velocity} = m_state.angular_velocity;
+    snapshot.mass = m_state.mass;
+    
+    snapshot.throttle = m_controls.throttle;
+    snapshot.aileron = m_controls.aileron;
+    snapshot.elevator = m_controls.elevator;
+    snapshot.rudder = m_controls.rudder;
+    
+    snapshot.properties_mass = m_properties.mass;
+    Eigen::Map<Eigen::Vector3d>{snapshot.properties_inertia} = m_properties.inertia;
+    Eigen::Map<Eigen::Vector3d>{snapshot.properties_dimensions} = m_properties.dimensions;
+    snapshot.properties_thrust_max = m_properties.thrust_max;
+    
+    Eigen::Map<Eigen::Vector4d>{snapshot.attitude} = m_attitude.coeffs();
+    Eigen::Map<Eigen::Matrix3d>{snapshot.rotation_body_to_ned} = m_rotationBodyToNED;
+    Eigen::Map<Eigen::Matrix3d>{snapshot.rotation_ned_to_body} = m_rotationNEDToBody;
+    if constexpr (kTunable) {
+        Eigen::Map<Eigen::Matrix3d>{snapshot.inertia_tensor} = m_airframe.inertia;
+        Eigen::Map<Eigen::Matrix3d>{snapshot.inverse_inertia_tensor} = m_airframe.inverse_inertia;
+    } else {
+        for (int axis = 0; axis < 3; ++axis) {
+            snapshot.inertia_tensor[axis * 4] = Airframe::inertia[axis];
+            snapshot.inverse_inertia_tensor[axis * 4] = 1.0 / Airframe::inertia[axis];
+        }
+    }
+    
+    snapshot.wing_area = m_airframe.wing_area;
+    snapshot.wingspan = m_airframe.wingspan;
+    snapshot.lift_coefficient = m_liftCoefficient;
+    snapshot.drag_coefficient = m_dragCoefficient;
+    snapshot.thrust_max = m_airframe.thrust_max;
+    snapshot.air_density = m_airDensity;
+    snapshot.gravity = m_gravity;
+    
+    Eigen::Map<Eigen::Vector3d>{snapshot.wind} = m_wind;
+    snapshot.environment_time = m_environmentTime;
+    snapshot.turbulence_wind_speed_20ft = m_turbulence.wind_speed_20ft;
+    snapshot.turbulence_seed = m_turbulence.seed;
+    snapshot.turbulence_step = m_dryden.getStep();
+    std::copy(m_dryden.getGust(), m_dryden.getGust() + 3, snapshot.gust);
+    return snapshot;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::restore(const DynamicsSnapshot& snapshot) {
+    if (snapshot.version != DynamicsSnapshot::kVersion ||
+        snapshot.integration_method > static_cast<std::uint32_t>(IntegrationMethod::RK4)) {
+        throw std::invalid_argument{"Incompatible dynamics snapshot"};
+    }
+    
+    // Raw copies only: going through the setters would clamp or re-derive
+    // values and break bit-exact replay
+    m_integrationMethod = static_cast<IntegrationMethod>(snapshot.integration_method);
+    
+    m_state.position = Eigen::Map<const Eigen::Vector3d>{snapshot.position};
+    m_state.velocity = Eigen::Map<const Eigen::Vector3d>{snapshot.velocity};
+    m_state.euler_angles = Eigen::Map<const Eigen::Vector3d>{snapshot.euler_angles};
+    m_state.angular_velocity = Eigen::Map<const Eigen::Vector3d>{snapshot.angular_velocity};
+    m_state.mass = snapshot.mass;
+    
+    m_controls.throttle = snapshot.throttle;
+    m_controls.aileron = snapshot.aileron;
+    m_controls.elevator = snapshot.elevator;
+    m_controls.rudder = snapshot.rudder;
+    
+    m_properties.mass = snapshot.properties_mass;
+    m_properties.inertia = Eigen::Map<const Eigen::Vector3d>{snapshot.properties_inertia};
+    m_properties.dimensions = Eigen::Map<const Eigen::Vector3d>{snapshot.properties_dimensions};
+    m_properties.thrust_max = snapshot.properties_thrust_max;
+    
+    m_attitude.coeffs() = Eigen::Map<const Eigen::Vector4d>{snapshot.attitude};
+    m_rotationBodyToNED = Eigen::Map<const Eigen::Matrix3d>{snapshot.rotation_body_to_ned};
+    m_rotationNEDToBody = Eigen::Map<const Eigen::Matrix3d>{snapshot.rotation_ned_to_body};
+    
+    // A compile-time airframe keeps its own constants
+    if constexpr (kTunable) {
+        m_airframe.inertia = Eigen::Map<const Eigen::Matrix3d>{snapshot.inertia_tensor};
+        m_airframe.inverse_inertia = Eigen::Map<const Eigen::Matrix3d>{snapshot.inverse_inertia_tensor};
+        m_airframe.wing_area = snapshot.wing_area;
+        m_airframe.wingspan = snapshot.wingspan;
+        m_airframe.thrust_max = snapshot.thrust_max;
+    }
+    m_liftCoefficient = snapshot.lift_coefficient;
+    m_dragCoefficient = snapshot.drag_coefficient;
+    m_airDensity = snapshot.air_density;
+    m_gravity = snapshot.gravity;
+    
+    m_wind = Eigen::Map<const Eigen::Vector3d>{snapshot.wind};
+    m_environmentTime = snapshot.environment_time;
+    m_turbulence.wind_speed_20ft = snapshot.turbulence_wind_speed_20ft;
+    m_turbulence.seed = snapshot.turbulence_seed;
+    m_dryden.setState(snapshot.gust, snapshot.turbulence_step);
+}
+
+template <typename Airframe>
+std::unique_ptr<FlightDynamicsT<Airframe>> FlightDynamicsT<Airframe>::fork() const {
+    auto copy = std::make_unique<FlightDynamicsT>();
+    copy->restore(snapshot());
+    copy->m_aeroTable = m_aeroTable;
+    copy->m_windField = m_windField;
+    return copy;
+}
+
+template <typename Airframe>
+const Airframe& FlightDynamicsT<Airframe>::getAirframe() const {
+    return m_airframe;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setMass(double mass) {
+    m_state.mass = std::max(0.1, mass); // Minimum mass of 0.1kg
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setLiftCoefficient(double cl) {
+    m_liftCoefficient = cl;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setDragCoefficient(double cd) {
+    m_dragCoefficient = std::max(0.0, cd);
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::setAeroTable(std::shared_ptr<const AeroTable> table) {
+    m_aeroTable = std::move(table);
+}
+
+template <typename Airframe>
+const std::shared_ptr<const AeroTable>& FlightDynamicsT<Airframe>::getAeroTable() const {
+    return m_aeroTable;
+}
+
+template <typename Airframe>
+typename FlightDynamicsT<Airframe>::KinematicContext FlightDynamicsT<Airframe>::computeKinematics() const {
+    KinematicContext kinematics;
+    
+    // Six trig calls per step; tan and sec are derived from them
+    kinematics.sinRoll = std::sin(m_state.euler_angles.x());
+    kinematics.cosRoll = std::cos(m_state.euler_angles.x());
+    kinematics.sinPitch = std::sin(m_state.euler_angles.y());
+    kinematics.cosPitch = std::cos(m_state.euler_angles.y());
+    kinematics.tanPitch = kinematics.sinPitch / kinematics.cosPitch;
+    kinematics.sinYaw = std::sin(m_state.euler_angles.z());
+    kinematics.cosYaw = std::cos(m_state.euler_angles.z());
+    
+    return kinematics;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::computeAirData(const Eigen::Vector3d& velocity,
+                                               KinematicContext& kinematics) const {
+    // Single square root for airspeed; the unit vector reuses it
+    kinematics.airspeed = velocity.norm();
+    if (kinematics.airspeed >= 0.1) {
+        kinematics.velocityUnit = velocity / kinematics.airspeed;
+        kinematics.dynamicPressureArea = 0.5 * m_airDensity * kinematics.airspeed * kinematics.airspeed *
+                                         m_airframe.wing_area;
+    } else {
+        kinematics.velocityUnit.setZero();
+        kinematics.dynamicPressureArea = 0.0;
+    }
+    
+    if (!m_aeroTable) {
+        kinematics.coefficients = AeroCoefficients{m_liftCoefficient, m_dragCoefficient, 0.0};
+        return;
+    }
+    
+    // Air data angles from the body velocity; at rest they are all zero
+    const double alpha{std::atan2(velocity.z(), velocity.x())};
+    const double beta{kinematics.airspeed > 0.0 ? std::asin(velocity.y() / kinematics.airspeed) : 0.0};
+    kinematics.coefficients = m_aeroTable->lookup(alpha, beta, kinematics.airspeed / m_speedOfSound,
+                                                  m_controls.elevator);
+}
+
+template <typename Airframe>
+bool FlightDynamicsT<Airframe>::hasWind() const {
+    return m_windField || m_turbulence.wind_speed_20ft > 0.0 || !m_wind.isZero();
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::updateWind(const Eigen::Matrix3d& nedToBody, double dt) {
+    if (!hasWind()) {
+        return;
+    }
+    FALCONSIM_TRACE_ZONE("FlightDynamics::wind");
+    const double time{m_environmentTime};
+    m_environmentTime += dt;
+    
+    // Mean wind, held for the whole step (RK4 stages included)
+    m_stepWind = m_wind;
+    if (m_windField) {
+        double sampled[3];
+        m_windField->sample(m_state.position.x(), m_state.position.y(), m_state.position.z(), time, sampled);
+        m_stepWind += Eigen::Map<const Eigen::Vector3d>{sampled};
+    }
+    
+    // The gust filter runs on the airspeed through the mean wind
+    if (m_turbulence.wind_speed_20ft > 0.0) {
+        const double airspeed{(m_state.velocity - nedToBody * m_stepWind).norm()};
+        m_dryden.advance(m_turbulence, m_state.altitude(), airspeed, dt);
+    }
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::airVelocity(const Eigen::Vector3d& velocity,
+                                                      const Eigen::Matrix3d& nedToBody) const {
+    // Still air leaves the body velocity untouched, bit for bit
+    if (!hasWind()) {
+        return velocity;
+    }
+    Eigen::Vector3d air{velocity - nedToBody * m_stepWind};
+    if (m_turbulence.wind_speed_20ft > 0.0) {
+        air -= Eigen::Map<const Eigen::Vector3d>{m_dryden.getGust()};
+    }
+    return air;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::updateRotationMatrices(const KinematicContext& kinematics) {
+    const double cphi{kinematics.cosRoll};
+    const double sphi{kinematics.sinRoll};
+    const double ctheta{kinematics.cosPitch};
+    const double stheta{kinematics.sinPitch};
+    const double cpsi{kinematics.cosYaw};
+    const double spsi{kinematics.sinYaw};
+    
+    // Create rotation matrix from body to NED
+    m_rotationBodyToNED << cpsi*ctheta, cpsi*stheta*sphi-spsi*cphi, cpsi*stheta*cphi+spsi*sphi,
+                           spsi*ctheta, spsi*stheta*sphi+cpsi*cphi, spsi*stheta*cphi-cpsi*sphi,
+                           -stheta, ctheta*sphi, ctheta*cphi;
+    
+    // Inverse rotation (transpose for orthogonal matrices)
+    m_rotationNEDToBody = m_rotationBodyToNED.transpose();
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::bodyForce(const KinematicContext& kinematics,
+                                                    const Eigen::Matrix3d& nedToBody) const {
+    FALCONSIM_TRACE_ZONE("FlightDynamics::forces");
+    // Calculate all forces in body frame
+    Eigen::Vector3d lift{calculateLift(kinematics)};
+    Eigen::Vector3d drag{calculateDrag(kinematics)};
+    Eigen::Vector3d thrust{calculateThrust()};
+    Eigen::Vector3d gravity{calculateGravity(nedToBody)};
+    
+    // Sum all forces (in body frame)
+    return thrust + lift + drag + gravity;
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::bodyMoment(const KinematicContext& kinematics) const {
+    FALCONSIM_TRACE_ZONE("FlightDynamics::moments");
+    // Sum the control surface moments; a surface the airframe lacks (zero gain) adds no work
+    Eigen::Vector3d moment{Eigen::Vector3d::Zero()};
+    if constexpr (Airframe::roll_gain != 0.0) {
+        moment += calculateAileronMoment();
+    }
+    if constexpr (Airframe::pitch_gain != 0.0) {
+        moment += calculateElevatorMoment();
+    }
+    if constexpr (Airframe::yaw_gain != 0.0) {
+        moment += calculateRudderMoment();
+    }
+    if (m_aeroTable) {
+        moment += calculateAeroMoment(kinematics);
+    }
+    return moment;
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::angularAcceleration(const Eigen::Vector3d& moment) const {
+    if constexpr (kTunable) {
+        return m_airframe.inverse_inertia * moment;
+    } else {
+        // Principal axes only, with the reciprocals folded at compile time
+        constexpr double inverse[3]{1.0 / Airframe::inertia[0], 1.0 / Airframe::inertia[1], 1.0 / Airframe::inertia[2]};
+        return Eigen::Vector3d{inverse[0] * moment.x(), inverse[1] * moment.y(), inverse[2] * moment.z()};
+    }
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::updateForces(const KinematicContext& kinematics, double dt) {
+    Eigen::Vector3d totalForce{bodyForce(kinematics, m_rotationNEDToBody)};
+    
+    // F = ma -> a = F/m
+    Eigen::Vector3d acceleration{totalForce / m_state.mass};
+    
+    // Update velocity (integrate acceleration)
+    m_state.velocity += acceleration * dt;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::updateMoments(const KinematicContext& kinematics, double dt) {
+    Eigen::Vector3d totalMoment{bodyMoment(kinematics)};
+    
+    // Calculate angular acceleration: α = I⁻¹ * M
+    Eigen::Vector3d angularAccel{angularAcceleration(totalMoment)};
+    
+    // Update angular velocity
+    m_state.angular_velocity += angularAccel * dt;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::integrateState(const KinematicContext& kinematics, double dt) {
+    FALCONSIM_TRACE_ZONE("FlightDynamics::integrate");
+    // Update position based on velocity
+    // Convert velocity from body to NED frame
+    Eigen::Vector3d velocityNED{m_rotationBodyToNED * m_state.velocity};
+    
+    // Update position in NED frame
+    m_state.position += velocityNED * dt;
+    
+    // Update orientation (Euler angles) based on angular velocity
+    // Note: this is a simple Euler integration that is singular at ±90° pitch;
+    // the quaternion schemes avoid it
+    
+    // Convert body rates to Euler rates
+    const double sphi{kinematics.sinRoll};
+    const double cphi{kinematics.cosRoll};
+    Eigen::Matrix3d W;
+    W << 1, sphi * kinematics.tanPitch, cphi * kinematics.tanPitch,
+         0, cphi, -sphi,
+         0, sphi / kinematics.cosPitch, cphi / kinematics.cosPitch;
+    
+    // Apply to angular velocity
+    Eigen::Vector3d eulerRates{W * m_state.angular_velocity};
+    
+    // Integrate to get new Euler angles
+    m_state.euler_angles += eulerRates * dt;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::integrateSemiImplicit(double dt) {
+    FALCONSIM_TRACE_ZONE("FlightDynamics::integrate");
+    RigidBodyState body{rigidBodyState()};
+    updateWind(body.attitude.toRotationMatrix().transpose(), dt);
+    const RigidBodyRates rates{computeRates(body)};
+    
+    // Velocities first, from forces at the start of the step
+    body.velocity += rates.velocity * dt;
+    body.angularVelocity += rates.angularVelocity * dt;
+    
+    // Rotate by the new body rate with the exact exponential map, so the
+    // quaternion stays on the unit sphere regardless of dt
+    const double angle{body.angularVelocity.norm() * dt};
+    if (angle > 0.0) {
+        const Eigen::AngleAxisd increment{angle, body.angularVelocity.normalized()};
+        body.attitude = (body.attitude * Eigen::Quaterniond{increment}).normalized();
+    }
+    
+    // Position with the updated velocity and attitude
+    body.position += body.attitude.toRotationMatrix() * body.velocity * dt;
+    
+    applyRigidBodyState(body);
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::integrateRK4(double dt) {
+    FALCONSIM_TRACE_ZONE("FlightDynamics::integrate");
+    const RigidBodyState start{rigidBodyState()};
+    updateWind(start.attitude.toRotationMatrix().transpose(), dt);
+    
+    // Stage state: start + rates * h (attitude renormalized for the force model)
+    const auto stage = [&start](const RigidBodyRates& rates, double h) {
+        RigidBodyState body;
+        body.position = start.position + rates.position * h;
+        body.velocity = start.velocity + rates.velocity * h;
+        body.attitude.coeffs() = start.attitude.coeffs() + rates.attitude * h;
+        body.attitude.normalize();
+        body.angularVelocity = start.angularVelocity + rates.angularVelocity * h;
+        return body;
+    };
+    
+    const RigidBodyRates k1{computeRates(start)};
+    const RigidBodyRates k2{computeRates(stage(k1, 0.5 * dt))};
+    const RigidBodyRates k3{computeRates(stage(k2, 0.5 * dt))};
+    const RigidBodyRates k4{computeRates(stage(k3, dt))};
+    
+    const double w{dt / 6.0};
+    RigidBodyState body{start};
+    body.position += w * (k1.position + 2.0 * k2.position + 2.0 * k3.position + k4.position);
+    body.velocity += w * (k1.velocity + 2.0 * k2.velocity + 2.0 * k3.velocity + k4.velocity);
+    body.attitude.coeffs() += w * (k1.attitude + 2.0 * k2.attitude + 2.0 * k3.attitude + k4.attitude);
+    body.attitude.normalize();
+    body.angularVelocity += w * (k1.angularVelocity + 2.0 * k2.angularVelocity +
+                                 2.0 * k3.angularVelocity + k4.angularVelocity);
+    
+    applyRigidBodyState(body);
+}
+
+template <typename Airframe>
+typename FlightDynamicsT<Airframe>::RigidBodyRates FlightDynamicsT<Airframe>::computeRates(const RigidBodyState& body) const {
+    const Eigen::Matrix3d bodyToNED{body.attitude.toRotationMatrix()};
+    
+    KinematicContext kinematics;
+    computeAirData(airVelocity(body.velocity, bodyToNED.transpose()), kinematics);
+    
+    // Same force and moment model as the Euler angle scheme; only the
+    // attitude representation and the integration order differ
+    RigidBodyRates rates;
+    rates.position = bodyToNED * body.velocity;
+    rates.velocity = bodyForce(kinematics, bodyToNED.transpose()) / m_state.mass;
+    rates.attitude = flight_detail::quaternionRate(body.attitude, body.angularVelocity);
+    rates.angularVelocity = angularAcceleration(bodyMoment(kinematics));
+    return rates;
+}
+
+template <typename Airframe>
+typename FlightDynamicsT<Airframe>::RigidBodyState FlightDynamicsT<Airframe>::rigidBodyState() const {
+    RigidBodyState body;
+    body.position = m_state.position;
+    body.velocity = m_state.velocity;
+    body.attitude = m_attitude;
+    body.angularVelocity = m_state.angular_velocity;
+    return body;
+}
+
+template <typename Airframe>
+void FlightDynamicsT<Airframe>::applyRigidBodyState(const RigidBodyState& body) {
+    m_state.position = body.position;
+    m_state.velocity = body.velocity;
+    m_state.angular_velocity = body.angularVelocity;
+    m_attitude = body.attitude;
+    
+    // Euler angles are a derived output for the quaternion schemes
+    m_state.euler_angles = flight_detail::eulerFromQuaternion(m_attitude);
+    m_rotationBodyToNED = m_attitude.toRotationMatrix();
+    m_rotationNEDToBody = m_rotationBodyToNED.transpose();
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateLift(const KinematicContext& kinematics) const {
+    // Basic lift equation: L = 0.5 * ρ * v² * CL * S (zero below 0.1 m/s airspeed)
+    double liftMagnitude{kinematics.dynamicPressureArea * kinematics.coefficients.lift};
+    
+    // Lift is perpendicular to velocity, pointing upward in body frame
+    return Eigen::Vector3d{0, 0, -liftMagnitude};
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateDrag(const KinematicContext& kinematics) const {
+    // Basic drag equation: D = 0.5 * ρ * v² * CD * S (zero below 0.1 m/s airspeed)
+    double dragMagnitude{kinematics.dynamicPressureArea * kinematics.coefficients.drag};
+    
+    // Drag is opposite to velocity
+    return -kinematics.velocityUnit * dragMagnitude;
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateThrust() const {
+    // Simple thrust model: Thrust acts in the body's x-direction
+    double thrustMagnitude{m_controls.throttle * m_airframe.thrust_max};
+    return Eigen::Vector3d{thrustMagnitude, 0, 0};
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateGravity(const Eigen::Matrix3d& nedToBody) const {
+    // Gravity in NED frame is (0, 0, m*g)
+    Eigen::Vector3d gravityNED{0, 0, m_state.mass * m_gravity};
+    
+    // Need to rotate to body frame
+    return nedToBody * gravityNED;
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateAileronMoment() const {
+    // Aileron creates roll moment (around x-axis)
+    double rollMoment{m_controls.aileron * Airframe::roll_gain * m_airframe.wingspan};
+    return Eigen::Vector3d{rollMoment, 0, 0};
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateElevatorMoment() const {
+    // Elevator creates pitch moment (around y-axis)
+    double pitchMoment{m_controls.elevator * Airframe::pitch_gain};
+    return Eigen::Vector3d{0, pitchMoment, 0};
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateAeroMoment(const KinematicContext& kinematics) const {
+    // Tabulated pitching moment: M = 0.5 * ρ * v² * S * c * Cm, with mean chord c = S / b
+    const double chord{m_airframe.wing_area / m_airframe.wingspan};
+    return Eigen::Vector3d{0, kinematics.dynamicPressureArea * chord * kinematics.coefficients.pitch_moment, 0};
+}
+
+template <typename Airframe>
+Eigen::Vector3d FlightDynamicsT<Airframe>::calculateRudderMoment() const {
+    // Rudder creates yaw moment (around z-axis)
+    double yawMoment{m_controls.rudder * Airframe::yaw_gain};
+    return Eigen::Vector3d{0, 0, yawMoment};
+}
+
+} // namespace falconsim
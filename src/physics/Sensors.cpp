@@ -0,0 +1,265 @@
+#include "Sensors.hpp"
+#include "CounterRng.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace falconsim {
+
+namespace {
+
+constexpr double kGravity{9.81};                        // m/s², as in FlightDynamics
+constexpr double kPi{3.14159265358979323846};
+constexpr double kSeaLevelPressure{101325.0};           // Pa
+constexpr double kTimeTolerance{1e-9};                  // s, for measurement times on the rate grid
+constexpr std::uint64_t kTurnOnStream{0x80};            // Stream flag for the turn-on bias draws
+
+std::size_t kindIndex(SensorKind kind) {
+    return static_cast<std::size_t>(kind) - 1;
+}
+
+// Noise stream of one sensor of one vehicle
+std::uint64_t sensorStream(std::uint32_t vehicleId, std::size_t kind) {
+    return (static_cast<std::uint64_t>(vehicleId) << 8) | (kind + 1);
+}
+
+void checkNoise(const SensorNoise& noise) {
+    if (!(noise.noise >= 0.0) || !(noise.bias >= 0.0) || !(noise.bias_walk >= 0.0)) {
+        throw std::invalid_argument{"Sensor noise levels must not be negative"};
+    }
+}
+
+// Body-to-NED rotation, the same 3-2-1 sequence as the dynamics
+Eigen::Matrix3d bodyToNed(const Eigen::Vector3d& euler) {
+    return (Eigen::AngleAxisd(euler.z(), Eigen::Vector3d::UnitZ()) *
+            Eigen::AngleAxisd(euler.y(), Eigen::Vector3d::UnitY()) *
+            Eigen::AngleAxisd(euler.x(), Eigen::Vector3d::UnitX())).toRotationMatrix();
+}
+
+double wrapAngle(double angle) {
+    return std::remainder(angle, 2.0 * kPi);
+}
+
+// ISA troposphere
+double pressureAtAltitude(double altitude) {
+    return kSeaLevelPressure * std::pow(1.0 - 2.25577e-5 * altitude, 5.25588);
+}
+
+} // namespace
+
+SensorSuite::SensorSuite(const SensorSettings& settings)
+    : m_settings{settings} {
+    const double rates[kSensorKindCount]{settings.imu.rate, settings.gps.rate, settings.baro.rate};
+    const double latencies[kSensorKindCount]{settings.imu.latency, settings.gps.latency, settings.baro.latency};
+    for (std::size_t kind = 0; kind < kSensorKindCount; ++kind) {
+        if (!(rates[kind] >= 0.0) || !(latencies[kind] >= 0.0)) {
+            throw std::invalid_argument{"Sensor rates and latencies must not be negative"};
+        }
+        m_rate[kind] = rates[kind];
+        m_latency[kind] = latencies[kind];
+    }
+    
+    SensorNoise (&imu)[kSensorValueCount]{m_noise[kindIndex(SensorKind::Imu)]};
+    SensorNoise (&gps)[kSensorValueCount]{m_noise[kindIndex(SensorKind::Gps)]};
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        imu[axis] = settings.imu.accel;
+        imu[3 + axis] = settings.imu.gyro;
+        gps[axis] = axis < 2 ? settings.gps.horizontal : settings.gps.vertical;
+        gps[3 + axis] = settings.gps.velocity;
+    }
+    m_noise[kindIndex(SensorKind::Baro)][1] = settings.baro.altitude;
+    for (const auto& axes : m_noise) {
+        for (const SensorNoise& noise : axes) {
+            checkNoise(noise);
+        }
+    }
+}
+
+const SensorSettings& SensorSuite::getSettings() const {
+    return m_settings;
+}
+
+std::size_t SensorSuite::getVehicleCount() const {
+    return m_vehicles.size();
+}
+
+std::size_t SensorSuite::getPending() const {
+    std::size_t pending{0};
+    for (const Vehicle& vehicle : m_vehicles) {
+        for (const Track& track : vehicle.tracks) {
+            pending += track.pending.size();
+        }
+    }
+    return pending;
+}
+
+std::uint64_t SensorSuite::getStale() const {
+    return m_stale;
+}
+
+SensorSuite::Vehicle& SensorSuite::vehicleFor(std::uint32_t id) {
+    const auto found = m_slots.find(id);
+    if (found != m_slots.end()) {
+        return m_vehicles[found->second];
+    }
+    
+    // A new vehicle draws its turn-on biases
+    m_slots.emplace(id, m_vehicles.size());
+    m_vehicles.emplace_back();
+    Vehicle& vehicle{m_vehicles.back()};
+    vehicle.id = id;
+    for (std::size_t kind = 0; kind < kSensorKindCount; ++kind) {
+        const std::uint64_t key{counter_rng::streamKey(m_settings.seed, sensorStream(id, kind) | kTurnOnStream)};
+        for (std::size_t axis = 0; axis < kSensorValueCount; ++axis) {
+            vehicle.tracks[kind].turnOnBias[axis] = m_noise[kind][axis].bias * counter_rng::normal(key, axis);
+        }
+    }
+    return vehicle;
+}
+
+void SensorSuite::process(const SensorSnapshot* snapshots, std::size_t count, std::vector<SensorSample>& out) {
+    ++m_calls;
+    m_owner.clear();
+    m_taken.clear();
+    m_keys.clear();
+    m_counters.clear();
+    m_fed.clear();
+    
+    // True values of every measurement due
+    for (std::size_t i = 0; i < count; ++i) {
+        Vehicle& vehicle{vehicleFor(snapshots[i].vehicle_id)};
+        if (vehicle.primed && !(snapshots[i].time > vehicle.previous.time)) {
+            ++m_stale;
+            continue;
+        }
+        const std::size_t slot{static_cast<std::size_t>(&vehicle - m_vehicles.data())};
+        if (vehicle.touched != m_calls) {
+            vehicle.touched = m_calls;
+            m_fed.push_back(slot);
+        }
+        measure(slot, snapshots[i]);
+    }
+    
+    applyNoise();
+    for (std::size_t slot : m_fed) {
+        deliver(m_vehicles[slot], out);
+    }
+}
+
+void SensorSuite::measure(std::size_t slot, const SensorSnapshot& snapshot) {
+    Vehicle& vehicle{m_vehicles[slot]};
+    const SensorSnapshot& previous{vehicle.primed ? vehicle.previous : snapshot};
+    const AircraftState& from{previous.state};
+    const AircraftState& to{snapshot.state};
+    const double interval{snapshot.time - previous.time};
+    
+    // NED acceleration across the interval (none known before the second snapshot)
+    const Eigen::Vector3d velocityFrom{bodyToNed(from.euler_angles) * from.velocity};
+    const Eigen::Vector3d velocityTo{bodyToNed(to.euler_angles) * to.velocity};
+    const Eigen::Vector3d acceleration{interval > 0.0 ? Eigen::Vector3d{(velocityTo - velocityFrom) / interval}
+                                                      : Eigen::Vector3d::Zero()};
+    const Eigen::Vector3d gravity{0.0, 0.0, kGravity};
+    const Eigen::Vector3d turn{wrapAngle(to.euler_angles.x() - from.euler_angles.x()),
+                               wrapAngle(to.euler_angles.y() - from.euler_angles.y()),
+                               wrapAngle(to.euler_angles.z() - from.euler_angles.z())};
+    
+    for (std::size_t kind = 0; kind < kSensorKindCount; ++kind) {
+        const double rate{m_rate[kind]};
+        if (rate <= 0.0) {
+            continue;
+        }
+        Track& track{vehicle.tracks[kind]};
+        if (!vehicle.primed) {
+            track.nextMeasurement = static_cast<std::uint64_t>(std::max(0.0, std::ceil(snapshot.time * rate - kTimeTolerance)));
+        }
+        const std::uint64_t key{counter_rng::streamKey(m_settings.seed, sensorStream(vehicle.id, kind))};
+        
+        for (;; ++track.nextMeasurement) {
+            const double time{static_cast<double>(track.nextMeasurement) / rate};
+            if (time > snapshot.time + kTimeTolerance) {
+                break;
+            }
+            const double s{interval > 0.0 ? std::min(1.0, std::max(0.0, (time - previous.time) / interval)) : 1.0};
+            const Eigen::Vector3d euler{from.euler_angles + s * turn};
+            
+            SensorSample sample;
+            sample.vehicle_id = vehicle.id;
+            sample.kind = static_cast<SensorKind>(kind + 1);
+            sample.time = time;
+            switch (sample.kind) {
+                case SensorKind::Imu: {
+                    const Eigen::Vector3d force{bodyToNed(euler).transpose() * (acceleration - gravity)};
+                    const Eigen::Vector3d rates{from.angular_velocity + s * (to.angular_velocity - from.angular_velocity)};
+                    for (std::size_t axis = 0; axis < 3; ++axis) {
+                        sample.values[axis] = force[axis];
+                        sample.values[3 + axis] = rates[axis];
+                    }
+                    break;
+                }
+                case SensorKind::Gps: {
+                    const Eigen::Vector3d position{from.position + s * (to.position - from.position)};
+                    const Eigen::Vector3d velocity{bodyToNed(euler) * (from.velocity + s * (to.velocity - from.velocity))};
+                    for (std::size_t axis = 0; axis < 3; ++axis) {
+                        sample.values[axis] = position[axis];
+                        sample.values[3 + axis] = velocity[axis];
+                    }
+                    break;
+                }
+                case SensorKind::Baro:
+                    sample.values[1] = -(from.position.z() + s * (to.position.z() - from.position.z()));
+                    break;
+            }
+            
+            m_owner.push_back(slot);
+            m_taken.push_back(sample);
+            m_keys.push_back(key);
+            m_counters.push_back(track.nextMeasurement * kDraws);
+        }
+    }
+    
+    vehicle.previous = snapshot;
+    vehicle.primed = true;
+}
+
+void SensorSuite::applyNoise() {
+    // Every draw of the batch in one pass; no draw depends on another
+    const std::size_t count{m_taken.size()};
+    m_draws.resize(count * kDraws);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t key{m_keys[i]};
+        const std::uint64_t first{m_counters[i]};
+        double* draws{m_draws.data() + i * kDraws};
+        for (std::size_t d = 0; d < kDraws; ++d) {
+            draws[d] = counter_rng::normal(key, first + d);
+        }
+    }
+    
+    // Biases evolve measurement by measurement, in each vehicle's time order
+    for (std::size_t i = 0; i < count; ++i) {
+        SensorSample& sample{m_taken[i]};
+        const std::size_t kind{kindIndex(sample.kind)};
+        Track& track{m_vehicles[m_owner[i]].tracks[kind]};
+        const double walkScale{std::sqrt(1.0 / m_rate[kind])};
+        const double* draws{m_draws.data() + i * kDraws};
+        for (std::size_t axis = 0; axis < kSensorValueCount; ++axis) {
+            const SensorNoise& noise{m_noise[kind][axis]};
+            track.walkBias[axis] += noise.bias_walk * walkScale * draws[kSensorValueCount + axis];
+            sample.values[axis] += track.turnOnBias[axis] + track.walkBias[axis] + noise.noise * draws[axis];
+        }
+        if (sample.kind == SensorKind::Baro) {
+            sample.values[0] = pressureAtAltitude(sample.values[1]);
+        }
+        track.pending.push_back(sample);
+    }
+}
+
+void SensorSuite::deliver(Vehicle& vehicle, std::vector<SensorSample>& out) {
+    for (std::size_t kind = 0; kind < kSensorKindCount; ++kind) {
+        std::deque<SensorSample>& pending{vehicle.tracks[kind].pending};
+        while (!pending.empty() && pending.front().time + m_latency[kind] <= vehicle.previous.time + kTimeTolerance) {
+            out.push_back(pending.front());
+            pending.pop_front();
+        }
+    }
+}
+
+} // namespace falconsim
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "FlightDynamics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Simulated sensor types
+ */
+enum class SensorKind : std::uint8_t {
+    Imu = 1,
+    Gps = 2,
+    Baro = 3
+};
+constexpr std::size_t kSensorKindCount{3};
+constexpr std::size_t kSensorValueCount{6};
+
+/**
+ * @brief One measurement of one sensor of one vehicle
+ *
+ *   Imu   specific force (m/s², body axes), then angular rate (rad/s, body axes)
+ *   Gps   position (m, NED), then velocity (m/s, NED)
+ *   Baro  static pressure (Pa), pressure altitude (m), then zeros
+ */
+struct SensorSample {
+    std::uint32_t vehicle_id{0};
+    SensorKind kind{SensorKind::Imu};
+    double time{0.0}; // When the measurement was taken (simulated s); it is delivered latency later
+    double values[kSensorValueCount]{};
+};
+
+/**
+ * @brief A published vehicle state, as sensors consume it
+ */
+struct SensorSnapshot {
+    std::uint32_t vehicle_id{0};
+    double time{0.0}; // Simulated time (s)
+    AircraftState state{};
+};
+
+/**
+ * @brief Error model of one group of sensor axes
+ */
+struct SensorNoise {
+    double noise{0.0};     // White noise σ per measurement
+    double bias{0.0};      // Turn-on bias σ, drawn once per vehicle and axis
+    double bias_walk{0.0}; // Bias random walk σ per √s
+};
+
+struct ImuSettings {
+    double rate{1000.0};                    // Hz; 0 disables the sensor
+    double latency{0.0};                    // Delivery delay (s)
+    SensorNoise accel{0.02, 0.05, 0.001};   // m/s²
+    SensorNoise gyro{0.002, 0.005, 0.0001}; // rad/s
+};
+
+struct GpsSettings {
+    double rate{10.0};
+    double latency{0.1};
+    SensorNoise horizontal{1.5, 0.0, 0.05}; // North and east (m)
+    SensorNoise vertical{3.0, 0.0, 0.1};    // Down (m)
+    SensorNoise velocity{0.1, 0.0, 0.0};    // m/s
+};
+
+struct BaroSettings {
+    double rate{50.0};
+    double latency{0.02};
+    SensorNoise altitude{0.3, 1.0, 0.01}; // m; the pressure follows from the measured altitude
+};
+
+struct SensorSettings {
+    ImuSettings imu{};
+    GpsSettings gps{};
+    BaroSettings baro{};
+    std::uint64_t seed{0}; // Equal seeds give identical noise and biases
+};
+
+/**
+ * @brief IMU, GPS and barometer models for any number of vehicles
+ *
+ * process() takes state snapshots, each vehicle's in time order, from a
+ * physics loop running at any rate. Every sensor measures on its own fixed
+ * grid of times k / rate; measurements that fall between two snapshots see
+ * the state interpolated between them, and the IMU's specific force comes
+ * from the change in NED velocity across the interval. A measurement is
+ * handed out once a snapshot at least its latency later has arrived.
+ *
+ * Noise is counter based (see CounterRng.hpp). Each draw hashes the seed,
+ * the vehicle id, the sensor, the measurement index k and the axis, so the
+ * samples are the same however snapshots are batched, and however vehicles
+ * are spread over suites and threads. A call works in stages over the
+ * whole batch: the true values of every measurement due, then the noise of
+ * all of them in one flat loop, then biases and delivery.
+ */
+class SensorSuite {
+public:
+    // Throws std::invalid_argument for negative rates, latencies or noise levels
+    explicit SensorSuite(const SensorSettings& settings = {});
+    
+    [[nodiscard]] const SensorSettings& getSettings() const;
+    
+    // Take every measurement due by each snapshot's time; append those delivered by then to out
+    void process(const SensorSnapshot* snapshots, std::size_t count, std::vector<SensorSample>& out);
+    
+    [[nodiscard]] std::size_t getVehicleCount() const;
+    [[nodiscard]] std::size_t getPending() const; // Measurements still waiting out their latency
+    [[nodiscard]] std::uint64_t getStale() const; // Snapshots ignored for being older than their vehicle's last
+
+private:
+    static constexpr std::size_t kDraws{2 * kSensorValueCount}; // White noise, then bias walk, per axis
+    
+    struct Track {
+        std::uint64_t nextMeasurement{0};             // Index k of the next measurement on the rate grid
+        double turnOnBias[kSensorValueCount]{};
+        double walkBias[kSensorValueCount]{};
+        std::deque<SensorSample> pending{};           // Taken, waiting out the latency
+    };
+    
+    struct Vehicle {
+        std::uint32_t id{0};
+        bool primed{false};  // Has a previous snapshot
+        SensorSnapshot previous{};
+        std::uint64_t touched{0}; // Last process() call that fed it
+        Track tracks[kSensorKindCount]{};
+    };
+    
+    [[nodiscard]] Vehicle& vehicleFor(std::uint32_t id);
+    void measure(std::size_t slot, const SensorSnapshot& snapshot);
+    void applyNoise();
+    void deliver(Vehicle& vehicle, std::vector<SensorSample>& out);
+    
+    SensorSettings m_settings{};
+    double m_rate[kSensorKindCount]{};
+    double m_latency[kSensorKindCount]{};
+    SensorNoise m_noise[kSensorKindCount][kSensorValueCount]{};
+    
+    std::vector<Vehicle> m_vehicles{};
+    std::unordered_map<std::uint32_t, std::size_t> m_slots{};
+    std::uint64_t m_calls{0};
+    std::uint64_t m_stale{0};
+    
+    // Measurements of one process() call, as columns
+    std::vector<std::size_t> m_owner{};      // Vehicle slot
+    std::vector<SensorSample> m_taken{};     // True values until the noise is applied
+    std::vector<std::uint64_t> m_keys{};     // Noise stream of the vehicle's sensor
+    std::vector<std::uint64_t> m_counters{}; // First draw of the measurement
+    std::vector<double> m_draws{};           // kDraws unit normals per measurement
+    std::vector<std::size_t> m_fed{};        // Vehicle slots fed by this call, in first-fed order
+};
+
+} // namespace falconsim
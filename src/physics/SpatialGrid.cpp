@@ -0,0 +1,272 @@
+#include "SpatialGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace falconsim {
+
+namespace {
+
+// A cell key packs three biased cell coordinates of 21 bits each, north in the top bits
+constexpr int kCoordinateBits{21};
+constexpr std::uint64_t kCoordinateMask{(std::uint64_t{1} << kCoordinateBits) - 1};
+constexpr double kCoordinateBias{static_cast<double>(std::uint64_t{1} << (kCoordinateBits - 1))};
+
+// Key difference of a cell offset, valid when no coordinate leaves [0, kCoordinateMask]
+std::uint64_t packedOffset(int dn, int de, int dd) {
+    return (static_cast<std::uint64_t>(dn) << (2 * kCoordinateBits)) + (static_cast<std::uint64_t>(de) << kCoordinateBits) +
+           static_cast<std::uint64_t>(dd);
+}
+
+// Whether every cell within reach of key has coordinates inside the key space
+bool isInterior(std::uint64_t key, int reach) {
+    const auto low = static_cast<std::uint64_t>(reach);
+    for (int shift = 0; shift < 3 * kCoordinateBits; shift += kCoordinateBits) {
+        const std::uint64_t c{(key >> shift) & kCoordinateMask};
+        if (c < low || c > kCoordinateMask - low) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Cells a query of this radius has to reach out along each axis
+int stencilReach(double radius, double inverseCellSize) {
+    return std::max(1, static_cast<int>(std::ceil(radius * inverseCellSize)));
+}
+
+} // namespace
+
+SpatialGrid::SpatialGrid(double cellSize)
+    : m_cellSize{cellSize} {
+    if (!(cellSize > 0.0)) {
+        throw std::invalid_argument{"Spatial grid cell size must be positive"};
+    }
+    m_inverseCellSize = 1.0 / cellSize;
+}
+
+std::uint64_t SpatialGrid::cellKey(double north, double east, double down) const noexcept {
+    // Positions beyond about a million cells from the origin share the edge cell
+    const double position[3]{north, east, down};
+    std::uint64_t key{0};
+    for (const double p : position) {
+        double cell{std::floor(p * m_inverseCellSize)};
+        cell = !(cell > -kCoordinateBias) ? -kCoordinateBias : std::min(cell, kCoordinateBias - 1.0);
+        key = (key << kCoordinateBits) | static_cast<std::uint64_t>(cell + kCoordinateBias);
+    }
+    return key;
+}
+
+std::size_t SpatialGrid::bucketOf(std::uint64_t key) const noexcept {
+    // Fibonacci hashing: the top bits of the product mix all three coordinates
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> m_bucketShift);
+}
+
+void SpatialGrid::link(std::uint32_t vehicle) noexcept {
+    std::uint32_t& head{m_buckets[bucketOf(m_entries[vehicle].cell)]};
+    m_previous[vehicle] = kNone;
+    m_next[vehicle] = head;
+    if (head != kNone) {
+        m_previous[head] = vehicle;
+    }
+    head = vehicle;
+}
+
+void SpatialGrid::unlink(std::uint32_t vehicle) noexcept {
+    const std::uint32_t previous{m_previous[vehicle]};
+    const std::uint32_t next{m_next[vehicle]};
+    if (previous != kNone) {
+        m_next[previous] = next;
+    } else {
+        m_buckets[bucketOf(m_entries[vehicle].cell)] = next;
+    }
+    if (next != kNone) {
+        m_previous[next] = previous;
+    }
+}
+
+void SpatialGrid::rebuild(std::size_t count) {
+    // At least two buckets per vehicle keeps the chains short
+    std::size_t buckets{64};
+    unsigned shift{64 - 6};
+    while (buckets < 2 * count) {
+        buckets *= 2;
+        --shift;
+    }
+    m_buckets.assign(buckets, kNone);
+    m_bucketShift = shift;
+    
+    m_next.resize(count);
+    m_previous.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        link(static_cast<std::uint32_t>(i));
+    }
+    m_moved = count;
+}
+
+void SpatialGrid::update(const double* north, const double* east, const double* down, std::size_t count) {
+    if (count >= kNone) {
+        throw std::invalid_argument{"Spatial grid holds at most 2^32 - 1 vehicles"};
+    }
+    if (count != m_entries.size()) {
+        m_entries.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            m_entries[i] = Entry{north[i], east[i], down[i], cellKey(north[i], east[i], down[i])};
+        }
+        rebuild(count);
+        return;
+    }
+    
+    m_moved = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        Entry& entry{m_entries[i]};
+        const std::uint64_t key{cellKey(north[i], east[i], down[i])};
+        if (key != entry.cell) {
+            const auto vehicle = static_cast<std::uint32_t>(i);
+            unlink(vehicle);
+            entry.cell = key;
+            link(vehicle);
+            ++m_moved;
+        }
+        entry.north = north[i];
+        entry.east = east[i];
+        entry.down = down[i];
+    }
+}
+
+bool SpatialGrid::offsetCell(std::uint64_t key, int dn, int de, int dd, std::uint64_t& target) noexcept {
+    const std::int64_t cell[3]{
+        static_cast<std::int64_t>((key >> (2 * kCoordinateBits)) & kCoordinateMask) + dn,
+        static_cast<std::int64_t>((key >> kCoordinateBits) & kCoordinateMask) + de,
+        static_cast<std::int64_t>(key & kCoordinateMask) + dd,
+    };
+    target = 0;
+    for (const std::int64_t c : cell) {
+        if (c < 0 || c > static_cast<std::int64_t>(kCoordinateMask)) {
+            return false;
+        }
+        target = (target << kCoordinateBits) | static_cast<std::uint64_t>(c);
+    }
+    return true;
+}
+
+template <typename Fn>
+void SpatialGrid::forEachInCell(std::uint64_t cell, Fn&& fn) const {
+    for (std::uint32_t j = m_buckets[bucketOf(cell)]; j != kNone; j = m_next[j]) {
+        if (m_entries[j].cell == cell) {
+            fn(j);
+        }
+    }
+}
+
+void SpatialGrid::findPairs(double radius, std::vector<ProximityPair>& pairs) const {
+    pairs.clear();
+    if (!(radius > 0.0)) {
+        return;
+    }
+    const int reach{stencilReach(radius, m_inverseCellSize)};
+    const double radiusSquared{radius * radius};
+    const auto test = [&](std::uint32_t a, std::uint32_t b) {
+        const Entry& first{m_entries[a]};
+        const Entry& second{m_entries[b]};
+        const double dn{second.north - first.north};
+        const double de{second.east - first.east};
+        const double dd{second.down - first.down};
+        const double distanceSquared{dn * dn + de * de + dd * dd};
+        if (distanceSquared < radiusSquared) {
+            pairs.push_back({std::min(a, b), std::max(a, b), std::sqrt(distanceSquared)});
+        }
+    };
+    
+    // Cell by cell, so each neighbouring cell is looked up once for all of a cell's vehicles
+    for (const std::uint32_t head : m_buckets) {
+        for (std::uint32_t leader = head; leader != kNone; leader = m_next[leader]) {
+            // The first vehicle of a cell on this chain stands for the cell
+            const std::uint64_t key{m_entries[leader].cell};
+            bool first{true};
+            for (std::uint32_t k = head; k != leader && first; k = m_next[k]) {
+                first = m_entries[k].cell != key;
+            }
+            if (!first) {
+                continue;
+            }
+            const auto forEachMember = [&](auto&& fn) {
+                for (std::uint32_t m = leader; m != kNone; m = m_next[m]) {
+                    if (m_entries[m].cell == key) {
+                        fn(m);
+                    }
+                }
+            };
+            
+            // Pairs within the cell
+            forEachMember([&](std::uint32_t a) {
+                for (std::uint32_t b = m_next[a]; b != kNone; b = m_next[b]) {
+                    if (m_entries[b].cell == key) {
+                        test(a, b);
+                    }
+                }
+            });
+            
+            // The half of the stencil that lies lexicographically after the cell, so each cell pair is seen once
+            const bool interior{isInterior(key, reach)};
+            for (int dn = 0; dn <= reach; ++dn) {
+                for (int de = dn == 0 ? 0 : -reach; de <= reach; ++de) {
+                    for (int dd = dn == 0 && de == 0 ? 1 : -reach; dd <= reach; ++dd) {
+                        // Away from the edges of the key space the offsets add without carries
+                        std::uint64_t target{key + packedOffset(dn, de, dd)};
+                        if (interior || offsetCell(key, dn, de, dd, target)) {
+                            forEachInCell(target, [&](std::uint32_t j) {
+                                forEachMember([&](std::uint32_t a) { test(a, j); });
+                            });
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::findNeighbors(double north, double east, double down, double radius,
+                                std::vector<std::uint32_t>& indices) const {
+    indices.clear();
+    if (!(radius > 0.0)) {
+        return;
+    }
+    const int reach{stencilReach(radius, m_inverseCellSize)};
+    const double radiusSquared{radius * radius};
+    const std::uint64_t key{cellKey(north, east, down)};
+    
+    const auto visit = [&](std::uint32_t j) {
+        const Entry& other{m_entries[j]};
+        const double dn{other.north - north};
+        const double de{other.east - east};
+        const double dd{other.down - down};
+        if (dn * dn + de * de + dd * dd < radiusSquared) {
+            indices.push_back(j);
+        }
+    };
+    for (int dn = -reach; dn <= reach; ++dn) {
+        for (int de = -reach; de <= reach; ++de) {
+            for (int dd = -reach; dd <= reach; ++dd) {
+                std::uint64_t target;
+                if (offsetCell(key, dn, de, dd, target)) {
+                    forEachInCell(target, visit);
+                }
+            }
+        }
+    }
+}
+
+double SpatialGrid::getCellSize() const {
+    return m_cellSize;
+}
+
+std::size_t SpatialGrid::size() const {
+    return m_entries.size();
+}
+
+std::size_t SpatialGrid::getMovedCount() const {
+    return m_moved;
+}
+
+} // namespace falconsim
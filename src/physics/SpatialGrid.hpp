@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Two vehicles found within a query radius of each other
+ */
+struct ProximityPair {
+    std::uint32_t first{0};  // Lower vehicle index
+    std::uint32_t second{0}; // Higher vehicle index
+    double distance{0.0};    // Separation (m)
+};
+
+/**
+ * @brief Uniform-grid broadphase over a set of NED positions
+ *
+ * Space is divided into cubic cells. Each vehicle sits on an intrusive
+ * doubly linked list, one per hash bucket of cell coordinates, and each
+ * vehicle remembers its packed cell key so a bucket shared by two cells is
+ * filtered exactly. The grid therefore needs no bounds up front and costs memory only
+ * in proportion to the vehicle count.
+ *
+ * update() is incremental: every vehicle's cell is recomputed, but only
+ * vehicles that crossed into another cell are unlinked and relinked, an
+ * O(1) splice each. At typical speeds and a 50-100 m cell that is a few
+ * percent of the fleet per step. A change in vehicle count rebuilds.
+ *
+ * With a query radius no larger than the cell size, a vehicle's neighbours
+ * all lie in the 27 cells around it. findPairs() walks the grid cell by
+ * cell and looks up only the 13 cells of that stencil that follow it, each
+ * once for all of the cell's vehicles: O(n) overall for a bounded density,
+ * rather than O(n²) for testing all pairs.
+ */
+class SpatialGrid {
+public:
+    // cellSize is the cell edge (m); throws std::invalid_argument unless it is positive
+    explicit SpatialGrid(double cellSize = 100.0);
+    
+    // Bin count positions (NED, m); vehicle i is the i-th entry of each column
+    void update(const double* north, const double* east, const double* down, std::size_t count);
+    
+    // Every pair closer than radius, each once with first < second (replaces the contents of pairs)
+    void findPairs(double radius, std::vector<ProximityPair>& pairs) const;
+    
+    // Vehicles closer than radius to a position (replaces the contents of indices)
+    void findNeighbors(double north, double east, double down, double radius,
+                       std::vector<std::uint32_t>& indices) const;
+    
+    [[nodiscard]] double getCellSize() const;
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t getMovedCount() const; // Vehicles relinked by the last update()
+
+private:
+    static constexpr std::uint32_t kNone{UINT32_MAX};
+    
+    [[nodiscard]] std::uint64_t cellKey(double north, double east, double down) const noexcept;
+    [[nodiscard]] std::size_t bucketOf(std::uint64_t key) const noexcept;
+    void link(std::uint32_t vehicle) noexcept;
+    void unlink(std::uint32_t vehicle) noexcept;
+    void rebuild(std::size_t count);
+    
+    // Key of the cell offset by (dn, de, dd) cells from key; false if it lies outside the key space
+    static bool offsetCell(std::uint64_t key, int dn, int de, int dd, std::uint64_t& target) noexcept;
+    
+    // Calls fn(j) for each vehicle j in a cell
+    template <typename Fn>
+    void forEachInCell(std::uint64_t cell, Fn&& fn) const;
+    
+    double m_cellSize{100.0};
+    double m_inverseCellSize{0.01};
+    
+    // Position as of the last update and packed cell key, together so a candidate costs one cache line
+    struct alignas(32) Entry {
+        double north;
+        double east;
+        double down;
+        std::uint64_t cell;
+    };
+    
+    // Per-vehicle entries and cell list links
+    AlignedVector<Entry> m_entries{};
+    std::vector<std::uint32_t> m_next{}, m_previous{};
+    
+    // List head per hash bucket; the bucket count is a power of two
+    std::vector<std::uint32_t> m_buckets{};
+    unsigned m_bucketShift{64};
+    std::size_t m_moved{0};
+};
+
+} // namespace falconsim
@@ -0,0 +1,80 @@
+#include "TerrainMap.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace falconsim {
+
+namespace {
+
+// Cells covered by one tile along an axis; the last sample is shared with the next tile
+constexpr std::size_t kTileCells{TerrainMap::kTileSamples - 1};
+
+// Cell of a grid coordinate and the position within it, clamped to the map
+std::size_t mapCell(double coordinate, std::size_t samples, double& fraction) {
+    coordinate = std::min(std::max(coordinate, 0.0), static_cast<double>(samples - 1));
+    const std::size_t cell{std::min(static_cast<std::size_t>(coordinate), samples - 2)};
+    fraction = coordinate - static_cast<double>(cell);
+    return cell;
+}
+
+} // namespace
+
+TerrainMap::TerrainMap(const TerrainSpec& spec, const std::vector<float>& heights)
+    : m_spec{spec} {
+    for (int axis = 0; axis < 2; ++axis) {
+        if (m_spec.samples[axis] < 2) {
+            throw std::invalid_argument{"Terrain map needs at least two samples along each axis"};
+        }
+        if (!(m_spec.spacing[axis] > 0.0)) {
+            throw std::invalid_argument{"Terrain map spacing must be positive"};
+        }
+        m_tiles[axis] = (m_spec.samples[axis] - 2) / kTileCells + 1;
+        m_inverseSpacing[axis] = 1.0 / m_spec.spacing[axis];
+    }
+    const std::size_t samples[2]{m_spec.samples[0], m_spec.samples[1]};
+    if (heights.size() != samples[0] * samples[1]) {
+        throw std::invalid_argument{"Terrain map has " + std::to_string(heights.size()) + " heights for " +
+                                    std::to_string(samples[0] * samples[1]) + " samples"};
+    }
+    
+    // Tiles overlap by one sample; samples past the map's far edge repeat the edge
+    m_storage.assign(m_tiles[0] * m_tiles[1] * kTileFloats, 0.0f);
+    float* sample{m_storage.data()};
+    for (std::size_t tn = 0; tn < m_tiles[0]; ++tn) {
+        for (std::size_t te = 0; te < m_tiles[1]; ++te) {
+            for (std::size_t n = 0; n < kTileSamples; ++n) {
+                const std::size_t gn{std::min(tn * kTileCells + n, samples[0] - 1)};
+                for (std::size_t e = 0; e < kTileSamples; ++e, ++sample) {
+                    const std::size_t ge{std::min(te * kTileCells + e, samples[1] - 1)};
+                    *sample = heights[gn * samples[1] + ge];
+                }
+            }
+        }
+    }
+}
+
+double TerrainMap::heightAt(double north, double east) const noexcept {
+    double fn;
+    double fe;
+    const std::size_t cn{mapCell((north - m_spec.origin[0]) * m_inverseSpacing[0], m_spec.samples[0], fn)};
+    const std::size_t ce{mapCell((east - m_spec.origin[1]) * m_inverseSpacing[1], m_spec.samples[1], fe)};
+    const std::size_t tn{cn / kTileCells};
+    const std::size_t te{ce / kTileCells};
+    const float* corner{m_storage.data() + (tn * m_tiles[1] + te) * kTileFloats +
+                        (cn - tn * kTileCells) * kTileSamples + (ce - te * kTileCells)};
+    
+    const double lower{corner[0] + fe * (corner[1] - corner[0])};
+    const double upper{corner[kTileSamples] + fe * (corner[kTileSamples + 1] - corner[kTileSamples])};
+    return lower + fn * (upper - lower);
+}
+
+const TerrainSpec& TerrainMap::getSpec() const {
+    return m_spec;
+}
+
+std::size_t TerrainMap::getTileCount() const {
+    return m_tiles[0] * m_tiles[1];
+}
+
+} // namespace falconsim
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Geometry of a terrain heightmap
+ */
+struct TerrainSpec {
+    std::size_t samples[2]{2, 2};     // Height samples along north and east (at least 2 each)
+    double origin[2]{0.0, 0.0};       // North and east position of the first sample (m)
+    double spacing[2]{30.0, 30.0};    // Sample spacing along north and east (m)
+};
+
+/**
+ * @brief Shared, immutable terrain elevation over the NED plane
+ *
+ * Heights are stored in square tiles of 16 x 16 floats (1 KiB), and
+ * neighbouring tiles repeat their shared edge, so the four samples around
+ * any point lie in one tile. A query is a multiply per axis to find the
+ * tile and cell, then a bilinear blend of at most two cache lines: O(1)
+ * and branch-light, whatever the size of the map. Outside the map the
+ * edge height holds.
+ *
+ * Elevations are metres above the NED origin (positive up), so a vehicle
+ * at NED position p clears the ground by -p.down - heightAt(p.north, p.east).
+ * One instance, held through std::shared_ptr<const TerrainMap>, serves any
+ * number of threads.
+ */
+class TerrainMap {
+public:
+    static constexpr std::size_t kTileSamples{16}; // Samples per tile edge
+    
+    // heights holds one elevation (m) per sample, north index major; throws std::invalid_argument on a bad spec or size
+    TerrainMap(const TerrainSpec& spec, const std::vector<float>& heights);
+    
+    // Ground elevation (m above the NED origin) at a north/east position (m)
+    [[nodiscard]] double heightAt(double north, double east) const noexcept;
+    
+    // Height of a NED position above the ground beneath it (m, negative below ground)
+    [[nodiscard]] double heightAboveGround(double north, double east, double down) const noexcept {
+        return -down - heightAt(north, east);
+    }
+    
+    [[nodiscard]] const TerrainSpec& getSpec() const;
+    [[nodiscard]] std::size_t getTileCount() const;
+
+private:
+    static constexpr std::size_t kTileFloats{kTileSamples * kTileSamples};
+    
+    TerrainSpec m_spec{};
+    std::size_t m_tiles[2]{};    // Tiles along north and east
+    double m_inverseSpacing[2]{};
+    AlignedVector<float> m_storage{};
+};
+
+} // namespace falconsim
@@ -0,0 +1,81 @@
+#include "Turbulence.hpp"
+#include "CounterRng.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace falconsim {
+
+namespace {
+
+using counter_rng::kTwoPi;
+using counter_rng::mix;
+using counter_rng::unitInterval;
+
+constexpr double kFeet{0.3048}; // m per ft
+
+} // namespace
+
+void DrydenTurbulence::whiteNoise(std::uint64_t seed, std::uint64_t step, double noise[3]) noexcept {
+    const std::uint64_t key{counter_rng::streamKey(seed, step)};
+    
+    // Two Box-Muller pairs; the fourth normal is not needed
+    const double radius0{std::sqrt(-2.0 * std::log(unitInterval(mix(key))))};
+    const double angle0{kTwoPi * unitInterval(mix(key + 1))};
+    const double radius1{std::sqrt(-2.0 * std::log(unitInterval(mix(key + 2))))};
+    const double angle1{kTwoPi * unitInterval(mix(key + 3))};
+    noise[0] = radius0 * std::cos(angle0);
+    noise[1] = radius0 * std::sin(angle0);
+    noise[2] = radius1 * std::cos(angle1);
+}
+
+void DrydenTurbulence::filter(const TurbulenceParameters& parameters, double altitude, double airspeed, double dt,
+                              const double noise[3], double gust[3]) noexcept {
+    // MIL-F-8785C scales in feet; the low-altitude model is defined from 10 ft up
+    const double h{std::max(altitude / kFeet, 10.0)};
+    const double sigmaW{0.1 * parameters.wind_speed_20ft};
+    double lengths[3];
+    double sigmas[3];
+    if (h <= 1000.0) {
+        const double shape{0.177 + 0.000823 * h};
+        lengths[0] = lengths[1] = h / std::pow(shape, 1.2);
+        lengths[2] = h;
+        sigmas[0] = sigmas[1] = sigmaW / std::pow(shape, 0.4);
+    } else {
+        // Isotropic; L grows to 1750 ft by 2000 ft and the intensity keeps its 1000 ft value
+        lengths[0] = lengths[1] = lengths[2] = 1000.0 + 750.0 * std::min((h - 1000.0) / 1000.0, 1.0);
+        sigmas[0] = sigmas[1] = sigmaW;
+    }
+    sigmas[2] = sigmaW;
+    
+    // u and v always share a scale length, so two exponentials cover all three axes
+    const double distance{airspeed * dt / kFeet};
+    const double a[3]{std::exp(-distance / lengths[0]), 0.0, std::exp(-distance / lengths[2])};
+    for (int axis = 0; axis < 3; ++axis) {
+        const double decay{axis == 1 ? a[0] : a[axis]};
+        gust[axis] = decay * gust[axis] + sigmas[axis] * std::sqrt(1.0 - decay * decay) * noise[axis];
+    }
+}
+
+const double* DrydenTurbulence::advance(const TurbulenceParameters& parameters, double altitude, double airspeed,
+                                        double dt) noexcept {
+    // Refill when the step leaves the block (the unsigned difference also catches rewinds)
+    if (!m_blockValid || m_blockSeed != parameters.seed || m_step - m_blockStart >= kBlockSteps) {
+        m_blockStart = m_step - m_step % kBlockSteps;
+        m_blockSeed = parameters.seed;
+        for (std::size_t k = 0; k < kBlockSteps; ++k) {
+            whiteNoise(m_blockSeed, m_blockStart + k, m_noise[k]);
+        }
+        m_blockValid = true;
+    }
+    
+    filter(parameters, altitude, airspeed, dt, m_noise[m_step - m_blockStart], m_gust);
+    ++m_step;
+    return m_gust;
+}
+
+void DrydenTurbulence::setState(const double gust[3], std::uint64_t step) noexcept {
+    std::copy(gust, gust + 3, m_gust);
+    m_step = step;
+}
+
+} // namespace falconsim
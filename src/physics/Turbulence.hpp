@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace falconsim {
+
+/**
+ * @brief Dryden turbulence settings
+ */
+struct TurbulenceParameters {
+    double wind_speed_20ft{0.0}; // Mean wind 6.1 m (20 ft) above ground (m/s); sets the intensity, 0 = off
+    std::uint64_t seed{0};       // Noise stream; equal seeds give identical gusts
+};
+
+/**
+ * @brief Dryden gust model for one aircraft
+ *
+ * Each body axis is a first-order Markov process, the exact discretization
+ * of a Dryden forming filter (the MIL-F-8785C discrete form):
+ *
+ *     x[k+1] = a x[k] + σ √(1 - a²) n[k],   a = exp(-V dt / L)
+ *
+ * with airspeed V and unit white noise n. Scale lengths L and intensities σ
+ * follow the MIL-F-8785C low-altitude model below 1000 ft; above 2000 ft
+ * turbulence is isotropic with L = 1750 ft, and the two are blended between.
+ *
+ * The noise is counter based: n[k] is a hash of the seed and the step
+ * number k, so a gust sequence depends on nothing but (seed, k). Restoring
+ * a step counter reproduces it exactly, vehicles of a fleet can be stepped
+ * from any thread in any order, and noise is cheap to produce for a whole
+ * block of steps or vehicles at once.
+ */
+class DrydenTurbulence {
+public:
+    // Steps of noise generated per refill
+    static constexpr std::size_t kBlockSteps{64};
+    
+    // Unit white noise for one step of one stream, one value per body axis
+    static void whiteNoise(std::uint64_t seed, std::uint64_t step, double noise[3]) noexcept;
+    
+    // Advance gust (body frame, m/s) by one step driven by noise
+    static void filter(const TurbulenceParameters& parameters, double altitude, double airspeed, double dt,
+                       const double noise[3], double gust[3]) noexcept;
+    
+    // Advance one step at altitude (m) and airspeed (m/s); returns the new body-frame gust
+    const double* advance(const TurbulenceParameters& parameters, double altitude, double airspeed, double dt) noexcept;
+    
+    // Filter state, for snapshots
+    [[nodiscard]] const double* getGust() const { return m_gust; }
+    [[nodiscard]] std::uint64_t getStep() const { return m_step; }
+    void setState(const double gust[3], std::uint64_t step) noexcept;
+
+private:
+    double m_gust[3]{};
+    std::uint64_t m_step{0};
+    
+    // Noise for steps [m_blockStart, m_blockStart + kBlockSteps) of m_blockSeed
+    double m_noise[kBlockSteps][3]{};
+    std::uint64_t m_blockStart{0};
+    std::uint64_t m_blockSeed{0};
+    bool m_blockValid{false};
+};
+
+} // namespace falconsim
@@ -0,0 +1,328 @@
+#include "WindField.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FALCONSIM_HAS_MMAP 1
+#endif
+
+namespace falconsim {
+
+namespace {
+
+/**
+ * @brief Wind field file layout (host byte order)
+ *
+ *   header   4096 bytes  magic "FSWIND", version, grid spec; pads the bricks to a page boundary
+ *   bricks               slice-major, then north, east and down brick index; kBrickFloats floats each
+ */
+constexpr char kFileMagic[8]{'F', 'S', 'W', 'I', 'N', 'D', 0, 0};
+constexpr std::uint32_t kFileVersion{1};
+constexpr std::size_t kFileHeaderSize{4096};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t brickNodes;
+    std::uint64_t nodes[3];
+    std::uint64_t slices;
+    double origin[3];
+    double spacing[3];
+    double sliceInterval;
+    std::uint8_t reserved[kFileHeaderSize - 104];
+};
+static_assert(sizeof(FileHeader) == kFileHeaderSize, "Wind field header must stay one page");
+
+// Cells covered by one brick along an axis; the last node is shared with the next brick
+constexpr std::size_t kBrickCells{WindField::kBrickNodes - 1};
+
+void validateSpec(const WindGridSpec& spec) {
+    for (int axis = 0; axis < 3; ++axis) {
+        if (spec.nodes[axis] < 2) {
+            throw std::invalid_argument{"Wind field needs at least two nodes along every axis"};
+        }
+        if (!(spec.spacing[axis] > 0.0)) {
+            throw std::invalid_argument{"Wind field spacing must be positive"};
+        }
+    }
+    if (spec.slices < 1) {
+        throw std::invalid_argument{"Wind field needs at least one time slice"};
+    }
+    if (spec.slices > 1 && !(spec.slice_interval > 0.0)) {
+        throw std::invalid_argument{"Wind field slice interval must be positive"};
+    }
+}
+
+// Cell of a grid coordinate and the position within it, clamped to the grid
+std::size_t gridCell(double coordinate, std::size_t nodes, double& fraction) {
+    coordinate = std::min(std::max(coordinate, 0.0), static_cast<double>(nodes - 1));
+    const std::size_t cell{std::min(static_cast<std::size_t>(coordinate), nodes - 2)};
+    fraction = coordinate - static_cast<double>(cell);
+    return cell;
+}
+
+#if defined(FALCONSIM_HAS_MMAP)
+[[noreturn]] void throwSystemError(const std::string& what, const std::string& path) {
+    throw std::runtime_error{what + " " + path + ": " + std::strerror(errno)};
+}
+#endif
+
+} // namespace
+
+WindField::WindField(const WindGridSpec& spec)
+    : m_spec{spec} {
+    validateSpec(m_spec);
+    for (int axis = 0; axis < 3; ++axis) {
+        m_bricks[axis] = (m_spec.nodes[axis] - 2) / kBrickCells + 1;
+        m_inverseSpacing[axis] = 1.0 / m_spec.spacing[axis];
+    }
+    m_sliceFloats = m_bricks[0] * m_bricks[1] * m_bricks[2] * kBrickFloats;
+    m_inverseSliceInterval = m_spec.slices > 1 ? 1.0 / m_spec.slice_interval : 0.0;
+}
+
+WindField::WindField(const WindGridSpec& spec, const std::vector<float>& values)
+    : WindField{spec} {
+    const std::size_t nodes[3]{m_spec.nodes[0], m_spec.nodes[1], m_spec.nodes[2]};
+    const std::size_t sliceNodes{nodes[0] * nodes[1] * nodes[2]};
+    if (values.size() != sliceNodes * m_spec.slices * 3) {
+        throw std::invalid_argument{"Wind field has " + std::to_string(values.size()) + " values for " +
+                                    std::to_string(sliceNodes * m_spec.slices) + " nodes of 3 components"};
+    }
+    
+    // Bricks overlap by one node; nodes past the grid's far edge repeat the edge
+    m_storage.assign(m_sliceFloats * m_spec.slices, 0.0f);
+    for (std::size_t slice = 0; slice < m_spec.slices; ++slice) {
+        float* brick{m_storage.data() + slice * m_sliceFloats};
+        for (std::size_t bn = 0; bn < m_bricks[0]; ++bn) {
+            for (std::size_t be = 0; be < m_bricks[1]; ++be) {
+                for (std::size_t bd = 0; bd < m_bricks[2]; ++bd, brick += kBrickFloats) {
+                    float* node{brick};
+                    for (std::size_t n = 0; n < kBrickNodes; ++n) {
+                        const std::size_t gn{std::min(bn * kBrickCells + n, nodes[0] - 1)};
+                        for (std::size_t e = 0; e < kBrickNodes; ++e) {
+                            const std::size_t ge{std::min(be * kBrickCells + e, nodes[1] - 1)};
+                            for (std::size_t d = 0; d < kBrickNodes; ++d, node += kNodeWidth) {
+                                const std::size_t gd{std::min(bd * kBrickCells + d, nodes[2] - 1)};
+                                const float* source{values.data() +
+                                                    (((slice * nodes[0] + gn) * nodes[1] + ge) * nodes[2] + gd) * 3};
+                                std::copy(source, source + 3, node);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    m_data = m_storage.data();
+}
+
+WindField::~WindField() {
+#if defined(FALCONSIM_HAS_MMAP)
+    if (m_mapping) {
+        ::munmap(m_mapping, m_mappingSize);
+    }
+#endif
+}
+
+std::shared_ptr<const WindField> WindField::open(const std::string& path, std::uint64_t offset) {
+    // Header first, read normally; the bricks are mapped, not read
+    FileHeader header{};
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            throw std::runtime_error{"Cannot open wind field " + path};
+        }
+        if (!file.seekg(static_cast<std::streamoff>(offset)) ||
+            !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+            header.version != kFileVersion || header.brickNodes != kBrickNodes) {
+            throw std::runtime_error{path + " is not a wind field file"};
+        }
+    }
+    
+    WindGridSpec spec;
+    for (int axis = 0; axis < 3; ++axis) {
+        spec.nodes[axis] = static_cast<std::size_t>(header.nodes[axis]);
+        spec.origin[axis] = header.origin[axis];
+        spec.spacing[axis] = header.spacing[axis];
+    }
+    spec.slices = static_cast<std::size_t>(header.slices);
+    spec.slice_interval = header.sliceInterval;
+    
+    std::shared_ptr<WindField> field;
+    try {
+        field.reset(new WindField{spec});
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error{"Wind field " + path + ": " + e.what()};
+    }
+    const std::size_t dataBytes{field->m_sliceFloats * spec.slices * sizeof(float)};
+
+#if defined(FALCONSIM_HAS_MMAP)
+    const int fd{::open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+        throwSystemError("Cannot open wind field", path);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < offset + kFileHeaderSize + dataBytes) {
+        ::close(fd);
+        throw std::runtime_error{"Wind field " + path + " is truncated"};
+    }
+    
+    // Mappings start on a page; an embedded image need not
+    const std::uint64_t page{static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE))};
+    const std::size_t lead{static_cast<std::size_t>(offset % page)};
+    const std::size_t mappingSize{lead + kFileHeaderSize + dataBytes};
+    void* mapping{::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(offset - lead))};
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throwSystemError("Failed to map wind field", path);
+    }
+    
+    // Aircraft touch a scattered handful of bricks; read-ahead would only pull in neighbours nobody samples
+    ::madvise(mapping, mappingSize, MADV_RANDOM);
+    field->m_mapping = mapping;
+    field->m_mappingSize = mappingSize;
+    field->m_data = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + lead + kFileHeaderSize);
+#else
+    std::ifstream file{path, std::ios::binary};
+    field->m_storage.resize(dataBytes / sizeof(float));
+    if (!file.seekg(static_cast<std::streamoff>(offset + kFileHeaderSize)) ||
+        !file.read(reinterpret_cast<char*>(field->m_storage.data()), static_cast<std::streamsize>(dataBytes))) {
+        throw std::runtime_error{"Wind field " + path + " is truncated"};
+    }
+    field->m_data = field->m_storage.data();
+#endif
+    return field;
+}
+
+void WindField::save(const std::string& path) const {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (file) {
+        save(file);
+    }
+    if (!file.flush()) {
+        throw std::runtime_error{"Failed to write wind field " + path};
+    }
+}
+
+void WindField::save(std::ostream& out) const {
+    // The caller checks the stream
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.brickNodes = kBrickNodes;
+    for (int axis = 0; axis < 3; ++axis) {
+        header.nodes[axis] = m_spec.nodes[axis];
+        header.origin[axis] = m_spec.origin[axis];
+        header.spacing[axis] = m_spec.spacing[axis];
+    }
+    header.slices = m_spec.slices;
+    header.sliceInterval = m_spec.slice_interval;
+    
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(m_data),
+              static_cast<std::streamsize>(m_sliceFloats * m_spec.slices * sizeof(float)));
+}
+
+std::size_t WindField::getFileSize() const {
+    return kFileHeaderSize + m_sliceFloats * m_spec.slices * sizeof(float);
+}
+
+void WindField::locate(double north, double east, double down, double time, const float* corners[2],
+                       double fractions[4]) const noexcept {
+    const double position[3]{north, east, down};
+    std::size_t brick{0};
+    std::size_t node{0};
+    for (int axis = 0; axis < 3; ++axis) {
+        const double coordinate{(position[axis] - m_spec.origin[axis]) * m_inverseSpacing[axis]};
+        const std::size_t cell{gridCell(coordinate, m_spec.nodes[axis], fractions[axis])};
+        const std::size_t brickIndex{cell / kBrickCells};
+        brick = brick * m_bricks[axis] + brickIndex;
+        node = node * kBrickNodes + (cell - brickIndex * kBrickCells);
+    }
+    
+    // A single slice is constant in time: both corners read it
+    const float* first{m_data + brick * kBrickFloats + node * kNodeWidth};
+    if (m_spec.slices == 1) {
+        corners[0] = corners[1] = first;
+        fractions[3] = 0.0;
+        return;
+    }
+    const std::size_t slice{gridCell(time * m_inverseSliceInterval, m_spec.slices, fractions[3])};
+    corners[0] = first + slice * m_sliceFloats;
+    corners[1] = corners[0] + m_sliceFloats;
+}
+
+void WindField::sample(double north, double east, double down, double time, double wind[3]) const noexcept {
+    const float* corners[2];
+    double fractions[4];
+    locate(north, east, down, time, corners, fractions);
+    
+    // Corner strides inside a brick: down is one node, east a row, north a plane
+    constexpr std::size_t kDown{kNodeWidth};
+    constexpr std::size_t kEast{kBrickNodes * kNodeWidth};
+    constexpr std::size_t kNorth{kBrickNodes * kBrickNodes * kNodeWidth};
+    const auto lerp = [](double a, double b, double t) { return a + (b - a) * t; };
+    
+    double slices[2][3];
+    for (int s = 0; s < 2; ++s) {
+        const float* c{corners[s]};
+        for (std::size_t k = 0; k < 3; ++k) {
+            const double c00{lerp(c[k], c[kDown + k], fractions[2])};
+            const double c01{lerp(c[kEast + k], c[kEast + kDown + k], fractions[2])};
+            const double c10{lerp(c[kNorth + k], c[kNorth + kDown + k], fractions[2])};
+            const double c11{lerp(c[kNorth + kEast + k], c[kNorth + kEast + kDown + k], fractions[2])};
+            slices[s][k] = lerp(lerp(c00, c01, fractions[1]), lerp(c10, c11, fractions[1]), fractions[0]);
+        }
+    }
+    for (std::size_t k = 0; k < 3; ++k) {
+        wind[k] = lerp(slices[0][k], slices[1][k], fractions[3]);
+    }
+}
+
+void WindField::prefetch(double north, double east, double down, double time) const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    const float* corners[2];
+    double fractions[4];
+    locate(north, east, down, time, corners, fractions);
+    
+    // Four down-adjacent node pairs per slice; a pair may straddle two lines
+    constexpr std::size_t kEast{kBrickNodes * kNodeWidth};
+    constexpr std::size_t kNorth{kBrickNodes * kBrickNodes * kNodeWidth};
+    for (const float* corner : corners) {
+        for (std::size_t offset : {std::size_t{0}, kEast, kNorth, kNorth + kEast}) {
+            __builtin_prefetch(corner + offset, 0, 1);
+            __builtin_prefetch(corner + offset + 2 * kNodeWidth - 1, 0, 1);
+        }
+    }
+#else
+    (void)north;
+    (void)east;
+    (void)down;
+    (void)time;
+#endif
+}
+
+const WindGridSpec& WindField::getSpec() const {
+    return m_spec;
+}
+
+std::size_t WindField::getBrickCount() const {
+    return m_bricks[0] * m_bricks[1] * m_bricks[2] * m_spec.slices;
+}
+
+bool WindField::isMapped() const {
+    return m_mapping != nullptr;
+}
+
+} // namespace falconsim
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Geometry of a gridded wind field
+ */
+struct WindGridSpec {
+    std::size_t nodes[3]{2, 2, 2};          // Node counts along north, east and down (at least 2 each)
+    std::size_t slices{1};                  // Time slices (at least 1)
+    double origin[3]{0.0, 0.0, 0.0};        // NED position of the first node (m)
+    double spacing[3]{100.0, 100.0, 100.0}; // Node spacing along north, east and down (m)
+    double slice_interval{60.0};            // Time between slices (s)
+};
+
+/**
+ * @brief Shared, immutable 4D wind field (NED wind over space and time)
+ *
+ * Nodes are stored in bricks of 8 x 8 x 8, each node a 16-byte
+ * (north, east, down, padding) float vector, so one brick is 8 KiB: two
+ * pages. Neighbouring bricks repeat their shared face, which puts all eight
+ * corners of any cell in a single brick. A sample therefore touches at most
+ * four cache lines of one brick per time slice, wherever the aircraft is.
+ * sample() interpolates trilinearly in space and linearly in time and
+ * clamps to the grid's bounds. prefetch() pulls in the lines a later sample
+ * at a position will need.
+ *
+ * save() writes the bricked layout to disk as is. open() maps such a file
+ * read-only, so a weather dataset of any size costs neither startup time
+ * nor resident memory until aircraft fly through it; only the bricks
+ * actually sampled are ever paged in. One instance, held through
+ * std::shared_ptr<const WindField>, serves any number of aircraft threads.
+ */
+class WindField {
+public:
+    static constexpr std::size_t kBrickNodes{8}; // Nodes per brick edge
+    
+    // values holds north, east and down wind (m/s) for every node, ordered by
+    // slice, then north, east and down index; throws std::invalid_argument on a bad spec or size
+    WindField(const WindGridSpec& spec, const std::vector<float>& values);
+    ~WindField();
+    
+    // Deleted copy and move operations
+    WindField(const WindField&) = delete;
+    WindField& operator=(const WindField&) = delete;
+    WindField(WindField&&) = delete;
+    WindField& operator=(WindField&&) = delete;
+    
+    // Map a file written by save(), or such an image embedded in a larger file at offset
+    // bytes in (throws std::runtime_error)
+    [[nodiscard]] static std::shared_ptr<const WindField> open(const std::string& path, std::uint64_t offset = 0);
+    
+    // Write the field in its bricked layout (throws std::runtime_error; the stream form leaves errors in the stream)
+    void save(const std::string& path) const;
+    void save(std::ostream& out) const;
+    [[nodiscard]] std::size_t getFileSize() const; // Bytes save() writes
+    
+    // NED wind (m/s) at a NED position (m) and time (s); outside the grid the edge value holds
+    void sample(double north, double east, double down, double time, double wind[3]) const noexcept;
+    
+    // Hint that sample() will soon be called near this position and time
+    void prefetch(double north, double east, double down, double time) const noexcept;
+    
+    [[nodiscard]] const WindGridSpec& getSpec() const;
+    [[nodiscard]] std::size_t getBrickCount() const;
+    [[nodiscard]] bool isMapped() const; // Backed by a file mapping rather than memory of its own
+
+private:
+    static constexpr std::size_t kNodeWidth{4}; // North, east, down, padding
+    static constexpr std::size_t kBrickFloats{kBrickNodes * kBrickNodes * kBrickNodes * kNodeWidth};
+    
+    explicit WindField(const WindGridSpec& spec);
+    
+    // First float of the cell containing a position, in each of the two bracketing slices
+    void locate(double north, double east, double down, double time, const float* corners[2],
+                double fractions[4]) const noexcept;
+    
+    WindGridSpec m_spec{};
+    std::size_t m_bricks[3]{};       // Bricks along north, east and down
+    std::size_t m_sliceFloats{0};    // Floats per time slice
+    double m_inverseSpacing[3]{};
+    double m_inverseSliceInterval{0.0};
+    
+    // Brick data: m_storage for in-memory fields, or a read-only file mapping
+    AlignedVector<float> m_storage{};
+    const float* m_data{nullptr};
+    void* m_mapping{nullptr};
+    std::size_t m_mappingSize{0};
+};
+
+} // namespace falconsim
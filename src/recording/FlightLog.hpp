@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../physics/FlightDynamics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Flight log file layout (host byte order; all supported hosts are little-endian)
+ *
+ *   file header   64 bytes  magic "FSLOG", version, column count, chunk capacity
+ *   chunk 0..n-1            a ChunkHeader, then kColumnCount columns of `count` doubles each
+ *   chunk index             one IndexEntry per chunk
+ *   footer        24 bytes  magic, chunk count, offset of the chunk index
+ *
+ * Columns hold one value per physics step, so scanning a single signal
+ * (say, altitude over an hour) touches only that column's pages. Chunk
+ * headers carry their first and last timestamp, which together with the
+ * index makes a timestamp seek two binary searches. A log whose recorder
+ * died before writing the footer is still readable: the reader rebuilds the
+ * index by walking the chunk headers.
+ */
+namespace flight_log {
+
+constexpr char kFileMagic[8]{'F', 'S', 'L', 'O', 'G', 0, 0, 0};
+constexpr std::uint32_t kVersion{1};
+constexpr std::uint32_t kChunkMagic{0x4B435346}; // "FSCK"
+constexpr std::uint32_t kIndexMagic{0x58495346}; // "FSIX"
+constexpr std::size_t kFileHeaderSize{64};
+constexpr std::size_t kDefaultChunkRecords{4096};
+
+/**
+ * @brief Recorded signals, in column order
+ */
+enum class Column : std::size_t {
+    SimTime,
+    PositionNorth, PositionEast, PositionDown,
+    VelocityX, VelocityY, VelocityZ,
+    Roll, Pitch, Yaw,
+    RollRate, PitchRate, YawRate,
+    Mass,
+    Throttle, Aileron, Elevator, Rudder
+};
+constexpr std::size_t kColumnCount{18};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columnCount;
+    std::uint32_t chunkRecords; // Capacity of a full chunk
+    std::uint8_t reserved[kFileHeaderSize - 20];
+};
+static_assert(sizeof(FileHeader) == kFileHeaderSize, "Flight log header must stay 64 bytes");
+
+struct ChunkHeader {
+    std::uint32_t magic;
+    std::uint32_t count;      // Records in this chunk
+    std::uint64_t firstIndex; // Index of its first record in the log
+    double firstTime;
+    double lastTime;
+};
+static_assert(sizeof(ChunkHeader) == 32, "Chunk header must stay 32 bytes");
+
+struct IndexEntry {
+    std::uint64_t offset; // File offset of the ChunkHeader
+    std::uint64_t firstIndex;
+    double firstTime;
+    double lastTime;
+};
+static_assert(sizeof(IndexEntry) == 32, "Index entry must stay 32 bytes");
+
+struct Footer {
+    std::uint32_t magic;
+    std::uint32_t reserved;
+    std::uint64_t chunkCount;
+    std::uint64_t indexOffset;
+};
+static_assert(sizeof(Footer) == 24, "Footer must stay 24 bytes");
+
+// Size of a chunk holding `count` records
+constexpr std::size_t chunkSize(std::size_t count) {
+    return sizeof(ChunkHeader) + kColumnCount * count * sizeof(double);
+}
+
+} // namespace flight_log
+
+/**
+ * @brief One recorded physics step
+ */
+struct FlightLogRecord {
+    double sim_time{0.0};
+    AircraftState state{};
+    ControlInputs controls{};
+};
+
+} // namespace falconsim
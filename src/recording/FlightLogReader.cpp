@@ -0,0 +1,225 @@
+#include "FlightLogReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FALCONSIM_HAS_MMAP 1
+#endif
+
+namespace falconsim {
+
+FlightLogReader::FlightLogReader(const std::string& path) {
+#if defined(FALCONSIM_HAS_MMAP)
+    const int fd{::open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+        throw std::runtime_error{"Failed to open flight log " + path + ": " + std::strerror(errno)};
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < flight_log::kFileHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error{"Not a flight log: " + path};
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    void* data{::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0)};
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error{"Failed to map flight log " + path + ": " + std::strerror(errno)};
+    }
+    m_data = static_cast<const unsigned char*>(data);
+    
+    // Scrubbing jumps around; don't let the kernel read ahead whole chunks we skip
+    ::madvise(data, m_size, MADV_RANDOM);
+#else
+    throw std::runtime_error{"Memory-mapped flight log replay is not supported on this platform"};
+#endif
+
+    flight_log::FileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, flight_log::kFileMagic, sizeof(header.magic)) != 0 ||
+        header.version != flight_log::kVersion || header.columnCount != flight_log::kColumnCount) {
+#if defined(FALCONSIM_HAS_MMAP)
+        ::munmap(data, m_size);
+#endif
+        m_data = nullptr;
+        throw std::runtime_error{"Not a flight log: " + path};
+    }
+    
+    loadIndex();
+    m_records = m_index.empty() ? 0 : m_index.back().firstIndex + chunkHeader(m_index.size() - 1).count;
+}
+
+FlightLogReader::~FlightLogReader() {
+#if defined(FALCONSIM_HAS_MMAP)
+    if (m_data) {
+        ::munmap(const_cast<unsigned char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+#endif
+}
+
+void FlightLogReader::loadIndex() {
+    // A complete log ends with a footer pointing at the chunk index
+    if (m_size >= flight_log::kFileHeaderSize + sizeof(flight_log::Footer)) {
+        flight_log::Footer footer;
+        const std::size_t footerOffset{m_size - sizeof(footer)};
+        std::memcpy(&footer, m_data + footerOffset, sizeof(footer));
+        if (footer.magic == flight_log::kIndexMagic && footer.indexOffset >= flight_log::kFileHeaderSize &&
+            footer.indexOffset <= footerOffset &&
+            footer.chunkCount == (footerOffset - footer.indexOffset) / sizeof(flight_log::IndexEntry) &&
+            (footerOffset - footer.indexOffset) % sizeof(flight_log::IndexEntry) == 0) {
+            m_index.resize(footer.chunkCount);
+            if (!m_index.empty()) {
+                std::memcpy(m_index.data(), m_data + footer.indexOffset,
+                            m_index.size() * sizeof(flight_log::IndexEntry));
+            }
+            if (indexIsValid(footer.indexOffset)) {
+                return;
+            }
+            m_index.clear();
+        }
+    }
+    rebuildIndex();
+}
+
+bool FlightLogReader::indexIsValid(std::uint64_t indexOffset) const {
+    // Every entry must point at a whole chunk before the index, in record order,
+    // as everything else dereferences m_data + offset unchecked
+    std::uint64_t records{0};
+    for (const flight_log::IndexEntry& entry : m_index) {
+        if (entry.offset < flight_log::kFileHeaderSize || entry.offset % sizeof(double) != 0 ||
+            entry.offset > indexOffset || indexOffset - entry.offset < sizeof(flight_log::ChunkHeader)) {
+            return false;
+        }
+        flight_log::ChunkHeader header;
+        std::memcpy(&header, m_data + entry.offset, sizeof(header));
+        const std::uint64_t room{indexOffset - entry.offset - sizeof(flight_log::ChunkHeader)};
+        if (header.magic != flight_log::kChunkMagic || header.count == 0 ||
+            header.count > room / (flight_log::kColumnCount * sizeof(double)) ||
+            header.firstIndex != records || entry.firstIndex != records) {
+            return false;
+        }
+        records += header.count;
+    }
+    return true;
+}
+
+void FlightLogReader::rebuildIndex() {
+    // Walk the chunk headers; a torn final chunk is ignored
+    m_recovered = true;
+    std::size_t offset{flight_log::kFileHeaderSize};
+    std::uint64_t records{0};
+    while (offset + sizeof(flight_log::ChunkHeader) <= m_size) {
+        flight_log::ChunkHeader header;
+        std::memcpy(&header, m_data + offset, sizeof(header));
+        if (header.magic != flight_log::kChunkMagic || header.count == 0 || header.firstIndex != records ||
+            offset + flight_log::chunkSize(header.count) > m_size) {
+            break;
+        }
+        m_index.push_back(flight_log::IndexEntry{offset, header.firstIndex, header.firstTime, header.lastTime});
+        records += header.count;
+        offset += flight_log::chunkSize(header.count);
+    }
+}
+
+const flight_log::ChunkHeader& FlightLogReader::chunkHeader(std::size_t chunk) const {
+    return *reinterpret_cast<const flight_log::ChunkHeader*>(m_data + m_index[chunk].offset);
+}
+
+std::size_t FlightLogReader::size() const {
+    return m_records;
+}
+
+bool FlightLogReader::empty() const {
+    return m_records == 0;
+}
+
+double FlightLogReader::getStartTime() const {
+    return m_index.empty() ? 0.0 : m_index.front().firstTime;
+}
+
+double FlightLogReader::getEndTime() const {
+    return m_index.empty() ? 0.0 : m_index.back().lastTime;
+}
+
+std::size_t FlightLogReader::getChunkCount() const {
+    return m_index.size();
+}
+
+bool FlightLogReader::wasRecovered() const {
+    return m_recovered;
+}
+
+const double* FlightLogReader::column(std::size_t chunk, flight_log::Column column, std::size_t& count) const {
+    if (chunk >= m_index.size()) {
+        throw std::out_of_range{"Flight log chunk out of range"};
+    }
+    count = chunkHeader(chunk).count;
+    
+    // Chunks are a multiple of 8 bytes from a page-aligned base, so columns are double-aligned
+    const unsigned char* columns{m_data + m_index[chunk].offset + sizeof(flight_log::ChunkHeader)};
+    return reinterpret_cast<const double*>(columns) + static_cast<std::size_t>(column) * count;
+}
+
+std::size_t FlightLogReader::chunkFor(std::size_t index) const {
+    // Last chunk whose first record is at or before index
+    auto it = std::upper_bound(m_index.begin(), m_index.end(), static_cast<std::uint64_t>(index),
+                               [](std::uint64_t value, const flight_log::IndexEntry& entry) {
+                                   return value < entry.firstIndex;
+                               });
+    return static_cast<std::size_t>(it - m_index.begin()) - 1;
+}
+
+FlightLogRecord FlightLogReader::at(std::size_t index) const {
+    if (index >= m_records) {
+        throw std::out_of_range{"Flight log record out of range"};
+    }
+    const std::size_t chunk{chunkFor(index)};
+    const std::size_t row{index - static_cast<std::size_t>(m_index[chunk].firstIndex)};
+    
+    std::size_t count;
+    const double* columns{column(chunk, flight_log::Column::SimTime, count)};
+    const auto value = [columns, count, row](flight_log::Column c) {
+        return columns[static_cast<std::size_t>(c) * count + row];
+    };
+    
+    using flight_log::Column;
+    FlightLogRecord record;
+    record.sim_time = value(Column::SimTime);
+    record.state.position = Eigen::Vector3d(value(Column::PositionNorth), value(Column::PositionEast),
+                                            value(Column::PositionDown));
+    record.state.velocity = Eigen::Vector3d(value(Column::VelocityX), value(Column::VelocityY),
+                                            value(Column::VelocityZ));
+    record.state.euler_angles = Eigen::Vector3d(value(Column::Roll), value(Column::Pitch), value(Column::Yaw));
+    record.state.angular_velocity = Eigen::Vector3d(value(Column::RollRate), value(Column::PitchRate),
+                                                    value(Column::YawRate));
+    record.state.mass = value(Column::Mass);
+    record.controls.throttle = value(Column::Throttle);
+    record.controls.aileron = value(Column::Aileron);
+    record.controls.elevator = value(Column::Elevator);
+    record.controls.rudder = value(Column::Rudder);
+    return record;
+}
+
+std::size_t FlightLogReader::seek(double time) const {
+    // First chunk that ends at or after time...
+    auto entry = std::lower_bound(m_index.begin(), m_index.end(), time,
+                                  [](const flight_log::IndexEntry& e, double t) { return e.lastTime < t; });
+    if (entry == m_index.end()) {
+        return m_records;
+    }
+    
+    // ...then the first record in it at or after time
+    const std::size_t chunk{static_cast<std::size_t>(entry - m_index.begin())};
+    std::size_t count;
+    const double* times{column(chunk, flight_log::Column::SimTime, count)};
+    const double* row{std::lower_bound(times, times + count, time)};
+    return static_cast<std::size_t>(entry->firstIndex) + static_cast<std::size_t>(row - times);
+}
+
+} // namespace falconsim
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FlightLog.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Random access to a flight log through a read-only memory map
+ *
+ * Nothing is loaded up front beyond the chunk index (32 bytes per chunk),
+ * so multi-hour logs open instantly and only the pages that are actually
+ * read become resident. seek() finds the chunk covering a timestamp by
+ * binary search over the index, then the record inside it by binary search
+ * over that chunk's time column.
+ */
+class FlightLogReader {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is not a flight log
+    explicit FlightLogReader(const std::string& path);
+    ~FlightLogReader();
+    
+    FlightLogReader(const FlightLogReader&) = delete;
+    FlightLogReader& operator=(const FlightLogReader&) = delete;
+    FlightLogReader(FlightLogReader&&) = delete;
+    FlightLogReader& operator=(FlightLogReader&&) = delete;
+    
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] double getStartTime() const;
+    [[nodiscard]] double getEndTime() const;
+    [[nodiscard]] std::size_t getChunkCount() const;
+    [[nodiscard]] bool wasRecovered() const; // True if the footer or index was missing or corrupt and the index was rebuilt
+    
+    // Record by position (throws std::out_of_range)
+    [[nodiscard]] FlightLogRecord at(std::size_t index) const;
+    
+    // Position of the first record at or after `time`; size() if there is none
+    [[nodiscard]] std::size_t seek(double time) const;
+    
+    // One signal of one chunk, straight from the mapping
+    [[nodiscard]] const double* column(std::size_t chunk, flight_log::Column column, std::size_t& count) const;
+
+private:
+    [[nodiscard]] std::size_t chunkFor(std::size_t index) const;
+    [[nodiscard]] const flight_log::ChunkHeader& chunkHeader(std::size_t chunk) const;
+    void loadIndex();
+    void rebuildIndex();
+    [[nodiscard]] bool indexIsValid(std::uint64_t indexOffset) const;
+    
+    const unsigned char* m_data{nullptr};
+    std::size_t m_size{0};
+    std::vector<flight_log::IndexEntry> m_index{};
+    std::size_t m_records{0};
+    bool m_recovered{false};
+};
+
+} // namespace falconsim
@@ -0,0 +1,169 @@
+#include "FlightRecorder.hpp"
+#include "../core/Trace.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace falconsim {
+
+FlightRecorder::FlightRecorder(const std::string& path, std::size_t chunkRecords, std::size_t bufferCount)
+    : m_chunkRecords{std::max<std::size_t>(1, chunkRecords)}
+    , m_free{std::max<std::size_t>(2, bufferCount)}
+    , m_full{std::max<std::size_t>(2, bufferCount)} {
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        throw std::runtime_error{"Failed to create flight log " + path + ": " + std::strerror(errno)};
+    }
+    
+    // Preallocate the whole pool up front; record() never allocates
+    m_buffers.resize(std::max<std::size_t>(2, bufferCount));
+    for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+        m_buffers[i].columns.assign(flight_log::kColumnCount * m_chunkRecords, 0.0);
+        m_free.tryPush(i);
+    }
+    
+    flight_log::FileHeader header{};
+    std::memcpy(header.magic, flight_log::kFileMagic, sizeof(header.magic));
+    header.version = flight_log::kVersion;
+    header.columnCount = static_cast<std::uint32_t>(flight_log::kColumnCount);
+    header.chunkRecords = static_cast<std::uint32_t>(m_chunkRecords);
+    writeBytes(&header, sizeof(header));
+    
+    m_writer = std::thread{&FlightRecorder::writerLoop, this};
+}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+void FlightRecorder::record(const AircraftState& state, const ControlInputs& controls, double simTime) {
+    if (m_closed) {
+        return;
+    }
+    if (m_current == kNoBuffer && !m_free.tryPop(m_current)) {
+        m_current = kNoBuffer;
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    Buffer& buffer{m_buffers[m_current]};
+    const double values[flight_log::kColumnCount]{
+        simTime,
+        state.position.x(), state.position.y(), state.position.z(),
+        state.velocity.x(), state.velocity.y(), state.velocity.z(),
+        state.euler_angles.x(), state.euler_angles.y(), state.euler_angles.z(),
+        state.angular_velocity.x(), state.angular_velocity.y(), state.angular_velocity.z(),
+        state.mass,
+        controls.throttle, controls.aileron, controls.elevator, controls.rudder};
+    for (std::size_t column = 0; column < flight_log::kColumnCount; ++column) {
+        buffer.columns[column * m_chunkRecords + buffer.count] = values[column];
+    }
+    ++buffer.count;
+    m_recorded.fetch_add(1, std::memory_order_relaxed);
+    
+    if (buffer.count == m_chunkRecords) {
+        submitCurrent();
+    }
+}
+
+void FlightRecorder::submitCurrent() {
+    // The full queue can hold every buffer, so this push cannot fail
+    m_full.tryPush(m_current);
+    m_current = kNoBuffer;
+    m_wake.notify_one();
+}
+
+void FlightRecorder::close() {
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+    
+    if (m_current != kNoBuffer && m_buffers[m_current].count > 0) {
+        submitCurrent();
+    }
+    m_closing = true;
+    m_wake.notify_one();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    
+    // Chunk index and footer, so readers can seek without scanning
+    const flight_log::Footer footer{flight_log::kIndexMagic, 0, m_index.size(), m_offset};
+    if (!m_index.empty()) {
+        writeBytes(m_index.data(), m_index.size() * sizeof(flight_log::IndexEntry));
+    }
+    writeBytes(&footer, sizeof(footer));
+    
+    if (std::fclose(m_file) != 0) {
+        m_writeErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_file = nullptr;
+}
+
+void FlightRecorder::writerLoop() {
+    FALCONSIM_TRACE_THREAD_NAME("recorder");
+    for (;;) {
+        // Read the flag first: buffers submitted before close() are queued by then
+        const bool closing{m_closing.load()};
+        
+        std::size_t index;
+        while (m_full.tryPop(index)) {
+            writeChunk(m_buffers[index]);
+            m_buffers[index].count = 0;
+            m_free.tryPush(index);
+        }
+        if (closing) {
+            return;
+        }
+        
+        // Timed wait: a notify that races the check above costs at most one period
+        std::unique_lock<std::mutex> lock{m_wakeMutex};
+        m_wake.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void FlightRecorder::writeChunk(const Buffer& buffer) {
+    FALCONSIM_TRACE_ZONE("FlightRecorder::writeChunk");
+    const std::size_t count{buffer.count};
+    const double* times{buffer.columns.data()};
+    
+    const flight_log::ChunkHeader header{flight_log::kChunkMagic, static_cast<std::uint32_t>(count), m_written,
+                                         times[0], times[count - 1]};
+    m_index.push_back(flight_log::IndexEntry{m_offset, m_written, header.firstTime, header.lastTime});
+    
+    writeBytes(&header, sizeof(header));
+    for (std::size_t column = 0; column < flight_log::kColumnCount; ++column) {
+        writeBytes(buffer.columns.data() + column * m_chunkRecords, count * sizeof(double));
+    }
+    
+    m_written += count;
+    m_chunksWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlightRecorder::writeBytes(const void* data, std::size_t size) {
+    if (std::fwrite(data, 1, size, m_file) != size) {
+        m_writeErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_offset += size;
+}
+
+std::uint64_t FlightRecorder::getRecorded() const {
+    return m_recorded.load(std::memory_order_relaxed);
+}
+
+std::uint64_t FlightRecorder::getDropped() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+std::uint64_t FlightRecorder::getChunksWritten() const {
+    return m_chunksWritten.load(std::memory_order_relaxed);
+}
+
+std::uint64_t FlightRecorder::getWriteErrors() const {
+    return m_writeErrors.load(std::memory_order_relaxed);
+}
+
+} // namespace falconsim
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FlightLog.hpp"
+#include "../core/BoundedQueue.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Appends every physics step to a columnar, chunked flight log
+ *
+ * record() fills a preallocated column buffer in place. A full buffer goes
+ * to a background writer thread, and the producer carries on with the next
+ * free buffer. The producer never blocks, allocates or touches the disk,
+ * so record() can run as a Simulation step observer. If the disk falls so
+ * far behind that every buffer is queued, records are dropped and counted
+ * rather than stalling the physics.
+ *
+ * record() and close() form a single producer: call them from one thread.
+ */
+class FlightRecorder {
+public:
+    // Throws std::runtime_error if the file cannot be created
+    explicit FlightRecorder(const std::string& path,
+                            std::size_t chunkRecords = flight_log::kDefaultChunkRecords,
+                            std::size_t bufferCount = 4);
+    ~FlightRecorder();
+    
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    FlightRecorder(FlightRecorder&&) = delete;
+    FlightRecorder& operator=(FlightRecorder&&) = delete;
+    
+    // Append one step (signature of Simulation::StepObserver)
+    void record(const AircraftState& state, const ControlInputs& controls, double simTime);
+    
+    // Flush the partial chunk, write the chunk index and close the file (idempotent)
+    void close();
+    
+    // Statistics
+    [[nodiscard]] std::uint64_t getRecorded() const;      // Records accepted by record()
+    [[nodiscard]] std::uint64_t getDropped() const;       // Records lost because every buffer was queued
+    [[nodiscard]] std::uint64_t getChunksWritten() const;
+    [[nodiscard]] std::uint64_t getWriteErrors() const;
+
+private:
+    /**
+     * @brief One chunk's worth of columns
+     */
+    struct Buffer {
+        std::vector<double> columns{}; // kColumnCount runs of chunkRecords values
+        std::size_t count{0};
+    };
+    static constexpr std::size_t kNoBuffer{static_cast<std::size_t>(-1)};
+    
+    void writerLoop();
+    void writeChunk(const Buffer& buffer);
+    void writeBytes(const void* data, std::size_t size);
+    void submitCurrent();
+    
+    std::FILE* m_file{nullptr};
+    std::size_t m_chunkRecords{0};
+    
+    // Buffer pool: indices cycle producer -> m_full -> writer -> m_free -> producer
+    std::vector<Buffer> m_buffers{};
+    BoundedQueue<std::size_t> m_free;
+    BoundedQueue<std::size_t> m_full;
+    std::size_t m_current{kNoBuffer}; // Producer only
+    
+    // Writer thread state
+    std::vector<flight_log::IndexEntry> m_index{};
+    std::uint64_t m_offset{0};
+    std::uint64_t m_written{0};
+    std::thread m_writer{};
+    std::mutex m_wakeMutex{};
+    std::condition_variable m_wake{};
+    std::atomic<bool> m_closing{false};
+    bool m_closed{false};
+    
+    // Statistics
+    std::atomic<std::uint64_t> m_recorded{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+    std::atomic<std::uint64_t> m_chunksWritten{0};
+    std::atomic<std::uint64_t> m_writeErrors{0};
+};
+
+} // namespace falconsim
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../physics/Airframe.hpp"
+#include "../physics/FleetDynamics.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Scenario bundle file layout (host byte order; all supported hosts are little-endian)
+ *
+ *   file header      4096 bytes  magic "FSSCENE", version, counts, environment, section offsets
+ *   airframes                    one AirframeRecord per aircraft type
+ *   vehicle columns              kFleetInputColumnCount columns of `vehicles` doubles, in FleetInputColumn
+ *                                order, then one u32 airframe index per vehicle
+ *   asset directory              one AssetEntry per asset
+ *   assets                       aero tables, and wind fields as a WindField file image on a page boundary
+ *
+ * Sections start on a cache line. The vehicle columns are the layout
+ * FleetDynamics keeps, so loading a fleet is one copy per column.
+ * Assets are only located through the directory, so a reader decodes a
+ * table or maps a wind field when it is first asked for. An aero table
+ * asset holds four u32 breakpoint counts (alpha, beta, Mach, deflection),
+ * the breakpoints as doubles, then CL, CD and Cm per node in AeroTable
+ * constructor order.
+ */
+namespace scenario_bundle {
+
+constexpr char kFileMagic[8]{'F', 'S', 'S', 'C', 'E', 'N', 'E', 0};
+constexpr std::uint32_t kVersion{1};
+constexpr std::size_t kFileHeaderSize{4096};
+constexpr std::size_t kSectionAlignment{64};
+constexpr std::size_t kPageAlignment{4096};
+constexpr std::uint32_t kNoAsset{0xFFFFFFFF};
+
+enum class AssetKind : std::uint32_t {
+    AeroTable = 1,
+    WindField = 2
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t inputColumns;   // kFleetInputColumnCount
+    std::uint64_t vehicleCount;
+    std::uint64_t airframeCount;
+    std::uint64_t assetCount;
+    std::uint64_t airframeOffset;
+    std::uint64_t vehicleOffset;
+    std::uint64_t assetOffset;    // Asset directory
+    double airDensity;
+    double wind[3];
+    double turbulenceWindSpeed;
+    std::uint64_t turbulenceSeed;
+    std::uint32_t windField;      // Asset index, or kNoAsset
+    std::uint8_t reserved[kFileHeaderSize - 116];
+};
+static_assert(sizeof(FileHeader) == kFileHeaderSize, "Scenario bundle header must stay one page");
+
+struct AirframeRecord {
+    double mass;
+    double inertia[3];
+    double dimensions[3];
+    double thrustMax;
+    double wingArea;
+    double liftCoefficient;
+    double dragCoefficient;
+    std::uint32_t aeroTable;      // Asset index, or kNoAsset
+    std::uint32_t reserved;
+};
+static_assert(sizeof(AirframeRecord) == 96, "Scenario airframe record must stay 96 bytes");
+
+struct AssetEntry {
+    std::uint32_t kind;           // AssetKind
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+static_assert(sizeof(AssetEntry) == 24, "Scenario asset entry must stay 24 bytes");
+
+// Bytes of the vehicle column section
+constexpr std::size_t vehicleSectionSize(std::size_t vehicles) {
+    return kFleetInputColumnCount * vehicles * sizeof(double) + vehicles * sizeof(std::uint32_t);
+}
+
+constexpr std::uint64_t alignUp(std::uint64_t offset, std::uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace scenario_bundle
+
+/**
+ * @brief One aircraft type of a scenario
+ */
+struct ScenarioAirframe {
+    UAVPhysicalProperties properties{};                  // Its mass is every vehicle's mass
+    double wing_area{SmallUavAirframe::wing_area};       // m²
+    double lift_coefficient{1.2};                        // Used without an aero table
+    double drag_coefficient{0.1};
+    std::uint32_t aero_table{scenario_bundle::kNoAsset}; // Asset index of its AeroTable, or none
+};
+
+/**
+ * @brief Fleet-wide settings of a scenario
+ */
+struct ScenarioEnvironment {
+    double air_density{1.225};                           // kg/m³
+    double wind[3]{0.0, 0.0, 0.0};                       // Steady NED wind (m/s)
+    TurbulenceParameters turbulence{};
+    std::uint32_t wind_field{scenario_bundle::kNoAsset}; // Asset index of the gridded wind, or none
+};
+
+} // namespace falconsim
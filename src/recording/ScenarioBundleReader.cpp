@@ -0,0 +1,311 @@
+#include "ScenarioBundleReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FALCONSIM_HAS_MMAP 1
+#endif
+
+namespace falconsim {
+
+namespace {
+
+using scenario_bundle::AssetEntry;
+using scenario_bundle::AssetKind;
+
+// True if [offset, offset + size) lies within a file of fileSize bytes
+bool fits(std::uint64_t offset, std::uint64_t size, std::uint64_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+} // namespace
+
+ScenarioBundleReader::ScenarioBundleReader(const std::string& path)
+    : m_path{path} {
+#if defined(FALCONSIM_HAS_MMAP)
+    const int fd{::open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+        throw std::runtime_error{"Failed to open scenario bundle " + path + ": " + std::strerror(errno)};
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < scenario_bundle::kFileHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error{"Not a scenario bundle: " + path};
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    void* data{::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0)};
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error{"Failed to map scenario bundle " + path + ": " + std::strerror(errno)};
+    }
+    m_data = static_cast<const unsigned char*>(data);
+#else
+    throw std::runtime_error{"Memory-mapped scenario bundles are not supported on this platform"};
+#endif
+
+    // Everything the accessors index is checked once here
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+    const std::uint64_t vehicles{m_header.vehicleCount};
+    const bool valid{
+        std::memcmp(m_header.magic, scenario_bundle::kFileMagic, sizeof(m_header.magic)) == 0 &&
+        m_header.version == scenario_bundle::kVersion && m_header.inputColumns == kFleetInputColumnCount &&
+        m_header.vehicleOffset % sizeof(double) == 0 && m_header.airframeOffset % sizeof(double) == 0 &&
+        m_header.assetOffset % sizeof(std::uint64_t) == 0 &&
+        m_header.airframeCount <= m_size / sizeof(scenario_bundle::AirframeRecord) &&
+        vehicles <= m_size / sizeof(double) && m_header.assetCount <= m_size / sizeof(AssetEntry) &&
+        fits(m_header.airframeOffset, m_header.airframeCount * sizeof(scenario_bundle::AirframeRecord), m_size) &&
+        fits(m_header.vehicleOffset, scenario_bundle::vehicleSectionSize(vehicles), m_size) &&
+        fits(m_header.assetOffset, m_header.assetCount * sizeof(AssetEntry), m_size)};
+    if (valid) {
+        m_airframes = reinterpret_cast<const scenario_bundle::AirframeRecord*>(m_data + m_header.airframeOffset);
+        m_vehicleAirframes = reinterpret_cast<const std::uint32_t*>(
+            m_data + m_header.vehicleOffset + kFleetInputColumnCount * vehicles * sizeof(double));
+        m_assets = reinterpret_cast<const AssetEntry*>(m_data + m_header.assetOffset);
+    }
+    const auto validAirframes = [this] {
+        for (std::size_t i = 0; i < m_header.vehicleCount; ++i) {
+            if (m_vehicleAirframes[i] >= m_header.airframeCount) {
+                return false;
+            }
+        }
+        return true;
+    };
+    const auto validAssets = [this] {
+        for (std::size_t i = 0; i < m_header.assetCount; ++i) {
+            if (!fits(m_assets[i].offset, m_assets[i].size, m_size)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!valid || !validAirframes() || !validAssets()) {
+#if defined(FALCONSIM_HAS_MMAP)
+        ::munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        throw std::runtime_error{"Not a scenario bundle: " + path};
+    }
+    
+    m_environment.air_density = m_header.airDensity;
+    std::copy(std::begin(m_header.wind), std::end(m_header.wind), m_environment.wind);
+    m_environment.turbulence.wind_speed_20ft = m_header.turbulenceWindSpeed;
+    m_environment.turbulence.seed = m_header.turbulenceSeed;
+    m_environment.wind_field = m_header.windField;
+    m_aeroTables.resize(m_header.assetCount);
+    m_windFields.resize(m_header.assetCount);
+}
+
+ScenarioBundleReader::~ScenarioBundleReader() {
+#if defined(FALCONSIM_HAS_MMAP)
+    if (m_data) {
+        ::munmap(const_cast<unsigned char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+#endif
+}
+
+std::size_t ScenarioBundleReader::size() const {
+    return static_cast<std::size_t>(m_header.vehicleCount);
+}
+
+std::size_t ScenarioBundleReader::getAirframeCount() const {
+    return static_cast<std::size_t>(m_header.airframeCount);
+}
+
+std::size_t ScenarioBundleReader::getAssetCount() const {
+    return static_cast<std::size_t>(m_header.assetCount);
+}
+
+const ScenarioEnvironment& ScenarioBundleReader::getEnvironment() const {
+    return m_environment;
+}
+
+ScenarioAirframe ScenarioBundleReader::getAirframe(std::size_t airframe) const {
+    if (airframe >= getAirframeCount()) {
+        throw std::out_of_range{"Scenario airframe index out of range"};
+    }
+    const scenario_bundle::AirframeRecord& record{m_airframes[airframe]};
+    ScenarioAirframe result;
+    result.properties.mass = record.mass;
+    result.properties.inertia = Eigen::Vector3d{record.inertia[0], record.inertia[1], record.inertia[2]};
+    result.properties.dimensions = Eigen::Vector3d{record.dimensions[0], record.dimensions[1], record.dimensions[2]};
+    result.properties.thrust_max = record.thrustMax;
+    result.wing_area = record.wingArea;
+    result.lift_coefficient = record.liftCoefficient;
+    result.drag_coefficient = record.dragCoefficient;
+    result.aero_table = record.aeroTable;
+    return result;
+}
+
+void ScenarioBundleReader::checkVehicle(std::size_t vehicle) const {
+    if (vehicle >= size()) {
+        throw std::out_of_range{"Scenario vehicle index out of range"};
+    }
+}
+
+const double* ScenarioBundleReader::column(FleetInputColumn column) const {
+    return reinterpret_cast<const double*>(m_data + m_header.vehicleOffset) +
+           static_cast<std::size_t>(column) * size();
+}
+
+std::uint32_t ScenarioBundleReader::getVehicleAirframe(std::size_t vehicle) const {
+    checkVehicle(vehicle);
+    return m_vehicleAirframes[vehicle];
+}
+
+AircraftState ScenarioBundleReader::getState(std::size_t vehicle) const {
+    checkVehicle(vehicle);
+    const auto value = [this, vehicle](FleetInputColumn c) { return column(c)[vehicle]; };
+    AircraftState state;
+    state.position = Eigen::Vector3d{value(FleetInputColumn::North), value(FleetInputColumn::East),
+                                     value(FleetInputColumn::Down)};
+    state.velocity = Eigen::Vector3d{value(FleetInputColumn::VelocityU), value(FleetInputColumn::VelocityV),
+                                     value(FleetInputColumn::VelocityW)};
+    state.euler_angles = Eigen::Vector3d{value(FleetInputColumn::Roll), value(FleetInputColumn::Pitch),
+                                         value(FleetInputColumn::Yaw)};
+    state.angular_velocity = Eigen::Vector3d{value(FleetInputColumn::RateP), value(FleetInputColumn::RateQ),
+                                             value(FleetInputColumn::RateR)};
+    state.mass = value(FleetInputColumn::Mass);
+    return state;
+}
+
+ControlInputs ScenarioBundleReader::getControls(std::size_t vehicle) const {
+    checkVehicle(vehicle);
+    ControlInputs controls;
+    controls.throttle = column(FleetInputColumn::Throttle)[vehicle];
+    controls.aileron = column(FleetInputColumn::Aileron)[vehicle];
+    controls.elevator = column(FleetInputColumn::Elevator)[vehicle];
+    controls.rudder = column(FleetInputColumn::Rudder)[vehicle];
+    return controls;
+}
+
+const AssetEntry& ScenarioBundleReader::assetEntry(std::uint32_t asset, AssetKind kind) const {
+    if (asset >= getAssetCount() || m_assets[asset].kind != static_cast<std::uint32_t>(kind)) {
+        throw std::out_of_range{"Scenario bundle has no such asset"};
+    }
+    return m_assets[asset];
+}
+
+std::shared_ptr<const AeroTable> ScenarioBundleReader::getAeroTable(std::uint32_t asset) const {
+    const AssetEntry& entry{assetEntry(asset, AssetKind::AeroTable)};
+    std::lock_guard<std::mutex> lock{m_assetMutex};
+    if (!m_aeroTables[asset]) {
+        m_aeroTables[asset] = decodeAeroTable(entry);
+        m_loadedAssets.fetch_add(1, std::memory_order_relaxed);
+    }
+    return m_aeroTables[asset];
+}
+
+std::shared_ptr<const WindField> ScenarioBundleReader::getWindField(std::uint32_t asset) const {
+    const AssetEntry& entry{assetEntry(asset, AssetKind::WindField)};
+    std::lock_guard<std::mutex> lock{m_assetMutex};
+    if (!m_windFields[asset]) {
+        // A mapping of its own, so the field outlives this reader
+        m_windFields[asset] = WindField::open(m_path, entry.offset);
+        m_loadedAssets.fetch_add(1, std::memory_order_relaxed);
+    }
+    return m_windFields[asset];
+}
+
+std::size_t ScenarioBundleReader::getLoadedAssetCount() const {
+    return m_loadedAssets.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<const AeroTable> ScenarioBundleReader::decodeAeroTable(const AssetEntry& entry) const {
+    const unsigned char* payload{m_data + entry.offset};
+    const auto malformed = [this] { return std::runtime_error{"Malformed aero table in scenario bundle " + m_path}; };
+    if (entry.size < 4 * sizeof(std::uint32_t)) {
+        throw malformed();
+    }
+    
+    std::uint32_t counts[AeroTable::kDimensions];
+    std::memcpy(counts, payload, sizeof(counts));
+    std::uint64_t breakpoints{0};
+    std::uint64_t nodes{1};
+    for (std::uint32_t count : counts) {
+        breakpoints += count;
+        nodes *= count;
+        if (nodes > entry.size) {
+            throw malformed();
+        }
+    }
+    if (sizeof(counts) + (breakpoints + 3 * nodes) * sizeof(double) != entry.size) {
+        throw malformed();
+    }
+    
+    const unsigned char* cursor{payload + sizeof(counts)};
+    AeroTableAxes axes;
+    std::vector<double>* const targets[AeroTable::kDimensions]{&axes.alpha, &axes.beta, &axes.mach, &axes.deflection};
+    for (std::size_t d = 0; d < AeroTable::kDimensions; ++d) {
+        targets[d]->resize(counts[d]);
+        std::memcpy(targets[d]->data(), cursor, counts[d] * sizeof(double));
+        cursor += counts[d] * sizeof(double);
+    }
+    std::vector<AeroCoefficients> values(static_cast<std::size_t>(nodes));
+    for (AeroCoefficients& node : values) {
+        double coefficients[3];
+        std::memcpy(coefficients, cursor, sizeof(coefficients));
+        cursor += sizeof(coefficients);
+        node = AeroCoefficients{coefficients[0], coefficients[1], coefficients[2]};
+    }
+    
+    try {
+        return std::make_shared<const AeroTable>(std::move(axes), values);
+    } catch (const std::invalid_argument&) {
+        throw malformed();
+    }
+}
+
+std::size_t ScenarioBundleReader::buildFleet(FleetDynamics& fleet) const {
+    const double* columns[kFleetInputColumnCount];
+    for (std::size_t c = 0; c < kFleetInputColumnCount; ++c) {
+        columns[c] = column(static_cast<FleetInputColumn>(c));
+    }
+    const std::size_t first{fleet.addVehicles(columns, size())};
+    
+    // Airframes are few: resolve each once, its table only if a vehicle uses it
+    std::vector<ScenarioAirframe> airframes;
+    std::vector<std::shared_ptr<const AeroTable>> tables(getAirframeCount());
+    std::vector<bool> resolved(getAirframeCount(), false);
+    airframes.reserve(getAirframeCount());
+    for (std::size_t a = 0; a < getAirframeCount(); ++a) {
+        airframes.push_back(getAirframe(a));
+    }
+    for (std::size_t vehicle = 0; vehicle < size(); ++vehicle) {
+        const std::uint32_t a{m_vehicleAirframes[vehicle]};
+        const ScenarioAirframe& airframe{airframes[a]};
+        if (!resolved[a]) {
+            resolved[a] = true;
+            if (airframe.aero_table != scenario_bundle::kNoAsset) {
+                tables[a] = getAeroTable(airframe.aero_table);
+            }
+        }
+        
+        const std::size_t index{first + vehicle};
+        fleet.setProperties(index, airframe.properties);
+        fleet.setWingspanArea(index, airframe.wing_area);
+        fleet.setLiftCoefficient(index, airframe.lift_coefficient);
+        fleet.setDragCoefficient(index, airframe.drag_coefficient);
+        if (tables[a]) {
+            fleet.setAeroTable(index, tables[a]);
+        }
+    }
+    
+    fleet.setAirDensity(m_environment.air_density);
+    fleet.setWind(Eigen::Vector3d{m_environment.wind[0], m_environment.wind[1], m_environment.wind[2]});
+    fleet.setTurbulence(m_environment.turbulence);
+    if (m_environment.wind_field != scenario_bundle::kNoAsset) {
+        fleet.setWindField(getWindField(m_environment.wind_field));
+    }
+    return first;
+}
+
+} // namespace falconsim
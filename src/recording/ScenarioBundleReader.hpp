@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ScenarioBundle.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Starts a scenario straight from a memory-mapped bundle file
+ *
+ * Opening maps the file and checks the header and section bounds; nothing
+ * else is read. buildFleet() appends every vehicle to a FleetDynamics with
+ * one bulk copy per column out of the mapping, then applies each vehicle's
+ * airframe, so a fleet of any size costs a handful of allocations and no
+ * per-vehicle objects.
+ *
+ * Assets load on first use and are cached: an aero table is decoded the
+ * first time a vehicle of its airframe is built or getAeroTable() asks for
+ * it, and a wind field is mapped, not read, so only the bricks aircraft
+ * fly through are ever paged in. Tables and fields outlive the reader.
+ *
+ * Reading vehicles and airframes is safe from any thread, and so is asset
+ * access; buildFleet() is as thread-safe as the fleet it fills.
+ */
+class ScenarioBundleReader {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is not a valid bundle
+    explicit ScenarioBundleReader(const std::string& path);
+    ~ScenarioBundleReader();
+    
+    // Deleted copy and move operations (mapping and asset cache)
+    ScenarioBundleReader(const ScenarioBundleReader&) = delete;
+    ScenarioBundleReader& operator=(const ScenarioBundleReader&) = delete;
+    ScenarioBundleReader(ScenarioBundleReader&&) = delete;
+    ScenarioBundleReader& operator=(ScenarioBundleReader&&) = delete;
+    
+    [[nodiscard]] std::size_t size() const; // Vehicles
+    [[nodiscard]] std::size_t getAirframeCount() const;
+    [[nodiscard]] std::size_t getAssetCount() const;
+    [[nodiscard]] const ScenarioEnvironment& getEnvironment() const;
+    
+    // By index (throw std::out_of_range)
+    [[nodiscard]] ScenarioAirframe getAirframe(std::size_t airframe) const;
+    [[nodiscard]] std::uint32_t getVehicleAirframe(std::size_t vehicle) const;
+    [[nodiscard]] AircraftState getState(std::size_t vehicle) const;
+    [[nodiscard]] ControlInputs getControls(std::size_t vehicle) const;
+    
+    // Assets, loaded on first call (throw std::out_of_range for a missing asset of that kind,
+    // std::runtime_error for a malformed one)
+    [[nodiscard]] std::shared_ptr<const AeroTable> getAeroTable(std::uint32_t asset) const;
+    [[nodiscard]] std::shared_ptr<const WindField> getWindField(std::uint32_t asset) const;
+    [[nodiscard]] std::size_t getLoadedAssetCount() const;
+    
+    // Append every vehicle to fleet and give it the scenario's environment; returns the first new index
+    std::size_t buildFleet(FleetDynamics& fleet) const;
+
+private:
+    [[nodiscard]] const scenario_bundle::AssetEntry& assetEntry(std::uint32_t asset,
+                                                               scenario_bundle::AssetKind kind) const;
+    [[nodiscard]] std::shared_ptr<const AeroTable> decodeAeroTable(const scenario_bundle::AssetEntry& entry) const;
+    [[nodiscard]] const double* column(FleetInputColumn column) const;
+    void checkVehicle(std::size_t vehicle) const;
+    
+    std::string m_path{};
+    const unsigned char* m_data{nullptr};
+    std::size_t m_size{0};
+    scenario_bundle::FileHeader m_header{};
+    ScenarioEnvironment m_environment{};
+    const scenario_bundle::AirframeRecord* m_airframes{nullptr};
+    const std::uint32_t* m_vehicleAirframes{nullptr};
+    const scenario_bundle::AssetEntry* m_assets{nullptr};
+    
+    // Asset cache, one slot per asset
+    mutable std::mutex m_assetMutex{};
+    mutable std::vector<std::shared_ptr<const AeroTable>> m_aeroTables{};
+    mutable std::vector<std::shared_ptr<const WindField>> m_windFields{};
+    mutable std::atomic<std::size_t> m_loadedAssets{0};
+};
+
+} // namespace falconsim
@@ -0,0 +1,200 @@
+#include "ScenarioBundleWriter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace falconsim {
+
+namespace {
+
+using scenario_bundle::alignUp;
+using scenario_bundle::AssetKind;
+
+// Bytes of an aero table asset
+std::size_t aeroTableSize(const AeroTable& table) {
+    const AeroTableAxes& axes{table.getAxes()};
+    const std::size_t breakpoints{axes.alpha.size() + axes.beta.size() + axes.mach.size() + axes.deflection.size()};
+    return 4 * sizeof(std::uint32_t) + (breakpoints + 3 * table.getNodeCount()) * sizeof(double);
+}
+
+void writeAeroTable(std::ostream& out, const AeroTable& table) {
+    const AeroTableAxes& axes{table.getAxes()};
+    const std::vector<double>* const breakpoints[]{&axes.alpha, &axes.beta, &axes.mach, &axes.deflection};
+    for (const auto* axis : breakpoints) {
+        const auto count = static_cast<std::uint32_t>(axis->size());
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    for (const auto* axis : breakpoints) {
+        out.write(reinterpret_cast<const char*>(axis->data()), static_cast<std::streamsize>(axis->size() * sizeof(double)));
+    }
+    for (std::size_t node = 0; node < table.getNodeCount(); ++node) {
+        const AeroCoefficients coefficients{table.getNode(node)};
+        const double values[3]{coefficients.lift, coefficients.drag, coefficients.pitch_moment};
+        out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    }
+}
+
+// Zero-fill up to an absolute offset
+void padTo(std::ostream& out, std::uint64_t offset) {
+    static const char zeros[scenario_bundle::kPageAlignment]{};
+    for (auto position = static_cast<std::uint64_t>(out.tellp()); position < offset;) {
+        const std::uint64_t chunk{std::min<std::uint64_t>(offset - position, sizeof(zeros))};
+        out.write(zeros, static_cast<std::streamsize>(chunk));
+        position += chunk;
+    }
+}
+
+} // namespace
+
+std::uint32_t ScenarioBundleWriter::addAeroTable(std::shared_ptr<const AeroTable> table) {
+    if (!table) {
+        throw std::invalid_argument{"Scenario aero table must not be null"};
+    }
+    m_assets.push_back(Asset{AssetKind::AeroTable, std::move(table), nullptr});
+    return static_cast<std::uint32_t>(m_assets.size() - 1);
+}
+
+std::uint32_t ScenarioBundleWriter::addWindField(std::shared_ptr<const WindField> field) {
+    if (!field) {
+        throw std::invalid_argument{"Scenario wind field must not be null"};
+    }
+    m_assets.push_back(Asset{AssetKind::WindField, nullptr, std::move(field)});
+    return static_cast<std::uint32_t>(m_assets.size() - 1);
+}
+
+bool ScenarioBundleWriter::isAsset(std::uint32_t asset, AssetKind kind) const {
+    return asset < m_assets.size() && m_assets[asset].kind == kind;
+}
+
+std::uint32_t ScenarioBundleWriter::addAirframe(const ScenarioAirframe& airframe) {
+    if (airframe.aero_table != scenario_bundle::kNoAsset && !isAsset(airframe.aero_table, AssetKind::AeroTable)) {
+        throw std::invalid_argument{"Scenario airframe refers to a missing aero table"};
+    }
+    m_airframes.push_back(airframe);
+    return static_cast<std::uint32_t>(m_airframes.size() - 1);
+}
+
+void ScenarioBundleWriter::setEnvironment(const ScenarioEnvironment& environment) {
+    if (environment.wind_field != scenario_bundle::kNoAsset && !isAsset(environment.wind_field, AssetKind::WindField)) {
+        throw std::invalid_argument{"Scenario environment refers to a missing wind field"};
+    }
+    m_environment = environment;
+}
+
+void ScenarioBundleWriter::addVehicle(std::uint32_t airframe, const AircraftState& state, const ControlInputs& controls) {
+    if (airframe >= m_airframes.size()) {
+        throw std::out_of_range{"Scenario airframe index out of range"};
+    }
+    const double values[kFleetInputColumnCount]{
+        state.position.x(), state.position.y(), state.position.z(),
+        state.velocity.x(), state.velocity.y(), state.velocity.z(),
+        state.euler_angles.x(), state.euler_angles.y(), state.euler_angles.z(),
+        state.angular_velocity.x(), state.angular_velocity.y(), state.angular_velocity.z(),
+        m_airframes[airframe].properties.mass,
+        controls.throttle, controls.aileron, controls.elevator, controls.rudder};
+    for (std::size_t column = 0; column < kFleetInputColumnCount; ++column) {
+        m_columns[column].push_back(values[column]);
+    }
+    m_vehicleAirframes.push_back(airframe);
+}
+
+void ScenarioBundleWriter::reserve(std::size_t vehicles) {
+    for (auto& column : m_columns) {
+        column.reserve(vehicles);
+    }
+    m_vehicleAirframes.reserve(vehicles);
+}
+
+std::size_t ScenarioBundleWriter::size() const {
+    return m_vehicleAirframes.size();
+}
+
+std::size_t ScenarioBundleWriter::getAirframeCount() const {
+    return m_airframes.size();
+}
+
+std::size_t ScenarioBundleWriter::getAssetCount() const {
+    return m_assets.size();
+}
+
+void ScenarioBundleWriter::write(const std::string& path) const {
+    using namespace scenario_bundle;
+    const std::size_t vehicles{size()};
+    
+    // Lay out every section before writing any of it
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.inputColumns = static_cast<std::uint32_t>(kFleetInputColumnCount);
+    header.vehicleCount = vehicles;
+    header.airframeCount = m_airframes.size();
+    header.assetCount = m_assets.size();
+    header.airframeOffset = kFileHeaderSize;
+    header.vehicleOffset = alignUp(header.airframeOffset + m_airframes.size() * sizeof(AirframeRecord), kSectionAlignment);
+    header.assetOffset = alignUp(header.vehicleOffset + vehicleSectionSize(vehicles), kSectionAlignment);
+    header.airDensity = m_environment.air_density;
+    std::copy(std::begin(m_environment.wind), std::end(m_environment.wind), header.wind);
+    header.turbulenceWindSpeed = m_environment.turbulence.wind_speed_20ft;
+    header.turbulenceSeed = m_environment.turbulence.seed;
+    header.windField = m_environment.wind_field;
+    
+    std::vector<AssetEntry> directory(m_assets.size());
+    std::uint64_t offset{header.assetOffset + m_assets.size() * sizeof(AssetEntry)};
+    for (std::size_t i = 0; i < m_assets.size(); ++i) {
+        const bool field{m_assets[i].kind == AssetKind::WindField};
+        directory[i].kind = static_cast<std::uint32_t>(m_assets[i].kind);
+        directory[i].offset = alignUp(offset, field ? kPageAlignment : kSectionAlignment);
+        directory[i].size = field ? m_assets[i].field->getFileSize() : aeroTableSize(*m_assets[i].table);
+        offset = directory[i].offset + directory[i].size;
+    }
+    
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out) {
+        throw std::runtime_error{"Failed to create scenario bundle " + path};
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    for (const ScenarioAirframe& airframe : m_airframes) {
+        const UAVPhysicalProperties& properties{airframe.properties};
+        AirframeRecord record{};
+        record.mass = properties.mass;
+        for (int axis = 0; axis < 3; ++axis) {
+            record.inertia[axis] = properties.inertia[axis];
+            record.dimensions[axis] = properties.dimensions[axis];
+        }
+        record.thrustMax = properties.thrust_max;
+        record.wingArea = airframe.wing_area;
+        record.liftCoefficient = airframe.lift_coefficient;
+        record.dragCoefficient = airframe.drag_coefficient;
+        record.aeroTable = airframe.aero_table;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    
+    padTo(out, header.vehicleOffset);
+    for (const auto& column : m_columns) {
+        out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(vehicles * sizeof(double)));
+    }
+    out.write(reinterpret_cast<const char*>(m_vehicleAirframes.data()),
+              static_cast<std::streamsize>(vehicles * sizeof(std::uint32_t)));
+    
+    padTo(out, header.assetOffset);
+    out.write(reinterpret_cast<const char*>(directory.data()),
+              static_cast<std::streamsize>(directory.size() * sizeof(AssetEntry)));
+    for (std::size_t i = 0; i < m_assets.size(); ++i) {
+        padTo(out, directory[i].offset);
+        if (m_assets[i].kind == AssetKind::WindField) {
+            m_assets[i].field->save(out);
+        } else {
+            writeAeroTable(out, *m_assets[i].table);
+        }
+    }
+    
+    if (!out.flush()) {
+        throw std::runtime_error{"Failed to write scenario bundle " + path};
+    }
+}
+
+} // namespace falconsim
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ScenarioBundle.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Compiles a scenario into a bundle file for ScenarioBundleReader
+ *
+ * Collects aircraft types, vehicles, aero tables and wind fields in memory,
+ * already in the bundle's column layout, and writes them in one go. Assets
+ * are added first; airframes and the environment refer to them by the
+ * index add*() returned. Tables and fields are written by value, so the
+ * bundle does not depend on the files they were first loaded from.
+ */
+class ScenarioBundleWriter {
+public:
+    ScenarioBundleWriter() = default;
+    
+    // Assets; each returns its asset index
+    std::uint32_t addAeroTable(std::shared_ptr<const AeroTable> table);
+    std::uint32_t addWindField(std::shared_ptr<const WindField> field);
+    
+    // Aircraft types (throws std::invalid_argument if aero_table is set but not an aero table asset)
+    std::uint32_t addAirframe(const ScenarioAirframe& airframe);
+    
+    // Throws std::invalid_argument if wind_field is set but not a wind field asset
+    void setEnvironment(const ScenarioEnvironment& environment);
+    
+    // A vehicle of an aircraft type, whose mass it takes (throws std::out_of_range for an unknown airframe)
+    void addVehicle(std::uint32_t airframe, const AircraftState& state, const ControlInputs& controls = {});
+    void reserve(std::size_t vehicles);
+    
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t getAirframeCount() const;
+    [[nodiscard]] std::size_t getAssetCount() const;
+    
+    // Throws std::runtime_error if the file cannot be written
+    void write(const std::string& path) const;
+
+private:
+    struct Asset {
+        scenario_bundle::AssetKind kind{scenario_bundle::AssetKind::AeroTable};
+        std::shared_ptr<const AeroTable> table{};
+        std::shared_ptr<const WindField> field{};
+    };
+    
+    [[nodiscard]] bool isAsset(std::uint32_t asset, scenario_bundle::AssetKind kind) const;
+    
+    std::vector<Asset> m_assets{};
+    std::vector<ScenarioAirframe> m_airframes{};
+    ScenarioEnvironment m_environment{};
+    std::vector<double> m_columns[kFleetInputColumnCount]{};
+    std::vector<std::uint32_t> m_vehicleAirframes{};
+};
+
+} // namespace falconsim
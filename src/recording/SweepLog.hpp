@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../core/SweepRunner.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Sweep result file layout (host byte order; all supported hosts are little-endian)
+ *
+ *   file header   64 bytes  magic "FSSWEEP", version, column count, chunk capacity
+ *   chunk 0..n-1            a ChunkHeader, then kColumnCount columns of `count` 8-byte values each
+ *
+ * One row per sweep run, in the order runs finished, with the case index as
+ * the first column. Every column is 8 bytes wide: the first three hold
+ * unsigned integers and the rest the doubles of SweepMetric, so a metric
+ * over a million runs is one contiguous 8 MB read. There is no index, as
+ * sweep files are read front to back; a chunk cut short by a crash is
+ * ignored by the reader.
+ */
+namespace sweep_log {
+
+constexpr char kFileMagic[8]{'F', 'S', 'S', 'W', 'E', 'E', 'P', 0};
+constexpr std::uint32_t kVersion{1};
+constexpr std::uint32_t kChunkMagic{0x43535346}; // "FSSC"
+constexpr std::size_t kFileHeaderSize{64};
+constexpr std::size_t kDefaultChunkRecords{4096};
+
+/**
+ * @brief Columns ahead of the metrics
+ */
+enum class Column : std::size_t {
+    CaseIndex, // std::uint64_t
+    Steps,     // std::uint64_t
+    Outcome,   // std::uint64_t holding a SweepOutcome
+    FirstMetric // then one double column per SweepMetric, in order
+};
+constexpr std::size_t kColumnCount{static_cast<std::size_t>(Column::FirstMetric) + kSweepMetricCount};
+
+// Column holding a metric
+constexpr std::size_t metricColumn(SweepMetric metric) {
+    return static_cast<std::size_t>(Column::FirstMetric) + static_cast<std::size_t>(metric);
+}
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columnCount;
+    std::uint32_t chunkRecords; // Capacity of a full chunk
+    std::uint8_t reserved[kFileHeaderSize - 20];
+};
+static_assert(sizeof(FileHeader) == kFileHeaderSize, "Sweep file header must stay 64 bytes");
+
+struct ChunkHeader {
+    std::uint32_t magic;
+    std::uint32_t count;    // Rows in this chunk
+    std::uint64_t firstRow; // Row number of its first row in the file
+};
+static_assert(sizeof(ChunkHeader) == 16, "Sweep chunk header must stay 16 bytes");
+
+// Size of a chunk holding `count` rows
+constexpr std::size_t chunkSize(std::size_t count) {
+    return sizeof(ChunkHeader) + kColumnCount * count * 8;
+}
+
+} // namespace sweep_log
+
+} // namespace falconsim
@@ -0,0 +1,118 @@
+#include "SweepLogReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace falconsim {
+
+namespace {
+
+struct FileCloser {
+    void operator()(std::FILE* file) const {
+        std::fclose(file);
+    }
+};
+
+// Append count 8-byte values read from file; false on a short read
+template <typename T>
+bool readColumn(std::FILE* file, std::size_t count, std::vector<T>& column) {
+    static_assert(sizeof(T) == 8, "Sweep file columns are 8 bytes wide");
+    const std::size_t start{column.size()};
+    column.resize(start + count);
+    if (std::fread(column.data() + start, sizeof(T), count, file) != count) {
+        column.resize(start);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+SweepLogReader::SweepLogReader(const std::string& path) {
+    const std::unique_ptr<std::FILE, FileCloser> file{std::fopen(path.c_str(), "rb")};
+    if (!file) {
+        throw std::runtime_error{"Failed to open sweep file " + path + ": " + std::strerror(errno)};
+    }
+    
+    sweep_log::FileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file.get()) != 1 ||
+        std::memcmp(header.magic, sweep_log::kFileMagic, sizeof(header.magic)) != 0 ||
+        header.version != sweep_log::kVersion || header.columnCount != sweep_log::kColumnCount) {
+        throw std::runtime_error{"Not a sweep file: " + path};
+    }
+    
+    sweep_log::ChunkHeader chunk;
+    while (std::fread(&chunk, sizeof(chunk), 1, file.get()) == 1) {
+        if (chunk.magic != sweep_log::kChunkMagic || chunk.count == 0 || chunk.count > header.chunkRecords ||
+            chunk.firstRow != m_caseIndex.size()) {
+            m_truncated = true;
+            break;
+        }
+        
+        // Columns are all read before any is kept, so a cut-off chunk leaves no ragged rows
+        const std::size_t rows{m_caseIndex.size()};
+        bool complete{readColumn(file.get(), chunk.count, m_caseIndex) &&
+                      readColumn(file.get(), chunk.count, m_steps) &&
+                      readColumn(file.get(), chunk.count, m_outcome)};
+        for (std::size_t metric = 0; complete && metric < kSweepMetricCount; ++metric) {
+            complete = readColumn(file.get(), chunk.count, m_metrics[metric]);
+        }
+        
+        // An outcome that is not a SweepOutcome means the chunk is corrupt
+        complete = complete && std::all_of(m_outcome.begin() + static_cast<std::ptrdiff_t>(rows), m_outcome.end(),
+                                           [](std::uint64_t outcome) { return outcome < kSweepOutcomeCount; });
+        if (!complete) {
+            m_caseIndex.resize(rows);
+            m_steps.resize(rows);
+            m_outcome.resize(rows);
+            for (std::vector<double>& column : m_metrics) {
+                column.resize(rows);
+            }
+            m_truncated = true;
+            break;
+        }
+    }
+}
+
+std::size_t SweepLogReader::size() const {
+    return m_caseIndex.size();
+}
+
+bool SweepLogReader::wasTruncated() const {
+    return m_truncated;
+}
+
+SweepRunSummary SweepLogReader::at(std::size_t row) const {
+    if (row >= size()) {
+        throw std::out_of_range{"Sweep row out of range"};
+    }
+    SweepRunSummary run;
+    run.case_index = m_caseIndex[row];
+    run.steps = m_steps[row];
+    run.outcome = static_cast<SweepOutcome>(m_outcome[row]);
+    for (std::size_t metric = 0; metric < kSweepMetricCount; ++metric) {
+        run.metrics[metric] = m_metrics[metric][row];
+    }
+    return run;
+}
+
+const std::vector<std::uint64_t>& SweepLogReader::caseIndices() const {
+    return m_caseIndex;
+}
+
+const std::vector<double>& SweepLogReader::metric(SweepMetric metric) const {
+    return m_metrics[static_cast<std::size_t>(metric)];
+}
+
+SweepAggregate SweepLogReader::aggregate() const {
+    SweepAggregate aggregate;
+    for (std::size_t row = 0; row < size(); ++row) {
+        aggregate.add(at(row));
+    }
+    return aggregate;
+}
+
+} // namespace falconsim
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SweepLog.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Loads a sweep result file into one array per column
+ *
+ * A sweep file holds summaries, not trajectories (about 100 bytes per
+ * run), so it is read whole, chunk by chunk, into column arrays ready for
+ * analysis. Rows keep the order in which the runs finished.
+ */
+class SweepLogReader {
+public:
+    // Throws std::runtime_error if the file cannot be read or is not a sweep file
+    explicit SweepLogReader(const std::string& path);
+    
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool wasTruncated() const; // True if a partial or corrupt chunk (and all after it) was dropped
+    
+    // Run by row (throws std::out_of_range)
+    [[nodiscard]] SweepRunSummary at(std::size_t row) const;
+    
+    // Whole columns
+    [[nodiscard]] const std::vector<std::uint64_t>& caseIndices() const;
+    [[nodiscard]] const std::vector<double>& metric(SweepMetric metric) const;
+    
+    // Statistics over every run in the file
+    [[nodiscard]] SweepAggregate aggregate() const;
+
+private:
+    std::vector<std::uint64_t> m_caseIndex{};
+    std::vector<std::uint64_t> m_steps{};
+    std::vector<std::uint64_t> m_outcome{};
+    std::vector<double> m_metrics[kSweepMetricCount]{};
+    bool m_truncated{false};
+};
+
+} // namespace falconsim
@@ -0,0 +1,84 @@
+#include "SweepLogWriter.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace falconsim {
+
+SweepLogWriter::SweepLogWriter(const std::string& path, std::size_t chunkRecords)
+    : m_chunkRecords{std::max<std::size_t>(1, chunkRecords)} {
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        throw std::runtime_error{"Failed to create sweep file " + path + ": " + std::strerror(errno)};
+    }
+    m_columns.assign(sweep_log::kColumnCount * m_chunkRecords, 0);
+    
+    sweep_log::FileHeader header{};
+    std::memcpy(header.magic, sweep_log::kFileMagic, sizeof(header.magic));
+    header.version = sweep_log::kVersion;
+    header.columnCount = static_cast<std::uint32_t>(sweep_log::kColumnCount);
+    header.chunkRecords = static_cast<std::uint32_t>(m_chunkRecords);
+    writeBytes(&header, sizeof(header));
+}
+
+SweepLogWriter::~SweepLogWriter() {
+    close();
+}
+
+void SweepLogWriter::append(const SweepRunSummary& run) {
+    if (!m_file) {
+        return;
+    }
+    std::uint64_t* row{m_columns.data() + m_count};
+    row[static_cast<std::size_t>(sweep_log::Column::CaseIndex) * m_chunkRecords] = run.case_index;
+    row[static_cast<std::size_t>(sweep_log::Column::Steps) * m_chunkRecords] = run.steps;
+    row[static_cast<std::size_t>(sweep_log::Column::Outcome) * m_chunkRecords] = static_cast<std::uint64_t>(run.outcome);
+    for (std::size_t metric = 0; metric < kSweepMetricCount; ++metric) {
+        const std::size_t column{sweep_log::metricColumn(static_cast<SweepMetric>(metric))};
+        std::memcpy(row + column * m_chunkRecords, &run.metrics[metric], sizeof(double));
+    }
+    ++m_written;
+    
+    if (++m_count == m_chunkRecords) {
+        writeChunk();
+    }
+}
+
+void SweepLogWriter::close() {
+    if (!m_file) {
+        return;
+    }
+    if (m_count > 0) {
+        writeChunk();
+    }
+    if (std::fclose(m_file) != 0) {
+        ++m_writeErrors;
+    }
+    m_file = nullptr;
+}
+
+void SweepLogWriter::writeChunk() {
+    const sweep_log::ChunkHeader header{sweep_log::kChunkMagic, static_cast<std::uint32_t>(m_count), m_written - m_count};
+    writeBytes(&header, sizeof(header));
+    for (std::size_t column = 0; column < sweep_log::kColumnCount; ++column) {
+        writeBytes(m_columns.data() + column * m_chunkRecords, m_count * sizeof(std::uint64_t));
+    }
+    m_count = 0;
+}
+
+void SweepLogWriter::writeBytes(const void* data, std::size_t size) {
+    if (std::fwrite(data, 1, size, m_file) != size) {
+        ++m_writeErrors;
+    }
+}
+
+std::uint64_t SweepLogWriter::getWritten() const {
+    return m_written;
+}
+
+std::uint64_t SweepLogWriter::getWriteErrors() const {
+    return m_writeErrors;
+}
+
+} // namespace falconsim
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SweepLog.hpp"
+
+namespace falconsim {
+
+/**
+ * @brief Writes sweep run summaries to a columnar sweep result file
+ *
+ * append() fills one chunk's worth of columns in memory and writes the
+ * chunk when it is full, so a sweep of any length holds a single chunk.
+ * Its signature matches SweepRunner::RunSink, whose calls arrive one at a
+ * time; the writer itself is not thread-safe.
+ */
+class SweepLogWriter {
+public:
+    // Throws std::runtime_error if the file cannot be created
+    explicit SweepLogWriter(const std::string& path, std::size_t chunkRecords = sweep_log::kDefaultChunkRecords);
+    ~SweepLogWriter();
+    
+    SweepLogWriter(const SweepLogWriter&) = delete;
+    SweepLogWriter& operator=(const SweepLogWriter&) = delete;
+    SweepLogWriter(SweepLogWriter&&) = delete;
+    SweepLogWriter& operator=(SweepLogWriter&&) = delete;
+    
+    // Append one run (ignored once closed)
+    void append(const SweepRunSummary& run);
+    
+    // Write the partial chunk and close the file (idempotent)
+    void close();
+    
+    // Statistics
+    [[nodiscard]] std::uint64_t getWritten() const; // Rows appended
+    [[nodiscard]] std::uint64_t getWriteErrors() const;
+
+private:
+    void writeChunk();
+    void writeBytes(const void* data, std::size_t size);
+    
+    std::FILE* m_file{nullptr};
+    std::size_t m_chunkRecords{0};
+    std::vector<std::uint64_t> m_columns{}; // kColumnCount runs of chunkRecords 8-byte values
+    std::size_t m_count{0};
+    std::uint64_t m_written{0};
+    std::uint64_t m_writeErrors{0};
+};
+
+} // namespace falconsim
@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include "core/ProximityMonitor.hpp"
+#include "physics/FlightDynamics.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#endif
+
+// This binary replaces the global allocation functions and, on glibc, the
+// libm trig entry points, so the FlightDynamics hot path and other per-step
+// code can be audited in isolation. Keep it separate from simulation_tests.
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<long> g_allocations{0};
+std::atomic<long> g_transcendentals{0};
+
+void* countedAllocate(std::size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void countTranscendental(long calls) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_transcendentals.fetch_add(calls, std::memory_order_relaxed);
+    }
+}
+
+// Counts allocations and trig calls for the lifetime of the scope
+class HotPathProbe {
+public:
+    HotPathProbe() {
+        g_allocations.store(0);
+        g_transcendentals.store(0);
+        g_counting.store(true);
+    }
+    ~HotPathProbe() { g_counting.store(false); }
+
+    [[nodiscard]] long allocations() const { return g_allocations.load(); }
+    [[nodiscard]] long transcendentals() const { return g_transcendentals.load(); }
+};
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#if defined(__GLIBC__)
+#define FALCONSIM_COUNTS_TRANSCENDENTALS 1
+
+namespace {
+
+template <typename Fn>
+Fn nextSymbol(const char* name) {
+    return reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+}
+
+} // namespace
+
+// Interpose libm so calls made from the falconsim library are counted.
+// sincos counts as two evaluations: GCC fuses sin/cos pairs into it.
+extern "C" {
+
+double sin(double x) noexcept {
+    static const auto next{nextSymbol<double (*)(double)>("sin")};
+    countTranscendental(1);
+    return next(x);
+}
+
+double cos(double x) noexcept {
+    static const auto next{nextSymbol<double (*)(double)>("cos")};
+    countTranscendental(1);
+    return next(x);
+}
+
+double tan(double x) noexcept {
+    static const auto next{nextSymbol<double (*)(double)>("tan")};
+    countTranscendental(1);
+    return next(x);
+}
+
+void sincos(double x, double* s, double* c) noexcept {
+    static const auto next{nextSymbol<void (*)(double, double*, double*)>("sincos")};
+    countTranscendental(2);
+    next(x, s, c);
+}
+
+} // extern "C"
+#endif
+
+using namespace falconsim;
+
+namespace {
+
+void setUpManeuver(FlightDynamics& dynamics) {
+    AircraftState state;
+    state.velocity = Eigen::Vector3d{12.0, 0.5, -0.3};
+    state.euler_angles = Eigen::Vector3d{0.1, 0.05, 0.3};
+    state.angular_velocity = Eigen::Vector3d{0.02, -0.01, 0.03};
+    dynamics.setState(state);
+
+    ControlInputs controls;
+    controls.throttle = 0.6;
+    controls.aileron = 0.2;
+    controls.elevator = -0.1;
+    controls.rudder = 0.05;
+    dynamics.setControls(controls);
+}
+
+} // namespace
+
+TEST(FlightDynamicsHotPathTest, StepDoesNotAllocate) {
+    FlightDynamics dynamics;
+    setUpManeuver(dynamics);
+
+    // Warm up once so any lazy initialization happens outside the probe
+    dynamics.update(0.001);
+
+    HotPathProbe probe;
+    for (int i = 0; i < 100; ++i) {
+        dynamics.update(0.001);
+    }
+    EXPECT_EQ(probe.allocations(), 0);
+}
+
+TEST(FlightDynamicsHotPathTest, AeroTableStepDoesNotAllocate) {
+    AeroTableAxes axes;
+    axes.alpha = {-0.2, 0.0, 0.2};
+    axes.deflection = {-1.0, 1.0};
+    const std::vector<AeroCoefficients> values(6, AeroCoefficients{0.5, 0.05, -0.01});
+
+    FlightDynamics dynamics;
+    setUpManeuver(dynamics);
+    dynamics.setAeroTable(std::make_shared<const AeroTable>(axes, values));
+    dynamics.update(0.001);
+
+    HotPathProbe probe;
+    for (int i = 0; i < 100; ++i) {
+        dynamics.update(0.001);
+    }
+    EXPECT_EQ(probe.allocations(), 0);
+}
+
+TEST(FlightDynamicsHotPathTest, WindAndTurbulenceStepDoesNotAllocate) {
+    WindGridSpec spec;
+    spec.nodes[0] = 12;
+    const std::vector<float> values(12 * 2 * 2 * 3, 2.0f);
+
+    FlightDynamics dynamics;
+    setUpManeuver(dynamics);
+    dynamics.setWindField(std::make_shared<const WindField>(spec, values));
+    dynamics.setTurbulence(TurbulenceParameters{10.0, 1});
+    dynamics.update(0.001);
+
+    // Long enough to cross several noise blocks
+    HotPathProbe probe;
+    for (int i = 0; i < 200; ++i) {
+        dynamics.update(0.001);
+    }
+    EXPECT_EQ(probe.allocations(), 0);
+}
+
+TEST(FlightDynamicsHotPathTest, StepUsesFixedTranscendentalCount) {
+#if defined(FALCONSIM_COUNTS_TRANSCENDENTALS)
+    FlightDynamics dynamics;
+    setUpManeuver(dynamics);
+    dynamics.update(0.001);
+
+    // One sin and one cos per Euler angle, shared by rotation and integration
+    constexpr long kSteps{100};
+    HotPathProbe probe;
+    for (long i = 0; i < kSteps; ++i) {
+        dynamics.update(0.001);
+    }
+    EXPECT_EQ(probe.transcendentals(), 6 * kSteps);
+#else
+    GTEST_SKIP() << "libm interposition requires glibc";
+#endif
+}
+
+TEST(FlightDynamicsHotPathTest, CachedInverseInertiaFollowsProperties) {
+    UAVPhysicalProperties properties;
+    properties.mass = 2.0;
+    properties.inertia = Eigen::Vector3d{0.25, 0.5, 2.0};
+    properties.thrust_max = 10.0;
+
+    FlightDynamics dynamics;
+    dynamics.setProperties(properties);
+
+    // A pure aileron input must roll at M / Ixx with the new tensor
+    ControlInputs controls;
+    controls.aileron = 1.0;
+    dynamics.setControls(controls);
+    dynamics.update(0.01);
+
+    const double rollRate{dynamics.getState().angular_velocity.x()};
+
+    FlightDynamics reference;
+    reference.setControls(controls);
+    reference.update(0.01);
+
+    // Default Ixx is 0.5, so halving it doubles the roll acceleration
+    EXPECT_NEAR(rollRate, 2.0 * reference.getState().angular_velocity.x(), 1e-12);
+
+    // Default properties are the default airframe, so applying them changes nothing
+    FlightDynamics defaults;
+    defaults.setProperties(UAVPhysicalProperties{});
+    defaults.setControls(controls);
+    defaults.update(0.01);
+    EXPECT_EQ(defaults.getState().angular_velocity, reference.getState().angular_velocity);
+}
+
+TEST(ProximityHotPathTest, WarmUpdateDoesNotAllocate) {
+    // A 16 x 16 formation 20 m apart, drifting back and forth across cell boundaries
+    std::vector<double> north, east, down;
+    for (int i = 0; i < 256; ++i) {
+        north.push_back(20.0 * (i % 16));
+        east.push_back(20.0 * (i / 16));
+        down.push_back(-5.0);
+    }
+    TerrainSpec spec;
+    auto terrain = std::make_shared<const TerrainMap>(spec, std::vector<float>{0.0f, 0.0f, 10.0f, 10.0f});
+    ProximityMonitor monitor;
+    monitor.setTerrain(terrain);
+    monitor.update(north.data(), east.data(), down.data(), north.size());
+    ASSERT_FALSE(monitor.getConflicts().empty());
+
+    HotPathProbe probe;
+    for (int step = 0; step < 20; ++step) {
+        for (double& n : north) {
+            n += (step & 1) != 0 ? 7.0 : -7.0;
+        }
+        monitor.update(north.data(), east.data(), down.data(), north.size());
+    }
+    EXPECT_EQ(probe.allocations(), 0);
+    EXPECT_GT(monitor.getGrid().getMovedCount(), 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,8 +1,53 @@
 #include <gtest/gtest.h>
 #include "core/Simulation.hpp"
+#include "core/SeqLock.hpp"
+#include "core/BoundedQueue.hpp"
+#include "core/SimulationPool.hpp"
+#include "core/SweepRunner.hpp"
+#include "core/OnlineStats.hpp"
+#include "core/ProximityMonitor.hpp"
+#include "core/SensorPipeline.hpp"
+#include "core/Metrics.hpp"
+#include "core/Trace.hpp"
+#include "physics/AeroTable.hpp"
 #include "physics/FlightDynamics.hpp"
+#include "physics/FleetDynamics.hpp"
+#include "physics/Sensors.hpp"
+#include "physics/SpatialGrid.hpp"
+#include "physics/TerrainMap.hpp"
+#include "physics/Turbulence.hpp"
+#include "physics/WindField.hpp"
+#include "network/TelemetryCodec.hpp"
+#include "network/CompactTelemetry.hpp"
+#include "network/DistributedFleet.hpp"
+#include "network/TelemetryServer.hpp"
+#include "network/SharedTelemetry.hpp"
+#include "network/MetricsServer.hpp"
+#include "network/TelemetryReceiver.hpp"
+#include "recording/FlightRecorder.hpp"
+#include "recording/FlightLogReader.hpp"
+#include "recording/ScenarioBundleReader.hpp"
+#include "recording/ScenarioBundleWriter.hpp"
+#include "recording/SweepLogReader.hpp"
+#include "recording/SweepLogWriter.hpp"
+#include <unistd.h>
+#include <algorithm>
 #include <thread>
 #include <chrono>
+#include <cmath>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace falconsim;
 
@@ -78,6 +123,421 @@ TEST(SimulationTest, PauseResume) {
     sim.stop();
 }
 
+TEST(SimulationTest, InvalidTimestep) {
+    EXPECT_THROW(Simulation{0.0}, std::invalid_argument);
+    EXPECT_THROW(Simulation{-0.01}, std::invalid_argument);
+}
+
+TEST(SimulationTest, FixedStepScheduler) {
+    Simulation sim{0.001}; // 1 kHz
+    const auto begin = std::chrono::steady_clock::now();
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    sim.stop();
+    const double elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count()};
+    
+    auto stats = sim.getSchedulerStats();
+    EXPECT_GT(stats.ticks, 0u);
+    EXPECT_GT(stats.steps, 0u);
+    // Every deadline is either stepped or explicitly dropped, so the count can't
+    // drift past the deadlines that actually elapsed (+1 for the first step at t=0)
+    EXPECT_LE(static_cast<double>(stats.steps + stats.dropped_steps), elapsed / 0.001 + 1.0);
+    
+    // The physics must have been advanced with exactly the fixed timestep
+    FlightDynamics reference;
+    for (std::uint64_t i = 0; i < stats.steps; ++i) {
+        reference.update(0.001);
+    }
+    EXPECT_EQ(sim.getState().position, reference.getState().position);
+    EXPECT_EQ(sim.getState().velocity, reference.getState().velocity);
+}
+
+TEST(SimulationTest, BatchRun) {
+    Simulation sim;
+    
+    int callbacks{0};
+    auto steps = sim.run(1.0, 0.001, [&callbacks](Simulation& s, double time) {
+        ++callbacks;
+        s.setThrust(time < 0.5 ? 0.5 : 0.2);
+    });
+    
+    EXPECT_EQ(steps, 1000u);
+    EXPECT_EQ(callbacks, 1000);
+    EXPECT_NEAR(sim.getSimulationTime(), 1.0, 1e-9);
+    EXPECT_GT(sim.getState().velocity.x(), 0.0);
+    
+    // step() uses the construction timestep
+    EXPECT_EQ(sim.step(10), 10u);
+    EXPECT_NEAR(sim.getSimulationTime(), 1.1, 1e-9);
+}
+
+TEST(SimulationTest, BatchMatchesDirectStepping) {
+    Simulation sim;
+    sim.setThrust(0.5);
+    sim.step(50);
+    
+    FlightDynamics reference;
+    ControlInputs controls;
+    controls.throttle = 0.5;
+    reference.setControls(controls);
+    for (int i = 0; i < 50; ++i) {
+        reference.update(0.01);
+    }
+    
+    EXPECT_EQ(sim.getState().position, reference.getState().position);
+}
+
+TEST(SimulationTest, BatchRejectedWhileRunning) {
+    Simulation sim;
+    sim.start();
+    EXPECT_THROW(sim.step(1), std::runtime_error);
+    EXPECT_THROW(sim.run(1.0, 0.01), std::runtime_error);
+    sim.stop();
+    
+    EXPECT_THROW(sim.run(1.0, 0.0), std::invalid_argument);
+}
+
+TEST(SimulationTest, ControlsReachRunningLoop) {
+    Simulation sim{0.001};
+    sim.start();
+    sim.setThrust(0.25);
+    sim.setControlSurfaces(Eigen::Vector3d(0.1, -0.2, 0.3));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    
+    auto controls = sim.getControls();
+    EXPECT_DOUBLE_EQ(controls.throttle, 0.25);
+    EXPECT_DOUBLE_EQ(controls.aileron, 0.1);
+    EXPECT_DOUBLE_EQ(controls.elevator, -0.2);
+    EXPECT_DOUBLE_EQ(controls.rudder, 0.3);
+    
+    sim.stop();
+}
+
+TEST(SimulationTest, StepObserverSeesEveryStep) {
+    Simulation sim;
+    sim.setThrust(0.5);
+    
+    std::vector<double> times;
+    AircraftState lastState;
+    sim.setStepObserver([&](const AircraftState& state, const ControlInputs& controls, double time) {
+        times.push_back(time);
+        lastState = state;
+        EXPECT_DOUBLE_EQ(controls.throttle, 0.5);
+    });
+    sim.step(5);
+    
+    ASSERT_EQ(times.size(), 5u);
+    EXPECT_NEAR(times.front(), 0.01, 1e-12);
+    EXPECT_NEAR(times.back(), 0.05, 1e-12);
+    EXPECT_EQ(lastState.position, sim.getState().position);
+    
+    sim.start();
+    EXPECT_THROW(sim.setStepObserver({}), std::runtime_error);
+    sim.stop();
+}
+
+TEST(SimulationTest, RestoredSnapshotReplaysBitExactly) {
+    for (const auto method : {IntegrationMethod::EulerAngles, IntegrationMethod::SemiImplicitEuler, IntegrationMethod::RK4}) {
+        Simulation sim;
+        sim.getPhysics().setIntegrationMethod(method);
+        sim.setThrust(0.6);
+        sim.setControlSurfaces(Eigen::Vector3d(0.1, -0.05, 0.02));
+        sim.step(20);
+        
+        const SimulationSnapshot snapshot{sim.snapshot()};
+        sim.step(30);
+        const AircraftState expected{sim.getState()};
+        const Eigen::Quaterniond expectedAttitude{sim.getPhysics().getAttitude()};
+        const double expectedTime{sim.getSimulationTime()};
+        
+        // Rewind and replay: every bit must match, not just approximately
+        sim.restore(snapshot);
+        sim.step(30);
+        EXPECT_EQ(sim.getState().position, expected.position);
+        EXPECT_EQ(sim.getState().velocity, expected.velocity);
+        EXPECT_EQ(sim.getState().angular_velocity, expected.angular_velocity);
+        EXPECT_EQ(sim.getPhysics().getAttitude().coeffs(), expectedAttitude.coeffs());
+        EXPECT_EQ(sim.getSimulationTime(), expectedTime);
+        
+        // Snapshots are plain data and survive a raw byte copy
+        SimulationSnapshot copy;
+        std::memcpy(&copy, &snapshot, sizeof(copy));
+        auto branch = sim.fork();
+        branch->restore(copy);
+        branch->step(30);
+        EXPECT_EQ(branch->getState().position, expected.position);
+        EXPECT_EQ(branch->getPhysics().getIntegrationMethod(), method);
+    }
+}
+
+TEST(SimulationTest, ForkedBranchesEvolveIndependently) {
+    Simulation sim;
+    sim.setThrust(0.5);
+    sim.step(20);
+    
+    auto climb = sim.fork();
+    auto dive = sim.fork();
+    EXPECT_EQ(climb->getSimulationTime(), sim.getSimulationTime());
+    EXPECT_EQ(climb->getControls().throttle, 0.5);
+    
+    // Setters on a branch start from the restored controls
+    climb->setControlSurfaces(Eigen::Vector3d(0.0, 0.3, 0.0));
+    dive->setControlSurfaces(Eigen::Vector3d(0.0, -0.3, 0.0));
+    EXPECT_EQ(climb->getControls().throttle, 0.5);
+    climb->step(20);
+    dive->step(20);
+    sim.step(20);
+    
+    EXPECT_NE(climb->getState().angular_velocity, dive->getState().angular_velocity);
+    EXPECT_NE(climb->getState().angular_velocity, sim.getState().angular_velocity);
+    
+    sim.start();
+    EXPECT_THROW(static_cast<void>(sim.snapshot()), std::runtime_error);
+    EXPECT_THROW(sim.restore(climb->snapshot()), std::runtime_error);
+    sim.stop();
+    
+    DynamicsSnapshot stale{sim.getPhysics().snapshot()};
+    stale.version = 0;
+    EXPECT_THROW(sim.getPhysics().restore(stale), std::invalid_argument);
+}
+
+std::shared_ptr<const AeroTable> makeSyntheticAeroTable();
+std::shared_ptr<const WindField> makeAffineWindField();
+
+TEST(SimulationTest, ForkedBranchesKeepSharedAssets) {
+    const auto table = makeSyntheticAeroTable();
+    const auto field = makeAffineWindField();
+    Simulation sim;
+    sim.getPhysics().setAeroTable(table);
+    sim.getPhysics().setWindField(field);
+    sim.setThrust(0.6);
+    sim.setControlSurfaces(Eigen::Vector3d(0.0, 0.1, 0.0));
+    sim.step(50);
+    
+    // The branch flies through the same table and wind, so identical steps stay bit-identical
+    auto branch = sim.fork();
+    EXPECT_EQ(branch->getPhysics().getAeroTable(), table);
+    EXPECT_EQ(branch->getPhysics().getWindField(), field);
+    sim.step(200);
+    branch->step(200);
+    EXPECT_EQ(branch->getState().position, sim.getState().position);
+    EXPECT_EQ(branch->getState().velocity, sim.getState().velocity);
+    EXPECT_EQ(branch->getState().angular_velocity, sim.getState().angular_velocity);
+}
+
+TEST(SimulationTest, MetricsTimeStepsAndTicks) {
+    Simulation sim{0.001};
+    sim.setThrust(0.5);
+    sim.step(50);
+    
+    // Steps 0, 16, 32 and 48 are timed
+    SimulationMetrics metrics{sim.getMetrics()};
+    EXPECT_EQ(metrics.step_time.count, (50 + Simulation::kStepTimingInterval - 1) / Simulation::kStepTimingInterval);
+    EXPECT_GT(metrics.step_time.max, 0u);
+    EXPECT_DOUBLE_EQ(metrics.target_rate, 1000.0);
+    EXPECT_EQ(metrics.achieved_rate, 0.0); // No real-time loop yet
+    
+    // start() resets the histograms; the loop then records ticks and lateness too
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    sim.stop();
+    metrics = sim.getMetrics();
+    EXPECT_EQ(metrics.step_time.count,
+              (metrics.scheduler.steps + Simulation::kStepTimingInterval - 1) / Simulation::kStepTimingInterval);
+    EXPECT_GT(metrics.tick_time.count, 0u);
+    EXPECT_EQ(metrics.lateness.count, metrics.scheduler.ticks);
+    EXPECT_GT(metrics.achieved_rate, 0.0);
+    
+    MetricsReport report;
+    appendMetrics(report, metrics);
+    EXPECT_NE(report.str().find("falconsim_sim_steps_total " + std::to_string(metrics.scheduler.steps) + "\n"),
+              std::string::npos);
+    EXPECT_NE(report.str().find("falconsim_sim_step_time_ns_p99 "), std::string::npos);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeTornValues) {
+    // Every published value has position == velocity == mass
+    AircraftState initial;
+    initial.mass = 0.0;
+    SeqLock<AircraftState> lock{initial};
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    
+    std::thread writer([&] {
+        for (int i = 1; i <= 200000; ++i) {
+            AircraftState state;
+            state.position = Eigen::Vector3d::Constant(i);
+            state.velocity = Eigen::Vector3d::Constant(i);
+            state.mass = i;
+            lock.store(state);
+        }
+        done = true;
+    });
+    
+    while (!done) {
+        auto state = lock.load();
+        if (state.position.x() != state.mass || state.velocity.z() != state.mass) {
+            ++torn;
+        }
+    }
+    writer.join();
+    
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(lock.load().mass, 200000.0);
+}
+
+TEST(SeqLockTest, MailboxDeliversLatestOnce) {
+    LatestValueMailbox<ControlInputs> mailbox;
+    ControlInputs out;
+    EXPECT_FALSE(mailbox.take(out));
+    
+    ControlInputs first;
+    first.throttle = 0.1;
+    ControlInputs second;
+    second.throttle = 0.9;
+    mailbox.post(first);
+    mailbox.post(second);
+    
+    ASSERT_TRUE(mailbox.take(out));
+    EXPECT_DOUBLE_EQ(out.throttle, 0.9);
+    EXPECT_FALSE(mailbox.take(out));
+}
+
+TEST(BoundedQueueTest, MultipleProducersDeliverEveryValueOnce) {
+    BoundedQueue<std::uint64_t> queue{64};
+    EXPECT_EQ(queue.capacity(), 64u);
+    
+    constexpr std::uint64_t kProducers{4};
+    constexpr std::uint64_t kPerProducer{20000};
+    std::vector<std::thread> producers;
+    for (std::uint64_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (std::uint64_t i = 0; i < kPerProducer; ++i) {
+                while (!queue.tryPush(p * kPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    // Values from each producer arrive in order, and none is lost or repeated
+    std::vector<std::uint64_t> nextExpected(kProducers, 0);
+    std::uint64_t received{0};
+    std::uint64_t value{0};
+    while (received < kProducers * kPerProducer) {
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::uint64_t producer{value / kPerProducer};
+        ASSERT_EQ(value % kPerProducer, nextExpected[producer]);
+        ++nextExpected[producer];
+        ++received;
+    }
+    
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(BoundedQueueTest, EvictingPushKeepsNewest) {
+    BoundedQueue<int> queue{3}; // Rounded up to 4
+    EXPECT_EQ(queue.capacity(), 4u);
+    
+    std::size_t evicted{0};
+    for (int i = 0; i < 10; ++i) {
+        evicted += queue.pushEvictingOldest(i);
+    }
+    EXPECT_EQ(evicted, 6u);
+    EXPECT_EQ(queue.sizeApprox(), 4u);
+    
+    int value{0};
+    for (int expected = 6; expected < 10; ++expected) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(MetricsTest, HistogramPercentilesWithinBucketPrecision) {
+    Histogram histogram;
+    for (std::uint64_t value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+    
+    const HistogramSummary summary{histogram.summary()};
+    EXPECT_EQ(summary.count, 10000u);
+    EXPECT_EQ(summary.min, 1u);
+    EXPECT_EQ(summary.max, 10000u);
+    EXPECT_DOUBLE_EQ(summary.mean, 5000.5);
+    
+    // 16 sub-buckets per power of two: within 1/16 of the exact percentile
+    EXPECT_NEAR(static_cast<double>(summary.p50), 5000.0, 5000.0 / 16.0);
+    EXPECT_NEAR(static_cast<double>(summary.p90), 9000.0, 9000.0 / 16.0);
+    EXPECT_NEAR(static_cast<double>(summary.p99), 9900.0, 9900.0 / 16.0);
+    EXPECT_LE(summary.p999, summary.max);
+    
+    // Small values are exact, huge ones saturate instead of overflowing
+    for (std::uint64_t value = 0; value < Histogram::kSubBuckets; ++value) {
+        EXPECT_EQ(Histogram::bucketIndex(value), value);
+    }
+    EXPECT_EQ(Histogram::bucketIndex(UINT64_MAX), Histogram::kBucketCount - 1);
+    for (std::size_t bucket = 1; bucket < Histogram::kBucketCount; ++bucket) {
+        ASSERT_GT(Histogram::bucketUpperBound(bucket), Histogram::bucketUpperBound(bucket - 1));
+        ASSERT_EQ(Histogram::bucketIndex(Histogram::bucketUpperBound(bucket)), bucket);
+    }
+    
+    histogram.reset();
+    EXPECT_EQ(histogram.summary().count, 0u);
+}
+
+TEST(MetricsTest, ShardedCounterMergesEveryThread) {
+    ShardedCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    counter.add(5);
+    EXPECT_EQ(counter.value(), 40005u);
+}
+
+TEST(TraceTest, ExportsChromeTraceWhenEnabled) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_trace_" + std::to_string(::getpid()) + ".json")).string()};
+    
+    std::thread worker{[] {
+        FALCONSIM_TRACE_THREAD_NAME("trace \"test\" worker");
+        FALCONSIM_TRACE_ZONE("TraceTest::outer");
+        Simulation sim;
+        sim.step(3);
+    }};
+    worker.join();
+    
+    if (!trace::kEnabled) {
+        EXPECT_FALSE(trace::writeChromeTrace(path));
+        return;
+    }
+    ASSERT_TRUE(trace::writeChromeTrace(path));
+    std::ifstream file{path};
+    const std::string json{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    std::filesystem::remove(path);
+    
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"trace \\\"test\\\" worker\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"TraceTest::outer\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"FlightDynamics::forces\""), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    EXPECT_EQ(trace::getDroppedEvents(), 0u);
+}
+
 TEST(FlightDynamicsTest, LiftGeneration) {
     FlightDynamics physics;
     
@@ -112,6 +572,2574 @@ TEST(FlightDynamicsTest, ControlInputEffects) {
     EXPECT_GT(state.angular_velocity.x(), 0.0); // Roll right from aileron
 }
 
+TEST(FlightDynamicsTest, QuaternionSchemesPitchThroughVertical) {
+    for (auto method : {IntegrationMethod::SemiImplicitEuler, IntegrationMethod::RK4}) {
+        FlightDynamics dynamics;
+        dynamics.setIntegrationMethod(method);
+        
+        // Constant 1 rad/s pitch rate and no control moments: attitude is a
+        // pure rotation about body y, straight through the Euler singularity
+        AircraftState state;
+        state.angular_velocity = Eigen::Vector3d{0, 1.0, 0};
+        dynamics.setState(state);
+        
+        const double dt{0.05};
+        const int steps{40};
+        for (int i = 0; i < steps; ++i) {
+            dynamics.update(dt);
+        }
+        
+        const Eigen::Quaterniond expected{Eigen::AngleAxisd{steps * dt, Eigen::Vector3d::UnitY()}};
+        EXPECT_LT(dynamics.getAttitude().angularDistance(expected), 1e-6);
+        EXPECT_NEAR(dynamics.getAttitude().norm(), 1.0, 1e-12);
+        EXPECT_TRUE(dynamics.getState().euler_angles.allFinite());
+    }
+}
+
+TEST(FlightDynamicsTest, RK4MatchesFineStepAtLargerTimestep) {
+    const auto simulate = [](IntegrationMethod method, double dt, double duration) {
+        FlightDynamics dynamics;
+        dynamics.setIntegrationMethod(method);
+        
+        AircraftState state;
+        state.velocity = Eigen::Vector3d{5.0, 0, 0};
+        state.angular_velocity = Eigen::Vector3d{0.5, 1.0, 0.3};
+        dynamics.setState(state);
+        
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        controls.aileron = 0.3;
+        dynamics.setControls(controls);
+        
+        const int steps{static_cast<int>(std::lround(duration / dt))};
+        for (int i = 0; i < steps; ++i) {
+            dynamics.update(dt);
+        }
+        return std::make_pair(dynamics.getAttitude(), dynamics.getState().velocity);
+    };
+    
+    const double duration{0.2};
+    const auto reference = simulate(IntegrationMethod::RK4, 1e-4, duration);
+    const auto euler = simulate(IntegrationMethod::EulerAngles, 0.002, duration);
+    const auto rk4 = simulate(IntegrationMethod::RK4, 0.02, duration);
+    
+    // RK4 at a 10x larger step is still more accurate than the legacy scheme
+    EXPECT_LT(rk4.first.angularDistance(reference.first), euler.first.angularDistance(reference.first));
+    EXPECT_LT((rk4.second - reference.second).norm(), (euler.second - reference.second).norm());
+}
+
+TEST(FlightDynamicsTest, SwitchingIntegrationMethodKeepsAttitude) {
+    FlightDynamics dynamics;
+    AircraftState state;
+    state.euler_angles = Eigen::Vector3d{0.2, -0.3, 1.0};
+    dynamics.setState(state);
+    
+    dynamics.setIntegrationMethod(IntegrationMethod::RK4);
+    EXPECT_EQ(dynamics.getIntegrationMethod(), IntegrationMethod::RK4);
+    EXPECT_TRUE(dynamics.getState().euler_angles.isApprox(state.euler_angles, 1e-12));
+    
+    dynamics.setIntegrationMethod(IntegrationMethod::EulerAngles);
+    EXPECT_TRUE(dynamics.getState().euler_angles.isApprox(state.euler_angles, 1e-12));
+}
+
+TEST(FlightDynamicsTest, CompileTimeAirframeMatchesRuntimeModel) {
+    for (auto method : {IntegrationMethod::EulerAngles, IntegrationMethod::SemiImplicitEuler, IntegrationMethod::RK4}) {
+        FlightDynamics runtime;
+        SmallUavDynamics fixed;
+        
+        AircraftState state;
+        state.velocity = Eigen::Vector3d{5.0, 0.5, -0.2};
+        state.angular_velocity = Eigen::Vector3d{0.5, 1.0, 0.3};
+        state.euler_angles = Eigen::Vector3d{0.1, 0.05, 0.4};
+        ControlInputs controls;
+        controls.throttle = 0.7;
+        controls.aileron = 0.3;
+        controls.elevator = -0.2;
+        controls.rudder = 0.4;
+        runtime.setIntegrationMethod(method);
+        fixed.setIntegrationMethod(method);
+        runtime.setState(state);
+        fixed.setState(state);
+        runtime.setControls(controls);
+        fixed.setControls(controls);
+        
+        for (int i = 0; i < 50; ++i) {
+            runtime.update(0.004);
+            fixed.update(0.004);
+        }
+        ASSERT_TRUE(runtime.getState().velocity.allFinite());
+        EXPECT_TRUE(fixed.getState().position.isApprox(runtime.getState().position, 1e-12));
+        EXPECT_TRUE(fixed.getState().velocity.isApprox(runtime.getState().velocity, 1e-12));
+        EXPECT_TRUE(fixed.getState().angular_velocity.isApprox(runtime.getState().angular_velocity, 1e-12));
+        EXPECT_LT(fixed.getAttitude().angularDistance(runtime.getAttitude()), 1e-12);
+    }
+    
+    // The fixed airframe reports its constants as properties
+    const SurveyWingDynamics survey;
+    EXPECT_DOUBLE_EQ(survey.getState().mass, SurveyWingAirframe::mass);
+    EXPECT_DOUBLE_EQ(survey.getProperties().thrust_max, SurveyWingAirframe::thrust_max);
+    EXPECT_DOUBLE_EQ(survey.getProperties().inertia.y(), SurveyWingAirframe::inertia[1]);
+}
+
+TEST(FlightDynamicsTest, ZeroGainAirframeIgnoresItsControl) {
+    // The survey wing has no rudder; the interceptor does
+    const auto yawRate = [](auto& dynamics, double rudder) {
+        ControlInputs controls;
+        controls.rudder = rudder;
+        dynamics.setControls(controls);
+        dynamics.update(0.1);
+        return dynamics.getState().angular_velocity.z();
+    };
+    SurveyWingDynamics survey;
+    InterceptorDynamics interceptor;
+    EXPECT_DOUBLE_EQ(yawRate(survey, 1.0), 0.0);
+    EXPECT_GT(yawRate(interceptor, 1.0), 0.0);
+}
+
+TEST(FlightDynamicsTest, CompileTimeAirframeSnapshotsReplayBitExactly) {
+    InterceptorDynamics dynamics;
+    dynamics.setIntegrationMethod(IntegrationMethod::RK4);
+    ControlInputs controls;
+    controls.throttle = 0.9;
+    controls.aileron = -0.4;
+    controls.rudder = 0.2;
+    dynamics.setControls(controls);
+    dynamics.update(0.05);
+    
+    const DynamicsSnapshot snapshot{dynamics.snapshot()};
+    EXPECT_DOUBLE_EQ(snapshot.thrust_max, InterceptorAirframe::thrust_max);
+    EXPECT_DOUBLE_EQ(snapshot.inverse_inertia_tensor[0], 1.0 / InterceptorAirframe::inertia[0]);
+    for (int i = 0; i < 20; ++i) {
+        dynamics.update(0.05);
+    }
+    const AircraftState first{dynamics.getState()};
+    
+    dynamics.restore(snapshot);
+    for (int i = 0; i < 20; ++i) {
+        dynamics.update(0.05);
+    }
+    EXPECT_EQ(dynamics.getState().position, first.position);
+    EXPECT_EQ(dynamics.getState().velocity, first.velocity);
+    
+    const auto branch = dynamics.fork();
+    EXPECT_EQ(branch->getState().position, dynamics.getState().position);
+    EXPECT_DOUBLE_EQ(branch->getAirframe().thrust_max, InterceptorAirframe::thrust_max);
+}
+
+// Coefficients that are multilinear in the table axes, so interpolation reproduces them exactly
+AeroCoefficients syntheticAero(double alpha, double beta, double mach, double deflection) {
+    return AeroCoefficients{0.2 + 5.0 * alpha + 0.4 * deflection - 0.5 * beta * mach,
+                            0.03 + 0.2 * alpha * beta + 0.05 * mach,
+                            -0.1 * alpha + 0.2 * deflection * mach};
+}
+
+std::shared_ptr<const AeroTable> makeSyntheticAeroTable() {
+    AeroTableAxes axes;
+    axes.alpha = {-0.3, -0.1, 0.0, 0.15, 0.4};
+    axes.beta = {-0.2, 0.2};
+    axes.mach = {0.0, 0.1, 0.3};
+    axes.deflection = {-1.0, 0.0, 1.0};
+    std::vector<AeroCoefficients> values;
+    for (double alpha : axes.alpha) {
+        for (double beta : axes.beta) {
+            for (double mach : axes.mach) {
+                for (double deflection : axes.deflection) {
+                    values.push_back(syntheticAero(alpha, beta, mach, deflection));
+                }
+            }
+        }
+    }
+    return std::make_shared<const AeroTable>(axes, values);
+}
+
+TEST(AeroTableTest, InterpolatesMultilinearlyAndClamps) {
+    const auto table = makeSyntheticAeroTable();
+    EXPECT_EQ(table->getNodeCount(), 5u * 2u * 3u * 3u);
+    
+    // Nodes, cell interiors and uneven cells all reproduce a multilinear function
+    for (double alpha : {-0.3, -0.25, 0.0, 0.07, 0.3, 0.4}) {
+        for (double beta : {-0.2, 0.05}) {
+            for (double mach : {0.0, 0.04, 0.25}) {
+                for (double deflection : {-1.0, -0.3, 0.6}) {
+                    const AeroCoefficients expected{syntheticAero(alpha, beta, mach, deflection)};
+                    const AeroCoefficients actual{table->lookup(alpha, beta, mach, deflection)};
+                    EXPECT_NEAR(actual.lift, expected.lift, 1e-12);
+                    EXPECT_NEAR(actual.drag, expected.drag, 1e-12);
+                    EXPECT_NEAR(actual.pitch_moment, expected.pitch_moment, 1e-12);
+                }
+            }
+        }
+    }
+    
+    // Outside the grid the edge value holds
+    const AeroCoefficients clamped{table->lookup(1.0, -5.0, 2.0, 3.0)};
+    EXPECT_NEAR(clamped.lift, syntheticAero(0.4, -0.2, 0.3, 1.0).lift, 1e-12);
+    
+    // A single breakpoint makes the table constant along that axis
+    AeroTableAxes flat;
+    flat.alpha = {0.0, 1.0};
+    const AeroTable line{flat, {AeroCoefficients{1.0, 0.1, 0.0}, AeroCoefficients{3.0, 0.3, 0.0}}};
+    EXPECT_DOUBLE_EQ(line.lookup(0.25, 0.7, 0.9, -1.0).lift, 1.5);
+    
+    AeroTableAxes unsorted;
+    unsorted.mach = {0.5, 0.2};
+    EXPECT_THROW((AeroTable{unsorted, {AeroCoefficients{}, AeroCoefficients{}}}), std::invalid_argument);
+    EXPECT_THROW((AeroTable{flat, {AeroCoefficients{}}}), std::invalid_argument);
+}
+
+TEST(AeroTableTest, LoadsTextTablesAndRejectsGaps) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_aero_" + std::to_string(::getpid()) + ".txt")).string()};
+    {
+        std::ofstream file{path};
+        file << "# Two-point alpha sweep at two deflections\n"
+             << "alpha -0.1 0.2\n"
+             << "deflection -1 1\n"
+             << "\n"
+             << "0.2 0 0 1    1.4 0.09 -0.02\n"
+             << "-0.1 0 0 -1 -0.3 0.05  0.04 # trailing comment\n"
+             << "-0.1 0 0 1   0.1 0.05  0.00\n"
+             << "0.2 0 0 -1   1.0 0.09  0.02\n";
+    }
+    const auto table = AeroTable::load(path);
+    EXPECT_EQ(table->getNodeCount(), 4u);
+    EXPECT_EQ(table->getAxes().beta, std::vector<double>{0.0});
+    const AeroCoefficients coefficients{table->lookup(0.05, 0.3, 0.8, 0.0)};
+    EXPECT_NEAR(coefficients.lift, 0.55, 1e-12);
+    EXPECT_NEAR(coefficients.drag, 0.07, 1e-12);
+    EXPECT_NEAR(coefficients.pitch_moment, 0.01, 1e-12);
+    
+    // A missing node, a key off the grid and a short row are all errors
+    for (const std::string& body : {std::string{"alpha 0 1\n0 0 0 0 1 0 0\n"},
+                                    std::string{"alpha 0 1\n0 0 0 0 1 0 0\n0.5 0 0 0 1 0 0\n"},
+                                    std::string{"alpha 0\n0 0 0 0 1 0\n"}}) {
+        std::ofstream{path} << body;
+        EXPECT_THROW(AeroTable::load(path), std::runtime_error) << body;
+    }
+    std::filesystem::remove(path);
+    EXPECT_THROW(AeroTable::load(path), std::runtime_error);
+}
+
+TEST(FlightDynamicsTest, AeroTableDrivesLiftDragAndPitch) {
+    const auto table = makeSyntheticAeroTable();
+    
+    AircraftState state;
+    state.position = Eigen::Vector3d(0.0, 0.0, -100.0);
+    state.velocity = Eigen::Vector3d(20.0, 1.0, 2.0);
+    ControlInputs controls;
+    controls.elevator = 0.5;
+    
+    FlightDynamics tabulated;
+    tabulated.setState(state);
+    tabulated.setControls(controls);
+    tabulated.setAeroTable(table);
+    
+    // The table's coefficients at this air data, as constants
+    const double alpha{std::atan2(2.0, 20.0)};
+    const double airspeed{state.velocity.norm()};
+    const AeroCoefficients expected{table->lookup(alpha, std::asin(1.0 / airspeed), airspeed / 340.29, 0.5)};
+    FlightDynamics constant;
+    constant.setState(state);
+    constant.setControls(controls);
+    constant.setLiftCoefficient(expected.lift);
+    constant.setDragCoefficient(expected.drag);
+    
+    tabulated.update(0.01);
+    constant.update(0.01);
+    EXPECT_TRUE(tabulated.getState().velocity.isApprox(constant.getState().velocity, 1e-12));
+    
+    // Cm adds 0.5 ρ v² S c Cm of pitching moment on top of the elevator
+    const double chord{0.5 / 1.5};
+    const double pitchMoment{0.5 * 1.225 * airspeed * airspeed * 0.5 * chord * expected.pitch_moment};
+    EXPECT_NEAR(tabulated.getState().angular_velocity.y() - constant.getState().angular_velocity.y(),
+                pitchMoment / 0.8 * 0.01, 1e-12);
+    
+    // Forks share the table; clearing it restores the constant model
+    EXPECT_EQ(tabulated.fork()->getAeroTable(), table);
+    tabulated.setAeroTable(nullptr);
+    EXPECT_EQ(tabulated.getAeroTable(), nullptr);
+}
+
+// Affine in position and time, so trilinear interpolation reproduces it up to float storage
+void affineWind(double north, double east, double down, double time, double wind[3]) {
+    wind[0] = 2.0 + 0.01 * north - 0.005 * east + 0.1 * time;
+    wind[1] = -1.0 + 0.002 * east + 0.003 * down;
+    wind[2] = 0.5 - 0.001 * north + 0.004 * down - 0.02 * time;
+}
+
+std::shared_ptr<const WindField> makeAffineWindField() {
+    WindGridSpec spec;
+    spec.nodes[0] = 20;
+    spec.nodes[1] = 10;
+    spec.nodes[2] = 9;
+    spec.slices = 2;
+    spec.origin[0] = -500.0;
+    spec.origin[1] = 200.0;
+    spec.origin[2] = -300.0;
+    spec.spacing[0] = 50.0;
+    spec.spacing[1] = 40.0;
+    spec.spacing[2] = 25.0;
+    spec.slice_interval = 30.0;
+    
+    std::vector<float> values;
+    for (std::size_t t = 0; t < spec.slices; ++t) {
+        for (std::size_t n = 0; n < spec.nodes[0]; ++n) {
+            for (std::size_t e = 0; e < spec.nodes[1]; ++e) {
+                for (std::size_t d = 0; d < spec.nodes[2]; ++d) {
+                    double wind[3];
+                    affineWind(spec.origin[0] + n * spec.spacing[0], spec.origin[1] + e * spec.spacing[1],
+                               spec.origin[2] + d * spec.spacing[2], t * spec.slice_interval, wind);
+                    values.insert(values.end(), {static_cast<float>(wind[0]), static_cast<float>(wind[1]),
+                                                 static_cast<float>(wind[2])});
+                }
+            }
+        }
+    }
+    return std::make_shared<const WindField>(spec, values);
+}
+
+TEST(WindFieldTest, InterpolatesAcrossBricksAndClamps) {
+    const auto field = makeAffineWindField();
+    EXPECT_EQ(field->getBrickCount(), 3u * 2u * 2u * 2u);
+    EXPECT_FALSE(field->isMapped());
+    
+    // Nodes, cell interiors and the faces bricks share (north node 7 and 14, down node 7)
+    for (double north : {-500.0, -151.0, -150.0, 0.0, 200.0, 333.3, 450.0}) {
+        for (double east : {200.0, 333.0, 479.9, 560.0}) {
+            for (double down : {-300.0, -126.0, -125.0, -100.0}) {
+                for (double time : {0.0, 12.5, 30.0}) {
+                    double expected[3];
+                    double actual[3];
+                    affineWind(north, east, down, time, expected);
+                    field->prefetch(north, east, down, time);
+                    field->sample(north, east, down, time, actual);
+                    for (int k = 0; k < 3; ++k) {
+                        EXPECT_NEAR(actual[k], expected[k], 1e-5) << north << " " << east << " " << down << " " << time;
+                    }
+                }
+            }
+        }
+    }
+    
+    // Outside the grid, in space or time, the edge value holds
+    double clamped[3];
+    double edge[3];
+    field->sample(1e6, -1e6, 50.0, 500.0, clamped);
+    field->sample(450.0, 200.0, -100.0, 30.0, edge);
+    for (int k = 0; k < 3; ++k) {
+        EXPECT_DOUBLE_EQ(clamped[k], edge[k]);
+    }
+    
+    WindGridSpec flat;
+    flat.nodes[2] = 1;
+    EXPECT_THROW((WindField{flat, std::vector<float>(6)}), std::invalid_argument);
+    EXPECT_THROW((WindField{WindGridSpec{}, std::vector<float>(3)}), std::invalid_argument);
+}
+
+TEST(WindFieldTest, SavesAndMapsBrickedFiles) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_wind_" + std::to_string(::getpid()) + ".bin")).string()};
+    const auto field = makeAffineWindField();
+    field->save(path);
+    
+    const auto mapped = WindField::open(path);
+    EXPECT_TRUE(mapped->isMapped());
+    EXPECT_EQ(mapped->getBrickCount(), field->getBrickCount());
+    EXPECT_EQ(mapped->getSpec().nodes[0], 20u);
+    for (double north : {-480.0, 10.0, 449.0}) {
+        double expected[3];
+        double actual[3];
+        field->sample(north, 300.0, -200.0, 7.0, expected);
+        mapped->sample(north, 300.0, -200.0, 7.0, actual);
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_EQ(actual[k], expected[k]);
+        }
+    }
+    
+    // A truncated file, a foreign file and a missing file are all rejected
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_THROW(WindField::open(path), std::runtime_error);
+    std::ofstream{path} << "not a wind field";
+    EXPECT_THROW(WindField::open(path), std::runtime_error);
+    std::filesystem::remove(path);
+    EXPECT_THROW(WindField::open(path), std::runtime_error);
+}
+
+TEST(FlightDynamicsTest, SteadyWindActsThroughAirspeed) {
+    // Flying east at 20 m/s with a 5 m/s tailwind is 15 m/s through the air
+    for (IntegrationMethod method : {IntegrationMethod::EulerAngles, IntegrationMethod::RK4}) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(0.0, 0.0, -100.0);
+        state.euler_angles = Eigen::Vector3d(0.0, 0.0, 0.5 * 3.14159265358979323846);
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        
+        FlightDynamics still;
+        still.setIntegrationMethod(method);
+        state.velocity = Eigen::Vector3d(15.0, 0.0, 0.0);
+        still.setState(state);
+        still.setControls(controls);
+        
+        FlightDynamics windy;
+        windy.setIntegrationMethod(method);
+        windy.setWind(Eigen::Vector3d(0.0, 5.0, 0.0));
+        state.velocity = Eigen::Vector3d(20.0, 0.0, 0.0);
+        windy.setState(state);
+        windy.setControls(controls);
+        
+        for (int step = 0; step < 10; ++step) {
+            still.update(0.01);
+            windy.update(0.01);
+        }
+        
+        // Same forces, so the velocities stay 5 m/s apart (along body x, which barely rotates)
+        const Eigen::Vector3d difference{windy.getState().velocity - still.getState().velocity};
+        EXPECT_NEAR(difference.x(), 5.0, 1e-3);
+        EXPECT_NEAR(windy.getState().angular_velocity.y(), still.getState().angular_velocity.y(), 1e-9);
+        EXPECT_NEAR(windy.getState().position.y() - still.getState().position.y(), 0.5, 1e-3);
+        EXPECT_DOUBLE_EQ(windy.getEnvironmentTime(), 0.1);
+    }
+}
+
+TEST(FlightDynamicsTest, DrydenTurbulenceIsSeededAndReplays) {
+    // The filter alone: above 2000 ft each axis is a Markov process with σ = 0.1 W20
+    TurbulenceParameters parameters;
+    parameters.wind_speed_20ft = 15.0;
+    parameters.seed = 3;
+    DrydenTurbulence turbulence;
+    double sumSquares[3]{};
+    constexpr int kSteps{200000};
+    for (int i = 0; i < kSteps; ++i) {
+        const double* gust{turbulence.advance(parameters, 800.0, 30.0, 0.05)};
+        for (int k = 0; k < 3; ++k) {
+            sumSquares[k] += gust[k] * gust[k];
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        EXPECT_NEAR(std::sqrt(sumSquares[k] / kSteps), 1.5, 0.2) << "axis " << k;
+    }
+    
+    const auto makeAircraft = [](std::uint64_t seed) {
+        auto dynamics = std::make_unique<FlightDynamics>();
+        AircraftState state;
+        state.position = Eigen::Vector3d(0.0, 0.0, -60.0);
+        state.velocity = Eigen::Vector3d(18.0, 0.0, 0.5);
+        dynamics->setState(state);
+        dynamics->setLiftCoefficient(0.2);
+        dynamics->setTurbulence(TurbulenceParameters{10.0, seed});
+        return dynamics;
+    };
+    auto first = makeAircraft(11);
+    auto twin = makeAircraft(11);
+    auto other = makeAircraft(12);
+    
+    // Snapshot off a noise block boundary, so replay has to regenerate the block
+    std::unique_ptr<FlightDynamics> branch;
+    DynamicsSnapshot midway;
+    for (int step = 0; step < 150; ++step) {
+        if (step == 37) {
+            branch = first->fork();
+            midway = first->snapshot();
+        }
+        first->update(0.01);
+        twin->update(0.01);
+        other->update(0.01);
+    }
+    EXPECT_EQ(first->getState().velocity, twin->getState().velocity);
+    EXPECT_NE(first->getState().velocity, other->getState().velocity);
+    EXPECT_NE(first->getGust(), Eigen::Vector3d::Zero());
+    
+    FlightDynamics restored;
+    restored.restore(midway);
+    for (int step = 37; step < 150; ++step) {
+        branch->update(0.01);
+        restored.update(0.01);
+    }
+    EXPECT_EQ(branch->getState().position, first->getState().position);
+    EXPECT_EQ(restored.getState().position, first->getState().position);
+    EXPECT_EQ(restored.getGust(), first->getGust());
+}
+
+namespace {
+
+// Level flight north at a constant speed, one snapshot every dt
+std::vector<SensorSnapshot> levelFlight(std::uint32_t vehicleId, double speed, double dt, std::size_t steps) {
+    std::vector<SensorSnapshot> snapshots;
+    for (std::size_t i = 0; i <= steps; ++i) {
+        SensorSnapshot snapshot;
+        snapshot.vehicle_id = vehicleId;
+        snapshot.time = static_cast<double>(i) * dt;
+        snapshot.state.position = Eigen::Vector3d{speed * snapshot.time, 0.0, -100.0};
+        snapshot.state.velocity = Eigen::Vector3d{speed, 0.0, 0.0};
+        snapshots.push_back(snapshot);
+    }
+    return snapshots;
+}
+
+SensorSettings noiseFreeSensors() {
+    SensorSettings settings;
+    settings.imu.accel = SensorNoise{};
+    settings.imu.gyro = SensorNoise{};
+    settings.gps.horizontal = SensorNoise{};
+    settings.gps.vertical = SensorNoise{};
+    settings.gps.velocity = SensorNoise{};
+    settings.baro.altitude = SensorNoise{};
+    return settings;
+}
+
+std::vector<SensorSample> sortedSamples(std::vector<SensorSample> samples) {
+    std::sort(samples.begin(), samples.end(), [](const SensorSample& a, const SensorSample& b) {
+        return std::make_tuple(a.vehicle_id, a.kind, a.time) < std::make_tuple(b.vehicle_id, b.kind, b.time);
+    });
+    return samples;
+}
+
+} // namespace
+
+TEST(SensorSuiteTest, NoiseFreeSensorsReadTheTruth) {
+    SensorSuite suite{noiseFreeSensors()};
+    std::vector<SensorSample> samples;
+    for (const SensorSnapshot& snapshot : levelFlight(7, 5.0, 0.01, 100)) {
+        suite.process(&snapshot, 1, samples);
+    }
+    
+    // Every measurement on each rate grid up to t = 1 s, less those still within their latency
+    std::size_t counts[kSensorKindCount]{};
+    for (const SensorSample& sample : samples) {
+        ++counts[static_cast<std::size_t>(sample.kind) - 1];
+        EXPECT_EQ(sample.vehicle_id, 7u);
+        switch (sample.kind) {
+            case SensorKind::Imu:
+                EXPECT_NEAR(sample.values[0], 0.0, 1e-9);
+                EXPECT_NEAR(sample.values[2], -9.81, 1e-9); // Level and unaccelerated: only the ground's push
+                EXPECT_NEAR(sample.values[3], 0.0, 1e-12);
+                break;
+            case SensorKind::Gps:
+                EXPECT_NEAR(sample.values[0], 5.0 * sample.time, 1e-9);
+                EXPECT_NEAR(sample.values[2], -100.0, 1e-9);
+                EXPECT_NEAR(sample.values[3], 5.0, 1e-9);
+                break;
+            case SensorKind::Baro:
+                EXPECT_NEAR(sample.values[1], 100.0, 1e-9);
+                EXPECT_NEAR(sample.values[0], 100129.4, 0.5);
+                break;
+        }
+    }
+    EXPECT_EQ(counts[0], 1001u);
+    EXPECT_EQ(counts[1], 10u); // 0.0 .. 0.9 s; 1.0 s waits out its 0.1 s latency
+    EXPECT_EQ(counts[2], 50u);
+    EXPECT_EQ(suite.getPending(), 2u);
+    
+    // A snapshot that does not move time forward is ignored
+    const SensorSnapshot repeat{levelFlight(7, 5.0, 0.01, 100).back()};
+    suite.process(&repeat, 1, samples);
+    EXPECT_EQ(suite.getStale(), 1u);
+}
+
+TEST(SensorSuiteTest, NoiseDoesNotDependOnBatching) {
+    const std::uint32_t ids[]{3, 7, 11, 42};
+    std::vector<std::vector<SensorSnapshot>> flights;
+    for (std::uint32_t id : ids) {
+        flights.push_back(levelFlight(id, 3.0 + id * 0.1, 0.005, 40));
+    }
+    
+    // All vehicles in one process() call per time step
+    SensorSuite together;
+    std::vector<SensorSample> batched;
+    std::vector<SensorSnapshot> step;
+    for (std::size_t i = 0; i < flights[0].size(); ++i) {
+        step.clear();
+        for (const auto& flight : flights) {
+            step.push_back(flight[i]);
+        }
+        together.process(step.data(), step.size(), batched);
+    }
+    
+    // One snapshot per call, vehicles back to front; and the last vehicle on a suite of its own
+    SensorSuite apart;
+    SensorSuite alone;
+    std::vector<SensorSample> single;
+    std::vector<SensorSample> own;
+    for (auto flight = flights.rbegin(); flight != flights.rend(); ++flight) {
+        for (const SensorSnapshot& snapshot : *flight) {
+            apart.process(&snapshot, 1, single);
+        }
+    }
+    alone.process(flights.back().data(), flights.back().size(), own);
+    
+    batched = sortedSamples(batched);
+    single = sortedSamples(single);
+    ASSERT_EQ(batched.size(), single.size());
+    ASSERT_FALSE(batched.empty());
+    for (std::size_t i = 0; i < batched.size(); ++i) {
+        EXPECT_EQ(std::memcmp(&batched[i], &single[i], sizeof(SensorSample)), 0) << i;
+    }
+    
+    own = sortedSamples(own);
+    const auto first = std::find_if(batched.begin(), batched.end(),
+                                    [](const SensorSample& s) { return s.vehicle_id == 42; });
+    ASSERT_EQ(static_cast<std::size_t>(batched.end() - first), own.size());
+    EXPECT_EQ(std::memcmp(&*first, own.data(), own.size() * sizeof(SensorSample)), 0);
+    
+    // Another seed, other noise
+    SensorSettings reseeded;
+    reseeded.seed = 1;
+    SensorSuite other{reseeded};
+    std::vector<SensorSample> different;
+    other.process(flights.back().data(), flights.back().size(), different);
+    different = sortedSamples(different);
+    ASSERT_EQ(different.size(), own.size());
+    EXPECT_NE(different[0].values[0], own[0].values[0]);
+}
+
+TEST(SensorSuiteTest, NoiseAndBiasesMatchTheirSettings) {
+    SensorSettings settings{noiseFreeSensors()};
+    settings.imu.accel.noise = 0.5;
+    settings.imu.gyro.bias = 0.2;
+    settings.gps.rate = 0.0;
+    settings.baro.rate = 0.0;
+    SensorSuite suite{settings};
+    
+    // White noise about the truth on one vehicle over 4 s
+    std::vector<SensorSample> samples;
+    const std::vector<SensorSnapshot> flight{levelFlight(1, 4.0, 0.01, 400)};
+    suite.process(flight.data(), flight.size(), samples);
+    RunningStats accel;
+    for (const SensorSample& sample : samples) {
+        accel.add(sample.values[0]);
+    }
+    EXPECT_EQ(accel.count(), 4001u);
+    EXPECT_NEAR(accel.mean(), 0.0, 0.04);
+    EXPECT_NEAR(accel.stddev(), 0.5, 0.03);
+    
+    // A fixed turn-on bias per vehicle, spread across vehicles
+    RunningStats bias;
+    for (std::uint32_t id = 100; id < 1100; ++id) {
+        samples.clear();
+        const SensorSnapshot snapshot{id, 0.0, AircraftState{}};
+        suite.process(&snapshot, 1, samples);
+        ASSERT_EQ(samples.size(), 1u);
+        bias.add(samples[0].values[4]);
+    }
+    EXPECT_NEAR(bias.mean(), 0.0, 0.03);
+    EXPECT_NEAR(bias.stddev(), 0.2, 0.02);
+    
+    settings.gps.latency = -1.0;
+    EXPECT_THROW(SensorSuite{settings}, std::invalid_argument);
+}
+
+TEST(FleetDynamicsTest, MatchesSingleVehicleModel) {
+    FleetDynamics fleet;
+    std::vector<std::unique_ptr<FlightDynamics>> singles;
+    
+    for (int i = 0; i < 8; ++i) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(i, -i, -100.0);
+        state.velocity = Eigen::Vector3d(10.0 + i, 0.5 * i, -0.2 * i);
+        state.euler_angles = Eigen::Vector3d(0.05 * i, -0.03 * i, 0.2 * i);
+        state.angular_velocity = Eigen::Vector3d(0.01 * i, 0.02, -0.01);
+        
+        ControlInputs controls;
+        controls.throttle = 0.1 * i;
+        controls.aileron = 0.2 - 0.05 * i;
+        controls.elevator = 0.1;
+        controls.rudder = -0.1 * (i % 3);
+        
+        auto index = fleet.addVehicle(state);
+        fleet.setControls(index, controls);
+        fleet.setLiftCoefficient(index, 0.2 + 0.01 * i);
+        
+        singles.push_back(std::make_unique<FlightDynamics>());
+        singles.back()->setState(state);
+        singles.back()->setControls(controls);
+        singles.back()->setLiftCoefficient(0.2 + 0.01 * i);
+    }
+    
+    for (int step = 0; step < 100; ++step) {
+        fleet.update(0.01);
+        for (auto& single : singles) {
+            single->update(0.01);
+        }
+    }
+    
+    for (std::size_t i = 0; i < singles.size(); ++i) {
+        auto expected = singles[i]->getState();
+        auto actual = fleet.getState(i);
+        EXPECT_TRUE(actual.position.isApprox(expected.position, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.velocity.isApprox(expected.velocity, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.euler_angles.isApprox(expected.euler_angles, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.angular_velocity.isApprox(expected.angular_velocity, 1e-9)) << "vehicle " << i;
+    }
+}
+
+TEST(FleetDynamicsTest, SharedAeroTableMatchesSingleVehicleModel) {
+    const auto table = makeSyntheticAeroTable();
+    FleetDynamics fleet;
+    std::vector<std::unique_ptr<FlightDynamics>> singles;
+    
+    // Every other vehicle flies the shared table, the rest keep constant coefficients
+    for (int i = 0; i < 12; ++i) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(i, -i, -100.0);
+        state.velocity = Eigen::Vector3d(15.0 + i, 0.3 * i, 1.0 - 0.2 * i);
+        state.euler_angles = Eigen::Vector3d(0.02 * i, 0.05, 0.1 * i);
+        
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        controls.elevator = -0.4 + 0.08 * i;
+        
+        auto index = fleet.addVehicle(state);
+        fleet.setControls(index, controls);
+        fleet.setLiftCoefficient(index, 0.2);
+        singles.push_back(std::make_unique<FlightDynamics>());
+        singles.back()->setState(state);
+        singles.back()->setControls(controls);
+        singles.back()->setLiftCoefficient(0.2);
+        if (i % 2 == 0) {
+            fleet.setAeroTable(index, table);
+            singles.back()->setAeroTable(table);
+        }
+    }
+    EXPECT_EQ(table.use_count(), 1 + 2 * 6);
+    
+    for (int step = 0; step < 100; ++step) {
+        fleet.update(0.01);
+        for (auto& single : singles) {
+            single->update(0.01);
+        }
+    }
+    
+    for (std::size_t i = 0; i < singles.size(); ++i) {
+        auto expected = singles[i]->getState();
+        auto actual = fleet.getState(i);
+        EXPECT_TRUE(actual.position.isApprox(expected.position, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.velocity.isApprox(expected.velocity, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.euler_angles.isApprox(expected.euler_angles, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.angular_velocity.isApprox(expected.angular_velocity, 1e-9)) << "vehicle " << i;
+    }
+}
+
+TEST(FleetDynamicsTest, WindAndTurbulenceMatchSingleVehicleModel) {
+    const auto field = makeAffineWindField();
+    const auto table = makeSyntheticAeroTable();
+    const Eigen::Vector3d steady{1.0, -2.0, 0.2};
+    TurbulenceParameters turbulence;
+    turbulence.wind_speed_20ft = 8.0;
+    turbulence.seed = 40;
+    
+    FleetDynamics fleet;
+    fleet.setWind(steady);
+    fleet.setWindField(field);
+    fleet.setTurbulence(turbulence);
+    std::vector<std::unique_ptr<FlightDynamics>> singles;
+    
+    // Enough vehicles for more than one noise block and for prefetching; every third flies the aero table
+    for (int i = 0; i < 70; ++i) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(-400.0 + 12.0 * i, 250.0 + 3.0 * i, -150.0 - i);
+        state.velocity = Eigen::Vector3d(15.0 + 0.1 * i, 0.2, 0.5);
+        state.euler_angles = Eigen::Vector3d(0.01 * (i % 5), 0.03, 0.09 * i);
+        
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        controls.elevator = 0.1 * (i % 4);
+        
+        auto index = fleet.addVehicle(state);
+        fleet.setControls(index, controls);
+        fleet.setLiftCoefficient(index, 0.2);
+        singles.push_back(std::make_unique<FlightDynamics>());
+        singles.back()->setState(state);
+        singles.back()->setControls(controls);
+        singles.back()->setLiftCoefficient(0.2);
+        singles.back()->setWind(steady);
+        singles.back()->setWindField(field);
+        singles.back()->setTurbulence(TurbulenceParameters{turbulence.wind_speed_20ft, turbulence.seed + index});
+        if (i % 3 == 0) {
+            fleet.setAeroTable(index, table);
+            singles.back()->setAeroTable(table);
+        }
+    }
+    
+    for (int step = 0; step < 100; ++step) {
+        fleet.update(0.01);
+        for (auto& single : singles) {
+            single->update(0.01);
+        }
+    }
+    
+    for (std::size_t i = 0; i < singles.size(); ++i) {
+        auto expected = singles[i]->getState();
+        auto actual = fleet.getState(i);
+        EXPECT_TRUE(actual.position.isApprox(expected.position, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.velocity.isApprox(expected.velocity, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.euler_angles.isApprox(expected.euler_angles, 1e-9)) << "vehicle " << i;
+        EXPECT_TRUE(actual.angular_velocity.isApprox(expected.angular_velocity, 1e-9)) << "vehicle " << i;
+    }
+}
+
+TEST(FleetDynamicsTest, RangeUpdateAndBounds) {
+    FleetDynamics fleet;
+    fleet.reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        fleet.addVehicle();
+    }
+    EXPECT_EQ(fleet.size(), 4u);
+    
+    // Only the first half falls
+    fleet.updateRange(0, 2, 0.1);
+    EXPECT_GT(fleet.getState(0).velocity.z(), 0.0);
+    EXPECT_GT(fleet.getState(1).velocity.z(), 0.0);
+    EXPECT_EQ(fleet.getState(2).velocity.z(), 0.0);
+    
+    EXPECT_THROW(fleet.getState(4), std::out_of_range);
+}
+
+TEST(FleetDynamicsTest, SnapshotsMoveVehiclesBetweenFleets) {
+    TurbulenceParameters turbulence;
+    turbulence.wind_speed_20ft = 6.0;
+    turbulence.seed = 11;
+    
+    // Scalar kernel throughout, so a vehicle's new slot can't change its last bits
+    FleetDynamics reference;
+    reference.setTurbulence(turbulence);
+    reference.setSimdIsa(SimdIsa::Scalar);
+    for (int i = 0; i < 5; ++i) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(10.0 * i, 0.0, -100.0);
+        state.velocity = Eigen::Vector3d(15.0, 0.0, 0.5);
+        
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        controls.elevator = 0.05 * i;
+        
+        auto index = reference.addVehicle(state);
+        reference.setControls(index, controls);
+        reference.setLiftCoefficient(index, 0.2);
+    }
+    for (int step = 0; step < 20; ++step) {
+        reference.update(0.01);
+    }
+    
+    // Vehicle 1 moves over; the last vehicle takes its index and keeps its own gust stream
+    FleetDynamics source{reference};
+    FleetDynamics destination;
+    destination.setTurbulence(turbulence);
+    destination.setSimdIsa(SimdIsa::Scalar);
+    destination.addVehicle(source.snapshotVehicle(1));
+    source.removeVehicle(1);
+    ASSERT_EQ(source.size(), 4u);
+    EXPECT_EQ(source.getTurbulenceStream(1), 4u);
+    EXPECT_EQ(destination.getTurbulenceStream(0), 1u);
+    EXPECT_EQ(destination.getControls(0).elevator, reference.getControls(1).elevator);
+    EXPECT_THROW(source.removeVehicle(4), std::out_of_range);
+    
+    for (int step = 0; step < 30; ++step) {
+        reference.update(0.01);
+        source.update(0.01);
+        destination.update(0.01);
+    }
+    EXPECT_EQ(destination.getState(0).position, reference.getState(1).position);
+    EXPECT_EQ(destination.getState(0).velocity, reference.getState(1).velocity);
+    EXPECT_EQ(source.getState(1).position, reference.getState(4).position);
+    EXPECT_EQ(source.getState(1).angular_velocity, reference.getState(4).angular_velocity);
+    EXPECT_EQ(source.getState(0).euler_angles, reference.getState(0).euler_angles);
+}
+
+TEST(FleetDynamicsTest, SimdKernelsMatchScalar) {
+    // 37 vehicles so every vector width leaves a scalar tail
+    FleetDynamics reference;
+    for (int i = 0; i < 37; ++i) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(i, 2.0 * i, -50.0);
+        state.velocity = Eigen::Vector3d(0.05 * i, 0.1 * (i % 5), -0.3 * (i % 7)); // Some below the lift threshold
+        state.euler_angles = Eigen::Vector3d(-1.5 + 0.08 * i, 0.7 - 0.04 * i, -40.0 + 2.5 * i);
+        state.angular_velocity = Eigen::Vector3d(0.1, -0.05 * (i % 3), 0.02 * i);
+        auto index = reference.addVehicle(state);
+        
+        ControlInputs controls;
+        controls.throttle = (i % 10) / 10.0;
+        controls.aileron = -0.5 + 0.03 * i;
+        controls.elevator = 0.2;
+        controls.rudder = (i % 2) ? 0.3 : -0.3;
+        reference.setControls(index, controls);
+        reference.setLiftCoefficient(index, 0.1);
+    }
+    reference.setSimdIsa(SimdIsa::Scalar);
+    
+    for (SimdIsa isa : {SimdIsa::Neon, SimdIsa::Avx2, SimdIsa::Avx512}) {
+        if (!isSimdIsaAvailable(isa)) {
+            EXPECT_THROW(FleetDynamics{}.setSimdIsa(isa), std::invalid_argument);
+            continue;
+        }
+        
+        FleetDynamics scalar{reference};
+        FleetDynamics vector{reference};
+        vector.setSimdIsa(isa);
+        for (int step = 0; step < 50; ++step) {
+            scalar.update(0.01);
+            vector.update(0.01);
+        }
+        
+        for (std::size_t i = 0; i < scalar.size(); ++i) {
+            auto expected = scalar.getState(i);
+            auto actual = vector.getState(i);
+            EXPECT_TRUE(actual.position.isApprox(expected.position, 1e-10)) << simdIsaName(isa) << " vehicle " << i;
+            EXPECT_TRUE(actual.velocity.isApprox(expected.velocity, 1e-10)) << simdIsaName(isa) << " vehicle " << i;
+            EXPECT_TRUE(actual.euler_angles.isApprox(expected.euler_angles, 1e-10)) << simdIsaName(isa) << " vehicle " << i;
+            EXPECT_TRUE(actual.angular_velocity.isApprox(expected.angular_velocity, 1e-10)) << simdIsaName(isa) << " vehicle " << i;
+        }
+    }
+}
+
+TEST(SimulationPoolTest, ParallelForVisitsEveryIndexOnce) {
+    SimulationPool pool{4};
+    std::vector<std::atomic<int>> visits(10007);
+    
+    for (int round = 0; round < 20; ++round) {
+        pool.parallelFor(visits.size(), 13, [&visits](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                visits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    
+    for (const auto& count : visits) {
+        ASSERT_EQ(count.load(), 20);
+    }
+}
+
+TEST(SimulationPoolTest, PropagatesExceptions) {
+    SimulationPool pool{3};
+    EXPECT_THROW(pool.parallelFor(100, 1, [](std::size_t begin, std::size_t) {
+        if (begin == 42) {
+            throw std::runtime_error{"boom"};
+        }
+    }), std::runtime_error);
+    
+    // Still usable afterwards
+    std::atomic<std::size_t> total{0};
+    pool.parallelFor(100, 7, [&total](std::size_t begin, std::size_t end) { total += end - begin; });
+    EXPECT_EQ(total.load(), 100u);
+}
+
+TEST(SimulationPoolTest, LockstepMatchesSequentialStepping) {
+    SimulationPool pool{4};
+    std::vector<std::unique_ptr<FlightDynamics>> reference;
+    
+    for (int i = 0; i < 50; ++i) {
+        ControlInputs controls;
+        controls.throttle = 0.01 * i;
+        controls.aileron = 0.02 * (i % 7);
+        
+        auto vehicle = std::make_unique<FlightDynamics>();
+        vehicle->setControls(controls);
+        pool.addVehicle(std::move(vehicle));
+        
+        reference.push_back(std::make_unique<FlightDynamics>());
+        reference.back()->setControls(controls);
+    }
+    pool.setVehiclesPerChunk(3);
+    
+    std::uint64_t ticksSeen{0};
+    pool.step(0.01, 25, [&ticksSeen](std::uint64_t) { ++ticksSeen; });
+    EXPECT_EQ(ticksSeen, 25u);
+    
+    for (int tick = 0; tick < 25; ++tick) {
+        for (auto& vehicle : reference) {
+            vehicle->update(0.01);
+        }
+    }
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        EXPECT_EQ(pool.vehicle(i).getState().position, reference[i]->getState().position);
+    }
+    
+    // Free-running produces the same trajectories without the per-tick barrier
+    pool.run(0.01, 10);
+    for (auto& vehicle : reference) {
+        for (int tick = 0; tick < 10; ++tick) {
+            vehicle->update(0.01);
+        }
+    }
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        EXPECT_EQ(pool.vehicle(i).getState().velocity, reference[i]->getState().velocity);
+    }
+}
+
+TEST(SimulationPoolTest, StepsFleetChunks) {
+    SimulationPool pool{2};
+    FleetDynamics fleet;
+    for (int i = 0; i < 1000; ++i) {
+        fleet.addVehicle();
+    }
+    FleetDynamics reference{fleet};
+    
+    pool.stepFleet(fleet, 0.01, 100);
+    reference.update(0.01);
+    
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        ASSERT_EQ(fleet.getState(i).velocity, reference.getState(i).velocity);
+    }
+}
+
+namespace {
+
+// Every pair closer than radius by testing all of them, in findPairs() order-independent form
+std::vector<std::pair<std::uint32_t, std::uint32_t>> bruteForcePairs(const std::vector<double>& north,
+                                                                     const std::vector<double>& east,
+                                                                     const std::vector<double>& down,
+                                                                     double radius) {
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    for (std::uint32_t i = 0; i < north.size(); ++i) {
+        for (std::uint32_t j = i + 1; j < north.size(); ++j) {
+            const double dn{north[j] - north[i]};
+            const double de{east[j] - east[i]};
+            const double dd{down[j] - down[i]};
+            if (dn * dn + de * de + dd * dd < radius * radius) {
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+    return pairs;
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> sortedPairs(const std::vector<ProximityPair>& found) {
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    for (const ProximityPair& pair : found) {
+        pairs.emplace_back(pair.first, pair.second);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+} // namespace
+
+TEST(OnlineStatsTest, MergedStatsAndSketchQuantilesMatchTheSamples) {
+    std::mt19937_64 rng{7};
+    std::normal_distribution<double> normal{-3.0, 20.0};
+    std::vector<double> samples(10000);
+    for (double& sample : samples) {
+        sample = normal(rng);
+    }
+    
+    // Two halves accumulated apart and merged, as per-thread partials would be
+    RunningStats first;
+    RunningStats second;
+    QuantileSketch left;
+    QuantileSketch right;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        (i % 3 == 0 ? first : second).add(samples[i]);
+        (i % 3 == 0 ? left : right).add(samples[i]);
+    }
+    first.merge(second);
+    left.merge(right);
+    
+    double mean{0.0};
+    for (const double sample : samples) {
+        mean += sample;
+    }
+    mean /= static_cast<double>(samples.size());
+    double squares{0.0};
+    for (const double sample : samples) {
+        squares += (sample - mean) * (sample - mean);
+    }
+    EXPECT_EQ(first.count(), samples.size());
+    EXPECT_NEAR(first.mean(), mean, 1e-9);
+    EXPECT_NEAR(first.variance(), squares / static_cast<double>(samples.size() - 1), 1e-6);
+    
+    // Each quantile is within the sketch's relative accuracy of the exact nearest-rank sample
+    std::sort(samples.begin(), samples.end());
+    EXPECT_EQ(left.count(), samples.size());
+    EXPECT_EQ(left.quantile(0.0), samples.front());
+    EXPECT_EQ(left.quantile(1.0), samples.back());
+    for (const double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+        const double exact{samples[static_cast<std::size_t>(std::llround(q * (samples.size() - 1)))]};
+        EXPECT_NEAR(left.quantile(q), exact, 0.016 * std::fabs(exact) + 1e-6) << "q = " << q;
+    }
+}
+
+SweepGrid smallSweepGrid() {
+    SweepGrid grid;
+    grid.mass = {0.8, 1.2};
+    grid.lift_coefficient = {1.0, 1.3};
+    grid.wind = {Eigen::Vector3d::Zero(), Eigen::Vector3d{1.0, -1.0, 0.0}};
+    AircraftState launch;
+    launch.position = Eigen::Vector3d{0, 0, -50};
+    launch.velocity = Eigen::Vector3d{4.0, 0, 0};
+    AircraftState dropped{launch};
+    dropped.position.z() = -0.5;
+    dropped.velocity.x() = 0.0;
+    grid.initial_state = {launch, dropped};
+    ControlKeyframe cruise;
+    cruise.controls.throttle = 0.05;
+    ControlKeyframe roll{cruise};
+    roll.time = 0.5;
+    roll.controls.aileron = 0.2;
+    grid.schedule = {ControlSchedule{}, ControlSchedule{cruise, roll}};
+    return grid;
+}
+
+TEST(SweepRunnerTest, GridRunsMatchDirectFlightOnAnyThreadCount) {
+    const SweepSpace space{SweepSpace::grid(smallSweepGrid())};
+    ASSERT_EQ(space.size(), 32u);
+    EXPECT_DOUBLE_EQ(space.caseAt(0).mass, 0.8);
+    EXPECT_DOUBLE_EQ(space.caseAt(16).mass, 1.2);
+    EXPECT_FALSE(space.caseAt(0).schedule);
+    EXPECT_TRUE(space.caseAt(1).schedule);
+    EXPECT_THROW(static_cast<void>(space.caseAt(32)), std::out_of_range);
+    
+    SweepSettings settings;
+    settings.duration = 2.0;
+    settings.timestep = 0.01;
+    settings.cases_per_chunk = 3;
+    
+    // Reference: each case on a fresh model, on this thread
+    std::vector<SweepRunSummary> expected;
+    for (std::uint64_t i = 0; i < space.size(); ++i) {
+        FlightDynamics dynamics;
+        expected.push_back(SweepRunner::fly(space.caseAt(i), i, settings, dynamics));
+    }
+    
+    for (const std::size_t threads : {std::size_t{1}, std::size_t{3}}) {
+        SweepRunner runner{threads};
+        std::vector<SweepRunSummary> runs;
+        const SweepAggregate result{runner.run(space, settings, [&runs](const SweepRunSummary& run) {
+            runs.push_back(run);
+        })};
+        
+        // Every case once, bit for bit as flown alone
+        ASSERT_EQ(runs.size(), expected.size());
+        std::sort(runs.begin(), runs.end(), [](const SweepRunSummary& a, const SweepRunSummary& b) {
+            return a.case_index < b.case_index;
+        });
+        std::uint64_t impacts{0};
+        std::uint64_t diverged{0};
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            ASSERT_EQ(runs[i].case_index, i);
+            EXPECT_EQ(runs[i].steps, expected[i].steps);
+            EXPECT_EQ(runs[i].outcome, expected[i].outcome);
+            for (std::size_t metric = 0; metric < kSweepMetricCount; ++metric) {
+                EXPECT_EQ(runs[i].metrics[metric], expected[i].metrics[metric]);
+            }
+            impacts += runs[i].outcome == SweepOutcome::GroundImpact ? 1 : 0;
+            diverged += runs[i].outcome == SweepOutcome::Diverged ? 1 : 0;
+        }
+        
+        EXPECT_EQ(result.getRuns(), space.size());
+        EXPECT_EQ(result.getOutcomeCount(SweepOutcome::GroundImpact), impacts);
+        EXPECT_EQ(result.getOutcomeCount(SweepOutcome::Diverged), diverged);
+        EXPECT_EQ(result.getOutcomeCount(SweepOutcome::Completed) + impacts + diverged, space.size());
+        EXPECT_EQ(result.stats(SweepMetric::EndTime).count(), space.size() - diverged);
+        EXPECT_EQ(result.getSteps(), std::accumulate(runs.begin(), runs.end(), std::uint64_t{0},
+                                                     [](std::uint64_t sum, const SweepRunSummary& run) {
+                                                         return sum + run.steps;
+                                                     }));
+        EXPECT_EQ(result.quantiles(SweepMetric::MinAltitude).quantile(0.0),
+                  result.stats(SweepMetric::MinAltitude).min());
+    }
+    
+    // Dropped half a metre up from a standstill, the aircraft is on the ground well before the duration
+    const SweepRunSummary& dropped{expected[2]};
+    ASSERT_EQ(dropped.outcome, SweepOutcome::GroundImpact);
+    EXPECT_LT(dropped.metric(SweepMetric::EndTime), settings.duration);
+    EXPECT_LT(dropped.metric(SweepMetric::FinalAltitude), 0.0);
+    EXPECT_EQ(expected[0].outcome, SweepOutcome::Completed);
+    EXPECT_NEAR(expected[0].metric(SweepMetric::EndTime), settings.duration, 1e-12);
+    EXPECT_EQ(expected[0].steps, 200u);
+}
+
+TEST(SweepRunnerTest, MonteCarloCasesDependOnlyOnSeedAndIndex) {
+    SweepRanges ranges;
+    ranges.mass[0] = 0.5;
+    ranges.mass[1] = 2.0;
+    ranges.wind_min = Eigen::Vector3d{-4.0, -4.0, 0.0};
+    ranges.wind_max = Eigen::Vector3d{4.0, 4.0, 0.0};
+    ranges.initial_state.position = Eigen::Vector3d{0, 0, -100};
+    ranges.position_spread = Eigen::Vector3d{10.0, 10.0, 5.0};
+    ranges.seed = 99;
+    
+    const SweepSpace space{SweepSpace::monteCarlo(ranges, 1000)};
+    const SweepSpace same{SweepSpace::monteCarlo(ranges, 10)};
+    ranges.seed = 100;
+    const SweepSpace other{SweepSpace::monteCarlo(ranges, 10)};
+    RunningStats mass;
+    for (std::uint64_t i = 0; i < space.size(); ++i) {
+        const SweepCase sweepCase{space.caseAt(i)};
+        ASSERT_GE(sweepCase.mass, 0.5);
+        ASSERT_LE(sweepCase.mass, 2.0);
+        ASSERT_LE(sweepCase.wind.head<2>().cwiseAbs().maxCoeff(), 4.0);
+        ASSERT_EQ(sweepCase.wind.z(), 0.0);
+        ASSERT_LE(std::fabs(sweepCase.initial_state.position.z() + 100.0), 5.0);
+        mass.add(sweepCase.mass);
+    }
+    EXPECT_NEAR(mass.mean(), 1.25, 0.05);
+    for (std::uint64_t i = 0; i < same.size(); ++i) {
+        EXPECT_EQ(same.caseAt(i).mass, space.caseAt(i).mass);
+        EXPECT_EQ(same.caseAt(i).initial_state.position, space.caseAt(i).initial_state.position);
+        EXPECT_NE(other.caseAt(i).mass, space.caseAt(i).mass);
+    }
+    
+    SweepRunner runner{2};
+    SweepSettings settings;
+    settings.timestep = 0.0;
+    EXPECT_THROW(static_cast<void>(runner.run(space, settings)), std::invalid_argument);
+    SweepGrid empty;
+    empty.wind.clear();
+    EXPECT_THROW(static_cast<void>(SweepSpace::grid(empty)), std::invalid_argument);
+}
+
+TEST(SpatialGridTest, FindsTheSamePairsAsBruteForceAcrossUpdates) {
+    // 400 vehicles in a 600 m cube straddling the origin, so negative cells are covered too
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<double> position{-300.0, 300.0};
+    std::uniform_real_distribution<double> drift{-4.0, 4.0};
+    std::vector<double> north(400), east(400), down(400);
+    for (std::size_t i = 0; i < north.size(); ++i) {
+        north[i] = position(rng);
+        east[i] = position(rng);
+        down[i] = position(rng);
+    }
+    
+    SpatialGrid grid{50.0};
+    for (int step = 0; step < 5; ++step) {
+        grid.update(north.data(), east.data(), down.data(), north.size());
+        ASSERT_EQ(grid.size(), north.size());
+        if (step == 0) {
+            EXPECT_EQ(grid.getMovedCount(), north.size());
+        } else {
+            // A few metres of drift moves only some vehicles into another cell
+            EXPECT_GT(grid.getMovedCount(), 0u);
+            EXPECT_LT(grid.getMovedCount(), north.size() / 2);
+        }
+        
+        // Within one cell, and reaching three cells out
+        std::vector<ProximityPair> found;
+        for (const double radius : {50.0, 120.0}) {
+            grid.findPairs(radius, found);
+            ASSERT_EQ(sortedPairs(found), bruteForcePairs(north, east, down, radius)) << "step " << step;
+        }
+        grid.findPairs(50.0, found);
+        for (const ProximityPair& pair : found) {
+            const double dn{north[pair.second] - north[pair.first]};
+            const double de{east[pair.second] - east[pair.first]};
+            const double dd{down[pair.second] - down[pair.first]};
+            EXPECT_DOUBLE_EQ(pair.distance, std::sqrt(dn * dn + de * de + dd * dd));
+        }
+        
+        std::vector<std::uint32_t> neighbors;
+        grid.findNeighbors(10.0, -20.0, 30.0, 80.0, neighbors);
+        std::sort(neighbors.begin(), neighbors.end());
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t i = 0; i < north.size(); ++i) {
+            const double dn{north[i] - 10.0};
+            const double de{east[i] + 20.0};
+            const double dd{down[i] - 30.0};
+            if (dn * dn + de * de + dd * dd < 80.0 * 80.0) {
+                expected.push_back(i);
+            }
+        }
+        ASSERT_EQ(neighbors, expected);
+        
+        for (std::size_t i = 0; i < north.size(); ++i) {
+            north[i] += drift(rng);
+            east[i] += drift(rng);
+            down[i] += drift(rng);
+        }
+    }
+    
+    // A different count starts over
+    grid.update(north.data(), east.data(), down.data(), 10);
+    EXPECT_EQ(grid.size(), 10u);
+    EXPECT_EQ(grid.getMovedCount(), 10u);
+    
+    // Far beyond the key space every vehicle shares an edge cell, which still pairs correctly
+    const std::vector<double> farNorth{1e12, 1e12 + 10.0, -1e12, 0.0};
+    const std::vector<double> farEast{0.0, 0.0, 5e11, 0.0};
+    const std::vector<double> farDown{-1e12, -1e12, 0.0, 0.0};
+    SpatialGrid edges{50.0};
+    edges.update(farNorth.data(), farEast.data(), farDown.data(), farNorth.size());
+    std::vector<ProximityPair> found;
+    edges.findPairs(50.0, found);
+    EXPECT_EQ(sortedPairs(found), bruteForcePairs(farNorth, farEast, farDown, 50.0));
+    EXPECT_THROW(SpatialGrid{0.0}, std::invalid_argument);
+}
+
+TEST(TerrainMapTest, InterpolatesAcrossTilesAndClamps) {
+    // An affine surface is reproduced exactly by bilinear interpolation, including across tile seams
+    TerrainSpec spec;
+    spec.samples[0] = 40;
+    spec.samples[1] = 35;
+    spec.origin[0] = -500.0;
+    spec.origin[1] = 200.0;
+    spec.spacing[0] = 25.0;
+    spec.spacing[1] = 10.0;
+    const auto surface = [](double north, double east) { return 120.0 + 0.05 * north - 0.125 * east; };
+    std::vector<float> heights;
+    for (std::size_t n = 0; n < spec.samples[0]; ++n) {
+        for (std::size_t e = 0; e < spec.samples[1]; ++e) {
+            heights.push_back(static_cast<float>(surface(-500.0 + 25.0 * n, 200.0 + 10.0 * e)));
+        }
+    }
+    const TerrainMap terrain{spec, heights};
+    EXPECT_EQ(terrain.getTileCount(), 3u * 3u);
+    
+    for (const double north : {-500.0, -126.0, -125.0, -124.0, 0.0, 374.9, 475.0}) {
+        for (const double east : {200.0, 349.0, 350.0, 351.0, 540.0}) {
+            EXPECT_NEAR(terrain.heightAt(north, east), surface(north, east), 1e-4) << north << ", " << east;
+        }
+    }
+    
+    // The edge height holds outside the map
+    EXPECT_NEAR(terrain.heightAt(-2000.0, 0.0), surface(-500.0, 200.0), 1e-4);
+    EXPECT_NEAR(terrain.heightAt(5000.0, 5000.0), surface(475.0, 540.0), 1e-4);
+    
+    // The ground at the first sample is 70 m, so 100 m up (down = -100) clears it by 30 m
+    EXPECT_NEAR(terrain.heightAboveGround(-500.0, 200.0, -100.0), 30.0, 1e-4);
+    
+    EXPECT_THROW((TerrainMap{spec, std::vector<float>(10)}), std::invalid_argument);
+    spec.samples[1] = 1;
+    EXPECT_THROW((TerrainMap{spec, std::vector<float>(40)}), std::invalid_argument);
+}
+
+TEST(ProximityMonitorTest, ReportsConflictsCollisionsAndGroundContact) {
+    // Ground rises 1 m per 10 m north
+    TerrainSpec spec;
+    spec.samples[0] = 3;
+    spec.samples[1] = 2;
+    spec.spacing[0] = spec.spacing[1] = 100.0;
+    auto terrain = std::make_shared<const TerrainMap>(spec, std::vector<float>{0.0f, 0.0f, 10.0f, 10.0f, 20.0f, 20.0f});
+    
+    FleetDynamics fleet;
+    const Eigen::Vector3d positions[]{
+        {0.0, 0.0, -100.0},   // 0: conflicts with 1
+        {0.0, 30.0, -100.0},  // 1
+        {150.0, 0.0, -15.5},  // 2: 0.5 m above 15 m terrain
+        {150.0, 2.0, -15.5},  // 3: collides with 2
+        {200.0, 50.0, -18.0}, // 4: 2 m below 20 m terrain
+    };
+    for (const Eigen::Vector3d& position : positions) {
+        AircraftState state;
+        state.position = position;
+        fleet.addVehicle(state);
+    }
+    
+    ProximitySettings settings;
+    settings.separation = 50.0;
+    settings.collision_radius = 3.0;
+    settings.ground_clearance = 1.0;
+    ProximityMonitor monitor{settings};
+    monitor.setTerrain(terrain);
+    monitor.update(fleet);
+    
+    ASSERT_EQ(sortedPairs(monitor.getConflicts()),
+              (std::vector<std::pair<std::uint32_t, std::uint32_t>>{{0, 1}, {2, 3}}));
+    ASSERT_EQ(monitor.getCollisions().size(), 1u);
+    EXPECT_EQ(monitor.getCollisions()[0].first, 2u);
+    EXPECT_EQ(monitor.getCollisions()[0].second, 3u);
+    EXPECT_DOUBLE_EQ(monitor.getCollisions()[0].distance, 2.0);
+    EXPECT_EQ(monitor.getGroundContacts(), (std::vector<std::uint32_t>{2, 3, 4}));
+    EXPECT_NEAR(monitor.heightAboveGround()[0], 100.0, 1e-9);
+    EXPECT_NEAR(monitor.heightAboveGround()[4], -2.0, 1e-5);
+    
+    // Scenario code typically reacts in the lockstep tick callback; telemetry gets the counters
+    const ProximityStats stats{monitor.getStats()};
+    EXPECT_EQ(stats.updates, 1u);
+    EXPECT_EQ(stats.vehicles, 5u);
+    EXPECT_EQ(stats.conflicts, 2u);
+    EXPECT_EQ(stats.collisions, 1u);
+    EXPECT_EQ(stats.ground_contacts, 3u);
+    EXPECT_DOUBLE_EQ(stats.min_separation, 2.0);
+    EXPECT_EQ(stats.update_time.count, 1u);
+    MetricsReport report;
+    appendMetrics(report, stats);
+    EXPECT_NE(report.str().find("falconsim_proximity_collisions 1"), std::string::npos);
+    EXPECT_NE(report.str().find("falconsim_proximity_ground_contacts 3"), std::string::npos);
+    
+    // Without terrain the ground is altitude 0
+    monitor.setTerrain(nullptr);
+    monitor.update(fleet);
+    EXPECT_TRUE(monitor.getGroundContacts().empty());
+    
+    settings.collision_radius = 60.0;
+    EXPECT_THROW(monitor.setSettings(settings), std::invalid_argument);
+}
+
+namespace {
+
+TelemetryData sampleTelemetry() {
+    TelemetryData data;
+    data.timestamp = 1234.5;
+    data.position_north = 10.25;
+    data.position_east = -3.5;
+    data.position_down = -100.0;
+    data.velocity_x = 15.0;
+    data.velocity_y = 0.125;
+    data.velocity_z = -0.75;
+    data.roll = 0.1;
+    data.pitch = -0.2;
+    data.yaw = 3.0;
+    data.throttle = 0.8;
+    data.aileron = -0.25;
+    data.elevator = 0.5;
+    data.rudder = 0.0625;
+    return data;
+}
+
+} // namespace
+
+TEST(TelemetryCodecTest, BinaryRoundTrip) {
+    const TelemetryData data{sampleTelemetry()};
+    TelemetryFrameBuffer frame;
+    ASSERT_EQ(encodeTelemetryBinary(data, 42, frame), telemetry_wire::kStateFrameSize);
+    
+    // Header is little-endian and starts with the magic
+    EXPECT_EQ(std::memcmp(frame.bytes.data(), "FSIM", 4), 0);
+    EXPECT_EQ(frame.bytes[4], telemetry_wire::kVersion);
+    EXPECT_EQ(frame.bytes[6], telemetry_wire::kStatePayloadSize);
+    EXPECT_EQ(frame.bytes[8], 42);
+    
+    TelemetryData decoded;
+    std::uint32_t sequence{0};
+    ASSERT_TRUE(decodeTelemetry(frame.bytes.data(), frame.size, decoded, &sequence));
+    EXPECT_EQ(sequence, 42u);
+    EXPECT_EQ(std::memcmp(&decoded, &data, sizeof(TelemetryData)), 0);
+}
+
+TEST(TelemetryCodecTest, CsvFallbackRoundTrip) {
+    const TelemetryData data{sampleTelemetry()};
+    TelemetryFrameBuffer frame;
+    ASSERT_GT(encodeTelemetry(TelemetryEncoding::Csv, data, 0, frame), 0u);
+    
+    const std::string text(reinterpret_cast<const char*>(frame.bytes.data()), frame.size);
+    EXPECT_EQ(text.rfind("1234.500000,10.250000,", 0), 0u);
+    
+    TelemetryData decoded;
+    ASSERT_TRUE(decodeTelemetry(frame.bytes.data(), frame.size, decoded));
+    EXPECT_DOUBLE_EQ(decoded.position_down, -100.0);
+    EXPECT_DOUBLE_EQ(decoded.rudder, 0.0625);
+}
+
+TEST(TelemetryCodecTest, RejectsMalformedFrames) {
+    TelemetryFrameBuffer frame;
+    encodeTelemetryBinary(sampleTelemetry(), 1, frame);
+    TelemetryData decoded;
+    
+    // Truncated payload
+    EXPECT_FALSE(decodeTelemetry(frame.bytes.data(), frame.size - 1, decoded));
+    
+    // Unknown version
+    frame.bytes[4] = telemetry_wire::kVersion + 1;
+    EXPECT_FALSE(decodeTelemetry(frame.bytes.data(), frame.size, decoded));
+    
+    // CSV with missing fields
+    const char* shortCsv{"1.0,2.0,3.0"};
+    EXPECT_FALSE(decodeTelemetry(reinterpret_cast<const std::uint8_t*>(shortCsv),
+                                 std::strlen(shortCsv), decoded));
+}
+
+TEST(TelemetryCodecTest, SensorBatchRoundTrip) {
+    std::vector<SensorSample> samples(30);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i].vehicle_id = static_cast<std::uint32_t>(1000 + i);
+        samples[i].kind = static_cast<SensorKind>(1 + i % kSensorKindCount);
+        samples[i].time = 0.001 * i;
+        for (std::size_t v = 0; v < kSensorValueCount; ++v) {
+            samples[i].values[v] = i * 10.0 + v + 0.125;
+        }
+    }
+    
+    TelemetryFrameBuffer frame;
+    ASSERT_EQ(encodeSensorBatch(samples.data(), samples.size(), 9, frame), telemetry_wire::kMaxSensorSamples);
+    EXPECT_LE(frame.size, telemetry_wire::kMaxDatagramSize);
+    
+    std::vector<SensorSample> decoded(telemetry_wire::kMaxSensorSamples);
+    std::uint32_t sequence{0};
+    ASSERT_EQ(decodeSensorSamples(frame.bytes.data(), frame.size, decoded.data(), decoded.size(), &sequence),
+              telemetry_wire::kMaxSensorSamples);
+    EXPECT_EQ(sequence, 9u);
+    EXPECT_EQ(std::memcmp(decoded.data(), samples.data(), decoded.size() * sizeof(SensorSample)), 0);
+    
+    // Telemetry decoders ignore the frame type; unknown sensor kinds are malformed
+    TelemetrySample telemetry;
+    EXPECT_EQ(decodeTelemetrySamples(frame.bytes.data(), frame.size, &telemetry, 1), 0u);
+    frame.bytes[telemetry_wire::kHeaderSize + telemetry_wire::kSensorPrefixSize + 4] = 9;
+    EXPECT_EQ(decodeSensorSamples(frame.bytes.data(), frame.size, decoded.data(), decoded.size()), 0u);
+}
+
+namespace {
+
+// Polls until the predicate holds or the timeout passes
+template <typename Predicate>
+bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(TelemetryCodecTest, BatchPacksSamplesIntoOneDatagram) {
+    std::vector<TelemetrySample> samples(telemetry_wire::kMaxBatchSamples + 1);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i].vehicle_id = static_cast<std::uint32_t>(100 + i);
+        samples[i].data = sampleTelemetry();
+        samples[i].data.timestamp = static_cast<double>(i);
+    }
+    
+    // Only what fits in one MTU-sized datagram is packed
+    TelemetryFrameBuffer frame;
+    const std::size_t packed{encodeTelemetryBatch(samples.data(), samples.size(), 7, frame)};
+    EXPECT_EQ(packed, telemetry_wire::kMaxBatchSamples);
+    EXPECT_LE(frame.size, telemetry_wire::kMaxDatagramSize);
+    
+    std::array<TelemetrySample, telemetry_wire::kMaxBatchSamples> decoded{};
+    std::uint32_t sequence{0};
+    ASSERT_EQ(decodeTelemetrySamples(frame.bytes.data(), frame.size, decoded.data(), decoded.size(), &sequence),
+              packed);
+    EXPECT_EQ(sequence, 7u);
+    for (std::size_t i = 0; i < packed; ++i) {
+        EXPECT_EQ(decoded[i].vehicle_id, samples[i].vehicle_id);
+        EXPECT_DOUBLE_EQ(decoded[i].data.timestamp, static_cast<double>(i));
+        EXPECT_DOUBLE_EQ(decoded[i].data.rudder, 0.0625);
+    }
+    
+    // Single-sample decoding does not accept batches; truncated batches are rejected
+    TelemetryData single;
+    EXPECT_FALSE(decodeTelemetry(frame.bytes.data(), frame.size, single));
+    EXPECT_EQ(decodeTelemetrySamples(frame.bytes.data(), frame.size - 1, decoded.data(), decoded.size()), 0u);
+}
+
+TEST(CompactTelemetryTest, KeyframesAndDeltasRoundTripWithinQuantization) {
+    CompactTelemetryEncoder encoder{10};
+    CompactTelemetryDecoder decoder;
+    TelemetryFrameBuffer frame;
+    
+    std::size_t deltaBytes{0};
+    std::size_t deltaFrames{0};
+    for (int i = 0; i < 50; ++i) {
+        TelemetrySample sample{3, sampleTelemetry()};
+        sample.data.timestamp = 1.7e9 + 0.02 * i;
+        sample.data.position_north += 0.3 * i;
+        sample.data.yaw += 0.01 * i;
+        sample.data.aileron = std::sin(0.1 * i);
+        
+        const std::size_t size{encoder.encode(sample, frame)};
+        ASSERT_GT(size, 0u);
+        ASSERT_TRUE(isCompactTelemetryFrame(frame.bytes.data(), size));
+        if (frame.bytes[1] == static_cast<std::uint8_t>(compact_wire::FrameType::Delta)) {
+            deltaBytes += size;
+            ++deltaFrames;
+        } else {
+            EXPECT_EQ(i % 10, 0); // Keyframe every 10 frames
+        }
+        
+        TelemetrySample decoded;
+        ASSERT_TRUE(decoder.decode(frame.bytes.data(), size, decoded));
+        EXPECT_EQ(decoded.vehicle_id, 3u);
+        EXPECT_NEAR(decoded.data.timestamp, sample.data.timestamp, 0.0005 + 1e-6);
+        EXPECT_NEAR(decoded.data.position_north, sample.data.position_north, 0.005 + 1e-9);
+        EXPECT_NEAR(decoded.data.velocity_y, sample.data.velocity_y, 0.005 + 1e-9);
+        EXPECT_NEAR(decoded.data.yaw, sample.data.yaw, compact_wire::kAngleStep / 2 + 1e-12);
+        EXPECT_NEAR(decoded.data.throttle, sample.data.throttle, 0.5 / 255.0 + 1e-12);
+        EXPECT_NEAR(decoded.data.aileron, sample.data.aileron, 0.5 / 127.0 + 1e-12);
+    }
+    
+    // Deltas are at least 5x smaller than a 128-byte binary State frame
+    ASSERT_GT(deltaFrames, 0u);
+    EXPECT_LE(deltaBytes * 5, deltaFrames * telemetry_wire::kStateFrameSize);
+}
+
+TEST(CompactTelemetryTest, DeltasWithoutTheirKeyframeAreRejected) {
+    CompactTelemetryEncoder encoder{4};
+    CompactTelemetryDecoder decoder;
+    TelemetryFrameBuffer frame;
+    TelemetrySample decoded;
+    
+    // Lose the first keyframe: its deltas are unusable, the next keyframe resyncs
+    const TelemetrySample sample{0, sampleTelemetry()};
+    encoder.encode(sample, frame);
+    for (int i = 1; i < 4; ++i) {
+        encoder.encode(sample, frame);
+        EXPECT_FALSE(decoder.decode(frame.bytes.data(), frame.size, decoded));
+    }
+    encoder.encode(sample, frame);
+    EXPECT_TRUE(decoder.decode(frame.bytes.data(), frame.size, decoded));
+    
+    // Compact frames are not mistaken for the other formats and vice versa
+    TelemetryData single;
+    EXPECT_FALSE(decodeTelemetry(frame.bytes.data(), frame.size, single));
+    encodeTelemetryBinary(sample.data, 0, frame);
+    EXPECT_FALSE(isCompactTelemetryFrame(frame.bytes.data(), frame.size));
+}
+
+TEST(TelemetryServerTest, RegisterHandshakeStreamsFrames) {
+    namespace asio = boost::asio;
+    
+    TelemetryServer server{0};
+    server.setUpdateRate(100.0);
+    server.start();
+    ASSERT_NE(server.getPort(), 0);
+    
+    asio::io_context io;
+    asio::ip::udp::socket client{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    const asio::ip::udp::endpoint serverEndpoint{asio::ip::address_v4::loopback(), server.getPort()};
+    
+    client.send_to(asio::buffer(std::string{"REGISTER\n"}), serverEndpoint);
+    ASSERT_TRUE(waitFor([&] { return server.getClientCount() == 1; }));
+    
+    // A binary frame arrives within a few ticks
+    server.sendTelemetry(sampleTelemetry());
+    ASSERT_TRUE(waitFor([&] { return client.available() > 0; }));
+    
+    std::array<std::uint8_t, 1024> datagram{};
+    asio::ip::udp::endpoint sender;
+    const std::size_t bytes{client.receive_from(asio::buffer(datagram), sender)};
+    EXPECT_EQ(bytes, telemetry_wire::kStateFrameSize);
+    
+    TelemetryData decoded;
+    ASSERT_TRUE(decodeTelemetry(datagram.data(), bytes, decoded));
+    EXPECT_DOUBLE_EQ(decoded.position_north, 10.25);
+    
+    // Re-registering switches the encoding; unregistering removes the client
+    client.send_to(asio::buffer(std::string{"register csv"}), serverEndpoint);
+    client.send_to(asio::buffer(std::string{"UNREGISTER"}), serverEndpoint);
+    EXPECT_TRUE(waitFor([&] { return server.getClientCount() == 0; }));
+    
+    server.stop();
+}
+
+TEST(TelemetryServerTest, UnreachableClientDoesNotStallOthers) {
+    namespace asio = boost::asio;
+    
+    TelemetryServer server{0};
+    server.setUpdateRate(100.0);
+    
+    // Nothing listens on the first client's port
+    asio::io_context io;
+    asio::ip::udp::socket client{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    server.addClient("127.0.0.1", 9, TelemetryEncoding::Binary);
+    server.addClient("127.0.0.1", client.local_endpoint().port(), TelemetryEncoding::Csv);
+    server.start();
+    ASSERT_TRUE(waitFor([&] { return server.getClientCount() == 2; }));
+    
+    for (int i = 0; i < 20; ++i) {
+        server.sendTelemetry(sampleTelemetry());
+    }
+    ASSERT_TRUE(waitFor([&] { return client.available() > 0; }));
+    
+    std::array<std::uint8_t, 1024> datagram{};
+    asio::ip::udp::endpoint sender;
+    const std::size_t bytes{client.receive_from(asio::buffer(datagram), sender)};
+    TelemetryData decoded;
+    ASSERT_TRUE(decodeTelemetry(datagram.data(), bytes, decoded));
+    EXPECT_DOUBLE_EQ(decoded.rudder, 0.0625);
+    
+    server.stop();
+}
+
+TEST(TelemetryServerTest, QueuePoliciesBoundTheBacklog) {
+    TelemetryData data{sampleTelemetry()};
+    
+    // DrainAll refuses samples once full
+    TelemetryServer drainAll{0, 4};
+    drainAll.setQueuePolicy(TelemetryQueuePolicy::DrainAll);
+    for (int i = 0; i < 10; ++i) {
+        drainAll.sendTelemetry(data);
+    }
+    TelemetryQueueStats stats{drainAll.getQueueStats()};
+    EXPECT_EQ(stats.enqueued, 4u);
+    EXPECT_EQ(stats.rejected, 6u);
+    EXPECT_EQ(stats.depth, 4u);
+    
+    // DropOldest always accepts and evicts instead
+    TelemetryServer dropOldest{0, 4};
+    dropOldest.setQueuePolicy(TelemetryQueuePolicy::DropOldest);
+    for (int i = 0; i < 10; ++i) {
+        dropOldest.sendTelemetry(data);
+    }
+    stats = dropOldest.getQueueStats();
+    EXPECT_EQ(stats.enqueued, 10u);
+    EXPECT_EQ(stats.evicted, 6u);
+    EXPECT_EQ(stats.depth, 4u);
+}
+
+TEST(TelemetryServerTest, ConflateLatestSendsOnlyNewestSample) {
+    namespace asio = boost::asio;
+    
+    asio::io_context io;
+    asio::ip::udp::socket client{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    
+    TelemetryServer server{0, 16};
+    EXPECT_EQ(server.getQueuePolicy(), TelemetryQueuePolicy::ConflateLatest);
+    server.setUpdateRate(1.0);
+    server.addClient("127.0.0.1", client.local_endpoint().port());
+    
+    // Queue a burst before the first tick; only the newest may go out
+    TelemetryData data{sampleTelemetry()};
+    for (int i = 0; i < 10; ++i) {
+        data.timestamp = i;
+        server.sendTelemetry(data);
+    }
+    server.start();
+    ASSERT_TRUE(waitFor([&] { return client.available() > 0; }, std::chrono::milliseconds(3000)));
+    
+    std::array<std::uint8_t, 1024> datagram{};
+    asio::ip::udp::endpoint sender;
+    const std::size_t bytes{client.receive_from(asio::buffer(datagram), sender)};
+    TelemetryData decoded;
+    ASSERT_TRUE(decodeTelemetry(datagram.data(), bytes, decoded));
+    EXPECT_DOUBLE_EQ(decoded.timestamp, 9.0);
+    
+    const TelemetryQueueStats stats{server.getQueueStats()};
+    EXPECT_EQ(stats.sent, 1u);
+    EXPECT_EQ(stats.conflated, 9u);
+    EXPECT_EQ(stats.depth, 0u);
+    
+    server.stop();
+}
+
+TEST(TelemetryServerTest, BatchedFanOutReachesEveryClient) {
+    namespace asio = boost::asio;
+    
+    asio::io_context io;
+    std::vector<std::unique_ptr<asio::ip::udp::socket>> clients;
+    TelemetryServer server{0};
+    server.setUpdateRate(100.0);
+    server.setSamplesPerDatagram(telemetry_wire::kMaxBatchSamples);
+    for (int i = 0; i < 3; ++i) {
+        clients.push_back(std::make_unique<asio::ip::udp::socket>(
+            io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}));
+        server.addClient("127.0.0.1", clients.back()->local_endpoint().port());
+    }
+    
+    // Five vehicles, two samples each: conflation keeps the newest per vehicle
+    for (std::uint32_t round = 0; round < 2; ++round) {
+        for (std::uint32_t vehicle = 0; vehicle < 5; ++vehicle) {
+            TelemetryData data{sampleTelemetry()};
+            data.timestamp = round;
+            server.sendTelemetry(data, vehicle);
+        }
+    }
+    server.start();
+    
+    for (auto& client : clients) {
+        ASSERT_TRUE(waitFor([&] { return client->available() > 0; }));
+        std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> datagram{};
+        asio::ip::udp::endpoint sender;
+        const std::size_t bytes{client->receive_from(asio::buffer(datagram), sender)};
+        
+        std::array<TelemetrySample, telemetry_wire::kMaxBatchSamples> samples{};
+        ASSERT_EQ(decodeTelemetrySamples(datagram.data(), bytes, samples.data(), samples.size()), 5u);
+        for (std::uint32_t vehicle = 0; vehicle < 5; ++vehicle) {
+            EXPECT_EQ(samples[vehicle].vehicle_id, vehicle);
+            EXPECT_DOUBLE_EQ(samples[vehicle].data.timestamp, 1.0);
+        }
+    }
+    server.stop();
+    
+    const TelemetryTransportStats stats{server.getTransportStats()};
+    EXPECT_EQ(stats.datagrams_sent, 3u);
+#if defined(__linux__)
+    EXPECT_EQ(stats.send_calls, 1u); // One sendmmsg for all three clients
+#endif
+}
+
+TEST(SensorPipelineTest, StreamsSamplesToSubscribedClients) {
+    namespace asio = boost::asio;
+    
+    asio::io_context io;
+    asio::ip::udp::socket client{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    asio::ip::udp::socket plain{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    TelemetryServer server{0};
+    server.addClient("127.0.0.1", plain.local_endpoint().port());
+    server.start();
+    
+    // Only a client that asks for sensor frames gets them
+    const asio::ip::udp::endpoint serverEndpoint{asio::ip::address_v4::loopback(), server.getPort()};
+    client.send_to(asio::buffer(std::string{"REGISTER BINARY SENSORS"}), serverEndpoint);
+    ASSERT_TRUE(waitFor([&] { return server.getClientCount() == 2; }));
+    
+    // Two vehicles at 100 Hz for half a second, as step observers would publish them
+    SensorSettings settings;
+    settings.imu.rate = 200.0;
+    SensorPipeline pipeline{settings, [&server](const SensorSample* samples, std::size_t count) {
+        server.sendSensorSamples(samples, count);
+    }};
+    for (std::uint32_t id = 1; id <= 2; ++id) {
+        for (const SensorSnapshot& snapshot : levelFlight(id, 4.0, 0.01, 50)) {
+            EXPECT_TRUE(pipeline.publish(snapshot.state, snapshot.time, snapshot.vehicle_id));
+        }
+    }
+    pipeline.stop();
+    EXPECT_FALSE(pipeline.publish(AircraftState{}, 1.0, 1));
+    
+    const SensorPipelineStats stats{pipeline.getStats()};
+    EXPECT_EQ(stats.published, 102u);
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.stale, 0u);
+    EXPECT_GE(stats.batches, 1u);
+    EXPECT_EQ(stats.samples, 2u * (101 + 5 + 25)); // IMU, then GPS and baro less their latency
+    
+    std::size_t received{0};
+    std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> datagram{};
+    std::array<SensorSample, telemetry_wire::kMaxSensorSamples> samples{};
+    while (received < stats.samples && waitFor([&] { return client.available() > 0; })) {
+        asio::ip::udp::endpoint sender;
+        const std::size_t bytes{client.receive_from(asio::buffer(datagram), sender)};
+        const std::size_t count{decodeSensorSamples(datagram.data(), bytes, samples.data(), samples.size())};
+        ASSERT_GT(count, 0u);
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_TRUE(samples[i].vehicle_id == 1 || samples[i].vehicle_id == 2);
+        }
+        received += count;
+    }
+    EXPECT_EQ(received, stats.samples);
+    EXPECT_EQ(plain.available(), 0u);
+    server.stop();
+    
+    const TelemetryQueueStats queue{server.getQueueStats()};
+    EXPECT_EQ(queue.sensor_enqueued, stats.samples);
+    EXPECT_EQ(queue.sensor_sent, stats.samples);
+    EXPECT_EQ(queue.sensor_dropped, 0u);
+    
+    MetricsReport report;
+    appendMetrics(report, stats);
+    EXPECT_NE(report.str().find("falconsim_sensor_samples_total 262"), std::string::npos);
+}
+
+TEST(SensorPipelineTest, SensorRingFollowsTheQueuePolicy) {
+    TelemetryServer server{0, 16, 8};
+    server.setQueuePolicy(TelemetryQueuePolicy::DrainAll);
+    server.start();
+    
+    // The flush is only posted once the batch is queued, so a full ring refuses the rest
+    std::vector<SensorSample> samples(100);
+    server.sendSensorSamples(samples.data(), samples.size());
+    ASSERT_TRUE(waitFor([&] { return server.getQueueStats().sensor_sent == 8; }));
+    TelemetryQueueStats stats{server.getQueueStats()};
+    EXPECT_EQ(stats.sensor_enqueued, 8u);
+    EXPECT_EQ(stats.sensor_rejected, 92u);
+    
+    // The other policies keep the newest samples instead
+    server.setQueuePolicy(TelemetryQueuePolicy::DropOldest);
+    server.sendSensorSamples(samples.data(), samples.size());
+    ASSERT_TRUE(waitFor([&] { return server.getQueueStats().sensor_sent == 16; }));
+    stats = server.getQueueStats();
+    EXPECT_EQ(stats.sensor_enqueued, 108u);
+    EXPECT_EQ(stats.sensor_evicted, 92u);
+    server.stop();
+}
+
+TEST(TelemetryReceiverTest, PollCoalescesUpdatesPerVehicle) {
+    TelemetryServer server{0};
+    server.setStreamMode(TelemetryStreamMode::PhysicsStep);
+    server.setQueuePolicy(TelemetryQueuePolicy::DrainAll);
+    server.setSamplesPerDatagram(telemetry_wire::kMaxBatchSamples);
+    server.start();
+    
+    TelemetryReceiver receiver{"127.0.0.1", server.getPort()};
+    receiver.start();
+    ASSERT_TRUE(waitFor([&] { return server.getClientCount() == 1; }));
+    
+    // Three vehicles, four steps each; only the newest step per vehicle is polled
+    for (std::uint32_t step = 0; step < 4; ++step) {
+        for (std::uint32_t vehicle = 0; vehicle < 3; ++vehicle) {
+            TelemetryData data{sampleTelemetry()};
+            data.timestamp = step;
+            data.position_north = vehicle;
+            server.sendTelemetry(data, 10 + vehicle);
+        }
+    }
+    double latest[3]{-1.0, -1.0, -1.0};
+    ASSERT_TRUE(waitFor([&] {
+        receiver.pollUpdates([&](std::size_t slot, const TelemetrySample& sample) {
+            EXPECT_EQ(sample.vehicle_id, 10 + slot);
+            EXPECT_DOUBLE_EQ(sample.data.position_north, static_cast<double>(slot));
+            latest[slot] = sample.data.timestamp;
+        });
+        return latest[0] == 3.0 && latest[1] == 3.0 && latest[2] == 3.0;
+    }));
+    EXPECT_EQ(receiver.getVehicleCount(), 3u);
+    
+    // Nothing changed since the previous poll
+    EXPECT_EQ(receiver.pollUpdates([](std::size_t, const TelemetrySample&) {}), 0u);
+    
+    // A new step of one vehicle shows up alone, in the slot first given to it
+    TelemetryData data{sampleTelemetry()};
+    data.timestamp = 4.0;
+    server.sendTelemetry(data, 11);
+    std::vector<std::pair<std::size_t, TelemetrySample>> updates;
+    ASSERT_TRUE(waitFor([&] {
+        receiver.pollUpdates([&](std::size_t slot, const TelemetrySample& sample) { updates.emplace_back(slot, sample); });
+        return !updates.empty();
+    }));
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].first, 1u);
+    EXPECT_EQ(updates[0].second.vehicle_id, 11u);
+    EXPECT_DOUBLE_EQ(updates[0].second.data.timestamp, 4.0);
+    EXPECT_DOUBLE_EQ(updates[0].second.data.position_north, 10.25);
+    
+    receiver.stop();
+    EXPECT_TRUE(waitFor([&] { return server.getClientCount() == 0; }));
+    server.stop();
+    EXPECT_GT(receiver.getDatagrams(), 0u);
+    EXPECT_EQ(receiver.getMalformed(), 0u);
+}
+
+TEST(TelemetryServerTest, PhysicsStepModeDecimatesPerClient) {
+    namespace asio = boost::asio;
+    
+    TelemetryServer server{0};
+    server.setStreamMode(TelemetryStreamMode::PhysicsStep);
+    server.setQueuePolicy(TelemetryQueuePolicy::DrainAll);
+    server.start();
+    
+    asio::io_context io;
+    asio::ip::udp::socket fullRate{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    asio::ip::udp::socket decimated{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    const asio::ip::udp::endpoint serverEndpoint{asio::ip::address_v4::loopback(), server.getPort()};
+    fullRate.send_to(asio::buffer(std::string{"REGISTER BINARY"}), serverEndpoint);
+    decimated.send_to(asio::buffer(std::string{"REGISTER BINARY 10"}), serverEndpoint);
+    ASSERT_TRUE(waitFor([&] { return server.getClientCount() == 2; }));
+    
+    // 100 physics steps at 1 kHz stream straight through, without waiting for a timer tick
+    Simulation sim{0.001};
+    sim.setStepObserver([&server](const AircraftState& state, const ControlInputs& controls, double time) {
+        server.publishStep(state, controls, time);
+    });
+    sim.step(100);
+    
+    const auto receiveAll = [](asio::ip::udp::socket& socket, std::size_t expected) {
+        std::vector<double> timestamps;
+        waitFor([&] {
+            while (socket.available() > 0) {
+                std::array<std::uint8_t, telemetry_wire::kMaxDatagramSize> datagram{};
+                asio::ip::udp::endpoint sender;
+                const std::size_t bytes{socket.receive_from(asio::buffer(datagram), sender)};
+                TelemetryData decoded;
+                if (decodeTelemetry(datagram.data(), bytes, decoded)) {
+                    timestamps.push_back(decoded.timestamp);
+                }
+            }
+            return timestamps.size() >= expected;
+        });
+        return timestamps;
+    };
+    
+    const std::vector<double> full{receiveAll(fullRate, 100)};
+    const std::vector<double> tenth{receiveAll(decimated, 10)};
+    server.stop();
+    
+    ASSERT_EQ(full.size(), 100u);
+    ASSERT_EQ(tenth.size(), 10u);
+    for (std::size_t i = 0; i < tenth.size(); ++i) {
+        EXPECT_NEAR(tenth[i], 0.001 * static_cast<double>(10 * i + 1), 1e-9); // Stamped with simulated time
+    }
+    EXPECT_EQ(server.getQueueStats().sent, 100u);
+}
+
+TEST(MetricsServerTest, StatsRequestReportsPerClientCounters) {
+    namespace asio = boost::asio;
+    
+    TelemetryServer telemetry{0};
+    telemetry.setStreamMode(TelemetryStreamMode::PhysicsStep);
+    telemetry.setQueuePolicy(TelemetryQueuePolicy::DrainAll);
+    telemetry.start();
+    
+    asio::io_context io;
+    asio::ip::udp::socket client{io, asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    client.send_to(asio::buffer(std::string{"REGISTER BINARY"}),
+                   asio::ip::udp::endpoint{asio::ip::address_v4::loopback(), telemetry.getPort()});
+    ASSERT_TRUE(waitFor([&] { return telemetry.getClientCount() == 1; }));
+    
+    for (int i = 0; i < 5; ++i) {
+        telemetry.sendTelemetry(sampleTelemetry());
+    }
+    ASSERT_TRUE(waitFor([&] {
+        const TelemetryMetrics metrics{telemetry.getMetrics()};
+        return metrics.clients.size() == 1 && metrics.clients[0].datagramsSent == 5;
+    }));
+    const TelemetryMetrics metrics{telemetry.getMetrics()};
+    EXPECT_EQ(metrics.queue.enqueued, 5u);
+    EXPECT_GT(metrics.flush_time.count, 0u);
+    EXPECT_GE(metrics.encode_time.count, 5u);
+    
+    MetricsServer stats{0};
+    stats.addSource([&telemetry](MetricsReport& report) { appendMetrics(report, telemetry.getMetrics()); });
+    stats.start();
+    EXPECT_THROW(stats.addSource({}), std::runtime_error);
+    
+    // Anything but STATS is ignored
+    const asio::ip::udp::endpoint statsEndpoint{asio::ip::address_v4::loopback(), stats.getPort()};
+    client.send_to(asio::buffer(std::string{"HELLO"}), statsEndpoint);
+    client.send_to(asio::buffer(std::string{"stats\n"}), statsEndpoint);
+    
+    // Drain leftover telemetry until the text report arrives
+    std::string reply;
+    ASSERT_TRUE(waitFor([&] {
+        while (client.available() > 0) {
+            std::array<char, MetricsServer::kMaxReportSize> datagram{};
+            asio::ip::udp::endpoint sender;
+            const std::size_t bytes{client.receive_from(asio::buffer(datagram), sender)};
+            if (sender.port() == stats.getPort()) {
+                reply.assign(datagram.data(), bytes);
+            }
+        }
+        return !reply.empty();
+    }));
+    stats.stop();
+    telemetry.stop();
+    
+    EXPECT_EQ(stats.getRequestCount(), 1u);
+    EXPECT_NE(reply.find("falconsim_telemetry_enqueued_total 5\n"), std::string::npos);
+    const std::string clientLabel{"client=\"127.0.0.1:" + std::to_string(client.local_endpoint().port()) + "\""};
+    EXPECT_NE(reply.find("falconsim_telemetry_client_datagrams_sent_total{" + clientLabel + "} 5\n"), std::string::npos);
+}
+
+TEST(SharedTelemetryTest, SubscriberPollsInOrderAndCountsOverruns) {
+    const std::string name{"/falconsim_test_" + std::to_string(::getpid())};
+    SharedTelemetryPublisher publisher{name, 8};
+    SharedTelemetrySubscriber subscriber{name};
+    EXPECT_EQ(subscriber.getCapacity(), 8u);
+    
+    SharedTelemetryRecord record;
+    EXPECT_FALSE(subscriber.latest(record));
+    
+    AircraftState state;
+    ControlInputs controls;
+    controls.throttle = 0.75;
+    for (int i = 0; i < 5; ++i) {
+        state.position.x() = i;
+        publisher.publish(state, controls, 0.01 * i, 3);
+    }
+    
+    ASSERT_TRUE(subscriber.latest(record));
+    EXPECT_EQ(record.index, 4u);
+    EXPECT_EQ(record.vehicle_id, 3u);
+    EXPECT_DOUBLE_EQ(record.state().position.x(), 4.0);
+    EXPECT_DOUBLE_EQ(record.controls().throttle, 0.75);
+    
+    SharedTelemetryRecord records[16];
+    ASSERT_EQ(subscriber.poll(records, 16), 5u);
+    for (std::uint64_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(records[i].index, i);
+    }
+    EXPECT_EQ(subscriber.poll(records, 16), 0u);
+    
+    // Lapping the ring loses the oldest records, and the reader says how many
+    for (int i = 0; i < 20; ++i) {
+        publisher.publish(state, controls, 0.0);
+    }
+    ASSERT_EQ(subscriber.poll(records, 16), 8u);
+    EXPECT_EQ(records[0].index, 17u);
+    EXPECT_EQ(subscriber.getMissed(), 12u);
+    
+    EXPECT_THROW(SharedTelemetrySubscriber{name + "_missing"}, std::runtime_error);
+}
+
+TEST(SharedTelemetryTest, ReadersNeverSeeTornRecords) {
+    const std::string name{"/falconsim_test_torn_" + std::to_string(::getpid())};
+    SharedTelemetryPublisher publisher{name, 4};
+    SharedTelemetrySubscriber subscriber{name};
+    
+    // Every field of record n holds n, so a torn copy mixes values. The
+    // reader runs first and the writer keeps going until it has read enough,
+    // so the two overlap however the threads are scheduled.
+    constexpr std::uint64_t kReads{20000};
+    std::atomic<bool> seen{false};
+    std::atomic<bool> finished{false};
+    std::uint64_t reads{0};
+    std::uint64_t torn{0};
+    std::thread reader{[&] {
+        SharedTelemetryRecord record;
+        while (reads < kReads) {
+            if (subscriber.latest(record)) {
+                ++reads;
+                if (record.position[0] != record.sim_time || record.position[2] != record.sim_time ||
+                    record.rudder != record.sim_time || record.index + 1 != static_cast<std::uint64_t>(record.sim_time)) {
+                    ++torn;
+                }
+                seen = true;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        finished = true;
+    }};
+    
+    SharedTelemetryRecord record;
+    const auto publishNext = [&](std::uint64_t n) {
+        const double value{static_cast<double>(n)};
+        record.sim_time = value;
+        std::fill(std::begin(record.position), std::end(record.position), value);
+        record.rudder = value;
+        publisher.publish(record);
+    };
+    std::uint64_t n{1};
+    publishNext(n++);
+    while (!seen) {
+        std::this_thread::yield();
+    }
+    while (!finished) {
+        publishNext(n++);
+    }
+    reader.join();
+    
+    EXPECT_GT(reads, 0u);
+    EXPECT_EQ(torn, 0u);
+}
+
+TEST(DistributedFleetTest, NodesMatchOneFleetAsVehiclesMigrate) {
+    constexpr std::size_t kNodes{3};
+    constexpr std::uint32_t kVehicles{24};
+    constexpr int kSteps{100};
+    TurbulenceParameters turbulence;
+    turbulence.wind_speed_20ft = 6.0;
+    turbulence.seed = 5;
+    
+    // Slabs (-inf, 0), [0, 30) and [30, inf) along north, one node each
+    std::vector<std::unique_ptr<DistributedFleet>> nodes;
+    for (std::size_t k = 0; k < kNodes; ++k) {
+        DistributedFleetSettings settings;
+        settings.node = k;
+        settings.boundaries = {0.0, 30.0};
+        settings.halo = 15.0;
+        settings.bind_address = "127.0.0.1";
+        nodes.push_back(std::make_unique<DistributedFleet>(settings));
+        nodes.back()->getFleet().setTurbulence(turbulence);
+        nodes.back()->getFleet().setSimdIsa(SimdIsa::Scalar);
+    }
+    for (std::size_t k = 0; k < kNodes; ++k) {
+        if (k > 0) {
+            nodes[k]->setNeighbour(DistributedFleet::Side::Lower, "127.0.0.1", nodes[k - 1]->getPort());
+        }
+        if (k + 1 < kNodes) {
+            nodes[k]->setNeighbour(DistributedFleet::Side::Upper, "127.0.0.1", nodes[k + 1]->getPort());
+        }
+    }
+    EXPECT_FALSE(nodes[0]->hasNeighbour(DistributedFleet::Side::Lower));
+    EXPECT_THROW(nodes[2]->setNeighbour(DistributedFleet::Side::Upper, "127.0.0.1", 9), std::invalid_argument);
+    
+    // Alternately heading north and south across both boundaries, each starting on the node owning its slab
+    FleetDynamics reference;
+    reference.setTurbulence(turbulence);
+    reference.setSimdIsa(SimdIsa::Scalar);
+    for (std::uint32_t id = 0; id < kVehicles; ++id) {
+        AircraftState state;
+        state.position = Eigen::Vector3d(-20.0 + 2.5 * id, 5.0 * (id % 3), -100.0);
+        state.velocity = Eigen::Vector3d(15.0, 0.0, 0.5);
+        state.euler_angles = Eigen::Vector3d(0.0, 0.02, (id % 2) ? 0.0 : 3.0);
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        controls.elevator = 0.02 * (id % 4);
+        
+        auto index = reference.addVehicle(state);
+        reference.setControls(index, controls);
+        reference.setLiftCoefficient(index, 0.2);
+        
+        DistributedFleet& owner{*nodes[nodes[0]->partitionOf(state.position.x())]};
+        auto local = owner.addVehicle(id, state);
+        owner.getFleet().setControls(local, controls);
+        owner.getFleet().setLiftCoefficient(local, 0.2);
+    }
+    EXPECT_EQ(nodes[1]->getIds().size(), 12u);
+    
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (auto& node : nodes) {
+        threads.emplace_back([&node, &failures] {
+            try {
+                for (int step = 0; step < kSteps; ++step) {
+                    node->step(0.01);
+                }
+            } catch (const std::exception&) {
+                ++failures;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(failures.load(), 0);
+    for (int step = 0; step < kSteps; ++step) {
+        reference.update(0.01);
+    }
+    
+    // Every vehicle is owned exactly once, by the node of its slab, bit for bit where one fleet has it
+    std::vector<int> owned(kVehicles, 0);
+    std::uint64_t migratedIn{0};
+    std::uint64_t migratedOut{0};
+    std::size_t ghosts{0};
+    for (const auto& node : nodes) {
+        EXPECT_EQ(node->getTick(), static_cast<std::uint64_t>(kSteps));
+        const std::vector<std::uint32_t>& ids{node->getIds()};
+        for (std::size_t local = 0; local < ids.size(); ++local) {
+            ASSERT_LT(ids[local], kVehicles);
+            ++owned[ids[local]];
+            const AircraftState expected{reference.getState(ids[local])};
+            const AircraftState actual{node->getFleet().getState(local)};
+            EXPECT_EQ(node->partitionOf(actual.position.x()), node->getNode()) << "vehicle " << ids[local];
+            EXPECT_EQ(actual.position, expected.position) << "vehicle " << ids[local];
+            EXPECT_EQ(actual.velocity, expected.velocity) << "vehicle " << ids[local];
+            EXPECT_EQ(actual.angular_velocity, expected.angular_velocity) << "vehicle " << ids[local];
+        }
+        
+        // Ghosts are the neighbours' vehicles near this slab, as of this tick
+        for (const TelemetrySample& ghost : node->getGhosts()) {
+            ASSERT_LT(ghost.vehicle_id, kVehicles);
+            const AircraftState expected{reference.getState(ghost.vehicle_id)};
+            EXPECT_NE(node->partitionOf(ghost.data.position_north), node->getNode());
+            EXPECT_EQ(ghost.data.position_north, expected.position.x());
+            EXPECT_EQ(ghost.data.yaw, expected.euler_angles.z());
+            EXPECT_NEAR(ghost.data.timestamp, 1.0, 1e-9);
+            ++ghosts;
+        }
+        
+        const DistributedFleetStats stats{node->getStats()};
+        EXPECT_EQ(stats.ticks, static_cast<std::uint64_t>(kSteps));
+        EXPECT_EQ(stats.rejected, 0u);
+        EXPECT_EQ(stats.barrier_wait.count, static_cast<std::uint64_t>(kSteps));
+        migratedIn += stats.migrated_in;
+        migratedOut += stats.migrated_out;
+    }
+    EXPECT_EQ(owned, std::vector<int>(kVehicles, 1));
+    EXPECT_GT(migratedIn, 0u);
+    EXPECT_EQ(migratedIn, migratedOut);
+    EXPECT_GT(ghosts, 0u);
+}
+
+TEST(DistributedFleetTest, SilentNeighbourTimesOut) {
+    DistributedFleetSettings settings;
+    settings.boundaries = {0.0};
+    settings.bind_address = "127.0.0.1";
+    settings.retransmit_interval = std::chrono::milliseconds(5);
+    settings.timeout = std::chrono::milliseconds(50);
+    
+    // Node 1 is bound but never steps
+    settings.node = 1;
+    DistributedFleet silent{settings};
+    settings.node = 0;
+    DistributedFleet node{settings};
+    EXPECT_THROW(node.step(0.01), std::runtime_error); // No neighbour address yet
+    node.setNeighbour(DistributedFleet::Side::Upper, "127.0.0.1", silent.getPort());
+    node.addVehicle(7);
+    EXPECT_THROW(node.step(0.01), std::runtime_error);
+    EXPECT_GT(node.getStats().retransmits, 0u);
+    EXPECT_EQ(node.getTick(), 0u);
+    
+    settings.node = 2;
+    EXPECT_THROW(DistributedFleet{settings}, std::invalid_argument);
+    settings.node = 0;
+    settings.boundaries = {10.0, 5.0};
+    EXPECT_THROW(DistributedFleet{settings}, std::invalid_argument);
+}
+
+TEST(FlightRecorderTest, RecordsChunksAndSeeksByTime) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_log_" + std::to_string(::getpid()) + ".fslog")).string()};
+    
+    // 2500 steps in 256-record chunks: nine full chunks and a partial one
+    {
+        FlightRecorder recorder{path, 256, 16}; // Enough buffers that a slow disk cannot drop steps
+        Simulation sim{0.001};
+        sim.setThrust(0.5);
+        sim.setStepObserver([&recorder](const AircraftState& state, const ControlInputs& controls, double time) {
+            recorder.record(state, controls, time);
+        });
+        sim.step(2500);
+        recorder.close();
+        EXPECT_EQ(recorder.getRecorded(), 2500u);
+        EXPECT_EQ(recorder.getDropped(), 0u);
+        EXPECT_EQ(recorder.getChunksWritten(), 10u);
+        EXPECT_EQ(recorder.getWriteErrors(), 0u);
+    }
+    
+    FlightLogReader reader{path};
+    EXPECT_FALSE(reader.wasRecovered());
+    const std::size_t records{reader.size()};
+    ASSERT_EQ(records, 2500u);
+    EXPECT_EQ(reader.getChunkCount(), 10u);
+    EXPECT_NEAR(reader.getStartTime(), 0.001, 1e-12);
+    
+    const FlightLogRecord first{reader.at(0)};
+    EXPECT_NEAR(first.sim_time, 0.001, 1e-12);
+    EXPECT_DOUBLE_EQ(first.controls.throttle, 0.5);
+    EXPECT_THROW(reader.at(records), std::out_of_range);
+    
+    // Timestamps are strictly increasing, so a seek lands on the exact step
+    for (std::size_t index : {std::size_t{0}, std::size_t{255}, std::size_t{256}, records / 2, records - 1}) {
+        const double time{reader.at(index).sim_time};
+        EXPECT_EQ(reader.seek(time), index);
+        EXPECT_EQ(reader.seek(time - 1e-7), index);
+    }
+    EXPECT_EQ(reader.seek(-1.0), 0u);
+    EXPECT_EQ(reader.seek(1e9), records);
+    
+    std::size_t count;
+    const double* throttle{reader.column(0, flight_log::Column::Throttle, count)};
+    EXPECT_EQ(count, 256u);
+    EXPECT_DOUBLE_EQ(throttle[count - 1], 0.5);
+    
+    std::filesystem::remove(path);
+}
+
+TEST(FlightRecorderTest, LogWithoutFooterIsRecovered) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_torn_" + std::to_string(::getpid()) + ".fslog")).string()};
+    {
+        FlightRecorder recorder{path, 100, 8};
+        AircraftState state;
+        ControlInputs controls;
+        for (int i = 0; i < 350; ++i) {
+            state.position.x() = i;
+            recorder.record(state, controls, 0.01 * (i + 1));
+        }
+    }
+    
+    // Cut off the index, the footer and half of the last chunk, as a crash would
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 4 * sizeof(flight_log::IndexEntry) - sizeof(flight_log::Footer) -
+                                           flight_log::chunkSize(50) / 2);
+    
+    FlightLogReader reader{path};
+    EXPECT_TRUE(reader.wasRecovered());
+    EXPECT_EQ(reader.getChunkCount(), 3u);
+    ASSERT_EQ(reader.size(), 300u);
+    EXPECT_DOUBLE_EQ(reader.at(299).state.position.x(), 299.0);
+    EXPECT_EQ(reader.seek(1.505), 150u);
+    
+    std::filesystem::remove(path);
+}
+
+TEST(FlightRecorderTest, CorruptIndexIsRebuilt) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_corrupt_" + std::to_string(::getpid()) + ".fslog")).string()};
+    {
+        FlightRecorder recorder{path, 16, 8};
+        AircraftState state;
+        ControlInputs controls;
+        for (int i = 0; i < 40; ++i) {
+            state.position.x() = i;
+            recorder.record(state, controls, 0.01 * (i + 1));
+        }
+    }
+    
+    // Overwrite one field of one index entry (chunks of 16, 16 and 8 records)
+    const auto size = std::filesystem::file_size(path);
+    const auto indexOffset = size - sizeof(flight_log::Footer) - 3 * sizeof(flight_log::IndexEntry);
+    const auto corrupt = [&](std::size_t entry, std::size_t field, std::uint64_t value) {
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(static_cast<std::streamoff>(indexOffset + entry * sizeof(flight_log::IndexEntry) + field));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    
+    // An offset far past the end, one into the middle of a chunk, and a gap in the record numbers
+    const std::uint64_t secondChunk{flight_log::kFileHeaderSize + flight_log::chunkSize(16)};
+    const std::tuple<std::size_t, std::size_t, std::uint64_t> corruptions[]{
+        {0, offsetof(flight_log::IndexEntry, offset), std::uint64_t{1} << 40},
+        {1, offsetof(flight_log::IndexEntry, offset), secondChunk + 8},
+        {2, offsetof(flight_log::IndexEntry, firstIndex), 33},
+    };
+    const std::uint64_t original[]{flight_log::kFileHeaderSize, secondChunk, 32};
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto& [entry, field, value] = corruptions[i];
+        corrupt(entry, field, value);
+        
+        FlightLogReader reader{path};
+        EXPECT_TRUE(reader.wasRecovered()) << i;
+        EXPECT_EQ(reader.getChunkCount(), 3u) << i;
+        ASSERT_EQ(reader.size(), 40u) << i;
+        EXPECT_DOUBLE_EQ(reader.at(39).state.position.x(), 39.0) << i;
+        EXPECT_EQ(reader.seek(0.205), 20u) << i;
+        corrupt(entry, field, original[i]);
+    }
+    
+    // Restored, the footer index is trusted again
+    FlightLogReader reader{path};
+    EXPECT_FALSE(reader.wasRecovered());
+    EXPECT_EQ(reader.size(), 40u);
+    
+    std::filesystem::remove(path);
+}
+
+TEST(SweepLogTest, ColumnsRoundTripAndCutOffChunksAreDropped) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_sweep_" + std::to_string(::getpid()) + ".fssweep")).string()};
+    
+    SweepSettings settings;
+    settings.duration = 1.0;
+    std::vector<SweepRunSummary> runs;
+    SweepAggregate result;
+    {
+        // 32 runs in chunks of 10: three full chunks and a partial one
+        SweepLogWriter writer{path, 10};
+        SweepRunner runner{2};
+        result = runner.run(SweepSpace::grid(smallSweepGrid()), settings, [&](const SweepRunSummary& run) {
+            runs.push_back(run);
+            writer.append(run);
+        });
+        writer.close();
+        EXPECT_EQ(writer.getWritten(), 32u);
+        EXPECT_EQ(writer.getWriteErrors(), 0u);
+    }
+    
+    const SweepLogReader reader{path};
+    EXPECT_FALSE(reader.wasTruncated());
+    ASSERT_EQ(reader.size(), runs.size());
+    for (std::size_t row = 0; row < runs.size(); ++row) {
+        const SweepRunSummary read{reader.at(row)};
+        EXPECT_EQ(read.case_index, runs[row].case_index);
+        EXPECT_EQ(read.steps, runs[row].steps);
+        EXPECT_EQ(read.outcome, runs[row].outcome);
+        EXPECT_EQ(std::memcmp(read.metrics, runs[row].metrics, sizeof(read.metrics)), 0);
+        EXPECT_EQ(reader.metric(SweepMetric::MaxSpeed)[row], runs[row].metric(SweepMetric::MaxSpeed));
+    }
+    EXPECT_THROW(static_cast<void>(reader.at(runs.size())), std::out_of_range);
+    
+    // Statistics rebuilt from the file agree with the streamed ones
+    const SweepAggregate reread{reader.aggregate()};
+    EXPECT_EQ(reread.getRuns(), result.getRuns());
+    EXPECT_EQ(reread.getOutcomeCount(SweepOutcome::GroundImpact), result.getOutcomeCount(SweepOutcome::GroundImpact));
+    EXPECT_EQ(reread.quantiles(SweepMetric::FinalAltitude).quantile(0.5),
+              result.quantiles(SweepMetric::FinalAltitude).quantile(0.5));
+    EXPECT_NEAR(reread.stats(SweepMetric::FinalAltitude).mean(), result.stats(SweepMetric::FinalAltitude).mean(), 1e-9);
+    
+    // Cut the last chunk short, as a crash mid-write would
+    std::filesystem::resize_file(path, sweep_log::kFileHeaderSize + 3 * sweep_log::chunkSize(10) +
+                                       sweep_log::chunkSize(2) - 8);
+    const SweepLogReader truncated{path};
+    EXPECT_TRUE(truncated.wasTruncated());
+    EXPECT_EQ(truncated.size(), 30u);
+    
+    // An outcome past the enum rejects its chunk rather than indexing out of bounds
+    {
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(static_cast<std::streamoff>(sweep_log::kFileHeaderSize + 2 * sweep_log::chunkSize(10) +
+                                               sizeof(sweep_log::ChunkHeader) +
+                                               static_cast<std::size_t>(sweep_log::Column::Outcome) * 10 * 8));
+        const std::uint64_t outcome{kSweepOutcomeCount};
+        file.write(reinterpret_cast<const char*>(&outcome), sizeof(outcome));
+    }
+    const SweepLogReader corrupt{path};
+    EXPECT_TRUE(corrupt.wasTruncated());
+    EXPECT_EQ(corrupt.size(), 20u);
+    EXPECT_EQ(corrupt.aggregate().getRuns(), 20u);
+    std::filesystem::remove(path);
+    
+    EXPECT_THROW(SweepLogReader{path}, std::runtime_error);
+}
+
+TEST(ScenarioBundleTest, BuildsTheFleetItWasCompiledFrom) {
+    const std::string path{(std::filesystem::temp_directory_path() /
+                            ("falconsim_scenario_" + std::to_string(::getpid()) + ".fsscene")).string()};
+    const auto table = makeSyntheticAeroTable();
+    const auto field = makeAffineWindField();
+    
+    ScenarioBundleWriter writer;
+    ScenarioAirframe light;
+    light.lift_coefficient = 0.2;
+    ScenarioAirframe heavy;
+    heavy.properties.mass = 4.5;
+    heavy.properties.thrust_max = 30.0;
+    heavy.wing_area = 0.8;
+    heavy.aero_table = writer.addAeroTable(table);
+    const std::uint32_t airframes[2]{writer.addAirframe(light), writer.addAirframe(heavy)};
+    ScenarioEnvironment environment;
+    environment.wind[0] = 1.0;
+    environment.wind[1] = -2.0;
+    environment.turbulence = TurbulenceParameters{8.0, 40};
+    environment.wind_field = writer.addWindField(field);
+    writer.setEnvironment(environment);
+    
+    // The reference fleet already holds a vehicle, so the bundle's are appended after it
+    FleetDynamics reference;
+    reference.setSimdIsa(SimdIsa::Scalar);
+    reference.addVehicle();
+    reference.setWind(Eigen::Vector3d{1.0, -2.0, 0.0});
+    reference.setWindField(field);
+    reference.setTurbulence(environment.turbulence);
+    constexpr int kVehicles{300};
+    writer.reserve(kVehicles);
+    for (int i = 0; i < kVehicles; ++i) {
+        const ScenarioAirframe& airframe{i % 3 == 0 ? heavy : light};
+        AircraftState state;
+        state.position = Eigen::Vector3d(-400.0 + 2.5 * i, 250.0 + i, -150.0 - 0.2 * i);
+        state.velocity = Eigen::Vector3d(15.0 + 0.01 * i, 0.2, 0.5);
+        state.euler_angles = Eigen::Vector3d(0.01 * (i % 5), 0.03, 0.02 * i);
+        ControlInputs controls;
+        controls.throttle = 0.5;
+        controls.elevator = 0.1 * (i % 4);
+        writer.addVehicle(airframes[i % 3 == 0 ? 1 : 0], state, controls);
+        
+        auto index = reference.addVehicle(state);
+        reference.setControls(index, controls);
+        reference.setProperties(index, airframe.properties);
+        reference.setWingspanArea(index, airframe.wing_area);
+        reference.setLiftCoefficient(index, airframe.lift_coefficient);
+        reference.setDragCoefficient(index, airframe.drag_coefficient);
+        if (i % 3 == 0) {
+            reference.setAeroTable(index, table);
+        }
+    }
+    EXPECT_THROW(writer.addVehicle(2, AircraftState{}), std::out_of_range);
+    EXPECT_THROW(writer.addAirframe(ScenarioAirframe{{}, 0.5, 1.2, 0.1, environment.wind_field}), std::invalid_argument);
+    writer.write(path);
+    
+    // Opening reads no assets; building the fleet loads the ones it uses
+    const ScenarioBundleReader reader{path};
+    ASSERT_EQ(reader.size(), static_cast<std::size_t>(kVehicles));
+    EXPECT_EQ(reader.getAirframeCount(), 2u);
+    EXPECT_EQ(reader.getAssetCount(), 2u);
+    EXPECT_EQ(reader.getLoadedAssetCount(), 0u);
+    EXPECT_EQ(reader.getVehicleAirframe(3), 1u);
+    EXPECT_EQ(reader.getState(7).position, reference.getState(8).position);
+    EXPECT_EQ(reader.getControls(6).elevator, reference.getControls(7).elevator);
+    EXPECT_EQ(reader.getAirframe(1).properties.mass, 4.5);
+    EXPECT_EQ(reader.getEnvironment().turbulence.seed, 40u);
+    EXPECT_THROW(static_cast<void>(reader.getState(kVehicles)), std::out_of_range);
+    EXPECT_THROW(static_cast<void>(reader.getAeroTable(environment.wind_field)), std::out_of_range);
+    
+    FleetDynamics fleet;
+    fleet.setSimdIsa(SimdIsa::Scalar);
+    fleet.addVehicle();
+    EXPECT_EQ(reader.buildFleet(fleet), 1u);
+    ASSERT_EQ(fleet.size(), reference.size());
+    EXPECT_EQ(reader.getLoadedAssetCount(), 2u);
+    EXPECT_TRUE(reader.getWindField(environment.wind_field)->isMapped());
+    const auto loaded = reader.getAeroTable(heavy.aero_table);
+    ASSERT_EQ(loaded->getNodeCount(), table->getNodeCount());
+    EXPECT_EQ(loaded->getNode(17).drag, table->getNode(17).drag);
+    EXPECT_EQ(fleet.getTurbulenceStream(5), 5u);
+    
+    for (int step = 0; step < 50; ++step) {
+        reference.update(0.01);
+        fleet.update(0.01);
+    }
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        EXPECT_EQ(fleet.getState(i).position, reference.getState(i).position) << "vehicle " << i;
+        EXPECT_EQ(fleet.getState(i).velocity, reference.getState(i).velocity) << "vehicle " << i;
+        EXPECT_EQ(fleet.getState(i).angular_velocity, reference.getState(i).angular_velocity) << "vehicle " << i;
+    }
+    
+    // A cut-off file, a foreign file and a missing file are all rejected
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_THROW(ScenarioBundleReader{path}, std::runtime_error);
+    std::ofstream{path} << std::string(5000, 'x');
+    EXPECT_THROW(ScenarioBundleReader{path}, std::runtime_error);
+    std::filesystem::remove(path);
+    EXPECT_THROW(ScenarioBundleReader{path}, std::runtime_error);
+}
+
+TEST(TelemetryServerTest, MulticastRequiresGroupAddress) {
+    TelemetryServer server{0};
+    EXPECT_THROW(server.addMulticastGroup("127.0.0.1", 5000), std::invalid_argument);
+    EXPECT_NO_THROW(server.addMulticastGroup("239.255.0.1", 5000));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();